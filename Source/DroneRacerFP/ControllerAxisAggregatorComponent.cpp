@@ -1,16 +1,29 @@
 #include "ControllerAxisAggregatorComponent.h"
 #include "GameFramework/Actor.h"
 #include "Components/InputComponent.h"
+#include "HAL/PlatformTime.h"
+
+// Longer than this between two stick samples and the filter restarts at the current sticks
+static constexpr float MaxRcSampleGap = 0.25f;
+
+// Device reports older than this mean the radio stopped streaming
+static constexpr double DeviceSticksTimeout = 0.1;
+
+static const FName RcChannelNames[RcChannel::Num] = { TEXT("Roll"), TEXT("Pitch"), TEXT("Yaw"), TEXT("Throttle") };
 
 UControllerAxisAggregatorComponent::UControllerAxisAggregatorComponent()
 {
 	PrimaryComponentTick.bCanEverTick = false;
 	EnsureAxesSize();
+
+	// Throttle moves slowly and drives thrust directly; smooth it harder than the rate axes
+	ThrottleFilter.Lowpass = ERcLowpassType::PT2;
+	ThrottleFilter.CutoffHz = 20.f;
 }
 
 void UControllerAxisAggregatorComponent::EnsureAxesSize()
 {
-	const int32 Clamped = FMath::Clamp(NumAxes, 1, 16);
+	const int32 Clamped = FMath::Clamp(NumAxes, 1, MaxControllerAxes);
 	NumAxes = Clamped;
 
 	if (Axes.Num() != NumAxes)
@@ -40,6 +53,139 @@ bool UControllerAxisAggregatorComponent::GetRawState(FControllerRawState& OutSta
 	return (Axes.Num() > 0);
 }
 
+void UControllerAxisAggregatorComponent::PushDeviceSample(TArrayView<const float> Values)
+{
+	EnsureAxesSize();
+
+	if (!SampleRing)
+	{
+		SampleRing = MakeUnique<FControllerSampleRing>();
+	}
+
+	const int32 Count = FMath::Min(NumAxes, Values.Num());
+
+	FControllerAxisSample& Sample = SampleRing->BeginPush();
+	Sample.TimeSeconds = FPlatformTime::Seconds();
+	Sample.NumAxes = Count;
+
+	for (int32 i = 0; i < Count; ++i)
+	{
+		SetAxisValue(i, Values[i]);
+		Sample.Axes[i] = Values[i];
+	}
+
+	SampleRing->CommitPush();
+
+	// Logical sticks through the RC filter chain at report rate
+	if (bHasLogicalMapping)
+	{
+		float Sticks[RcChannel::Num];
+		for (int32 Ch = 0; Ch < RcChannel::Num; ++Ch)
+		{
+			const FAxisMapping& M = ActiveCalibration.Mappings[LogicalMappingIndex[Ch]];
+			const float Raw = (M.AxisIndex < Count) ? Values[M.AxisIndex] : M.Calibration.RawCenter;
+			Sticks[Ch] = (Ch == RcChannel::Throttle)
+				? NormalizeThrottleAxis(Raw, M.Calibration)
+				: NormalizeCenteredAxis(Raw, M.Calibration);
+		}
+
+		FMemory::Memcpy(DeviceSticks, Sticks, sizeof(DeviceSticks));
+
+		const float Dt = (LastDeviceStickTime > 0.0) ? (float)(Sample.TimeSeconds - LastDeviceStickTime) : 0.f;
+		LastDeviceStickTime = Sample.TimeSeconds;
+		FilterSticks(Sticks, Dt);
+	}
+}
+
+void UControllerAxisAggregatorComponent::PushLogicalSticks(const float (&Sticks)[RcChannel::Num], float DeltaSeconds)
+{
+	if (HasDeviceSticks())
+	{
+		return;
+	}
+	FilterSticks(Sticks, DeltaSeconds);
+}
+
+bool UControllerAxisAggregatorComponent::HasDeviceSticks() const
+{
+	return bHasLogicalMapping && (FPlatformTime::Seconds() - LastDeviceStickTime) < DeviceSticksTimeout;
+}
+
+void UControllerAxisAggregatorComponent::FilterSticks(const float (&Sticks)[RcChannel::Num], float DeltaSeconds)
+{
+	const bool bGap = DeltaSeconds <= 0.f || DeltaSeconds > MaxRcSampleGap;
+
+	// Coefficients follow the measured input rate (500 Hz radio, 60 Hz frames, ...)
+	if (!bGap)
+	{
+		AvgStickInterval = (AvgStickInterval > 0.f)
+			? AvgStickInterval + 0.05f * (DeltaSeconds - AvgStickInterval)
+			: DeltaSeconds;
+
+		const float Rate = 1.f / AvgStickInterval;
+		const float ConfiguredRate = RcFilter.GetSampleRate();
+		if (!RcFilter.IsConfigured() || FMath::Abs(Rate - ConfiguredRate) > 0.1f * ConfiguredRate)
+		{
+			ConfigureRcFilter(Rate);
+		}
+	}
+
+	if (bGap || !bRcFilterPrimed)
+	{
+		if (!RcFilter.IsConfigured())
+		{
+			ConfigureRcFilter(250.f);
+		}
+
+		RcFilter.Reset(Sticks);
+		bRcFilterPrimed = true;
+
+		for (int32 Ch = 0; Ch < RcChannel::Num; ++Ch)
+		{
+			FilteredSticks.Setpoint[Ch] = Sticks[Ch];
+			FilteredSticks.Feedforward[Ch] = 0.f;
+		}
+		return;
+	}
+
+	RcFilter.Process(Sticks, FilteredSticks.Setpoint, FilteredSticks.Feedforward);
+}
+
+void UControllerAxisAggregatorComponent::ConfigureRcFilter(float SampleRateHz)
+{
+	FRcAxisFilterSettings Settings[RcChannel::Num];
+	GetRcFilterSettings(Settings);
+	RcFilter.Configure(Settings, SampleRateHz);
+}
+
+void UControllerAxisAggregatorComponent::GetRcFilterSettings(FRcAxisFilterSettings (&OutSettings)[RcChannel::Num]) const
+{
+	OutSettings[RcChannel::Roll] = RollFilter;
+	OutSettings[RcChannel::Pitch] = PitchFilter;
+	OutSettings[RcChannel::Yaw] = YawFilter;
+	OutSettings[RcChannel::Throttle] = ThrottleFilter;
+}
+
+void UControllerAxisAggregatorComponent::ApplyRcFilterSettings()
+{
+	if (RcFilter.IsConfigured())
+	{
+		ConfigureRcFilter(RcFilter.GetSampleRate());
+	}
+}
+
+void UControllerAxisAggregatorComponent::CacheLogicalMappings()
+{
+	bHasLogicalMapping = true;
+	for (int32 Ch = 0; Ch < RcChannel::Num; ++Ch)
+	{
+		LogicalMappingIndex[Ch] = ActiveCalibration.Mappings.IndexOfByPredicate(
+			[Ch](const FAxisMapping& M) { return M.LogicalName == RcChannelNames[Ch] && M.AxisIndex != INDEX_NONE; });
+
+		bHasLogicalMapping &= (LogicalMappingIndex[Ch] != INDEX_NONE);
+	}
+}
+
 void UControllerAxisAggregatorComponent::BindAxisMappings(UInputComponent* InputComponent)
 {
 	if (!InputComponent)
@@ -156,6 +302,39 @@ void UControllerAxisAggregatorComponent::ToggleCalibration()
 	}
 }
 
+void UControllerAxisAggregatorComponent::ApplyCalibrationProfile(const FControllerCalibrationProfile& Profile)
+{
+	if (DeviceId.IsEmpty())
+	{
+		DeviceId = Profile.GetDeviceId();
+	}
+
+	ActiveCalibration = Profile.Calibration;
+	ActiveCalibration.DeviceId = DeviceId;
+
+	EnsureAxesSize();
+	const int32 Count = FMath::Min(AxisCalibs.Num(), Profile.AxisCalibrations.Num());
+	for (int32 i = 0; i < Count; ++i)
+	{
+		AxisCalibs[i] = Profile.AxisCalibrations[i];
+	}
+
+	bHasAppliedProfile = true;
+	CacheLogicalMappings();
+
+	UE_LOG(LogTemp, Log, TEXT("AxisAggregator: Applied calibration profile for %s (%d mappings, %d axes)"),
+		*DeviceId, ActiveCalibration.Mappings.Num(), Count);
+}
+
+FControllerCalibrationProfile UControllerAxisAggregatorComponent::MakeCalibrationProfile() const
+{
+	FControllerCalibrationProfile Profile;
+	Profile.Calibration = ActiveCalibration;
+	Profile.Calibration.DeviceId = DeviceId;
+	Profile.AxisCalibrations = AxisCalibs;
+	return Profile;
+}
+
 void UControllerAxisAggregatorComponent::SetAxisValue(int32 Index0, float v)
 {
 	if (!Axes.IsValidIndex(Index0))
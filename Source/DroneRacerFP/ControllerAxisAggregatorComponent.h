@@ -3,8 +3,20 @@
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
 #include "ControllerCalibration.h" // FControllerRawState, FAxisCalibration
+#include "ControllerSampleRing.h"
+#include "RcFilterChain.h"
 #include "ControllerAxisAggregatorComponent.generated.h"
 
+/** Logical sticks after RC smoothing. Roll/Pitch/Yaw -1..1 (+ = stick up/right), Throttle 0..1. */
+struct FRcStickState
+{
+	float Setpoint[RcChannel::Num] = {};
+	float Feedforward[RcChannel::Num] = {};
+
+	/** Setpoint with the feedforward lead applied: what a direct-rate controller should follow. */
+	float GetCommand(RcChannel::Type Channel) const { return Setpoint[Channel] + Feedforward[Channel]; }
+};
+
 UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
 class DRONERACERFP_API UControllerAxisAggregatorComponent : public UActorComponent
 {
@@ -25,6 +37,19 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "AxisAggregator")
 	bool GetRawState(FControllerRawState& OutState) const;
 
+	/**
+	 * Feed one complete device report (all axes, in raw order). Call this from the
+	 * HID layer for every report so consumers see the full device rate rather than
+	 * the once-per-frame BindAxis updates.
+	 */
+	void PushDeviceSample(TArrayView<const float> Values);
+
+	/**
+	 * Every sample pushed through PushDeviceSample, timestamped. Null until the first
+	 * report arrives (backends that only use BindAxis never create it).
+	 */
+	const FControllerSampleRing* GetSampleRing() const { return SampleRing.Get(); }
+
 	/**
 	 * Bind axis mappings on a classic UInputComponent (BindAxis).
 	 * Uses AxisMappingNames if provided, otherwise defaults to RawAxis1..RawAxisN.
@@ -53,6 +78,45 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Calibration")
 	const TArray<FAxisCalibration>& GetAxisCalibrations() const { return AxisCalibs; }
 
+	/** Logical mapping (Pitch/Roll/Yaw/Throttle -> raw axis) last applied from the calibration widget or store. */
+	UFUNCTION(BlueprintPure, Category = "Calibration")
+	const FControllerCalibration& GetActiveCalibration() const { return ActiveCalibration; }
+
+	/** Replace per-axis calibration and logical mapping with a stored profile. */
+	UFUNCTION(BlueprintCallable, Category = "Calibration")
+	void ApplyCalibrationProfile(const FControllerCalibrationProfile& Profile);
+
+	/** Snapshot of the current calibration, ready to hand to UControllerCalibrationStore. */
+	UFUNCTION(BlueprintCallable, Category = "Calibration")
+	FControllerCalibrationProfile MakeCalibrationProfile() const;
+
+	UFUNCTION(BlueprintPure, Category = "Calibration")
+	bool HasAppliedProfile() const { return bHasAppliedProfile; }
+
+	// ---------------- RC smoothing ----------------
+
+	/**
+	 * Feed logical sticks from a frame-rate source (Enhanced Input), same convention as
+	 * FRcStickState. Ignored while a calibrated device is streaming reports.
+	 */
+	void PushLogicalSticks(const float (&Sticks)[RcChannel::Num], float DeltaSeconds);
+
+	/** True while device reports are mapped through the active calibration and filtered at report rate. */
+	bool HasDeviceSticks() const;
+
+	/** Latest output of the RC filter chain. */
+	const FRcStickState& GetFilteredSticks() const { return FilteredSticks; }
+
+	/** Latest calibrated device sticks before smoothing (FRcStickState convention). Valid while HasDeviceSticks(). */
+	void GetDeviceSticks(float (&OutSticks)[RcChannel::Num]) const { FMemory::Memcpy(OutSticks, DeviceSticks, sizeof(DeviceSticks)); }
+
+	/** Per-channel smoothing settings in RcChannel order. */
+	void GetRcFilterSettings(FRcAxisFilterSettings (&OutSettings)[RcChannel::Num]) const;
+
+	/** Recompute filter coefficients after changing the RcSmoothing settings at runtime. */
+	UFUNCTION(BlueprintCallable, Category = "RcSmoothing")
+	void ApplyRcFilterSettings();
+
 public:
 	/** Device id string you can set upstream (or leave empty). */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AxisAggregator")
@@ -85,6 +149,19 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Calibration", meta = (ClampMin = "0.0", ClampMax = "1.0"))
 	float CenterLerpAlpha = 0.02f;
 
+	/** Per-channel stick smoothing, run once per input sample (device reports or frames). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RcSmoothing")
+	FRcAxisFilterSettings RollFilter;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RcSmoothing")
+	FRcAxisFilterSettings PitchFilter;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RcSmoothing")
+	FRcAxisFilterSettings YawFilter;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RcSmoothing")
+	FRcAxisFilterSettings ThrottleFilter;
+
 protected:
 	void SetAxisValue(int32 Index0, float v);
 
@@ -112,4 +189,28 @@ private:
 	/** One per axis index (size == NumAxes). */
 	UPROPERTY(VisibleAnywhere, Category = "Calibration")
 	TArray<FAxisCalibration> AxisCalibs;
+
+	UPROPERTY(VisibleAnywhere, Category = "Calibration")
+	FControllerCalibration ActiveCalibration;
+
+	bool bHasAppliedProfile = false;
+
+	TUniquePtr<FControllerSampleRing> SampleRing;
+
+	void CacheLogicalMappings();
+	void FilterSticks(const float (&Sticks)[RcChannel::Num], float DeltaSeconds);
+	void ConfigureRcFilter(float SampleRateHz);
+
+	/** Index into ActiveCalibration.Mappings per RC channel (INDEX_NONE if unmapped). */
+	int32 LogicalMappingIndex[RcChannel::Num] = { INDEX_NONE, INDEX_NONE, INDEX_NONE, INDEX_NONE };
+	bool bHasLogicalMapping = false;
+
+	FRcFilterBank RcFilter;
+	FRcStickState FilteredSticks;
+	float DeviceSticks[RcChannel::Num] = {};
+	bool bRcFilterPrimed = false;
+
+	/** Smoothed interval between filter samples; coefficients follow it. */
+	float AvgStickInterval = 0.f;
+	double LastDeviceStickTime = 0.0;
 };
@@ -0,0 +1,259 @@
+// ControllerCalibration.cpp
+
+#include "ControllerCalibration.h"
+
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+// -------- Binary profile format --------
+//
+// uint32  Magic ('DCAL')
+// uint16  Version
+// FString DeviceId
+// uint8   NumMappings, then per mapping: FString LogicalName, int8 AxisIndex, <axis>
+// uint8   NumAxes, then per raw axis: <axis>
+//
+// <axis> = float RawMin, float RawCenter, float RawMax, float DeadZone, uint8 Flags (bit0 = invert)
+//
+// Bump CalibrationProfileVersion when the layout changes and keep the reader
+// accepting older versions.
+
+namespace
+{
+	constexpr uint32 CalibrationProfileMagic = 0x4C414344; // "DCAL"
+	constexpr uint16 CalibrationProfileVersion = 1;
+
+	constexpr uint8 AxisFlag_Invert = 1 << 0;
+
+	void SerializeAxisCalibration(FArchive& Ar, FAxisCalibration& C)
+	{
+		Ar << C.RawMin;
+		Ar << C.RawCenter;
+		Ar << C.RawMax;
+		Ar << C.DeadZone;
+
+		uint8 Flags = C.bInvert ? AxisFlag_Invert : 0;
+		Ar << Flags;
+		C.bInvert = (Flags & AxisFlag_Invert) != 0;
+	}
+}
+
+void WriteCalibrationProfile(const FControllerCalibrationProfile& Profile, TArray<uint8>& OutBytes)
+{
+	OutBytes.Reset();
+	FMemoryWriter Ar(OutBytes);
+
+	uint32 Magic = CalibrationProfileMagic;
+	uint16 Version = CalibrationProfileVersion;
+	Ar << Magic;
+	Ar << Version;
+
+	FString DeviceId = Profile.Calibration.DeviceId;
+	Ar << DeviceId;
+
+	const int32 NumMappings = FMath::Min(Profile.Calibration.Mappings.Num(), (int32)MAX_uint8);
+	uint8 NumMappings8 = (uint8)NumMappings;
+	Ar << NumMappings8;
+
+	for (int32 i = 0; i < NumMappings; ++i)
+	{
+		FAxisMapping M = Profile.Calibration.Mappings[i];
+
+		FString LogicalName = M.LogicalName.ToString();
+		int8 AxisIndex = (int8)FMath::Clamp(M.AxisIndex, (int32)INDEX_NONE, (int32)MAX_int8);
+		Ar << LogicalName;
+		Ar << AxisIndex;
+		SerializeAxisCalibration(Ar, M.Calibration);
+	}
+
+	const int32 NumAxes = FMath::Min(Profile.AxisCalibrations.Num(), (int32)MAX_uint8);
+	uint8 NumAxes8 = (uint8)NumAxes;
+	Ar << NumAxes8;
+
+	for (int32 i = 0; i < NumAxes; ++i)
+	{
+		FAxisCalibration C = Profile.AxisCalibrations[i];
+		SerializeAxisCalibration(Ar, C);
+	}
+}
+
+bool ReadCalibrationProfile(const TArray<uint8>& Bytes, FControllerCalibrationProfile& OutProfile)
+{
+	FMemoryReader Ar(Bytes);
+
+	uint32 Magic = 0;
+	uint16 Version = 0;
+	Ar << Magic;
+	Ar << Version;
+
+	if (Ar.IsError() || Magic != CalibrationProfileMagic)
+	{
+		return false;
+	}
+
+	if (Version == 0 || Version > CalibrationProfileVersion)
+	{
+		return false;
+	}
+
+	FControllerCalibrationProfile Profile;
+	Ar << Profile.Calibration.DeviceId;
+
+	uint8 NumMappings = 0;
+	Ar << NumMappings;
+	Profile.Calibration.Mappings.Reserve(NumMappings);
+
+	for (int32 i = 0; i < NumMappings && !Ar.IsError(); ++i)
+	{
+		FString LogicalName;
+		int8 AxisIndex = INDEX_NONE;
+		Ar << LogicalName;
+		Ar << AxisIndex;
+
+		FAxisMapping& M = Profile.Calibration.Mappings.AddDefaulted_GetRef();
+		M.LogicalName = FName(*LogicalName);
+		M.AxisIndex = AxisIndex;
+		SerializeAxisCalibration(Ar, M.Calibration);
+	}
+
+	uint8 NumAxes = 0;
+	Ar << NumAxes;
+	Profile.AxisCalibrations.SetNum(NumAxes);
+
+	for (int32 i = 0; i < NumAxes && !Ar.IsError(); ++i)
+	{
+		SerializeAxisCalibration(Ar, Profile.AxisCalibrations[i]);
+	}
+
+	if (Ar.IsError())
+	{
+		return false;
+	}
+
+	OutProfile = MoveTemp(Profile);
+	return true;
+}
+
+// -------- Axis identification --------
+
+void CorrelateAxesWithReference(TArrayView<const float> Series, int32 Stride,
+	TArrayView<const float> Reference, int32 MaxLagSamples, int32 LagStep, TArrayView<FAxisCorrelation> OutResults)
+{
+	constexpr int32 MaxGroups = MaxControllerAxes / 4;
+
+	check(Stride > 0 && Stride % 4 == 0 && Stride <= MaxControllerAxes);
+	check(OutResults.Num() >= Stride);
+
+	const int32 NumSamples = Reference.Num();
+	check(Series.Num() >= NumSamples * Stride);
+
+	for (FAxisCorrelation& Result : OutResults)
+	{
+		Result = FAxisCorrelation();
+	}
+
+	if (NumSamples < 2)
+	{
+		return;
+	}
+
+	const int32 NumGroups = Stride / 4;
+	LagStep = FMath::Max(1, LagStep);
+	MaxLagSamples = FMath::Clamp(MaxLagSamples, 0, NumSamples - 2);
+
+	VectorRegister4Float BestAbsR[MaxGroups];
+	VectorRegister4Float BestGain[MaxGroups];
+	VectorRegister4Float BestLag[MaxGroups];
+	for (int32 G = 0; G < NumGroups; ++G)
+	{
+		BestAbsR[G] = VectorZeroFloat();
+		BestGain[G] = VectorZeroFloat();
+		BestLag[G] = VectorZeroFloat();
+	}
+
+	const float* Ref = Reference.GetData();
+
+	for (int32 Lag = 0; Lag <= MaxLagSamples; Lag += LagStep)
+	{
+		// Reference sample i lines up with axis sample i + Lag
+		const int32 N = NumSamples - Lag;
+
+		float SumR = 0.f;
+		float SumRR = 0.f;
+		for (int32 i = 0; i < N; ++i)
+		{
+			SumR += Ref[i];
+			SumRR += Ref[i] * Ref[i];
+		}
+
+		const float InvN = 1.f / N;
+		const float MeanR = SumR * InvN;
+		const float VarR = SumRR * InvN - MeanR * MeanR;
+		if (VarR <= KINDA_SMALL_NUMBER)
+		{
+			continue; // the prompt didn't change inside this window
+		}
+
+		VectorRegister4Float SumX[MaxGroups];
+		VectorRegister4Float SumXX[MaxGroups];
+		VectorRegister4Float SumXR[MaxGroups];
+		for (int32 G = 0; G < NumGroups; ++G)
+		{
+			SumX[G] = VectorZeroFloat();
+			SumXX[G] = VectorZeroFloat();
+			SumXR[G] = VectorZeroFloat();
+		}
+
+		// One pass over the recording; each sample is a single cache line at 16 axes
+		const float* X = Series.GetData() + Lag * Stride;
+		for (int32 i = 0; i < N; ++i, X += Stride)
+		{
+			const VectorRegister4Float R = VectorSetFloat1(Ref[i]);
+			for (int32 G = 0; G < NumGroups; ++G)
+			{
+				const VectorRegister4Float V = VectorLoad(X + G * 4);
+				SumX[G] = VectorAdd(SumX[G], V);
+				SumXX[G] = VectorMultiplyAdd(V, V, SumXX[G]);
+				SumXR[G] = VectorMultiplyAdd(V, R, SumXR[G]);
+			}
+		}
+
+		const VectorRegister4Float VInvN = VectorSetFloat1(InvN);
+		const VectorRegister4Float VMeanR = VectorSetFloat1(MeanR);
+		const VectorRegister4Float VVarR = VectorSetFloat1(VarR);
+		const VectorRegister4Float VLag = VectorSetFloat1((float)Lag);
+		const VectorRegister4Float Tiny = VectorSetFloat1(SMALL_NUMBER);
+
+		for (int32 G = 0; G < NumGroups; ++G)
+		{
+			const VectorRegister4Float MeanX = VectorMultiply(SumX[G], VInvN);
+			const VectorRegister4Float VarX = VectorSubtract(VectorMultiply(SumXX[G], VInvN), VectorMultiply(MeanX, MeanX));
+			const VectorRegister4Float Cov = VectorSubtract(VectorMultiply(SumXR[G], VInvN), VectorMultiply(MeanX, VMeanR));
+
+			const VectorRegister4Float Gain = VectorDivide(Cov, VVarR);
+			const VectorRegister4Float R = VectorDivide(Cov, VectorSqrt(VectorMax(VectorMultiply(VarX, VVarR), Tiny)));
+			const VectorRegister4Float AbsR = VectorAbs(R);
+
+			const VectorRegister4Float Better = VectorCompareGT(AbsR, BestAbsR[G]);
+			BestAbsR[G] = VectorSelect(Better, AbsR, BestAbsR[G]);
+			BestGain[G] = VectorSelect(Better, Gain, BestGain[G]);
+			BestLag[G] = VectorSelect(Better, VLag, BestLag[G]);
+		}
+	}
+
+	for (int32 G = 0; G < NumGroups; ++G)
+	{
+		float AbsR[4], Gain[4], Lag[4];
+		VectorStore(BestAbsR[G], AbsR);
+		VectorStore(BestGain[G], Gain);
+		VectorStore(BestLag[G], Lag);
+
+		for (int32 Lane = 0; Lane < 4; ++Lane)
+		{
+			FAxisCorrelation& Result = OutResults[G * 4 + Lane];
+			Result.Gain = Gain[Lane];
+			Result.Correlation = FMath::Min(AbsR[Lane], 1.f) * FMath::Sign(Gain[Lane]);
+			Result.LagSamples = (int32)Lag[Lane];
+		}
+	}
+}
@@ -5,6 +5,9 @@
 #include "CoreMinimal.h"
 #include "ControllerCalibration.generated.h"
 
+/** Highest axis count any backend reports (the aggregator clamps to this too). */
+static constexpr int32 MaxControllerAxes = 16;
+
 // Raw state coming from your input backend (GenericUSBController, Raw Input, etc.)
 USTRUCT(BlueprintType)
 struct FControllerRawState
@@ -115,6 +118,97 @@ struct FControllerCalibration
 	}
 };
 
+// Everything we persist for one device: the logical mapping plus the
+// per-physical-axis calibration the aggregator captured (index == raw axis).
+USTRUCT(BlueprintType)
+struct FControllerCalibrationProfile
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FControllerCalibration Calibration;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	TArray<FAxisCalibration> AxisCalibrations;
+
+	const FString& GetDeviceId() const { return Calibration.DeviceId; }
+};
+
+// -------- Binary profile format (see ControllerCalibration.cpp) --------
+
+// Writes Profile in the compact versioned binary format.
+DRONERACERFP_API void WriteCalibrationProfile(const FControllerCalibrationProfile& Profile, TArray<uint8>& OutBytes);
+
+// Reads a profile written by any version <= the current one. Returns false on bad magic,
+// unknown version or truncated data.
+DRONERACERFP_API bool ReadCalibrationProfile(const TArray<uint8>& Bytes, FControllerCalibrationProfile& OutProfile);
+
+// Streaming mean / variance of one raw axis (Welford). Numerically stable for
+// thousands of samples, O(1) per sample, no history kept.
+struct FAxisNoiseStats
+{
+	int32 Count = 0;
+	double Mean = 0.0;
+	double M2 = 0.0;
+
+	void Reset()
+	{
+		Count = 0;
+		Mean = 0.0;
+		M2 = 0.0;
+	}
+
+	void Add(float Value)
+	{
+		++Count;
+		const double Delta = (double)Value - Mean;
+		Mean += Delta / Count;
+		M2 += Delta * ((double)Value - Mean);
+	}
+
+	double GetVariance() const { return (Count > 1) ? M2 / (Count - 1) : 0.0; }
+	float GetStdDev() const { return (float)FMath::Sqrt(GetVariance()); }
+};
+
+// Deadzone (in normalized units) that hides SigmaMultiplier standard deviations of
+// measured jitter. HalfRange is the raw distance that maps to 1.0 (center->end for
+// sticks, full travel for throttle).
+static inline float ComputeNoiseFloorDeadZone(const FAxisNoiseStats& Stats, float HalfRange,
+	float SigmaMultiplier, float MinDeadZone, float MaxDeadZone)
+{
+	if (Stats.Count < 2 || HalfRange <= KINDA_SMALL_NUMBER)
+	{
+		return MaxDeadZone;
+	}
+
+	const float DeadZone = SigmaMultiplier * Stats.GetStdDev() / HalfRange;
+	return FMath::Clamp(DeadZone, MinDeadZone, MaxDeadZone);
+}
+
+// Fit of one raw axis against a prompted reference signal (see CorrelateAxesWithReference).
+struct FAxisCorrelation
+{
+	// Raw units per reference unit; the sign says which way the axis runs
+	float Gain = 0.f;
+
+	// Pearson correlation with the reference, -1..1
+	float Correlation = 0.f;
+
+	// Delay (in samples) of the axis behind the reference that gave the best fit
+	int32 LagSamples = 0;
+};
+
+// Correlates every axis of an interleaved recording against one reference signal.
+//
+// Series holds Reference.Num() samples of Stride floats each ([sample][axis], Stride a
+// multiple of 4 and <= MaxControllerAxes, padding lanes zero). For every lag in
+// [0, MaxLagSamples] (stepping LagStep) the axis is compared with the reference shifted
+// by that many samples, which absorbs the user's reaction time. OutResults[Axis] gets the
+// lag with the strongest |Correlation| and the gain at that lag. All axes are processed
+// four at a time in SIMD registers.
+DRONERACERFP_API void CorrelateAxesWithReference(TArrayView<const float> Series, int32 Stride,
+	TArrayView<const float> Reference, int32 MaxLagSamples, int32 LagStep, TArrayView<FAxisCorrelation> OutResults);
+
 // -------- Normalization helpers (from raw -> normalized) --------
 
 // For centered axes: -1..+1 (pitch, roll, yaw)
@@ -0,0 +1,226 @@
+// ControllerCalibrationStore.cpp
+
+#include "ControllerCalibrationStore.h"
+
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "JsonObjectConverter.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY(LogDroneCalibration);
+
+static const TCHAR* CalibrationProfileExtension = TEXT(".dcal");
+
+void UControllerCalibrationStore::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Preload every profile we know about; they are tiny and this keeps the
+	// first flight frame from waiting on disk.
+	TArray<FString> Files;
+	IFileManager::Get().FindFiles(Files, *(GetCalibrationDir() / TEXT("*") + CalibrationProfileExtension), true, false);
+
+	FDateTime MostRecentTime = FDateTime::MinValue();
+	for (const FString& File : Files)
+	{
+		const FString Key = FPaths::GetBaseFilename(File);
+		StartLoad(Key);
+
+		const FDateTime Stamp = IFileManager::Get().GetTimeStamp(*(GetCalibrationDir() / File));
+		if (Stamp > MostRecentTime)
+		{
+			MostRecentTime = Stamp;
+			MostRecentFileKey = Key;
+		}
+	}
+
+	UE_LOG(LogDroneCalibration, Log, TEXT("CalibrationStore: preloading %d profile(s) from %s"),
+		Files.Num(), *GetCalibrationDir());
+}
+
+void UControllerCalibrationStore::Deinitialize()
+{
+	for (TPair<FString, TFuture<FLoadResult>>& It : PendingLoads)
+	{
+		It.Value.Wait();
+	}
+	PendingLoads.Empty();
+	Profiles.Empty();
+
+	Super::Deinitialize();
+}
+
+FString UControllerCalibrationStore::GetCalibrationDir()
+{
+	return FPaths::ProjectSavedDir() / TEXT("Calibration");
+}
+
+FString UControllerCalibrationStore::MakeFileKey(const FString& DeviceId)
+{
+	return FPaths::MakeValidFileName(DeviceId, TEXT('_'));
+}
+
+FString UControllerCalibrationStore::GetProfilePath(const FString& DeviceId)
+{
+	return GetCalibrationDir() / MakeFileKey(DeviceId) + CalibrationProfileExtension;
+}
+
+bool UControllerCalibrationStore::SaveProfile(const FControllerCalibrationProfile& Profile)
+{
+	const FString& DeviceId = Profile.GetDeviceId();
+	if (DeviceId.IsEmpty())
+	{
+		UE_LOG(LogDroneCalibration, Warning, TEXT("CalibrationStore: refusing to save a profile without a DeviceId"));
+		return false;
+	}
+
+	const FString Key = MakeFileKey(DeviceId);
+
+	// A newer profile supersedes anything still being read from disk.
+	if (TFuture<FLoadResult>* Pending = PendingLoads.Find(Key))
+	{
+		Pending->Wait();
+		PendingLoads.Remove(Key);
+	}
+	Profiles.Add(Key, Profile);
+	MostRecentFileKey = Key;
+
+	TArray<uint8> Bytes;
+	WriteCalibrationProfile(Profile, Bytes);
+
+	const FString Path = GetProfilePath(DeviceId);
+	if (!FFileHelper::SaveArrayToFile(Bytes, *Path))
+	{
+		UE_LOG(LogDroneCalibration, Error, TEXT("CalibrationStore: failed to write %s"), *Path);
+		return false;
+	}
+
+	ExportProfileAsJson(Profile, FPaths::ChangeExtension(Path, TEXT(".json")));
+
+	UE_LOG(LogDroneCalibration, Log, TEXT("CalibrationStore: saved %s (%d bytes, %d mappings, %d axes)"),
+		*DeviceId, Bytes.Num(), Profile.Calibration.Mappings.Num(), Profile.AxisCalibrations.Num());
+	return true;
+}
+
+void UControllerCalibrationStore::RequestLoad(const FString& DeviceId)
+{
+	if (DeviceId.IsEmpty())
+	{
+		return;
+	}
+
+	const FString Key = MakeFileKey(DeviceId);
+	if (Profiles.Contains(Key) || PendingLoads.Contains(Key))
+	{
+		return;
+	}
+
+	StartLoad(Key);
+}
+
+bool UControllerCalibrationStore::TryGetProfile(const FString& DeviceId, FControllerCalibrationProfile& OutProfile, bool bWaitForPending)
+{
+	return TryGetProfileByKey(MakeFileKey(DeviceId), OutProfile, bWaitForPending);
+}
+
+bool UControllerCalibrationStore::TryGetMostRecentProfile(FControllerCalibrationProfile& OutProfile, bool bWaitForPending)
+{
+	if (MostRecentFileKey.IsEmpty())
+	{
+		return false;
+	}
+	return TryGetProfileByKey(MostRecentFileKey, OutProfile, bWaitForPending);
+}
+
+bool UControllerCalibrationStore::TryGetProfileByKey(const FString& FileKey, FControllerCalibrationProfile& OutProfile, bool bWaitForPending)
+{
+	if (bWaitForPending)
+	{
+		if (TFuture<FLoadResult>* Pending = PendingLoads.Find(FileKey))
+		{
+			CompleteLoad(FileKey, Pending->Get());
+		}
+	}
+
+	if (const FControllerCalibrationProfile* Found = Profiles.Find(FileKey))
+	{
+		OutProfile = *Found;
+		return true;
+	}
+	return false;
+}
+
+bool UControllerCalibrationStore::ExportProfileAsJson(const FControllerCalibrationProfile& Profile, const FString& FilePath) const
+{
+	FString Json;
+	if (!FJsonObjectConverter::UStructToJsonObjectString(Profile, Json))
+	{
+		return false;
+	}
+	return FFileHelper::SaveStringToFile(Json, *FilePath);
+}
+
+void UControllerCalibrationStore::StartLoad(const FString& FileKey)
+{
+	const FString Path = GetCalibrationDir() / FileKey + CalibrationProfileExtension;
+	TWeakObjectPtr<UControllerCalibrationStore> WeakThis(this);
+
+	PendingLoads.Add(FileKey, Async(EAsyncExecution::ThreadPool, [Path, FileKey, WeakThis]()
+		{
+			FLoadResult Result = LoadFromFile(Path);
+
+			// Hand the result to the game thread; TryGetProfile may have beaten us to it.
+			AsyncTask(ENamedThreads::GameThread, [FileKey, WeakThis, Result]()
+				{
+					if (UControllerCalibrationStore* Store = WeakThis.Get())
+					{
+						Store->CompleteLoad(FileKey, Result);
+					}
+				});
+
+			return Result;
+		}));
+}
+
+void UControllerCalibrationStore::CompleteLoad(const FString& FileKey, const FLoadResult& Result)
+{
+	if (!PendingLoads.Contains(FileKey))
+	{
+		return; // already completed (or superseded by a save)
+	}
+
+	// Result may live inside the pending future, so take what we need before removing it.
+	const bool bFound = Result.bFound;
+	const FString DeviceId = bFound ? Result.Profile.GetDeviceId() : FileKey;
+	if (bFound)
+	{
+		Profiles.Add(FileKey, Result.Profile);
+	}
+	PendingLoads.Remove(FileKey);
+
+	UE_LOG(LogDroneCalibration, Log, TEXT("CalibrationStore: load %s -> %s"),
+		*DeviceId, bFound ? TEXT("found") : TEXT("none"));
+
+	OnProfileLoaded.Broadcast(DeviceId, bFound);
+}
+
+UControllerCalibrationStore::FLoadResult UControllerCalibrationStore::LoadFromFile(const FString& FilePath)
+{
+	FLoadResult Result;
+
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *FilePath, FILEREAD_Silent))
+	{
+		return Result;
+	}
+
+	if (!ReadCalibrationProfile(Bytes, Result.Profile))
+	{
+		UE_LOG(LogDroneCalibration, Warning, TEXT("CalibrationStore: %s is not a valid profile, ignoring"), *FilePath);
+		return Result;
+	}
+
+	Result.bFound = true;
+	return Result;
+}
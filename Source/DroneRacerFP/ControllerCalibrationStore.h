@@ -0,0 +1,88 @@
+// ControllerCalibrationStore.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Async/Future.h"
+#include "ControllerCalibration.h"
+#include "ControllerCalibrationStore.generated.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogDroneCalibration, Log, All);
+
+/** Fired on the game thread when a profile finished loading (bFound=false if there was none on disk). */
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnCalibrationProfileLoaded, const FString& /*DeviceId*/, bool /*bFound*/);
+
+/**
+ * Calibration profiles keyed by device id.
+ *
+ * Profiles live in Saved/Calibration/<DeviceId>.dcal (compact binary, see ControllerCalibration.cpp)
+ * with a .json sidecar written next to each one for humans. Every profile on disk is read on a
+ * worker thread as soon as the game instance starts, so by the time a pawn asks for its device
+ * the data is normally already in memory; if not, TryGetProfile waits for that one small read.
+ */
+UCLASS()
+class DRONERACERFP_API UControllerCalibrationStore : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** Stores the profile in memory and writes it (plus the JSON export) to disk. */
+	UFUNCTION(BlueprintCallable, Category = "Calibration")
+	bool SaveProfile(const FControllerCalibrationProfile& Profile);
+
+	/** Starts an async load of DeviceId's profile if it isn't loaded or loading already. */
+	UFUNCTION(BlueprintCallable, Category = "Calibration")
+	void RequestLoad(const FString& DeviceId);
+
+	/**
+	 * Returns the profile for DeviceId. If a load for it is still in flight and bWaitForPending
+	 * is set, blocks until it completes (a few hundred bytes of file IO).
+	 */
+	bool TryGetProfile(const FString& DeviceId, FControllerCalibrationProfile& OutProfile, bool bWaitForPending = true);
+
+	UFUNCTION(BlueprintCallable, Category = "Calibration")
+	bool GetProfile(const FString& DeviceId, FControllerCalibrationProfile& OutProfile) { return TryGetProfile(DeviceId, OutProfile); }
+
+	/**
+	 * Profile of the most recently saved device. Lets a pawn apply calibration on its first
+	 * frame, before the HID layer has seen a report and told us which device is plugged in.
+	 */
+	bool TryGetMostRecentProfile(FControllerCalibrationProfile& OutProfile, bool bWaitForPending = true);
+
+	/** Writes a human-readable JSON copy of a profile. */
+	UFUNCTION(BlueprintCallable, Category = "Calibration")
+	bool ExportProfileAsJson(const FControllerCalibrationProfile& Profile, const FString& FilePath) const;
+
+	FOnCalibrationProfileLoaded OnProfileLoaded;
+
+	static FString GetCalibrationDir();
+	static FString GetProfilePath(const FString& DeviceId);
+
+private:
+	struct FLoadResult
+	{
+		bool bFound = false;
+		FControllerCalibrationProfile Profile;
+	};
+
+	void StartLoad(const FString& FileKey);
+	void CompleteLoad(const FString& FileKey, const FLoadResult& Result);
+
+	static FLoadResult LoadFromFile(const FString& FilePath);
+	static FString MakeFileKey(const FString& DeviceId);
+
+	bool TryGetProfileByKey(const FString& FileKey, FControllerCalibrationProfile& OutProfile, bool bWaitForPending);
+
+	/** Profiles that are in memory, by file key. Game thread only. */
+	TMap<FString, FControllerCalibrationProfile> Profiles;
+
+	/** Loads in flight, by file key. Game thread only. */
+	TMap<FString, TFuture<FLoadResult>> PendingLoads;
+
+	/** File key of the newest profile on disk (or last saved). */
+	FString MostRecentFileKey;
+};
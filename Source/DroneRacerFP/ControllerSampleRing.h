@@ -0,0 +1,112 @@
+// ControllerSampleRing.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ControllerCalibration.h" // MaxControllerAxes
+#include <atomic>
+
+/** One device report, fixed size so it can live in a ring without allocations. */
+struct FControllerAxisSample
+{
+	double TimeSeconds = 0.0;
+	int32 NumAxes = 0;
+	float Axes[MaxControllerAxes];
+
+	TArrayView<const float> GetAxes() const { return TArrayView<const float>(Axes, NumAxes); }
+};
+
+/**
+ * Single-producer / single-consumer ring of fixed-size samples.
+ *
+ * The producer writes in place (BeginPush/CommitPush) and the consumer reads the
+ * samples it hasn't seen yet as at most two contiguous views straight into the
+ * ring storage, so nothing is copied on either side. Each consumer keeps its own
+ * cursor. If a consumer falls more than Capacity samples behind, the oldest ones
+ * are reported as dropped and skipped.
+ */
+template <typename ElementType, uint32 Capacity>
+class TSampleRing
+{
+	static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+	/** Producer: slot for the next element. Fill it and call CommitPush. */
+	ElementType& BeginPush()
+	{
+		return Storage[Head.load(std::memory_order_relaxed) & Mask];
+	}
+
+	/** Producer: publish the slot returned by BeginPush. */
+	void CommitPush()
+	{
+		Head.store(Head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	void Push(const ElementType& Element)
+	{
+		BeginPush() = Element;
+		CommitPush();
+	}
+
+	/** Total number of elements ever pushed. A fresh consumer starts its cursor here. */
+	uint64 GetHead() const
+	{
+		return Head.load(std::memory_order_acquire);
+	}
+
+	/**
+	 * Consumer: views of every element pushed since Cursor, oldest first, and advance
+	 * Cursor past them. Returns the number of elements lost to overrun.
+	 */
+	uint64 Drain(uint64& Cursor, TArrayView<const ElementType>& OutFirst, TArrayView<const ElementType>& OutSecond) const
+	{
+		const uint64 End = GetHead();
+
+		uint64 Dropped = 0;
+		if (End - Cursor > Capacity)
+		{
+			Dropped = End - Cursor - Capacity;
+			Cursor = End - Capacity;
+		}
+
+		const uint32 Count = (uint32)(End - Cursor);
+		const uint32 Start = (uint32)(Cursor & Mask);
+		const uint32 FirstCount = FMath::Min(Count, Capacity - Start);
+
+		OutFirst = TArrayView<const ElementType>(Storage + Start, FirstCount);
+		OutSecond = TArrayView<const ElementType>(Storage, Count - FirstCount);
+
+		Cursor = End;
+		return Dropped;
+	}
+
+	/** Consumer convenience: visit every new element in order. */
+	template <typename FuncType>
+	uint64 ForEachSince(uint64& Cursor, FuncType&& Func) const
+	{
+		TArrayView<const ElementType> First, Second;
+		const uint64 Dropped = Drain(Cursor, First, Second);
+
+		for (const ElementType& E : First)
+		{
+			Func(E);
+		}
+		for (const ElementType& E : Second)
+		{
+			Func(E);
+		}
+		return Dropped;
+	}
+
+	static constexpr uint32 GetCapacity() { return Capacity; }
+
+private:
+	static constexpr uint64 Mask = Capacity - 1;
+
+	ElementType Storage[Capacity];
+	std::atomic<uint64> Head{ 0 };
+};
+
+/** Two seconds of 500 Hz reports; the calibration widget drains it every UI tick. */
+using FControllerSampleRing = TSampleRing<FControllerAxisSample, 1024>;
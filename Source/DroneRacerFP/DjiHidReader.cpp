@@ -1,6 +1,7 @@
 ﻿// DjiHidReader.cpp
 
 #include "DjiHidReader.h"
+#include "DroneLatency.h"
 
 #include "HAL/RunnableThread.h"
 #include "Misc/ScopeLock.h"
@@ -175,6 +176,8 @@ uint32 FDjiHidReader::Run()
 
 	TArray<uint8> Buffer;
 	Buffer.SetNumUninitialized(ReportLen);
+	// Latest report; reused so a read doesn't allocate
+	TArray<uint8> Report;
 
 	while (!bStopRequested)
 	{
@@ -337,11 +340,17 @@ uint32 FDjiHidReader::Run()
 
 		if (BytesRead > 0)
 		{
-			TArray<uint8> Copy;
-			Copy.Append(Buffer.GetData(), BytesRead);
+			// Only a report that differs from the last one can change what's on screen
+			if (Report.Num() != (int32)BytesRead || FMemory::Memcmp(Report.GetData(), Buffer.GetData(), BytesRead) != 0)
+			{
+				FDroneLatency::StampDeviceRead();
+				Report.SetNumUninitialized(BytesRead, EAllowShrinking::No);
+				FMemory::Memcpy(Report.GetData(), Buffer.GetData(), BytesRead);
+			}
+			const TArray<uint8>& Copy = Report;
 
-			// Debug: dump raw packet (you can change Warning -> Verbose later)
-			UE_LOG(LogDjiHid, Warning,
+			// Raw packet dump, off the hot path unless asked for (log LogDjiHid VeryVerbose)
+			UE_LOG(LogDjiHid, VeryVerbose,
 				TEXT("DJI: Report (%d bytes): %s"),
 				BytesRead,
 				*HexDump(Copy.GetData(), Copy.Num()));
@@ -381,7 +390,7 @@ uint32 FDjiHidReader::Run()
 					static int32 LogTick = 0;
 					if (++LogTick % 20 == 0)
 					{
-						UE_LOG(LogDjiHid, Warning, TEXT("REALIGN -> T: %.2f | Raw4: %u | A4: %u"),
+						UE_LOG(LogDjiHid, VeryVerbose, TEXT("REALIGN -> T: %.2f | Raw4: %u | A4: %u"),
 							Channels.Throttle01, RawCh4, ((uint16)Copy[7] | ((uint16)Copy[8] << 8)));
 					}
 				}
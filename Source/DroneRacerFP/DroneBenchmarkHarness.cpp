@@ -0,0 +1,360 @@
+// DroneBenchmarkHarness.cpp
+
+#include "DroneBenchmarkHarness.h"
+#include "DroneFPCharacter.h"
+#include "DroneFlightCollision.h"
+#include "DroneInputLog.h"
+#include "EngineUtils.h"
+#include "Dom/JsonObject.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+#include <atomic>
+
+DEFINE_LOG_CATEGORY_STATIC(LogDroneBenchmark, Log, All);
+
+namespace
+{
+	/**
+	 * Counts allocations on every thread by sitting in front of GMalloc for the length of a run.
+	 * Everything is forwarded, so blocks may be freed after it's gone; it's never deleted because
+	 * another thread can still be inside it when it's taken out.
+	 */
+	class FBenchmarkCountingMalloc final : public FMalloc
+	{
+	public:
+		explicit FBenchmarkCountingMalloc(FMalloc* InInner) : Inner(InInner) {}
+
+		FMalloc* GetInner() const { return Inner; }
+		uint64 GetNumAllocs() const { return NumAllocs.load(std::memory_order_relaxed); }
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override { Count1(); return Inner->Malloc(Count, Alignment); }
+		virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override { Count1(); return Inner->TryMalloc(Count, Alignment); }
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override { Count1(); return Inner->Realloc(Original, Count, Alignment); }
+		virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override { Count1(); return Inner->TryRealloc(Original, Count, Alignment); }
+		virtual void Free(void* Original) override { Inner->Free(Original); }
+
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual void UpdateStats() override { Inner->UpdateStats(); }
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+		virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+		virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+		virtual const TCHAR* GetDescriptiveName() override { return Inner->GetDescriptiveName(); }
+
+	private:
+		void Count1() { NumAllocs.fetch_add(1, std::memory_order_relaxed); }
+
+		FMalloc* Inner;
+		std::atomic<uint64> NumAllocs{ 0 };
+	};
+
+	struct FBenchmarkRun
+	{
+		FDroneBenchmarkSettings Settings;
+		TWeakObjectPtr<UWorld> World;
+		TWeakObjectPtr<ADroneFPCharacter> Drone;
+		FDroneInputLog Log;
+		FDroneFlightProfile Profile;
+		FBenchmarkCountingMalloc* CountingMalloc = nullptr;
+
+		int32 Lap = 0;
+		int32 Frame = 0;
+		uint64 FrameStartCycles = 0;
+		uint64 FrameStartAllocs = 0;
+		double StartSeconds = 0.0;
+
+		// Reserved up front so collecting them doesn't count
+		TArray<double> GameThreadMs;
+		TArray<uint32> Allocs;
+
+		FDelegateHandle BeginFrameHandle;
+		FDelegateHandle EndFrameHandle;
+	};
+
+	TUniquePtr<FBenchmarkRun> GBenchmarkRun;
+
+	ADroneFPCharacter* FindOrSpawnBenchmarkDrone(UWorld& World, const FDroneInputLog& Log)
+	{
+		TActorIterator<ADroneFPCharacter> Existing(&World);
+		ADroneFPCharacter* Drone = Existing ? *Existing : nullptr;
+
+		if (!Drone)
+		{
+			// The game mode's pawn has the Blueprint setup (meshes, input); the native class is the fallback
+			UClass* DroneClass = ADroneFPCharacter::StaticClass();
+			const AGameModeBase* GameMode = World.GetAuthGameMode();
+			if (GameMode && GameMode->DefaultPawnClass && GameMode->DefaultPawnClass->IsChildOf(ADroneFPCharacter::StaticClass()))
+			{
+				DroneClass = GameMode->DefaultPawnClass;
+			}
+
+			FActorSpawnParameters Params;
+			Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+			const FTransform Start(ToQuat(Log.InitialState.Rotation), ToVector(Log.InitialState.Position));
+			Drone = World.SpawnActor<ADroneFPCharacter>(DroneClass, Start, Params);
+		}
+
+		// Possessed, like in play: locally controlled code paths (camera, input) run too
+		APlayerController* PC = World.GetFirstPlayerController();
+		if (Drone && PC && PC->GetPawn() != Drone)
+		{
+			PC->Possess(Drone);
+		}
+		return Drone;
+	}
+
+	double BenchmarkPercentile(TArray<double> Values, double Fraction)
+	{
+		if (Values.Num() == 0)
+		{
+			return 0.0;
+		}
+		Values.Sort();
+		return Values[FMath::Min(FMath::FloorToInt32(Values.Num() * Fraction), Values.Num() - 1)];
+	}
+
+	void FinishBenchmark(bool bCompleted);
+
+	void OnBenchmarkBeginFrame()
+	{
+		FBenchmarkRun& Run = *GBenchmarkRun;
+		Run.FrameStartCycles = FPlatformTime::Cycles64();
+		Run.FrameStartAllocs = Run.CountingMalloc->GetNumAllocs();
+	}
+
+	void OnBenchmarkEndFrame()
+	{
+		FBenchmarkRun& Run = *GBenchmarkRun;
+		if (Run.FrameStartCycles == 0)
+		{
+			return; // started mid-frame
+		}
+
+		if (++Run.Frame > Run.Settings.WarmupFrames)
+		{
+			Run.GameThreadMs.Add(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - Run.FrameStartCycles));
+			Run.Allocs.Add((uint32)(Run.CountingMalloc->GetNumAllocs() - Run.FrameStartAllocs));
+		}
+
+		ADroneFPCharacter* Drone = Run.Drone.Get();
+		if (!Drone || !Run.World.IsValid())
+		{
+			UE_LOG(LogDroneBenchmark, Error, TEXT("The benchmark drone or world went away on lap %d"), Run.Lap + 1);
+			FinishBenchmark(false);
+			return;
+		}
+
+		if (!Drone->IsPlayingInputs())
+		{
+			if (++Run.Lap >= Run.Settings.Laps)
+			{
+				FinishBenchmark(true);
+				return;
+			}
+			Drone->StartInputPlayback(Run.Log);
+		}
+	}
+
+	void WriteBenchmarkReport(const FBenchmarkRun& Run, bool bCompleted)
+	{
+		const double WallSeconds = FPlatformTime::Seconds() - Run.StartSeconds;
+		const double SimSeconds = Run.Profile.Steps * (double)Run.Log.StepSeconds;
+
+		double GtSum = 0.0;
+		double GtMax = 0.0;
+		for (double Ms : Run.GameThreadMs)
+		{
+			GtSum += Ms;
+			GtMax = FMath::Max(GtMax, Ms);
+		}
+		uint64 AllocSum = 0;
+		uint32 AllocMax = 0;
+		for (uint32 Count : Run.Allocs)
+		{
+			AllocSum += Count;
+			AllocMax = FMath::Max(AllocMax, Count);
+		}
+		const int32 NumFrames = Run.GameThreadMs.Num();
+
+		TSharedRef<FJsonObject> GameThread = MakeShared<FJsonObject>();
+		GameThread->SetNumberField(TEXT("mean"), NumFrames > 0 ? GtSum / NumFrames : 0.0);
+		GameThread->SetNumberField(TEXT("p99"), BenchmarkPercentile(Run.GameThreadMs, 0.99));
+		GameThread->SetNumberField(TEXT("max"), GtMax);
+
+		TSharedRef<FJsonObject> AllocsPerFrame = MakeShared<FJsonObject>();
+		AllocsPerFrame->SetNumberField(TEXT("mean"), NumFrames > 0 ? (double)AllocSum / NumFrames : 0.0);
+		AllocsPerFrame->SetNumberField(TEXT("max"), AllocMax);
+
+		TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+		Root->SetBoolField(TEXT("completed"), bCompleted);
+		Root->SetStringField(TEXT("map"), Run.World.IsValid() ? Run.World->GetMapName() : FString());
+		Root->SetStringField(TEXT("input_log"), Run.Settings.InputLog);
+		Root->SetStringField(TEXT("build"), LexToString(FApp::GetBuildConfiguration()));
+		Root->SetNumberField(TEXT("laps"), FMath::Min(Run.Lap, Run.Settings.Laps));
+		Root->SetNumberField(TEXT("frames"), NumFrames);
+		Root->SetNumberField(TEXT("warmup_frames"), Run.Settings.WarmupFrames);
+		Root->SetNumberField(TEXT("wall_seconds"), WallSeconds);
+		Root->SetNumberField(TEXT("simulated_seconds"), SimSeconds);
+		Root->SetObjectField(TEXT("game_thread_ms"), GameThread);
+		Root->SetNumberField(TEXT("physics_steps"), (double)Run.Profile.Steps);
+		Root->SetNumberField(TEXT("physics_us_per_step"),
+			Run.Profile.Steps > 0 ? FPlatformTime::ToMilliseconds64(Run.Profile.StepCycles) * 1000.0 / Run.Profile.Steps : 0.0);
+		Root->SetNumberField(TEXT("sweeps_per_second"), SimSeconds > 0.0 ? Run.Profile.Sweeps / SimSeconds : 0.0);
+		Root->SetObjectField(TEXT("allocs_per_frame"), AllocsPerFrame);
+
+		FString Json;
+		const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+		FJsonSerializer::Serialize(Root, Writer);
+
+		const FString Path = Run.Settings.OutputPath.IsEmpty()
+			? FPaths::ProjectSavedDir() / TEXT("Benchmarks") / FPaths::MakeValidFileName(Run.Settings.InputLog, TEXT('_')) + TEXT(".json")
+			: Run.Settings.OutputPath;
+		const bool bSaved = FFileHelper::SaveStringToFile(Json, *Path);
+
+		UE_LOG(LogDroneBenchmark, Display, TEXT("Benchmark %s: %d frames, game thread %.2f / %.2f / %.2f ms (mean / p99 / max), %.2f us per step, %.1f allocs per frame -> %s%s"),
+			bCompleted ? TEXT("done") : TEXT("cut short"), NumFrames,
+			NumFrames > 0 ? GtSum / NumFrames : 0.0, BenchmarkPercentile(Run.GameThreadMs, 0.99), GtMax,
+			Run.Profile.Steps > 0 ? FPlatformTime::ToMilliseconds64(Run.Profile.StepCycles) * 1000.0 / Run.Profile.Steps : 0.0,
+			NumFrames > 0 ? (double)AllocSum / NumFrames : 0.0,
+			*Path, bSaved ? TEXT("") : TEXT(" (write failed)"));
+	}
+
+	void FinishBenchmark(bool bCompleted)
+	{
+		TUniquePtr<FBenchmarkRun> Run = MoveTemp(GBenchmarkRun);
+
+		FCoreDelegates::OnBeginFrame.Remove(Run->BeginFrameHandle);
+		FCoreDelegates::OnEndFrame.Remove(Run->EndFrameHandle);
+		GMalloc = Run->CountingMalloc->GetInner();
+
+		if (ADroneFPCharacter* Drone = Run->Drone.Get())
+		{
+			Drone->SetFlightProfile(nullptr);
+			Drone->StopInputPlayback();
+		}
+
+		WriteBenchmarkReport(*Run, bCompleted);
+
+		if (Run->Settings.bQuitWhenDone)
+		{
+			FPlatformMisc::RequestExitWithStatus(false, bCompleted ? 0 : 1);
+		}
+	}
+}
+
+bool FDroneBenchmarkHarness::IsRunning()
+{
+	return GBenchmarkRun.IsValid();
+}
+
+bool FDroneBenchmarkHarness::Start(UWorld* World, const FDroneBenchmarkSettings& Settings)
+{
+	auto Fail = [&Settings](const TCHAR* Why)
+	{
+		UE_LOG(LogDroneBenchmark, Error, TEXT("Benchmark not started: %s"), Why);
+		if (Settings.bQuitWhenDone)
+		{
+			FPlatformMisc::RequestExitWithStatus(false, 1);
+		}
+		return false;
+	};
+
+	if (GBenchmarkRun)
+	{
+		return Fail(TEXT("one is already running"));
+	}
+	if (!World)
+	{
+		return Fail(TEXT("no world"));
+	}
+
+	TUniquePtr<FBenchmarkRun> Run = MakeUnique<FBenchmarkRun>();
+	Run->Settings = Settings;
+	Run->Settings.Laps = FMath::Max(Settings.Laps, 1);
+	if (!Run->Log.LoadFromFile(Settings.InputLog))
+	{
+		return Fail(*FString::Printf(TEXT("can't read %s"), *FDroneInputLog::GetLogPath(Settings.InputLog)));
+	}
+
+	ADroneFPCharacter* Drone = FindOrSpawnBenchmarkDrone(*World, Run->Log);
+	if (!Drone || !Drone->StartInputPlayback(Run->Log))
+	{
+		return Fail(TEXT("no drone to fly the log"));
+	}
+	Drone->SetFlightProfile(&Run->Profile);
+
+	Run->World = World;
+	Run->Drone = Drone;
+	Run->StartSeconds = FPlatformTime::Seconds();
+
+	// Generous: a frame per physics step
+	const int32 ExpectedFrames = Run->Log.Checksums.Num() * Run->Settings.Laps + Run->Settings.WarmupFrames;
+	Run->GameThreadMs.Reserve(ExpectedFrames);
+	Run->Allocs.Reserve(ExpectedFrames);
+
+	Run->CountingMalloc = new FBenchmarkCountingMalloc(GMalloc);
+	GMalloc = Run->CountingMalloc;
+
+	Run->BeginFrameHandle = FCoreDelegates::OnBeginFrame.AddStatic(&OnBenchmarkBeginFrame);
+	Run->EndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&OnBenchmarkEndFrame);
+
+	UE_LOG(LogDroneBenchmark, Display, TEXT("Benchmark: %d laps of %s (%d steps each) in %s"),
+		Run->Settings.Laps, *Settings.InputLog, Run->Log.Checksums.Num(), *World->GetMapName());
+
+	GBenchmarkRun = MoveTemp(Run);
+	return true;
+}
+
+static void BenchmarkRunCommand(const TArray<FString>& Args, UWorld* World)
+{
+	if (Args.Num() < 1)
+	{
+		UE_LOG(LogDroneBenchmark, Display, TEXT("Usage: Drone.Bench.Run <InputLog> [Laps=3] [OutputJson] [Quit]"));
+		return;
+	}
+
+	FDroneBenchmarkSettings Settings;
+	Settings.InputLog = Args[0];
+
+	// The optional arguments can be left out independently: "Quit" is a flag wherever it is,
+	// the first number is the lap count, anything else is the output path
+	bool bHaveLaps = false;
+	for (int32 i = 1; i < Args.Num(); ++i)
+	{
+		if (Args[i].Equals(TEXT("Quit"), ESearchCase::IgnoreCase))
+		{
+			Settings.bQuitWhenDone = true;
+		}
+		else if (!bHaveLaps && Args[i].IsNumeric())
+		{
+			Settings.Laps = FCString::Atoi(*Args[i]);
+			bHaveLaps = true;
+		}
+		else if (Settings.OutputPath.IsEmpty())
+		{
+			Settings.OutputPath = Args[i];
+		}
+		else
+		{
+			UE_LOG(LogDroneBenchmark, Warning, TEXT("Drone.Bench.Run: ignoring argument '%s'"), *Args[i]);
+		}
+	}
+	FDroneBenchmarkHarness::Start(World, Settings);
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GBenchmarkRunCommand(
+	TEXT("Drone.Bench.Run"),
+	TEXT("Flies a recorded input log (Drone.Flight.RecordInputs) for N laps and writes frame, flight and allocation stats as JSON. Args: <InputLog> [Laps=3] [OutputJson=Saved/Benchmarks/<InputLog>.json] [Quit]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&BenchmarkRunCommand));
@@ -0,0 +1,39 @@
+// DroneBenchmarkHarness.h
+//
+// Nightly perf run of the full game loop: a recorded input log is flown for N laps by the player
+// drone and the frame / flight / allocation numbers are written as JSON. Runs headless:
+//
+//   UnrealEditor-Cmd <project> <Map> -game -nullrhi -unattended -nosound -benchmark -fps=120
+//     -ExecCmds="Drone.Bench.Run Lap1 5 /tmp/drone_bench.json Quit"
+//
+// -benchmark -fps=N gives every frame the same DeltaTime, so runs line up frame for frame.
+// Record the log with Drone.Flight.RecordInputs; it carries its start state.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Filled by ADroneFPCharacter while a profile is attached. */
+struct FDroneFlightProfile
+{
+	int64 Steps = 0;
+	uint64 StepCycles = 0;
+	int64 Sweeps = 0;
+};
+
+struct FDroneBenchmarkSettings
+{
+	FString InputLog;
+	int32 Laps = 3;
+	FString OutputPath;         // empty: Saved/Benchmarks/<InputLog>.json
+	bool bQuitWhenDone = false; // exit code 0 on success, 1 if the run couldn't start or was cut short
+	int32 WarmupFrames = 30;    // left out of the frame statistics
+};
+
+class DRONERACERFP_API FDroneBenchmarkHarness
+{
+public:
+	/** Starts a run in World; only one at a time. */
+	static bool Start(UWorld* World, const FDroneBenchmarkSettings& Settings);
+	static bool IsRunning();
+};
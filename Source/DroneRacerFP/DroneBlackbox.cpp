@@ -0,0 +1,550 @@
+// DroneBlackbox.cpp
+//
+// File format (little endian):
+//   header   FlightBlackboxHeaderBytes: "DBBX", uint16 version, uint16 reserved, float step seconds
+//   records  FFlightBlackboxEncoder output, back to back
+// The file is grown in MappedChunkBytes steps while recording and trimmed to size on close.
+
+#include "DroneBlackbox.h"
+#include "DroneFPCharacter.h"
+#include "EngineUtils.h"
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#if PLATFORM_WINDOWS
+#include "Windows/AllowWindowsPlatformTypes.h"
+#include <windows.h>
+#include "Windows/HideWindowsPlatformTypes.h"
+#elif PLATFORM_UNIX || PLATFORM_MAC
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+DEFINE_LOG_CATEGORY_STATIC(LogDroneBlackbox, Log, All);
+
+namespace
+{
+	constexpr int32 BlackboxBlockBytes = 64 * 1024;
+	constexpr int32 BlackboxNumBlocks = 32;             // 2 MB; a block goes out at least every submit interval,
+	                                                    // so the writer can stall for ~16 s before frames drop
+	constexpr int64 BlackboxMappedChunkBytes = 16 * 1024 * 1024;
+	constexpr float BlackboxSubmitIntervalSeconds = 0.5f;
+
+	/**
+	 * Append-only file written through a shared mapping; grows by remapping. Platforms without
+	 * a mapping path here fall back to a plain file handle, which the writer thread owns anyway.
+	 */
+	class FBlackboxMappedFile
+	{
+	public:
+		~FBlackboxMappedFile() { Close(); }
+
+		bool Open(const FString& Path)
+		{
+			IFileManager::Get().MakeDirectory(*FPaths::GetPath(Path), true);
+			const FString FullPath = FPaths::ConvertRelativePathToFull(Path);
+#if PLATFORM_WINDOWS
+			File = CreateFileW(*FullPath, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+			return File != INVALID_HANDLE_VALUE;
+#elif PLATFORM_UNIX || PLATFORM_MAC
+			Descriptor = open(TCHAR_TO_UTF8(*FullPath), O_RDWR | O_CREAT | O_TRUNC, 0644);
+			return Descriptor >= 0;
+#else
+			Handle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*FullPath));
+			return Handle.IsValid();
+#endif
+		}
+
+		bool Append(const uint8* Data, int64 Num)
+		{
+#if PLATFORM_WINDOWS || PLATFORM_UNIX || PLATFORM_MAC
+			if (Size + Num > Capacity && !Map(FMath::Max(Capacity + BlackboxMappedChunkBytes, Size + Num)))
+			{
+				return false;
+			}
+			FMemory::Memcpy(View + Size, Data, Num);
+			Size += Num;
+			return true;
+#else
+			Size += Num;
+			return Handle.IsValid() && Handle->Write(Data, Num);
+#endif
+		}
+
+		void Close()
+		{
+#if PLATFORM_WINDOWS
+			if (File != INVALID_HANDLE_VALUE)
+			{
+				Unmap();
+				LARGE_INTEGER End;
+				End.QuadPart = Size;
+				SetFilePointerEx(File, End, nullptr, FILE_BEGIN);
+				SetEndOfFile(File);
+				CloseHandle(File);
+				File = INVALID_HANDLE_VALUE;
+			}
+#elif PLATFORM_UNIX || PLATFORM_MAC
+			if (Descriptor >= 0)
+			{
+				Unmap();
+				if (ftruncate(Descriptor, (off_t)Size) != 0)
+				{
+					UE_LOG(LogDroneBlackbox, Warning, TEXT("Couldn't trim the blackbox file to %lld bytes"), Size);
+				}
+				close(Descriptor);
+				Descriptor = -1;
+			}
+#else
+			Handle.Reset();
+#endif
+		}
+
+		int64 GetSize() const { return Size; }
+
+	private:
+#if PLATFORM_WINDOWS
+		bool Map(int64 NewCapacity)
+		{
+			Unmap();
+			Mapping = CreateFileMappingW(File, nullptr, PAGE_READWRITE, (DWORD)(NewCapacity >> 32), (DWORD)NewCapacity, nullptr);
+			View = Mapping ? (uint8*)MapViewOfFile(Mapping, FILE_MAP_WRITE, 0, 0, (SIZE_T)NewCapacity) : nullptr;
+			Capacity = View ? NewCapacity : 0;
+			return View != nullptr;
+		}
+
+		void Unmap()
+		{
+			if (View)
+			{
+				UnmapViewOfFile(View);
+				View = nullptr;
+			}
+			if (Mapping)
+			{
+				CloseHandle(Mapping);
+				Mapping = nullptr;
+			}
+			Capacity = 0;
+		}
+
+		HANDLE File = INVALID_HANDLE_VALUE;
+		HANDLE Mapping = nullptr;
+#elif PLATFORM_UNIX || PLATFORM_MAC
+		bool Map(int64 NewCapacity)
+		{
+			Unmap();
+			if (ftruncate(Descriptor, (off_t)NewCapacity) != 0)
+			{
+				return false;
+			}
+			void* Address = mmap(nullptr, (size_t)NewCapacity, PROT_READ | PROT_WRITE, MAP_SHARED, Descriptor, 0);
+			View = Address != MAP_FAILED ? (uint8*)Address : nullptr;
+			Capacity = View ? NewCapacity : 0;
+			return View != nullptr;
+		}
+
+		void Unmap()
+		{
+			if (View)
+			{
+				munmap(View, (size_t)Capacity);
+				View = nullptr;
+			}
+			Capacity = 0;
+		}
+
+		int Descriptor = -1;
+#else
+		TUniquePtr<IFileHandle> Handle;
+#endif
+		uint8* View = nullptr;
+		int64 Capacity = 0;
+		int64 Size = 0;
+	};
+
+	constexpr int32 BlackboxCsvChunkBytes = 64 * 1024;
+
+	/** CSV text going out through a file archive in fixed-size chunks, so an export never holds a whole file. */
+	class FBlackboxCsvWriter
+	{
+	public:
+		bool Open(const FString& Path, const ANSICHAR* Header)
+		{
+			File.Reset(IFileManager::Get().CreateFileWriter(*Path));
+			Buffer.Reset(BlackboxCsvChunkBytes);
+			Append(Header, FCStringAnsi::Strlen(Header));
+			return File.IsValid();
+		}
+
+		void Append(const ANSICHAR* Text, int32 Length)
+		{
+			Buffer.Append(Text, Length);
+			if (Buffer.Num() >= BlackboxCsvChunkBytes)
+			{
+				Flush();
+			}
+		}
+
+		/** Writes what's left; false if the file couldn't be opened or written. */
+		bool Close()
+		{
+			if (!File)
+			{
+				return false;
+			}
+			Flush();
+			const bool bOk = File->Close();
+			File.Reset();
+			return bOk;
+		}
+
+	private:
+		void Flush()
+		{
+			if (File && Buffer.Num() > 0)
+			{
+				File->Serialize(Buffer.GetData(), Buffer.Num());
+			}
+			Buffer.Reset();
+		}
+
+		TUniquePtr<FArchive> File;
+		TArray<ANSICHAR> Buffer;
+	};
+}
+
+/**
+ * Single producer (the game thread fills blocks in ring order), single consumer (this thread
+ * appends them to the file). The block counters are the only shared state.
+ */
+class FDroneBlackboxWriter : public FRunnable
+{
+public:
+	FDroneBlackboxWriter()
+	{
+		Storage.SetNumUninitialized(BlackboxBlockBytes * BlackboxNumBlocks);
+		WakeEvent = FPlatformProcess::GetSynchEventFromPool();
+	}
+
+	virtual ~FDroneBlackboxWriter() override
+	{
+		FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	}
+
+	bool Start(const FString& Path, float StepSeconds)
+	{
+		if (!File.Open(Path))
+		{
+			return false;
+		}
+		uint8 Header[FlightBlackboxHeaderBytes];
+		WriteFlightBlackboxHeader(Header, StepSeconds);
+		File.Append(Header, sizeof(Header));
+
+		Thread.Reset(FRunnableThread::Create(this, TEXT("DroneBlackboxWriter"), 0, TPri_BelowNormal));
+		return Thread.IsValid();
+	}
+
+	/** Next block to fill, or null if the writer hasn't freed one yet. */
+	uint8* AcquireBlock()
+	{
+		const uint32 P = Produced.load(std::memory_order_relaxed);
+		if (P - Consumed.load(std::memory_order_acquire) >= (uint32)BlackboxNumBlocks)
+		{
+			return nullptr;
+		}
+		return &Storage[(P % BlackboxNumBlocks) * BlackboxBlockBytes];
+	}
+
+	void SubmitBlock(int32 Bytes)
+	{
+		const uint32 P = Produced.load(std::memory_order_relaxed);
+		BlockSizes[P % BlackboxNumBlocks] = Bytes;
+		Produced.store(P + 1, std::memory_order_release);
+		WakeEvent->Trigger();
+	}
+
+	/** Drains what was submitted, closes the file and joins the thread. */
+	int64 Finish()
+	{
+		bStopping = true;
+		WakeEvent->Trigger();
+		Thread->WaitForCompletion();
+		Thread.Reset();
+		File.Close();
+		return File.GetSize();
+	}
+
+	virtual uint32 Run() override
+	{
+		for (;;)
+		{
+			const bool bLast = bStopping;
+			const uint32 P = Produced.load(std::memory_order_acquire);
+			for (uint32 C = Consumed.load(std::memory_order_relaxed); C != P; ++C)
+			{
+				const int32 Index = C % BlackboxNumBlocks;
+				if (!bFailed && !File.Append(&Storage[Index * BlackboxBlockBytes], BlockSizes[Index]))
+				{
+					UE_LOG(LogDroneBlackbox, Error, TEXT("Blackbox write failed at %lld bytes; the rest of the session is not recorded"), File.GetSize());
+					bFailed = true;
+				}
+				Consumed.store(C + 1, std::memory_order_release);
+			}
+			if (bLast)
+			{
+				return 0;
+			}
+			WakeEvent->Wait(100);
+		}
+	}
+
+private:
+	TArray<uint8> Storage;
+	int32 BlockSizes[BlackboxNumBlocks] = {};
+	std::atomic<uint32> Produced{ 0 };
+	std::atomic<uint32> Consumed{ 0 };
+	std::atomic<bool> bStopping{ false };
+	bool bFailed = false;
+
+	FBlackboxMappedFile File;
+	FEvent* WakeEvent = nullptr;
+	TUniquePtr<FRunnableThread> Thread;
+};
+
+FDroneBlackbox::FDroneBlackbox() = default;
+
+FDroneBlackbox::~FDroneBlackbox()
+{
+	Stop();
+}
+
+FString FDroneBlackbox::GetLogPath(const FString& Name)
+{
+	return FPaths::ProjectSavedDir() / TEXT("Blackbox") / FPaths::MakeValidFileName(Name, TEXT('_')) + TEXT(".dbbx");
+}
+
+bool FDroneBlackbox::Start(const FString& Name, float StepSeconds)
+{
+	Stop();
+
+	TUniquePtr<FDroneBlackboxWriter> NewWriter = MakeUnique<FDroneBlackboxWriter>();
+	if (!NewWriter->Start(GetLogPath(Name), StepSeconds))
+	{
+		UE_LOG(LogDroneBlackbox, Error, TEXT("Can't open %s for the blackbox"), *GetLogPath(Name));
+		return false;
+	}
+
+	Writer = MoveTemp(NewWriter);
+	Encoder = FFlightBlackboxEncoder(FMath::Max(FMath::RoundToInt(1.f / StepSeconds), 1));
+	Block = Writer->AcquireBlock();
+	BlockUsed = 0;
+	StepsSinceSubmit = 0;
+	SubmitIntervalSteps = FMath::Max(FMath::RoundToInt(BlackboxSubmitIntervalSeconds / StepSeconds), 1);
+	NumFrames = 0;
+	NumDropped = 0;
+
+	UE_LOG(LogDroneBlackbox, Log, TEXT("Blackbox recording to %s at %.0f Hz"), *GetLogPath(Name), 1.f / StepSeconds);
+	return true;
+}
+
+void FDroneBlackbox::Stop()
+{
+	if (!Writer)
+	{
+		return;
+	}
+
+	if (Block && BlockUsed > 0)
+	{
+		Writer->SubmitBlock(BlockUsed);
+	}
+	const int64 Bytes = Writer->Finish();
+	Writer.Reset();
+	Block = nullptr;
+
+	UE_LOG(LogDroneBlackbox, Log, TEXT("Blackbox stopped: %lld frames, %lld bytes (%.1f per frame), %lld records dropped"),
+		NumFrames, Bytes, NumFrames > 0 ? (double)Bytes / NumFrames : 0.0, NumDropped);
+}
+
+uint8* FDroneBlackbox::BeginRecord()
+{
+	if (!Block)
+	{
+		Block = Writer->AcquireBlock();
+		BlockUsed = 0;
+	}
+	else if (BlockUsed + (int32)FlightBlackboxMaxRecordBytes > BlackboxBlockBytes)
+	{
+		SubmitBlock();
+	}
+
+	if (!Block)
+	{
+		// Whatever comes next can't lean on what was lost
+		++NumDropped;
+		Encoder.ForceKeyframe();
+		return nullptr;
+	}
+	return Block + BlockUsed;
+}
+
+void FDroneBlackbox::EndRecord(int32 Bytes)
+{
+	BlockUsed += Bytes;
+}
+
+void FDroneBlackbox::SubmitBlock()
+{
+	Writer->SubmitBlock(BlockUsed);
+	Block = Writer->AcquireBlock();
+	BlockUsed = 0;
+	StepsSinceSubmit = 0;
+}
+
+void FDroneBlackbox::RecordFrame(const FFlightBlackboxFrame& Frame)
+{
+	if (!Writer)
+	{
+		return;
+	}
+
+	if (uint8* Out = BeginRecord())
+	{
+		EndRecord((int32)Encoder.EncodeFrame(Frame, Out));
+		++NumFrames;
+	}
+
+	if (++StepsSinceSubmit >= SubmitIntervalSteps && Block && BlockUsed > 0)
+	{
+		SubmitBlock();
+	}
+}
+
+void FDroneBlackbox::RecordEvent(const FFlightBlackboxEvent& Event)
+{
+	if (!Writer)
+	{
+		return;
+	}
+
+	if (uint8* Out = BeginRecord())
+	{
+		EndRecord((int32)Encoder.EncodeEvent(Event, Out));
+	}
+}
+
+bool FDroneBlackbox::ExportCsv(const FString& Name)
+{
+	const FString LogPath = GetLogPath(Name);
+	TArray<uint8> Bytes;
+	float StepSeconds = 0.f;
+	if (!FFileHelper::LoadFileToArray(Bytes, *LogPath, FILEREAD_Silent) || !ReadFlightBlackboxHeader(Bytes.GetData(), Bytes.Num(), StepSeconds))
+	{
+		UE_LOG(LogDroneBlackbox, Error, TEXT("%s is not a blackbox log"), *LogPath);
+		return false;
+	}
+
+	const FString BasePath = FPaths::ChangeExtension(LogPath, TEXT(""));
+	FBlackboxCsvWriter Frames, Events;
+	bool bOpened = Frames.Open(BasePath + TEXT(".csv"),
+		"step,time,stick_roll,stick_pitch,stick_yaw,stick_throttle,cmd_roll,cmd_pitch,cmd_yaw,cmd_throttle,"
+		"motor_fr,motor_rr,motor_rl,motor_fl,quat_x,quat_y,quat_z,quat_w,vel_x,vel_y,vel_z,pos_x,pos_y,pos_z,health,armed,contact,on_ground\n");
+	bOpened &= Events.Open(BasePath + TEXT("_events.csv"), "step,time,type,loc_x,loc_y,loc_z,normal_x,normal_y,normal_z,value\n");
+	if (!bOpened)
+	{
+		UE_LOG(LogDroneBlackbox, Error, TEXT("Can't create the CSV files next to %s"), *LogPath);
+		Frames.Close();
+		Events.Close();
+		return false;
+	}
+
+	static const ANSICHAR* EventNames[] = { "impact", "damage", "crash", "marker" };
+	ANSICHAR Line[512];
+
+	FFlightBlackboxDecoder Decoder;
+	FFlightBlackboxFrame F;
+	FFlightBlackboxEvent E;
+	const uint8* Cursor = Bytes.GetData() + FlightBlackboxHeaderBytes;
+	const uint8* End = Bytes.GetData() + Bytes.Num();
+	int64 NumFrames = 0;
+	int64 NumEvents = 0;
+
+	for (EFlightBlackboxRecord Record; (Record = Decoder.Next(Cursor, End, F, E)) != EFlightBlackboxRecord::None;)
+	{
+		if (Record == EFlightBlackboxRecord::Event)
+		{
+			const int32 Length = FCStringAnsi::Snprintf(Line, UE_ARRAY_COUNT(Line), "%u,%.6f,%s,%.2f,%.2f,%.2f,%.4f,%.4f,%.4f,%.2f\n",
+				E.Step, E.Step * (double)StepSeconds, E.Type < UE_ARRAY_COUNT(EventNames) ? EventNames[E.Type] : "?",
+				E.Location.X, E.Location.Y, E.Location.Z, E.Normal.X, E.Normal.Y, E.Normal.Z, E.Value);
+			Events.Append(Line, FMath::Clamp(Length, 0, (int32)UE_ARRAY_COUNT(Line) - 1));
+			++NumEvents;
+			continue;
+		}
+
+		const int32 Length = FCStringAnsi::Snprintf(Line, UE_ARRAY_COUNT(Line), "%u,%.6f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.2f,%.2f,%.2f,%.2f,%.6f,%.6f,%.6f,%.6f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%.2f,%d,%d,%d\n",
+			F.Step, F.Step * (double)StepSeconds,
+			F.Sticks[0], F.Sticks[1], F.Sticks[2], F.Sticks[3],
+			F.Commands[0], F.Commands[1], F.Commands[2], F.Commands[3],
+			F.MotorThrust[0], F.MotorThrust[1], F.MotorThrust[2], F.MotorThrust[3],
+			F.Rotation.X, F.Rotation.Y, F.Rotation.Z, F.Rotation.W,
+			F.Velocity.X, F.Velocity.Y, F.Velocity.Z,
+			F.Position.X, F.Position.Y, F.Position.Z,
+			F.Health,
+			(F.Flags & FlightBlackboxFlag_Armed) ? 1 : 0, (F.Flags & FlightBlackboxFlag_Contact) ? 1 : 0, (F.Flags & FlightBlackboxFlag_OnGround) ? 1 : 0);
+		Frames.Append(Line, FMath::Clamp(Length, 0, (int32)UE_ARRAY_COUNT(Line) - 1));
+		++NumFrames;
+	}
+
+	bool bSaved = Frames.Close();
+	bSaved &= Events.Close();
+
+	UE_LOG(LogDroneBlackbox, Display, TEXT("Exported %lld frames and %lld events from %s%s"),
+		NumFrames, NumEvents, *LogPath, bSaved ? TEXT("") : TEXT(" (write failed)"));
+	return bSaved;
+}
+
+static void BlackboxRecordCommand(const TArray<FString>& Args, UWorld* World)
+{
+	TActorIterator<ADroneFPCharacter> Drone(World);
+	if (!World || !Drone)
+	{
+		return;
+	}
+
+	if (Drone->IsBlackboxRecording())
+	{
+		Drone->StopBlackbox();
+	}
+	else
+	{
+		Drone->StartBlackbox(Args.Num() > 0 ? Args[0] : FString());
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GBlackboxRecordCommand(
+	TEXT("Drone.Blackbox.Record"),
+	TEXT("Starts recording every physics step of the player drone to Saved/Blackbox; run again to stop. Args: [Name=timestamp]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&BlackboxRecordCommand));
+
+static FAutoConsoleCommand GBlackboxExportCommand(
+	TEXT("Drone.Blackbox.ExportCsv"),
+	TEXT("Decodes Saved/Blackbox/<Name>.dbbx into <Name>.csv and <Name>_events.csv on a worker thread. Args: Name"),
+	FConsoleCommandWithArgsDelegate::CreateStatic([](const TArray<FString>& Args)
+	{
+		if (Args.Num() < 1)
+		{
+			UE_LOG(LogDroneBlackbox, Display, TEXT("Usage: Drone.Blackbox.ExportCsv <Name>"));
+			return;
+		}
+		Async(EAsyncExecution::Thread, [Name = Args[0]]() { FDroneBlackbox::ExportCsv(Name); });
+	}));
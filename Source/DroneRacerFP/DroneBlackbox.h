@@ -0,0 +1,62 @@
+// DroneBlackbox.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FlightCore/FlightBlackbox.h"
+
+#include <atomic>
+
+/**
+ * Per-physics-step flight recorder. Frames are delta-encoded straight into a preallocated ring
+ * of blocks on the game thread; a writer thread copies finished blocks into a memory-mapped
+ * Saved/Blackbox/<Name>.dbbx. Nothing on the recording side allocates, locks or touches the
+ * disk. If the writer falls a whole ring behind, records are dropped and the next frame is a
+ * keyframe, so the log stays decodable.
+ */
+class DRONERACERFP_API FDroneBlackbox
+{
+public:
+	FDroneBlackbox();
+	~FDroneBlackbox();
+
+	FDroneBlackbox(const FDroneBlackbox&) = delete;
+	FDroneBlackbox& operator=(const FDroneBlackbox&) = delete;
+
+	bool Start(const FString& Name, float StepSeconds);
+
+	/** Hands the last partial block to the writer and waits for the file to be closed. */
+	void Stop();
+
+	bool IsRecording() const { return Writer.IsValid(); }
+
+	void RecordFrame(const FFlightBlackboxFrame& Frame);
+	void RecordEvent(const FFlightBlackboxEvent& Event);
+
+	int64 GetNumFrames() const { return NumFrames; }
+	int64 GetNumDropped() const { return NumDropped; }
+
+	/** Saved/Blackbox/<Name>.dbbx */
+	static FString GetLogPath(const FString& Name);
+
+	/**
+	 * Decodes a log into <Name>.csv (one row per step) and <Name>_events.csv next to it.
+	 * Blocking; the console command runs it on a worker thread.
+	 */
+	static bool ExportCsv(const FString& Name);
+
+private:
+	uint8* BeginRecord();
+	void EndRecord(int32 Bytes);
+	void SubmitBlock();
+
+	FFlightBlackboxEncoder Encoder;
+	TUniquePtr<class FDroneBlackboxWriter> Writer;
+
+	uint8* Block = nullptr;         // block being filled; null while the ring is full
+	int32 BlockUsed = 0;
+	int32 StepsSinceSubmit = 0;
+	int32 SubmitIntervalSteps = 0;  // partial blocks go out at least this often, to bound what a crash loses
+	int64 NumFrames = 0;
+	int64 NumDropped = 0;
+};
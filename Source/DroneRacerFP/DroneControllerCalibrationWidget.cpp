@@ -2,6 +2,45 @@
 
 #include "DroneControllerCalibrationWidget.h"
 
+#include "HAL/PlatformTime.h"
+
+// Every axis step walks the user through three held stick positions. The reference
+// is where the prompt asks the stick to be (+1 = up/right/top); correlating the raw
+// axes against it tells us both which axis it is and which way it runs.
+static constexpr int32 NumAxisPhases = 3;
+
+struct FAxisStepPrompt
+{
+    const TCHAR* Stick;
+    const TCHAR* Phases[NumAxisPhases];
+    float Reference[NumAxisPhases];
+};
+
+static const FAxisStepPrompt* GetAxisStepPrompt(ECalibrationStep Step)
+{
+    static const FAxisStepPrompt Pitch = { TEXT("Step 2: PITCH (right stick forward/back)"),
+        { TEXT("Let it rest in the center."), TEXT("Push it fully UP and hold."), TEXT("Now fully DOWN and hold.") },
+        { 0.f, 1.f, -1.f } };
+    static const FAxisStepPrompt Roll = { TEXT("Step 3: ROLL (right stick left/right)"),
+        { TEXT("Let it rest in the center."), TEXT("Push it fully RIGHT and hold."), TEXT("Now fully LEFT and hold.") },
+        { 0.f, 1.f, -1.f } };
+    static const FAxisStepPrompt Yaw = { TEXT("Step 4: YAW (left stick left/right)"),
+        { TEXT("Let it rest in the center."), TEXT("Push it fully RIGHT and hold."), TEXT("Now fully LEFT and hold.") },
+        { 0.f, 1.f, -1.f } };
+    static const FAxisStepPrompt Throttle = { TEXT("Step 5: THROTTLE (left stick up/down)"),
+        { TEXT("Pull it fully DOWN."), TEXT("Push it fully UP and hold."), TEXT("Back fully DOWN and hold.") },
+        { -1.f, 1.f, -1.f } };
+
+    switch (Step)
+    {
+    case ECalibrationStep::DetectPitch:    return &Pitch;
+    case ECalibrationStep::DetectRoll:     return &Roll;
+    case ECalibrationStep::DetectYaw:      return &Yaw;
+    case ECalibrationStep::DetectThrottle: return &Throttle;
+    default:                               return nullptr;
+    }
+}
+
 bool UDroneControllerCalibrationWidget::GetRawStateBP(FControllerRawState& OutState) const
 {
     if (!AxisAgg) return false;
@@ -41,6 +80,7 @@ void UDroneControllerCalibrationWidget::NativeConstruct()
     CurrentStep = ECalibrationStep::NotStarted;
 }
 
+
 void UDroneControllerCalibrationWidget::StartCalibration()
 {
     PendingCalibration.Mappings.Empty();
@@ -54,18 +94,27 @@ void UDroneControllerCalibrationWidget::BeginStep(ECalibrationStep NewStep)
 {
     CurrentStep = NewStep;
     StepElapsed = 0.f;
-    CenterSampleCount = 0;
 
-    CenterAccumulator.Empty();
-    MotionAccumulator.Empty();
-    Baseline.Empty();
+    // Only samples that arrive after the prompt changes belong to this step
+    const FControllerSampleRing* Ring = AxisAgg ? AxisAgg->GetSampleRing() : nullptr;
+    SampleCursor = Ring ? Ring->GetHead() : 0;
+
+    // Axis buffers are re-initialized from the next sample. CenterStats survives
+    // until the next DetectCenter: the axis steps derive deadzones from it.
+    if (CurrentStep == ECalibrationStep::DetectCenter)
+    {
+        CenterStats.Empty();
+    }
+    bHasAxisCount = false;
+    StepSeries.Reset();
+    StepReference.Reset();
     StepRawMin.Empty();
     StepRawMax.Empty();
 
     switch (CurrentStep)
     {
     case ECalibrationStep::DetectCenter:
-        StepDuration = 2.0f;
+        StepDuration = CenterStepDuration;
         UpdateInstructionText(FText::FromString(TEXT(
             "Controller Calibration\n\n"
             "Step 1: Leave all sticks centered and do not touch them."
@@ -73,35 +122,11 @@ void UDroneControllerCalibrationWidget::BeginStep(ECalibrationStep NewStep)
         break;
 
     case ECalibrationStep::DetectPitch:
-        StepDuration = 2.0f;
-        UpdateInstructionText(FText::FromString(TEXT(
-            "Step 2: Move the PITCH stick fully up and down repeatedly.\n"
-            "(Right stick: forward/back)"
-        )));
-        break;
-
     case ECalibrationStep::DetectRoll:
-        StepDuration = 2.0f;
-        UpdateInstructionText(FText::FromString(TEXT(
-            "Step 3: Move the ROLL stick fully left and right repeatedly.\n"
-            "(Right stick: left/right)"
-        )));
-        break;
-
     case ECalibrationStep::DetectYaw:
-        StepDuration = 2.0f;
-        UpdateInstructionText(FText::FromString(TEXT(
-            "Step 4: Move the YAW stick fully left and right repeatedly.\n"
-            "(Left stick: yaw)"
-        )));
-        break;
-
     case ECalibrationStep::DetectThrottle:
-        StepDuration = 2.0f;
-        UpdateInstructionText(FText::FromString(TEXT(
-            "Step 5: Move the THROTTLE stick from bottom to top and back repeatedly.\n"
-            "(Left stick: throttle)"
-        )));
+        StepDuration = NumAxisPhases * AxisPhaseDuration;
+        BeginPhase(0);
         break;
 
     case ECalibrationStep::Done:
@@ -121,6 +146,19 @@ void UDroneControllerCalibrationWidget::BeginStep(ECalibrationStep NewStep)
     UpdateProgress(0.f);
 }
 
+void UDroneControllerCalibrationWidget::BeginPhase(int32 NewPhase)
+{
+    StepPhase = NewPhase;
+    PhaseElapsed = 0.f;
+    PhaseStartTime = FPlatformTime::Seconds();
+
+    if (const FAxisStepPrompt* Prompt = GetAxisStepPrompt(CurrentStep))
+    {
+        UpdateInstructionText(FText::FromString(FString::Printf(TEXT("%s\n\n%s"),
+            Prompt->Stick, Prompt->Phases[StepPhase])));
+    }
+}
+
 void UDroneControllerCalibrationWidget::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
 {
     Super::NativeTick(MyGeometry, InDeltaTime);
@@ -131,215 +169,366 @@ void UDroneControllerCalibrationWidget::NativeTick(const FGeometry& MyGeometry,
         return;
     }
 
-    if (!OnGetRawState.IsBound())
-    {
-        return; // no input source
-    }
-
-    FControllerRawState State;
-    if (!OnGetRawState.Execute(State))
+    if (ConsumeSamples() == 0 && !bHasAxisCount)
     {
         return; // device not ready / disconnected
     }
 
-    EnsureAxisBuffersInitialized(State);
-
     StepElapsed += InDeltaTime;
     const float Alpha = FMath::Clamp(StepElapsed / StepDuration, 0.f, 1.f);
     UpdateProgress(Alpha);
 
-    TickStep(InDeltaTime);
+    bool bStepDone = false;
 
-    // Step transition
-    if (StepElapsed >= StepDuration)
+    if (GetLogicalAxisName(CurrentStep) == NAME_None)
     {
-        switch (CurrentStep)
+        bStepDone = StepElapsed >= StepDuration;
+    }
+    else
+    {
+        PhaseElapsed += InDeltaTime;
+
+        if (StepPhase < NumAxisPhases - 1)
+        {
+            if (PhaseElapsed >= AxisPhaseDuration)
+            {
+                BeginPhase(StepPhase + 1);
+            }
+        }
+        else
         {
-        case ECalibrationStep::DetectCenter:
-            BeginStep(ECalibrationStep::DetectPitch);
-            break;
-        case ECalibrationStep::DetectPitch:
-            BeginStep(ECalibrationStep::DetectRoll);
-            break;
-        case ECalibrationStep::DetectRoll:
-            BeginStep(ECalibrationStep::DetectYaw);
-            break;
-        case ECalibrationStep::DetectYaw:
-            BeginStep(ECalibrationStep::DetectThrottle);
-            break;
-        case ECalibrationStep::DetectThrottle:
-            BeginStep(ECalibrationStep::Done);
-            break;
-        default:
-            break;
+            // With device-rate data the answer is usually clear before the last prompt runs out
+            bStepDone = PhaseElapsed >= AxisPhaseDuration ||
+                (PhaseElapsed >= AxisPhaseMinDuration && IsAxisStepConclusive());
         }
     }
+
+    if (bStepDone)
+    {
+        FinishStep();
+    }
 }
 
-void UDroneControllerCalibrationWidget::TickStep(float DeltaTime)
+void UDroneControllerCalibrationWidget::FinishStep()
 {
-    FControllerRawState State;
-    if (!OnGetRawState.Execute(State))
+    const FName LogicalAxisName = GetLogicalAxisName(CurrentStep);
+    if (LogicalAxisName != NAME_None)
     {
-        return;
+        CommitAxis(LogicalAxisName);
     }
 
     switch (CurrentStep)
     {
     case ECalibrationStep::DetectCenter:
-        TickDetectCenter(State);
+        BeginStep(ECalibrationStep::DetectPitch);
         break;
-
     case ECalibrationStep::DetectPitch:
-        TickDetectAxis(State, TEXT("Pitch"));
+        BeginStep(ECalibrationStep::DetectRoll);
         break;
-
     case ECalibrationStep::DetectRoll:
-        TickDetectAxis(State, TEXT("Roll"));
+        BeginStep(ECalibrationStep::DetectYaw);
         break;
-
     case ECalibrationStep::DetectYaw:
-        TickDetectAxis(State, TEXT("Yaw"));
+        BeginStep(ECalibrationStep::DetectThrottle);
         break;
-
     case ECalibrationStep::DetectThrottle:
-        TickDetectAxis(State, TEXT("Throttle"));
+        BeginStep(ECalibrationStep::Done);
         break;
-
     default:
         break;
     }
 }
 
-void UDroneControllerCalibrationWidget::EnsureAxisBuffersInitialized(const FControllerRawState& State)
+int32 UDroneControllerCalibrationWidget::ConsumeSamples()
 {
-    if (bHasAxisCount)
+    // Device-rate path: read the ring in place, oldest first
+    if (const FControllerSampleRing* Ring = AxisAgg ? AxisAgg->GetSampleRing() : nullptr)
+    {
+        int32 Count = 0;
+        const uint64 Dropped = Ring->ForEachSince(SampleCursor, [this, &Count](const FControllerAxisSample& Sample)
+            {
+                ProcessSample(Sample.GetAxes(), Sample.TimeSeconds);
+                ++Count;
+            });
+
+        if (Dropped > 0)
+        {
+            UE_LOG(LogTemp, Verbose, TEXT("Calibration: UI fell behind, %llu device samples dropped"), Dropped);
+        }
+        return Count;
+    }
+
+    // Backends that don't push reports: one snapshot per tick
+    if (!OnGetRawState.IsBound())
+    {
+        return 0; // no input source
+    }
+
+    FControllerRawState State;
+    if (!OnGetRawState.Execute(State))
+    {
+        return 0;
+    }
+
+    ProcessSample(State.Axes, FPlatformTime::Seconds());
+    return 1;
+}
+
+void UDroneControllerCalibrationWidget::ProcessSample(TArrayView<const float> Axes, double TimeSeconds)
+{
+    if (!EnsureAxisBuffersInitialized(Axes) || Axes.Num() < NumAxes)
     {
         return;
     }
 
-    NumAxes = State.Axes.Num();
+    if (CurrentStep == ECalibrationStep::DetectCenter)
+    {
+        AddCenterSample(Axes);
+    }
+    else
+    {
+        AddMotionSample(Axes, TimeSeconds);
+    }
+}
+
+bool UDroneControllerCalibrationWidget::EnsureAxisBuffersInitialized(TArrayView<const float> Axes)
+{
+    if (bHasAxisCount)
+    {
+        return true;
+    }
+
+    NumAxes = FMath::Min(Axes.Num(), MaxControllerAxes);
     if (NumAxes <= 0)
     {
-        return;
+        return false;
     }
 
-    CenterAccumulator.Init(0.f, NumAxes);
-    MotionAccumulator.Init(0.f, NumAxes);
-    Baseline = State.Axes;
+    if (CenterStats.Num() != NumAxes)
+    {
+        CenterStats.SetNum(NumAxes);
+    }
+
+    // Pad to whole SIMD registers. Reset keeps the capacity, so after the first
+    // step recording doesn't allocate.
+    SeriesStride = Align(NumAxes, 4);
+    StepSeries.Reset();
+    StepReference.Reset();
+    StepSeries.Reserve(SeriesStride * 2048);
+    StepReference.Reserve(2048);
+    AxisCorrelations.SetNum(SeriesStride);
 
     StepRawMin.Init(FLT_MAX, NumAxes);
     StepRawMax.Init(-FLT_MAX, NumAxes);
 
     bHasAxisCount = true;
+    return true;
 }
 
-// -------- Center detection step --------
-
-void UDroneControllerCalibrationWidget::TickDetectCenter(const FControllerRawState& State)
+FName UDroneControllerCalibrationWidget::GetLogicalAxisName(ECalibrationStep Step)
 {
-    if (!bHasAxisCount || State.Axes.Num() != NumAxes)
+    switch (Step)
     {
-        return;
+    case ECalibrationStep::DetectPitch:    return TEXT("Pitch");
+    case ECalibrationStep::DetectRoll:     return TEXT("Roll");
+    case ECalibrationStep::DetectYaw:      return TEXT("Yaw");
+    case ECalibrationStep::DetectThrottle: return TEXT("Throttle");
+    default:                               return NAME_None;
     }
+}
+
+float UDroneControllerCalibrationWidget::GetPhaseReference(ECalibrationStep Step, int32 Phase)
+{
+    const FAxisStepPrompt* Prompt = GetAxisStepPrompt(Step);
+    return Prompt ? Prompt->Reference[FMath::Clamp(Phase, 0, NumAxisPhases - 1)] : 0.f;
+}
 
-    ++CenterSampleCount;
+// -------- Center detection step --------
 
+void UDroneControllerCalibrationWidget::AddCenterSample(TArrayView<const float> Axes)
+{
     for (int32 Axis = 0; Axis < NumAxes; ++Axis)
     {
-        const float Val = State.Axes[Axis];
-        CenterAccumulator[Axis] += Val;
+        const float Val = Axes[Axis];
+        CenterStats[Axis].Add(Val);
 
         StepRawMin[Axis] = FMath::Min(StepRawMin[Axis], Val);
         StepRawMax[Axis] = FMath::Max(StepRawMax[Axis], Val);
     }
-
-    // At the end of this step we *could* compute jitter-based deadzones,
-    // but for simplicity we keep that logic in the per-axis steps.
 }
 
 // -------- Per-axis detection step (Pitch / Roll / Yaw / Throttle) --------
 
-void UDroneControllerCalibrationWidget::TickDetectAxis(const FControllerRawState& State, FName LogicalAxisName)
+void UDroneControllerCalibrationWidget::AddMotionSample(TArrayView<const float> Axes, double TimeSeconds)
 {
-    if (!bHasAxisCount || State.Axes.Num() != NumAxes)
-    {
-        return;
-    }
+    // A sample taken before the current prompt appeared still belongs to the previous one
+    const int32 Phase = (TimeSeconds >= PhaseStartTime) ? StepPhase : StepPhase - 1;
+    StepReference.Add(GetPhaseReference(CurrentStep, Phase));
 
-    // Accumulate how much each axis moves compared to the baseline
+    // Stored relative to rest so the float sums in the kernel don't cancel
+    float* Row = StepSeries.GetData() + StepSeries.AddZeroed(SeriesStride);
     for (int32 Axis = 0; Axis < NumAxes; ++Axis)
     {
-        const float Val = State.Axes[Axis];
-        const float Delta = FMath::Abs(Val - Baseline[Axis]);
-
-        MotionAccumulator[Axis] += Delta;
+        const float Val = Axes[Axis];
+        Row[Axis] = Val - (float)CenterStats[Axis].Mean;
 
         StepRawMin[Axis] = FMath::Min(StepRawMin[Axis], Val);
         StepRawMax[Axis] = FMath::Max(StepRawMax[Axis], Val);
     }
 
-    // When this step's time is up, pick the axis that moved the most
-    if (StepElapsed >= StepDuration)
+    if (StepReference.Num() == 1)
+    {
+        StepFirstSampleTime = TimeSeconds;
+    }
+    StepLastSampleTime = TimeSeconds;
+}
+
+void UDroneControllerCalibrationWidget::CorrelateStep()
+{
+    const int32 NumSamples = StepReference.Num();
+    if (!bHasAxisCount || NumSamples < 2)
     {
-        const int32 AxisIndex = PickAxisWithLargestMotion();
-        if (AxisIndex == INDEX_NONE)
+        for (FAxisCorrelation& C : AxisCorrelations)
         {
-            UE_LOG(LogTemp, Warning, TEXT("Calibration: No moving axis detected for %s"),
-                *LogicalAxisName.ToString());
-            return;
+            C = FAxisCorrelation();
         }
+        return;
+    }
+
+    // Lags are searched in samples; derive the rate from the timestamps so the same
+    // reaction window works for 60 Hz snapshots and 1 kHz reports alike.
+    const double Span = StepLastSampleTime - StepFirstSampleTime;
+    const double SampleRate = (Span > 0.0) ? (NumSamples - 1) / Span : 60.0;
+    const int32 MaxLagSamples = FMath::RoundToInt(MaxReactionLag * SampleRate);
+    const int32 LagStep = FMath::Max(1, FMath::RoundToInt(0.01 * SampleRate)); // 10 ms resolution
 
-        UsedAxisIndices.Add(AxisIndex);
+    CorrelateAxesWithReference(StepSeries, SeriesStride, StepReference, MaxLagSamples, LagStep, AxisCorrelations);
+}
 
-        // Commit mapping
-        FAxisMapping& Mapping = PendingCalibration.FindOrAddMapping(LogicalAxisName);
-        Mapping.AxisIndex = AxisIndex;
+int32 UDroneControllerCalibrationWidget::PickAxisByCorrelation(float* OutRunnerUpGain) const
+{
+    // Crosstalk moves neighbouring axes in step with the prompt too (high |r|), but
+    // only a fraction as far, so among the axes that follow the prompt we take the
+    // one with the largest gain.
+    float BestGain = 0.f;
+    float RunnerUpGain = 0.f;
+    int32 BestAxis = INDEX_NONE;
 
-        FAxisCalibration& Cal = Mapping.Calibration;
-        const float RawMin = StepRawMin[AxisIndex];
-        const float RawMax = StepRawMax[AxisIndex];
+    for (int32 Axis = 0; Axis < NumAxes && Axis < AxisCorrelations.Num(); ++Axis)
+    {
+        if (IsAxisAlreadyUsed(Axis))
+        {
+            continue;
+        }
 
-        Cal.RawMin = RawMin;
-        Cal.RawMax = RawMax;
+        const FAxisCorrelation& C = AxisCorrelations[Axis];
+        const float Gain = FMath::Abs(C.Gain);
 
-        if (LogicalAxisName == TEXT("Throttle"))
+        if (Gain > BestGain && FMath::Abs(C.Correlation) >= MinAxisCorrelation)
         {
-            // For throttle we mostly use min/max; center is not critical
-            Cal.RawCenter = (RawMin + RawMax) * 0.5f;
-            Cal.DeadZone = 0.02f;
+            RunnerUpGain = FMath::Max(RunnerUpGain, BestGain);
+            BestGain = Gain;
+            BestAxis = Axis;
         }
         else
         {
-            Cal.RawCenter = (RawMin + RawMax) * 0.5f;
-            Cal.DeadZone = 0.05f;
+            RunnerUpGain = FMath::Max(RunnerUpGain, Gain);
         }
+    }
 
-        Cal.bInvert = false; // you can add UI later to flip this if user wants
+    if (OutRunnerUpGain)
+    {
+        *OutRunnerUpGain = RunnerUpGain;
     }
+    return BestAxis;
 }
 
-int32 UDroneControllerCalibrationWidget::PickAxisWithLargestMotion() const
+bool UDroneControllerCalibrationWidget::IsAxisStepConclusive()
 {
-    float BestScore = 0.f;
-    int32 BestAxis = INDEX_NONE;
+    CorrelateStep();
 
-    for (int32 Axis = 0; Axis < MotionAccumulator.Num(); ++Axis)
+    float RunnerUp = 0.f;
+    const int32 AxisIndex = PickAxisByCorrelation(&RunnerUp);
+    if (AxisIndex == INDEX_NONE || FMath::Abs(AxisCorrelations[AxisIndex].Gain) < GainDominanceRatio * RunnerUp)
     {
-        if (IsAxisAlreadyUsed(Axis))
-        {
-            continue;
-        }
+        return false;
+    }
 
-        const float Score = MotionAccumulator[Axis];
-        if (Score > BestScore)
-        {
-            BestScore = Score;
-            BestAxis = Axis;
-        }
+    // Throttle reached both ends in the first two prompts
+    if (CurrentStep == ECalibrationStep::DetectThrottle)
+    {
+        return true;
     }
 
-    return BestAxis;
+    // Sticks: wait until the second end stop is reached too, i.e. the excursions
+    // either side of rest are about equal
+    const float Center = (float)CenterStats[AxisIndex].Mean;
+    const float Up = StepRawMax[AxisIndex] - Center;
+    const float Down = Center - StepRawMin[AxisIndex];
+    return Up > 0.f && Down > 0.f && FMath::Min(Up, Down) >= 0.8f * FMath::Max(Up, Down);
+}
+
+void UDroneControllerCalibrationWidget::CommitAxis(FName LogicalAxisName)
+{
+    if (!bHasAxisCount)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Calibration: No samples received for %s"), *LogicalAxisName.ToString());
+        return;
+    }
+
+    CorrelateStep();
+
+    const int32 AxisIndex = PickAxisByCorrelation();
+    if (AxisIndex == INDEX_NONE)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Calibration: No axis followed the prompts for %s"),
+            *LogicalAxisName.ToString());
+        return;
+    }
+
+    UsedAxisIndices.Add(AxisIndex);
+
+    // Commit mapping
+    FAxisMapping& Mapping = PendingCalibration.FindOrAddMapping(LogicalAxisName);
+    Mapping.AxisIndex = AxisIndex;
+
+    FAxisCalibration& Cal = Mapping.Calibration;
+    const float RawMin = StepRawMin[AxisIndex];
+    const float RawMax = StepRawMax[AxisIndex];
+
+    Cal.RawMin = RawMin;
+    Cal.RawMax = RawMax;
+
+    // Jitter measured while the sticks were untouched in DetectCenter
+    const FAxisNoiseStats Noise = CenterStats.IsValidIndex(AxisIndex) ? CenterStats[AxisIndex] : FAxisNoiseStats();
+
+    if (LogicalAxisName == TEXT("Throttle"))
+    {
+        // For throttle we mostly use min/max; center is not critical.
+        // Deadzone sits at the bottom and is relative to full travel.
+        Cal.RawCenter = (RawMin + RawMax) * 0.5f;
+        Cal.DeadZone = ComputeNoiseFloorDeadZone(Noise, RawMax - RawMin,
+            DeadZoneSigmaMultiplier, MinDeadZone, MaxDeadZone);
+    }
+    else
+    {
+        // Rest position is the measured mean, not the midpoint of the end stops:
+        // gimbals are rarely symmetric and the midpoint is what made worn ones drift.
+        Cal.RawCenter = (Noise.Count > 0) ? (float)Noise.Mean : (RawMin + RawMax) * 0.5f;
+
+        const float HalfRange = FMath::Min(RawMax - Cal.RawCenter, Cal.RawCenter - RawMin);
+        Cal.DeadZone = ComputeNoiseFloorDeadZone(Noise, HalfRange,
+            DeadZoneSigmaMultiplier, MinDeadZone, MaxDeadZone);
+    }
+
+    // The prompts say which way is positive, so the sign of the fit is the inversion
+    const FAxisCorrelation& Fit = AxisCorrelations[AxisIndex];
+    Cal.bInvert = Fit.Gain < 0.f;
+
+    const double SampleRate = (StepReference.Num() - 1) / FMath::Max(StepLastSampleTime - StepFirstSampleTime, UE_DOUBLE_SMALL_NUMBER);
+    UE_LOG(LogTemp, Log, TEXT("Calibration: %s -> axis %d%s r=%.3f lag=%.0fms center=%.4f sigma=%.5f (n=%d) deadzone=%.4f"),
+        *LogicalAxisName.ToString(), AxisIndex, Cal.bInvert ? TEXT(" (inverted)") : TEXT(""), Fit.Correlation,
+        1000.0 * Fit.LagSamples / SampleRate, Cal.RawCenter, Noise.GetStdDev(), Noise.Count, Cal.DeadZone);
 }
 
 bool UDroneControllerCalibrationWidget::IsAxisAlreadyUsed(int32 AxisIndex) const
@@ -350,4 +539,4 @@ bool UDroneControllerCalibrationWidget::IsAxisAlreadyUsed(int32 AxisIndex) const
 void UDroneControllerCalibrationWidget::InitWithAxisAggregator(UControllerAxisAggregatorComponent* InAxisAgg)
 {
     AxisAgg = InAxisAgg;
-}
\ No newline at end of file
+}
@@ -66,6 +66,43 @@ public:
 	bool GetLogicalCalibrationBP(FName LogicalName, FAxisCalibration& OutCalib) const;
 
 
+	/** Deadzone = this many standard deviations of the jitter measured while centered. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Calibration|DeadZone")
+	float DeadZoneSigmaMultiplier = 4.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Calibration|DeadZone")
+	float MinDeadZone = 0.005f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Calibration|DeadZone")
+	float MaxDeadZone = 0.15f;
+
+	/** Hands-off time used to measure center and jitter. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Calibration|Timing")
+	float CenterStepDuration = 0.5f;
+
+	/**
+	 * Each axis step prompts three stick positions (center, one end, the other end;
+	 * bottom/top/bottom for throttle) and holds each prompt this long.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Calibration|Timing")
+	float AxisPhaseDuration = 0.7f;
+
+	/** The last prompt of a step may end after this once the answer is unambiguous. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Calibration|Timing")
+	float AxisPhaseMinDuration = 0.35f;
+
+	/** Longest reaction time we search for when lining the axes up with the prompts. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Calibration|Identification")
+	float MaxReactionLag = 0.5f;
+
+	/** An axis must follow the prompts at least this well (|Pearson r|) to be picked. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Calibration|Identification")
+	float MinAxisCorrelation = 0.8f;
+
+	/** End the step early once the best axis' |gain| is this many times the runner-up's. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Calibration|Identification")
+	float GainDominanceRatio = 4.f;
+
 protected:
 	// Store a reference to the aggregator
 	UPROPERTY(BlueprintReadOnly, Category = "Calibration")
@@ -98,13 +135,28 @@ private:
 	bool bHasAxisCount = false;
 	int32 NumAxes = 0;
 
-	// For center detection
-	TArray<float> CenterAccumulator;
-	int32 CenterSampleCount = 0;
+	// For center detection: per-axis mean / jitter, fed at device rate when available
+	TArray<FAxisNoiseStats> CenterStats;
+
+	// Our read position in the aggregator's sample ring
+	uint64 SampleCursor = 0;
+
+	// Prompt within an axis step (0..NumAxisPhases-1) and when it was shown
+	int32 StepPhase = 0;
+	float PhaseElapsed = 0.f;
+	double PhaseStartTime = 0.0;
+
+	// Per-step recording for axis identification: [sample][SeriesStride] raw values
+	// relative to the measured center (padding lanes zero), plus the prompted position
+	// for every sample.
+	int32 SeriesStride = 0;
+	TArray<float> StepSeries;
+	TArray<float> StepReference;
+	double StepFirstSampleTime = 0.0;
+	double StepLastSampleTime = 0.0;
 
-	// For motion detection
-	TArray<float> Baseline;           // starting values for this step
-	TArray<float> MotionAccumulator;  // total movement per axis
+	// Latest fit of every axis against StepReference
+	TArray<FAxisCorrelation> AxisCorrelations;
 
 	// For min/max during each step
 	TArray<float> StepRawMin;
@@ -116,14 +168,28 @@ private:
 private:
 	// Step control
 	void BeginStep(ECalibrationStep NewStep);
-	void TickStep(float DeltaTime);
+	void BeginPhase(int32 NewPhase);
+	void FinishStep();
+
+	// Feeds every device sample since the last tick (or one snapshot if there is no ring).
+	// Returns the number of samples processed.
+	int32 ConsumeSamples();
+	void ProcessSample(TArrayView<const float> Axes, double TimeSeconds);
+
+	bool EnsureAxisBuffersInitialized(TArrayView<const float> Axes);
+
+	void AddCenterSample(TArrayView<const float> Axes);
+	void AddMotionSample(TArrayView<const float> Axes, double TimeSeconds);
 
-	void EnsureAxisBuffersInitialized(const FControllerRawState& State);
+	bool IsAxisStepConclusive();
+	void CommitAxis(FName LogicalAxisName);
 
-	void TickDetectCenter(const FControllerRawState& State);
-	void TickDetectAxis(const FControllerRawState& State, FName LogicalAxisName);
+	static FName GetLogicalAxisName(ECalibrationStep Step);
+	static float GetPhaseReference(ECalibrationStep Step, int32 Phase);
 
-	int32 PickAxisWithLargestMotion() const;
+	// Runs the correlation kernel over everything recorded in this step
+	void CorrelateStep();
+	int32 PickAxisByCorrelation(float* OutRunnerUpGain = nullptr) const;
 	bool IsAxisAlreadyUsed(int32 AxisIndex) const;
 };
 
@@ -0,0 +1,64 @@
+// DroneCourseVoxelizer.cpp
+
+#include "DroneCourseVoxelizer.h"
+#include "Engine/World.h"
+
+namespace
+{
+	// Cells per side of the coarse blocks tested before single cells
+	constexpr int32 VoxelizerBlockCells = 4;
+
+	// Overlap test for one box of the grid against anything a drone would hit
+	bool IsCourseBoxBlocked(const UWorld& World, const FVector& Center, const FVector& HalfExtent)
+	{
+		FCollisionResponseParams Response(ECR_Block);
+		Response.CollisionResponse.SetResponse(ECC_Pawn, ECR_Ignore); // other drones move
+		return World.OverlapBlockingTestByChannel(Center, FQuat::Identity, ECC_Pawn,
+			FCollisionShape::MakeBox(HalfExtent), FCollisionQueryParams(SCENE_QUERY_STAT(DroneCourseVoxelizer)), Response);
+	}
+}
+
+int64 VoxelizeDroneCourse(const UWorld& World, const FVector& Min, float CellSize, const FIntVector& Num,
+	TFunctionRef<void(int32 X, int32 Y, int32 Z)> OnBlocked)
+{
+	const FVector CellExtent(0.5f * CellSize);
+	int64 NumQueries = 0;
+
+	for (int32 BZ = 0; BZ < Num.Z; BZ += VoxelizerBlockCells)
+	{
+		for (int32 BY = 0; BY < Num.Y; BY += VoxelizerBlockCells)
+		{
+			for (int32 BX = 0; BX < Num.X; BX += VoxelizerBlockCells)
+			{
+				const FIntVector BlockEnd(
+					FMath::Min(BX + VoxelizerBlockCells, Num.X),
+					FMath::Min(BY + VoxelizerBlockCells, Num.Y),
+					FMath::Min(BZ + VoxelizerBlockCells, Num.Z));
+				const FVector BlockMin = Min + FVector(BX, BY, BZ) * CellSize;
+				const FVector BlockMax = Min + FVector(BlockEnd) * CellSize;
+
+				++NumQueries;
+				if (!IsCourseBoxBlocked(World, 0.5 * (BlockMin + BlockMax), 0.5 * (BlockMax - BlockMin)))
+				{
+					continue;
+				}
+
+				for (int32 Z = BZ; Z < BlockEnd.Z; ++Z)
+				{
+					for (int32 Y = BY; Y < BlockEnd.Y; ++Y)
+					{
+						for (int32 X = BX; X < BlockEnd.X; ++X)
+						{
+							++NumQueries;
+							if (IsCourseBoxBlocked(World, Min + (FVector(X, Y, Z) + 0.5) * CellSize, CellExtent))
+							{
+								OnBlocked(X, Y, Z);
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+	return NumQueries;
+}
@@ -0,0 +1,17 @@
+// DroneCourseVoxelizer.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+
+/**
+ * Marks which cells of a grid contain geometry a drone would collide with (other pawns
+ * excluded), for the fields baked over a course: proximity (clearance) and wind.
+ * Coarse blocks of cells are tested first, so open air costs little.
+ *
+ * @return Number of overlap queries issued.
+ */
+int64 VoxelizeDroneCourse(const UWorld& World, const FVector& Min, float CellSize, const FIntVector& Num,
+	TFunctionRef<void(int32 X, int32 Y, int32 Z)> OnBlocked);
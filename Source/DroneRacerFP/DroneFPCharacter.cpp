@@ -1,84 +1,67 @@
 ﻿#include "DroneFPCharacter.h"
+#include "DroneFlightCollision.h"
+#include "DroneFlightStats.h"
+#include "DroneTelemetry.h"
+#include "DroneLatency.h"
+#include "DroneBenchmarkHarness.h"
+#include "FlightCore/FlightDeterminism.h"
+#include "DroneProximitySubsystem.h"
+#include "DroneWindField.h"
+#include "DroneGhostManager.h"
 #include "DjiHidReader.h"
 #include "Camera/CameraComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "Components/InputComponent.h"
-#include "GameFramework/CharacterMovementComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/StaticMesh.h"
+#include "UObject/ConstructorHelpers.h"
 #include "GameFramework/PlayerController.h"
 #include "PhysicalMaterials/PhysicalMaterial.h"
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "Engine/LocalPlayer.h"
 #include "DroneControllerCalibrationWidget.h"
+#include "ControllerCalibrationStore.h"
 #include "Blueprint/UserWidget.h"
 #include "Kismet/GameplayStatics.h"
 #include "GameFramework/PlayerController.h"
 #include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "EngineUtils.h"
 
 // Alias the channel struct from the HID reader so we can write FDjiChannels
 using FDjiChannels = FDjiHidReader::FDjiChannels;
 
-// ===== FPV-style rate calculation (Betaflight-inspired) =====
-static float ApplyFpvRates(
-	float stick,      // -1..1
-	float expo,       // 0..1
-	float rcRate,     // ~0.5..2.0
-	float superRate   // 0..1
-)
-{
-	stick = FMath::Clamp(stick, -1.f, 1.f);
-	expo = FMath::Clamp(expo, 0.f, 1.f);
-	rcRate = FMath::Max(0.f, rcRate);
-	superRate = FMath::Clamp(superRate, 0.f, 0.99f);
-
-	// 1) Expo (cubic blend)
-	float x = (1.f - expo) * stick + expo * stick * stick * stick;
-
-	return x;
-
-	//// 2) RC Rate (linear scaling)
-	//float rate = x * rcRate;
-
-	//// 3) SuperRate (end-stick boost)
-	//const float absRate = FMath::Abs(rate);
-	//// Clamp absRate to slightly less than 1.0 to prevent division by zero
-	//const float ClampedAbsRate = FMath::Min(absRate, 0.99f);
-
-	//if (ClampedAbsRate > KINDA_SMALL_NUMBER)
-	//{
-	//	// Use the clamped version here
-	//	rate = rate * (1.f + superRate * ClampedAbsRate / (1.f - ClampedAbsRate));
-	//}
-	//return rate; // still normalized (-∞..∞), scaled later
-}
-
-static float ApplyCubicExpo(float x, float expo)
-{
-	x = FMath::Clamp(x, -1.f, 1.f);
-	expo = FMath::Clamp(expo, 0.f, 1.f);
-
-	// Blend linear and cubic: (1-e)*x + e*x^3
-	return (1.f - expo) * x + expo * x * x * x;
-}
+DECLARE_CYCLE_STAT(TEXT("Flight substep"), STAT_DroneFlightSubstep, STATGROUP_DroneFlight);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Substeps per frame"), STAT_DroneFlightSubsteps, STATGROUP_DroneFlight);
+DECLARE_CYCLE_STAT(TEXT("Camera late latch"), STAT_DroneLateLatch, STATGROUP_DroneFlight);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Late latch correction (deg)"), STAT_DroneLateLatchDegrees, STATGROUP_DroneFlight);
+
+// Drone.Telemetry.Graph / Drone.Telemetry.File
+DECLARE_DRONE_TELEMETRY_CHANNEL(TelemetryRawPitch, TEXT("Input.RawPitch"), Verbose);
+DECLARE_DRONE_TELEMETRY_CHANNEL(TelemetryPitchSmoothed, TEXT("Input.PitchSmoothed"), Verbose);
+DECLARE_DRONE_TELEMETRY_CHANNEL(TelemetryPitchCmd, TEXT("Input.PitchCmd"), Basic);
+DECLARE_DRONE_TELEMETRY_CHANNEL(TelemetryRollCmd, TEXT("Input.RollCmd"), Basic);
+DECLARE_DRONE_TELEMETRY_CHANNEL(TelemetryYawCmd, TEXT("Input.YawCmd"), Basic);
+DECLARE_DRONE_TELEMETRY_CHANNEL(TelemetryYawEvent, TEXT("Input.YawEvent"), Verbose);
+DECLARE_DRONE_TELEMETRY_CHANNEL(TelemetryPitchEvent, TEXT("Input.PitchEvent"), Verbose);
+DECLARE_DRONE_TELEMETRY_CHANNEL(TelemetryRollEvent, TEXT("Input.RollEvent"), Verbose);
+DECLARE_DRONE_TELEMETRY_CHANNEL(TelemetryThrottleEvent, TEXT("Input.ThrottleEvent"), Verbose);
+DECLARE_DRONE_TELEMETRY_CHANNEL(TelemetryHidAxes, TEXT("Input.HidXYZ"), Verbose);
+DECLARE_DRONE_TELEMETRY_CHANNEL(TelemetryHidRotAxes, TEXT("Input.HidRxRyRz"), Verbose);
+DECLARE_DRONE_TELEMETRY_CHANNEL(TelemetryThrottle, TEXT("Flight.Throttle"), Basic);
+DECLARE_DRONE_TELEMETRY_CHANNEL(TelemetryThrottleSmoothed, TEXT("Flight.ThrottleSmoothed"), Basic);
+DECLARE_DRONE_TELEMETRY_CHANNEL(TelemetryUpAccel, TEXT("Flight.UpAccel"), Basic);
+DECLARE_DRONE_TELEMETRY_CHANNEL(TelemetryVelocity, TEXT("Flight.Velocity"), Basic);
+DECLARE_DRONE_TELEMETRY_CHANNEL(TelemetryAltitude, TEXT("Flight.Altitude"), Basic);
+DECLARE_DRONE_TELEMETRY_CHANNEL(TelemetryCameraRotation, TEXT("Camera.WorldRotation"), Verbose);
+DECLARE_DRONE_TELEMETRY_CHANNEL(TelemetryPivotRotation, TEXT("Camera.PivotRotation"), Verbose);
 
 ADroneFPCharacter::ADroneFPCharacter()
 {
 	PrimaryActorTick.bCanEverTick = true;
 
-	if (APlayerController* PC = Cast<APlayerController>(GetController()))
-	{
-		for (int i = 0; i < 8; i++)
-		{
-			float v = PC->GetInputAnalogKeyState(
-				FKey(*FString::Printf(TEXT("GenericUSBController Axis%d"), i))
-			);
-
-			if (FMath::Abs(v) > 0.01f)
-			{
-				UE_LOG(LogTemp, Warning, TEXT("Axis %d = %f"), i, v);
-			}
-		}
-	}
 	GenericHid = CreateDefaultSubobject<UGenericHidInputComponent>(TEXT("GenericHid"));
 	GenericHid->bAutoStart = true;
 	GenericHid->bLogDevices = true;
@@ -86,12 +69,16 @@ ADroneFPCharacter::ADroneFPCharacter()
 	//controller aggregator
 	AxisAgg = CreateDefaultSubobject<UControllerAxisAggregatorComponent>(TEXT("AxisAgg"));
 
-	// Resize the collision capsule
-	GetCapsuleComponent()->InitCapsuleSize(12.0f, 7.0f);
+	// ===== Collision capsule (root, swept by the flight model) =====
+	CapsuleComponent = CreateDefaultSubobject<UCapsuleComponent>(TEXT("CollisionCylinder"));
+	CapsuleComponent->InitCapsuleSize(12.0f, 7.0f);
+	CapsuleComponent->SetCollisionProfileName(UCollisionProfile::Pawn_ProfileName);
+	CapsuleComponent->SetCanEverAffectNavigation(false);
+	RootComponent = CapsuleComponent;
 
 	// ===== Camera Tilt Pivot =====
 	CameraTiltPivot = CreateDefaultSubobject<USceneComponent>(TEXT("CameraTiltPivot"));
-	CameraTiltPivot->SetupAttachment(GetCapsuleComponent());
+	CameraTiltPivot->SetupAttachment(CapsuleComponent);
 	CameraTiltPivot->SetRelativeLocation(FVector(0.f, 0.f, 64.f)); // camera height
 
 	// ===== First-person camera =====
@@ -100,19 +87,21 @@ ADroneFPCharacter::ADroneFPCharacter()
 	FirstPersonCamera->bUsePawnControlRotation = false; // we rotate the whole actor
 	FirstPersonCamera->bAutoActivate = true;
 
-	// ===== Arms mesh (kept for compatibility, not used visually) =====
-	Mesh1P = CreateDefaultSubobject<USkeletalMeshComponent>(TEXT("CharacterMesh1P"));
-
-	// ===== Character movement component: disabled (custom physics) =====
-	UCharacterMovementComponent* MoveComp = GetCharacterMovement();
-	if (MoveComp)
+	// ===== Drone mesh (visual only, not seen from our own camera) =====
+	DroneMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("DroneMesh"));
+	DroneMesh->SetupAttachment(CapsuleComponent);
+	DroneMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	DroneMesh->SetGenerateOverlapEvents(false);
+	DroneMesh->SetCanEverAffectNavigation(false);
+	DroneMesh->SetOwnerNoSee(true);
+
+	// Stand-in body (24 x 24 x 6 cm) until the Blueprint sets a real model. The ACharacter meshes
+	// the Blueprint may have set up aren't carried over, so without this the drone is invisible.
+	static ConstructorHelpers::FObjectFinder<UStaticMesh> DefaultDroneMesh(TEXT("/Engine/BasicShapes/Cube.Cube"));
+	if (DefaultDroneMesh.Succeeded())
 	{
-		MoveComp->SetMovementMode(MOVE_Flying);
-		MoveComp->GravityScale = 0.f;
-		MoveComp->Velocity = FVector::ZeroVector;
-		MoveComp->bOrientRotationToMovement = false;
-		MoveComp->bUseControllerDesiredRotation = false;
-		MoveComp->Deactivate(); // We drive movement manually
+		DroneMesh->SetStaticMesh(DefaultDroneMesh.Object);
+		DroneMesh->SetRelativeScale3D(FVector(0.24f, 0.24f, 0.06f));
 	}
 
 	// ===== We control rotation directly on the actor =====
@@ -133,21 +122,55 @@ void ADroneFPCharacter::BeginPlay()
 		UE_LOG(LogTemp, Warning, TEXT("Bound GenericHID OnAxesUpdated"));
 	}
 
+	if (GenericHid)
+	{
+		GenericHid->OnDeviceConnected.AddUObject(this, &ADroneFPCharacter::OnGenericHidDeviceConnected);
+		GenericHid->OnReport.AddUObject(this, &ADroneFPCharacter::OnGenericHidReport);
+	}
+
+	// Calibration must be in place before the first flight Tick
+	if (UControllerCalibrationStore* Store = GetCalibrationStore())
+	{
+		Store->OnProfileLoaded.AddUObject(this, &ADroneFPCharacter::OnCalibrationProfileLoaded);
+	}
+	ApplyStoredCalibration();
+
 	// Initialize health
 	Health = MaxHealth;
 
+	if (!BetaflightRatesDump.IsEmpty())
+	{
+		ImportBetaflightRates(BetaflightRatesDump);
+	}
+	UpdateRateTable();
 
-	UE_LOG(LogTemp, Warning, TEXT("ADroneFPCharacter::BeginPlay (%s)"),
-		IsLocallyControlled() ? TEXT("Local") : TEXT("Remote"));
+	ProximityCache = GetWorld() ? GetWorld()->GetSubsystem<UDroneProximitySubsystem>() : nullptr;
 
-	// Hide / disable arms mesh (visual only)
-	if (Mesh1P)
+	if (!WindField)
 	{
-		Mesh1P->SetHiddenInGame(true);
-		Mesh1P->SetVisibility(false, true);
-		Mesh1P->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+		for (TActorIterator<ADroneWindField> It(GetWorld()); It; ++It)
+		{
+			WindField = *It;
+			break;
+		}
+	}
+
+	for (TActorIterator<ADroneGhostManager> It(GetWorld()); It; ++It)
+	{
+		GhostManager = *It;
+		break;
 	}
 
+	ResetPhysicsStateFromActor();
+
+	if (bRecordBlackbox)
+	{
+		StartBlackbox(FString());
+	}
+
+	UE_LOG(LogTemp, Warning, TEXT("ADroneFPCharacter::BeginPlay (%s)"),
+		IsLocallyControlled() ? TEXT("Local") : TEXT("Remote"));
+
 	// ---- Local-only setup (camera + input) ----
 	if (!GetController() || !GetController()->IsLocalController())
 	{
@@ -177,13 +200,7 @@ void ADroneFPCharacter::BeginPlay()
 	}
 
 	// ----- Camera inheritance (critical) -----
-	if (CameraTiltPivot)
-	{
-		CameraTiltPivot->SetUsingAbsoluteRotation(false);
-		CameraTiltPivot->SetRelativeRotation(
-			FRotator(CameraTiltDegrees, 0.f, 0.f)
-		);
-	}
+	UpdateCameraTilt();
 
 	if (FirstPersonCamera)
 	{
@@ -203,28 +220,110 @@ void ADroneFPCharacter::OnGenericHidAxesUpdated(const FGenericHidDeviceAxes& Axe
 {
 	// 0=X 1=Y 2=Z 3=Rx 4=Ry 5=Rz 6=Slider 7=Dial 8=Wheel
 	auto GetA = [&](int32 i) { return Axes.Axes.IsValidIndex(i) ? Axes.Axes[i] : 0.f; };
+	RECORD_DRONE_TELEMETRY(TelemetryHidAxes, FVector(GetA(0), GetA(1), GetA(2)));
+	RECORD_DRONE_TELEMETRY(TelemetryHidRotAxes, FVector(GetA(3), GetA(4), GetA(5)));
+}
 
-	UE_LOG(LogTemp, Warning, TEXT("HID %s  X=%.3f Y=%.3f Z=%.3f Rx=%.3f Ry=%.3f Rz=%.3f Sl=%.3f"),
-		*Axes.DeviceId,
-		GetA(0), GetA(1), GetA(2),
-		GetA(3), GetA(4), GetA(5),
-		GetA(6));
+UControllerCalibrationStore* ADroneFPCharacter::GetCalibrationStore() const
+{
+	const UGameInstance* GI = GetGameInstance();
+	return GI ? GI->GetSubsystem<UControllerCalibrationStore>() : nullptr;
+}
+
+void ADroneFPCharacter::ApplyStoredCalibration()
+{
+	UControllerCalibrationStore* Store = GetCalibrationStore();
+	if (!Store || !AxisAgg)
+	{
+		return;
+	}
+
+	FControllerCalibrationProfile Profile;
+	const bool bFound = AxisAgg->DeviceId.IsEmpty()
+		? Store->TryGetMostRecentProfile(Profile)
+		: Store->TryGetProfile(AxisAgg->DeviceId, Profile);
+
+	if (bFound)
+	{
+		AxisAgg->ApplyCalibrationProfile(Profile);
+	}
+}
+
+void ADroneFPCharacter::SaveCurrentCalibration()
+{
+	UControllerCalibrationStore* Store = GetCalibrationStore();
+	if (!Store || !AxisAgg || AxisAgg->DeviceId.IsEmpty())
+	{
+		return;
+	}
+
+	Store->SaveProfile(AxisAgg->MakeCalibrationProfile());
+}
+
+void ADroneFPCharacter::OnGenericHidDeviceConnected(const FGenericHidDeviceAxes& Device)
+{
+	if (!AxisAgg || AxisAgg->DeviceId == Device.DeviceId)
+	{
+		return;
+	}
+
+	// A different radio than the one we guessed at BeginPlay: switch profiles.
+	// Don't block here, we may already be flying; OnCalibrationProfileLoaded picks it up.
+	AxisAgg->DeviceId = Device.DeviceId;
+
+	if (UControllerCalibrationStore* Store = GetCalibrationStore())
+	{
+		Store->RequestLoad(Device.DeviceId);
+
+		FControllerCalibrationProfile Profile;
+		if (Store->TryGetProfile(Device.DeviceId, Profile, /*bWaitForPending=*/false))
+		{
+			AxisAgg->ApplyCalibrationProfile(Profile);
+		}
+	}
+}
+
+void ADroneFPCharacter::OnCalibrationProfileLoaded(const FString& DeviceId, bool bFound)
+{
+	if (!bFound || !AxisAgg || AxisAgg->DeviceId != DeviceId)
+	{
+		return;
+	}
+
+	if (UControllerCalibrationStore* Store = GetCalibrationStore())
+	{
+		FControllerCalibrationProfile Profile;
+		if (Store->TryGetProfile(DeviceId, Profile, /*bWaitForPending=*/false))
+		{
+			AxisAgg->ApplyCalibrationProfile(Profile);
+		}
+	}
+}
+
+void ADroneFPCharacter::OnGenericHidReport(const FString& DeviceId, TArrayView<const float> Axes)
+{
+	// Every report goes through the aggregator so calibration sees device-rate samples
+	if (AxisAgg && (AxisAgg->DeviceId.IsEmpty() || AxisAgg->DeviceId == DeviceId))
+	{
+		AxisAgg->PushDeviceSample(Axes);
+		FDroneLatency::StampInputEvent(/*bDeviceReport=*/true);
+	}
 }
 
 void ADroneFPCharacter::CalcCamera(float DeltaTime, FMinimalViewInfo& OutResult)
 {
+	FDroneLatency::StampCamera();
+
 	if (FirstPersonCamera)
 	{
-		const FRotator CamWorld = FirstPersonCamera->GetComponentRotation();
-		const FRotator PivotWorld = CameraTiltPivot ? CameraTiltPivot->GetComponentRotation() : FRotator::ZeroRotator;
-
-		UE_LOG(LogTemp, Warning, TEXT("CalcCamera: CamWorld=%s PivotWorld=%s Actor=%s Local=%d"),
-			*CamWorld.ToString(),
-			*PivotWorld.ToString(),
-			*GetActorRotation().ToString(),
-			IsLocallyControlled() ? 1 : 0);
+		RECORD_DRONE_TELEMETRY(TelemetryCameraRotation, FirstPersonCamera->GetComponentRotation().Euler());
+		RECORD_DRONE_TELEMETRY(TelemetryPivotRotation, CameraTiltPivot ? CameraTiltPivot->GetComponentRotation().Euler() : FVector::ZeroVector);
 
 		FirstPersonCamera->GetCameraView(DeltaTime, OutResult);
+		if (bLateLatchCamera)
+		{
+			ApplyLateLatch(OutResult);
+		}
 		return;
 	}
 
@@ -313,6 +412,7 @@ void ADroneFPCharacter::OnToggleCalibration(const FInputActionValue& Value)
 	if (AxisAgg->IsCalibrating())
 	{
 		AxisAgg->StopCalibration(true);  // keep results
+		SaveCurrentCalibration();
 		HideCalibrationUI();
 	}
 	else
@@ -325,222 +425,623 @@ void ADroneFPCharacter::OnToggleCalibration(const FInputActionValue& Value)
 void ADroneFPCharacter::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
-	if (GEngine)
+	if (DeltaTime <= 0.f)
+	{
+		return;
+	}
+
+
+
+// A) Camera tilt (only touches the pivot when CameraTiltDegrees was changed)
+	UpdateCameraTilt();
+
+	// Something else (respawn, editor, Blueprint) moved us: adopt that as the physics state
+	if (!GetActorLocation().Equals(RenderedLocation, 0.01f))
+	{
+		ResetPhysicsStateFromActor();
+	}
+
+	const float Step = 1.f / FMath::Clamp(PhysicsRateHz, 250.f, 2000.f);
+
+	// 0) Process commands. Normal: once per frame (the RC filter already ran at input rate).
+	// Deterministic: stamp the raw sticks with the simulation time of this frame; each step picks them up.
+	FFlightInput Input;
+	if (bDeterministic)
+	{
+		if (DeterministicStep != Step)
+		{
+			ResetDeterministicInput(Step);
+		}
+
+		// A playback pushed all of its samples up front
+		if (!bPlayingInputs)
+		{
+			const FDroneInputSample Sample = SampleSticks(StepIndex * (double)Step + PhysicsAccumulator);
+			DeterministicInput.Push(Sample);
+			if (bRecordingInputs)
+			{
+				InputLog.Samples.Add(Sample);
+			}
+		}
+	}
+	else
 	{
-		// 1. Get the Player Controller
-		APlayerController* PC = Cast<APlayerController>(GetController());
-		if (PC)
+		DeterministicStep = 0.f;
+		bPlayingInputs = false;
+
+		float PitchCmd = 0.f;
+		float RollCmd = 0.f;
+		float YawCmd = 0.f;
+		SmoothInputs(DeltaTime, PitchCmd, RollCmd, YawCmd);
+
+		Input.Pitch = PitchCmd;
+		Input.Roll = RollCmd;
+		Input.Yaw = YawCmd;
+		Input.Throttle = Throttle01;
+		Input.bArmed = bThrottleArmed;
+	}
+
+	UpdateRateTable();
+
+	const FFlightParams Params = MakeFlightParams();
+	FDroneCapsuleCollision Collision(GetCapsuleComponent());
+	Collision.SetProximityField(ProximityCache ? ProximityCache->GetField() : nullptr);
+
+	// 1-4) Fixed-step flight: the frame rate only decides how many steps run, never their size
+	PhysicsAccumulator += DeltaTime;
+
+	int32 Substeps = 0;
+	{
+		TOptional<FFlightFloatEnvironment> FloatEnvironment;
+		if (bDeterministic)
 		{
-			// 2. Scan GenericUSBController Axes 1 through 8
-			for (int32 i = 1; i <= 8; i++)
+			FloatEnvironment.Emplace();
+		}
+
+		while (PhysicsAccumulator >= Step && Substeps < MaxSubstepsPerFrame)
+		{
+			PrevFlightState = FlightState;
+
+			if (bDeterministic)
 			{
-				FKey AxisKey = FKey(FName(*FString::Printf(TEXT("GenericUSBController_Axis%d"), i)));
-				float AxisValue = PC->GetInputAnalogKeyState(AxisKey);
+				Input = DeterministicInput.Consume(StepIndex);
+				Throttle01 = Input.Throttle;
+			}
 
-				// 3. Only display if the value is not zero (to clear the clutter)
-				if (FMath::Abs(AxisValue) > 0.01f)
+			if (Substeps == 0)
+			{
+				FDroneLatency::StampSimulated();
+			}
+
+			const uint64 StepStartCycles = FlightProfile ? FPlatformTime::Cycles64() : 0;
+			StepFlight(Step, Params, Input, Collision);
+			if (FlightProfile)
+			{
+				FlightProfile->StepCycles += FPlatformTime::Cycles64() - StepStartCycles;
+				++FlightProfile->Steps;
+			}
+
+			if (bDeterministic)
+			{
+				StateChecksum = HashFlightState(FlightState, StateChecksum);
+				if (bRecordingInputs)
 				{
-					// Use Key '10 + i' to ensure each axis gets its own line (Line 11, 12, etc.)
-					GEngine->AddOnScreenDebugMessage(10 + i, 0.1f, FColor::Orange,
-						FString::Printf(TEXT("DETECTED - Axis %d: %.3f"), i, AxisValue));
+					InputLog.Checksums.Add(StateChecksum);
 				}
 			}
+
+			PhysicsAccumulator -= Step;
+			++StepIndex;
+
+			if (bPlayingInputs && StepIndex >= PlaybackEndStep)
+			{
+				bPlayingInputs = false;
+			}
+			++Substeps;
 		}
 	}
-	if (DeltaTime <= 0.f)
+
+	// After a long hitch, drop the backlog: the drone pauses instead of launching
+	if (PhysicsAccumulator >= Step)
 	{
-		return;
+		PhysicsAccumulator = FMath::Fmod(PhysicsAccumulator, Step);
 	}
 
+	SET_DWORD_STAT(STAT_DroneFlightSubsteps, Substeps);
 
+	LateLatchInput = Input;
+	LateLatchBaseSeconds = FPlatformTime::Seconds();
 
-// A) Camera tilt
-	UpdateCameraTilt();
+	RECORD_DRONE_TELEMETRY(TelemetryThrottle, Throttle01);
+	RECORD_DRONE_TELEMETRY(TelemetryThrottleSmoothed, FlightState.ThrottleSmoothed);
+	RECORD_DRONE_TELEMETRY(TelemetryUpAccel, bThrottleArmed ? ComputeFlightUpAccel(FlightState.ThrottleSmoothed, Params) : 0.f);
+	RECORD_DRONE_TELEMETRY(TelemetryVelocity, Velocity);
+	RECORD_DRONE_TELEMETRY(TelemetryAltitude, FlightState.Position.Z);
 
-	// 0) Process commands
-	float PitchCmd = 0.f;
-	float RollCmd = 0.f;
-	float YawCmd = 0.f;
+	// 5) One transform write per frame, interpolated between the last two physics states
+	ApplyInterpolatedTransform(PhysicsAccumulator / Step);
+}
 
-	// IMPORTANT: Check your SmoothInputs function. 
-	// It should be using the member variables (PitchInput, etc.) 
-	// that your Enhanced Input functions are now updating.
-	SmoothInputs(DeltaTime, PitchCmd, RollCmd, YawCmd);
+FFlightParams ADroneFPCharacter::MakeFlightParams() const
+{
+	FFlightParams Params;
+	Params.Mass = Mass;
+	Params.GravityZ = GetWorld() ? GetWorld()->GetGravityZ() : -980.f; // cm/s^2
+	Params.MaxThrustG = MaxThrustG;
+	Params.HoverThrottle = HoverThrottle;
+	Params.ThrustExpo = ThrustExpo;
+	Params.ThrustResponse = ThrustResponse;
+	Params.DragCoeff = DragCoeff;
+	Params.DragArea = ToFlight(DragArea);
+	Params.Wind = WindField ? WindField->GetField() : nullptr;
+	Params.Integrator = static_cast<EFlightIntegrator>(Integrator);
+	Params.MaxSlideIterations = MaxSlideIterations;
+	Params.BounceMinSpeed = BounceMinSpeed;
+	Params.Rates = &RateTable;
+	Params.Inertia = ToFlight(Inertia);
+	Params.ArmLength = ArmLength;
+	Params.YawTorqueCoeff = YawTorqueCoeff;
+	Params.MotorSpinUpTime = MotorSpinUpTime;
+	Params.MotorSpinDownTime = MotorSpinDownTime;
+
+	Params.Pid.Mode = static_cast<EFlightMode>(FlightMode);
+	Params.Pid.LoopRateHz = FMath::Clamp(PidLoopRateHz, 1000.f, 8000.f);
+	Params.Pid.P = ToFlight(RatePidP);
+	Params.Pid.I = ToFlight(RatePidI);
+	Params.Pid.D = ToFlight(RatePidD);
+	Params.Pid.FF = ToFlight(RatePidFF);
+	Params.Pid.DTermCutoffHz = DTermCutoffHz;
+	Params.Pid.AngleLimitDeg = AngleLimitDeg;
+	Params.Pid.AngleStrength = AngleStrength;
+	Params.Pid.HorizonTransition = HorizonTransition;
+	return Params;
+}
 
-	// 1) Update orientation
-	UpdateOrientation(DeltaTime, PitchCmd, RollCmd, YawCmd);
+static_assert((uint8)EDroneRatesType::Actual == (uint8)EFlightRatesType::Actual
+	&& (uint8)EDroneRatesType::Quick == (uint8)EFlightRatesType::Quick, "EDroneRatesType must mirror EFlightRatesType");
+static_assert((uint8)EDroneFlightMode::Angle == (uint8)EFlightMode::Angle
+	&& (uint8)EDroneFlightMode::Horizon == (uint8)EFlightMode::Horizon, "EDroneFlightMode must mirror EFlightMode");
+static_assert((uint8)EDroneIntegrator::SemiImplicitEuler == (uint8)EFlightIntegrator::SemiImplicitEuler
+	&& (uint8)EDroneIntegrator::RK4 == (uint8)EFlightIntegrator::RK4, "EDroneIntegrator must mirror EFlightIntegrator");
 
-	// 2–3) Compute net acceleration (thrust + gravity + drag)
-	const FVector Accel = ComputeTotalAcceleration(DeltaTime);
+void ADroneFPCharacter::UpdateRateTable()
+{
+	auto MakeAxis = [this](float RcRate, float SuperRate, float Expo)
+	{
+		FFlightAxisRates Axis;
+		Axis.Type = static_cast<EFlightRatesType>(RatesType);
+		Axis.RcRate = RcRate;
+		Axis.SuperRate = SuperRate;
+		Axis.Expo = FMath::Clamp(Expo, 0.f, 1.f);
+		Axis.RateLimit = RateLimit;
+		return Axis;
+	};
+
+	const FFlightAxisRates Axes[FlightAxis::Num] = {
+		MakeAxis(RollRcRate, RollSuperRate, RollExpo),
+		MakeAxis(PitchRcRate, PitchSuperRate, PitchExpo),
+		MakeAxis(YawRcRate, YawSuperRate, YawExpo)
+	};
+
+	// Cheap compare every frame; the bake only runs when something was edited
+	if (bRateTableValid
+		&& Axes[FlightAxis::Roll] == RateTable.GetAxisRates(FlightAxis::Roll)
+		&& Axes[FlightAxis::Pitch] == RateTable.GetAxisRates(FlightAxis::Pitch)
+		&& Axes[FlightAxis::Yaw] == RateTable.GetAxisRates(FlightAxis::Yaw))
+	{
+		return;
+	}
 
-	// 4) Integrate movement and handle collisions
-	IntegrateMovement(DeltaTime, Accel);
+	RateTable.Build(Axes);
+	bRateTableValid = true;
 }
 
-void ADroneFPCharacter::UpdateCameraTilt()
+bool ADroneFPCharacter::ImportBetaflightRates(const FString& CliDump)
 {
-	if (IsLocallyControlled() && CameraTiltPivot)
+	FFlightAxisRates Axes[FlightAxis::Num];
+	std::string Error;
+	if (!ParseBetaflightRates(TCHAR_TO_UTF8(*CliDump), Axes, Error))
 	{
-		CameraTiltPivot->SetUsingAbsoluteRotation(false);
-		CameraTiltPivot->SetRelativeRotation(FRotator(CameraTiltDegrees, 0.f, 0.f));
+		UE_LOG(LogTemp, Warning, TEXT("ImportBetaflightRates: %s"), UTF8_TO_TCHAR(Error.c_str()));
+		return false;
 	}
+
+	RatesType = static_cast<EDroneRatesType>(Axes[FlightAxis::Roll].Type);
+	RateLimit = FMath::Max3(Axes[FlightAxis::Roll].RateLimit, Axes[FlightAxis::Pitch].RateLimit, Axes[FlightAxis::Yaw].RateLimit);
+
+	RollRcRate = Axes[FlightAxis::Roll].RcRate;
+	RollSuperRate = Axes[FlightAxis::Roll].SuperRate;
+	RollExpo = Axes[FlightAxis::Roll].Expo;
+	PitchRcRate = Axes[FlightAxis::Pitch].RcRate;
+	PitchSuperRate = Axes[FlightAxis::Pitch].SuperRate;
+	PitchExpo = Axes[FlightAxis::Pitch].Expo;
+	YawRcRate = Axes[FlightAxis::Yaw].RcRate;
+	YawSuperRate = Axes[FlightAxis::Yaw].SuperRate;
+	YawExpo = Axes[FlightAxis::Yaw].Expo;
+
+	UE_LOG(LogTemp, Log, TEXT("ImportBetaflightRates: %s rates, full stick roll/pitch/yaw %.0f/%.0f/%.0f deg/s"),
+		*UEnum::GetValueAsString(RatesType),
+		EvaluateFlightRate(Axes[FlightAxis::Roll], 1.f),
+		EvaluateFlightRate(Axes[FlightAxis::Pitch], 1.f),
+		EvaluateFlightRate(Axes[FlightAxis::Yaw], 1.f));
+
+	UpdateRateTable();
+	return true;
 }
 
-void ADroneFPCharacter::SmoothInputs(
-	float DeltaTime,
-	float& OutPitchCmd,
-	float& OutRollCmd,
-	float& OutYawCmd)
+void ADroneFPCharacter::StepFlight(float Step, const FFlightParams& Params, const FFlightInput& Input, FDroneCapsuleCollision& Collision)
 {
-	// Smooth stick inputs
-	PitchInputSmoothed = FMath::FInterpTo(PitchInputSmoothed, PitchInput, DeltaTime, RotSmoothSpeed);
-	RollInputSmoothed = FMath::FInterpTo(RollInputSmoothed, RollInput, DeltaTime, RotSmoothSpeed);
-	YawInputSmoothed = FMath::FInterpTo(YawInputSmoothed, YawInput, DeltaTime, RotSmoothSpeed);
-
-	// Apply FPV expo / rates
-	OutPitchCmd = ApplyFpvRates(
-		PitchInputSmoothed,
-		PitchExpo,
-		PitchRcRate,
-		PitchSuperRate
-	);
+	SCOPE_CYCLE_COUNTER(STAT_DroneFlightSubstep);
 
-	OutRollCmd = ApplyFpvRates(
-		RollInputSmoothed,
-		RollExpo,
-		RollRcRate,
-		RollSuperRate
-	);
+	// Orientation, thrust + gravity + drag, integration and the contact response
+	FFlightStepResult Result;
+	Collision.BeginStep();
+	StepFlightModel(FlightState, Params, Input, Step, &Collision, &Result);
 
-	OutYawCmd = ApplyFpvRates(
-		YawInputSmoothed,
-		YawExpo,
-		YawRcRate,
-		YawSuperRate
-	);
+	Velocity = ToVector(FlightState.Velocity);
+
+	if (FlightProfile)
+	{
+		FlightProfile->Sweeps += Result.NumSweeps;
+	}
+
+	if (ProximityCache && ProximityCache->IsRecordingLap())
+	{
+		ProximityCache->RecordLapSample(ToVector(FlightState.Position), ToQuat(FlightState.Rotation));
+	}
 
-	UE_LOG(LogTemp, Warning, TEXT("RawPitch=%.3f Smoothed=%.3f Cmd=%.3f"),
-		PitchInput,
-		PitchInputSmoothed,
-		OutPitchCmd);
+	if (GhostManager && GhostManager->IsRecording())
+	{
+		GhostManager->RecordStep(Step, ToVector(FlightState.Position), ToQuat(FlightState.Rotation));
+	}
+
+	const float HealthBefore = Health;
+	if (Result.bContact)
+	{
+		HandleImpactDamage(Collision.ImpactHit, Result.ImpactSpeed);
+	}
+
+	if (Blackbox.IsRecording())
+	{
+		RecordBlackboxStep(Input, Result, HealthBefore);
+	}
 }
 
-void ADroneFPCharacter::VelocityDebugPrint()
+void ADroneFPCharacter::RecordBlackboxStep(const FFlightInput& Input, const FFlightStepResult& Result, float HealthBefore)
 {
-	const float SpeedCm = Velocity.Size();
-	if (GEngine)
+	const FDroneInputSample Sticks = SampleSticks(0.0);
+
+	FFlightBlackboxFrame Frame;
+	Frame.Step = (uint32)StepIndex;
+	for (int32 i = 0; i < RcChannel::Num; ++i)
 	{
-		GEngine->AddOnScreenDebugMessage(
-			1,                      // key (replaces same line)
-			0.f,                    // display for this frame only
-			FColor::Yellow,
-			FString::Printf(
-				TEXT("Vel = %s | Speed = %.1f cm/s (%.2f m/s)"),
-				*Velocity.ToString(),
-				SpeedCm,
-				SpeedCm / 100.f
-			)
-		);
+		Frame.Sticks[i] = Sticks.Sticks[i];
+	}
+	Frame.Commands[0] = Input.Roll;
+	Frame.Commands[1] = Input.Pitch;
+	Frame.Commands[2] = Input.Yaw;
+	Frame.Commands[3] = Input.Throttle;
+	for (int32 i = 0; i < 4; ++i)
+	{
+		Frame.MotorThrust[i] = FlightState.MotorThrust[i];
+	}
+	Frame.Rotation = FlightState.Rotation;
+	Frame.Velocity = FlightState.Velocity;
+	Frame.Position = FlightState.Position;
+	Frame.Health = Health;
+	Frame.Flags = (Input.bArmed ? FlightBlackboxFlag_Armed : 0)
+		| (Result.bContact ? FlightBlackboxFlag_Contact : 0)
+		| (Result.bOnGround ? FlightBlackboxFlag_OnGround : 0);
+	Blackbox.RecordFrame(Frame);
+
+	FFlightBlackboxEvent Event;
+	Event.Step = Frame.Step;
+	Event.Location = FlightState.Position;
+
+	// Resting contact fires every step; only real hits (the ones damage looks at) are events
+	if (Result.bContact && !IsRestingImpact(Result.ImpactSpeed))
+	{
+		Event.Type = FFlightBlackboxEvent::Impact;
+		Event.Location = Result.Contact.Location;
+		Event.Normal = Result.Contact.SurfaceNormal;
+		Event.Value = Result.ImpactSpeed;
+		Blackbox.RecordEvent(Event);
+	}
+	if (Health < HealthBefore)
+	{
+		Event.Type = FFlightBlackboxEvent::Damage;
+		Event.Value = HealthBefore - Health;
+		Blackbox.RecordEvent(Event);
+
+		if (Health <= 0.f)
+		{
+			Event.Type = FFlightBlackboxEvent::Crash;
+			Event.Value = 0.f;
+			Blackbox.RecordEvent(Event);
+		}
 	}
 }
 
-void ADroneFPCharacter::UpdateOrientation(
-	float DeltaTime,
-	float PitchCmd,
-	float RollCmd,
-	float YawCmd)
+bool ADroneFPCharacter::StartBlackbox(const FString& Name)
 {
-	// Flip pitch so +stick pitches DOWN (your existing behavior)
-	const float dPitch = PitchCmd * PitchRateDeg * DeltaTime;
-	const float dYaw = YawCmd * YawRateDeg * DeltaTime;
-	const float dRoll = RollCmd * RollRateDeg * DeltaTime;
+	const float Step = 1.f / FMath::Clamp(PhysicsRateHz, 250.f, 2000.f);
+	return Blackbox.Start(Name.IsEmpty() ? FDateTime::Now().ToString(TEXT("Flight_%Y%m%d_%H%M%S")) : Name, Step);
+}
 
-	AddActorLocalRotation(FRotator(dPitch, dYaw, dRoll), false);
+void ADroneFPCharacter::StopBlackbox()
+{
+	Blackbox.Stop();
 }
 
-FVector ADroneFPCharacter::ComputeTotalAcceleration(float DeltaTime)
+void ADroneFPCharacter::ResetPhysicsStateFromActor()
 {
-	const float SafeMass = FMath::Max(Mass, KINDA_SMALL_NUMBER);
+	if (bRecordingInputs)
+	{
+		// The log can't reproduce a teleport
+		UE_LOG(LogTemp, Warning, TEXT("Input recording stopped: the drone was moved from outside the flight model"));
+		StopInputRecording(TEXT("Interrupted"));
+	}
 
-	// --- Thrust (only when armed) ---
-	FVector ThrustAccel = FVector::ZeroVector;
-	if (bThrottleArmed)
+	FlightState.Position = ToFlight(GetActorLocation());
+	FlightState.Rotation = ToFlight(GetActorQuat());
+	FlightState.Velocity = ToFlight(Velocity);
+	PrevFlightState = FlightState;
+	RenderedLocation = GetActorLocation();
+	PhysicsAccumulator = 0.f;
+}
+
+FDroneInputSample ADroneFPCharacter::SampleSticks(double SimTime) const
+{
+	FDroneInputSample Sample;
+	Sample.Time = SimTime;
+	Sample.bArmed = bThrottleArmed;
+
+	// A streaming radio's calibrated sticks, or the Enhanced Input values ("+ = stick up/right")
+	if (AxisAgg && AxisAgg->HasDeviceSticks())
 	{
-		ThrustAccel = ComputeThrustAccel(DeltaTime);  // your function
+		AxisAgg->GetDeviceSticks(Sample.Sticks);
 	}
 	else
 	{
-		// Optionally: relax throttle when disarmed
-		ThrottleSmoothed = FMath::FInterpTo(ThrottleSmoothed, 0.f, DeltaTime, ThrustResponse);
+		Sample.Sticks[RcChannel::Roll] = RollInput;
+		Sample.Sticks[RcChannel::Pitch] = -PitchInput;
+		Sample.Sticks[RcChannel::Yaw] = YawInput;
+		Sample.Sticks[RcChannel::Throttle] = ThrottleInput;
+	}
+	return Sample;
+}
+
+void ADroneFPCharacter::ResetDeterministicInput(float Step)
+{
+	FRcAxisFilterSettings Settings[RcChannel::Num];
+	if (AxisAgg)
+	{
+		AxisAgg->GetRcFilterSettings(Settings);
+	}
+	DeterministicInput.Reset(Step, Settings);
+	DeterministicStep = Step;
+}
+
+void ADroneFPCharacter::StartInputRecording()
+{
+	const float Step = 1.f / FMath::Clamp(PhysicsRateHz, 250.f, 2000.f);
+
+	// Start clean so the log's first step sees exactly what a replay will
+	bDeterministic = true;
+	ResetDeterministicInput(Step);
+	StateChecksum = FlightChecksumSeed;
+
+	InputLog.Reset(Step, StepIndex, FlightState);
+	bRecordingInputs = true;
+	UE_LOG(LogTemp, Log, TEXT("Input recording started at step %lld (%.0f Hz)"), StepIndex, 1.f / Step);
+}
+
+bool ADroneFPCharacter::StopInputRecording(const FString& Name)
+{
+	if (!bRecordingInputs)
+	{
+		return false;
+	}
+	bRecordingInputs = false;
+
+	const bool bSaved = InputLog.SaveToFile(Name);
+	UE_LOG(LogTemp, Log, TEXT("Input recording: %d steps, %d samples, final checksum %08x -> %s%s"),
+		InputLog.Checksums.Num(), InputLog.Samples.Num(), StateChecksum,
+		*FDroneInputLog::GetLogPath(Name), bSaved ? TEXT("") : TEXT(" (write failed)"));
+	return bSaved;
+}
+
+bool ADroneFPCharacter::StartInputPlayback(const FDroneInputLog& Log)
+{
+	const float Step = 1.f / FMath::Clamp(PhysicsRateHz, 250.f, 2000.f);
+	if (Log.StepSeconds != Step)
+	{
+		UE_LOG(LogTemp, Error, TEXT("StartInputPlayback: the log was recorded at %.0f Hz, the drone runs at %.0f Hz"),
+			1.f / Log.StepSeconds, 1.f / Step);
+		return false;
+	}
+	StopInputRecording(TEXT("Interrupted"));
+
+	bDeterministic = true;
+	ResetDeterministicInput(Step);
+	StateChecksum = FlightChecksumSeed;
+
+	// Same step-relative timing as when it was recorded, from our current step on
+	const double TimeShift = (double)(StepIndex - Log.FirstStep) * Step;
+	for (FDroneInputSample Sample : Log.Samples)
+	{
+		Sample.Time += TimeShift;
+		DeterministicInput.Push(Sample);
+	}
+
+	FlightState = Log.InitialState;
+	PrevFlightState = FlightState;
+	Velocity = ToVector(FlightState.Velocity);
+	PhysicsAccumulator = 0.f;
+	Health = MaxHealth;
+	ApplyInterpolatedTransform(0.f);
+
+	PlaybackEndStep = StepIndex + Log.Checksums.Num();
+	bPlayingInputs = true;
+	return true;
+}
+
+bool ADroneFPCharacter::VerifyInputLog(const FString& Name)
+{
+	FDroneInputLog Log;
+	if (!Log.LoadFromFile(Name))
+	{
+		UE_LOG(LogTemp, Error, TEXT("VerifyInputLog: can't read %s"), *FDroneInputLog::GetLogPath(Name));
+		return false;
+	}
+
+	const float Step = 1.f / FMath::Clamp(PhysicsRateHz, 250.f, 2000.f);
+	if (Log.StepSeconds != Step)
+	{
+		UE_LOG(LogTemp, Error, TEXT("VerifyInputLog: %s was recorded at %.0f Hz, the drone runs at %.0f Hz"),
+			*Name, 1.f / Log.StepSeconds, 1.f / Step);
+		return false;
+	}
+
+	UpdateRateTable();
+	const FFlightParams Params = MakeFlightParams();
+	FDroneCapsuleCollision Collision(GetCapsuleComponent());
+	Collision.SetProximityField(ProximityCache ? ProximityCache->GetField() : nullptr);
+
+	FRcAxisFilterSettings Settings[RcChannel::Num];
+	if (AxisAgg)
+	{
+		AxisAgg->GetRcFilterSettings(Settings);
+	}
+	FDroneDeterministicInput Replay;
+	Replay.Reset(Step, Settings);
+	for (const FDroneInputSample& Sample : Log.Samples)
+	{
+		Replay.Push(Sample);
 	}
 
-	// --- Gravity (as acceleration) ---
-	const float GravityZ = GetWorld() ? GetWorld()->GetGravityZ() : -980.f; // cm/s^2
-	const FVector GravityAccel(0.f, 0.f, GravityZ);
+	// Same steps as Tick, on a copy of the state
+	const FFlightFloatEnvironment FloatEnvironment;
+	FFlightState State = Log.InitialState;
+	uint32 Checksum = FlightChecksumSeed;
+	for (int32 i = 0; i < Log.Checksums.Num(); ++i)
+	{
+		const FFlightInput Input = Replay.Consume(Log.FirstStep + i);
+		Collision.BeginStep();
+		StepFlightModel(State, Params, Input, Step, &Collision);
 
-	// --- Drag ---
-	const FVector DragForce = -DragCoeff * Velocity;
-	const FVector DragAccel = DragForce / SafeMass;
+		Checksum = HashFlightState(State, Checksum);
+		if (Checksum != Log.Checksums[i])
+		{
+			UE_LOG(LogTemp, Error, TEXT("VerifyInputLog: %s diverges at step %d of %d (%08x, recorded %08x), position (%.3f, %.3f, %.3f)"),
+				*Name, i, Log.Checksums.Num(), Checksum, Log.Checksums[i], State.Position.X, State.Position.Y, State.Position.Z);
+			return false;
+		}
+	}
 
-	// Total acceleration
-	return ThrustAccel + GravityAccel + DragAccel;
+	UE_LOG(LogTemp, Display, TEXT("VerifyInputLog: %s matches over %d steps (%08x)"), *Name, Log.Checksums.Num(), Checksum);
+	return true;
 }
 
-void ADroneFPCharacter::IntegrateMovement(float DeltaTime, const FVector& Accel)
+void ADroneFPCharacter::ApplyInterpolatedTransform(float Alpha)
 {
-	// Integrate velocity
-	Velocity += Accel * DeltaTime;
+	const FVector Location = FMath::Lerp(ToVector(PrevFlightState.Position), ToVector(FlightState.Position), Alpha);
+	const FQuat Rotation = FQuat::Slerp(ToQuat(PrevFlightState.Rotation), ToQuat(FlightState.Rotation), Alpha);
 
-	// Integrate position
-	const FVector Delta = Velocity * DeltaTime;
+	// Collision was already resolved by the substep sweeps
+	SetActorLocationAndRotation(Location, Rotation, /*bSweep=*/false);
+	RenderedLocation = GetActorLocation();
+}
 
-	FHitResult Hit;
-	AddActorWorldOffset(Delta, /*bSweep=*/true, &Hit);
+void ADroneFPCharacter::ApplyLateLatch(FMinimalViewInfo& View)
+{
+	SCOPE_CYCLE_COUNTER(STAT_DroneLateLatch);
 
-	if (!Hit.IsValidBlockingHit())
+	// The last step is PhysicsAccumulator behind the clock as of the end of Tick, plus whatever ran since
+	const float Step = 1.f / FMath::Clamp(PhysicsRateHz, 250.f, 2000.f);
+	const float Horizon = FMath::Min(PhysicsAccumulator + (float)(FPlatformTime::Seconds() - LateLatchBaseSeconds), MaxLateLatchMs * 0.001f);
+	if (Horizon <= 0.f)
 	{
 		return;
 	}
 
-	// Prefer ImpactNormal for the surface normal
-	const FVector SurfaceNormal = Hit.ImpactNormal.IsNearlyZero()
-		? Hit.Normal.GetSafeNormal()
-		: Hit.ImpactNormal.GetSafeNormal();
+	// Free flight on a copy: the view only takes the orientation, the position stays where the sweeps put it
+	const FFlightParams Params = MakeFlightParams();
+	FFlightState Latched = FlightState;
+	for (float Remaining = Horizon; Remaining > KINDA_SMALL_NUMBER; Remaining -= Step)
+	{
+		StepFlightModel(Latched, Params, LateLatchInput, FMath::Min(Step, Remaining), nullptr);
+	}
+
+	// Turn the view about the drone by whatever separates the shown pose from the latched one
+	const FQuat Correction = ToQuat(Latched.Rotation) * GetActorQuat().Inverse();
+	const FVector Pivot = GetActorLocation();
+	View.Location = Pivot + Correction.RotateVector(View.Location - Pivot);
+	View.Rotation = (Correction * View.Rotation.Quaternion()).Rotator();
+
+	SET_FLOAT_STAT(STAT_DroneLateLatchDegrees, FMath::RadiansToDegrees(Correction.GetAngle()));
+}
 
-	// Remove into-surface velocity (prevents tunneling / pogo)
-	const float Vn = FVector::DotProduct(Velocity, SurfaceNormal);
-	if (Vn < 0.f)
+void ADroneFPCharacter::UpdateCameraTilt()
+{
+	// Every SetRelativeRotation re-transforms the camera; the tilt is a setting, not per frame
+	if (IsLocallyControlled() && CameraTiltPivot && CameraTiltDegrees != AppliedCameraTiltDegrees)
 	{
-		Velocity -= SurfaceNormal * Vn;
+		CameraTiltPivot->SetUsingAbsoluteRotation(false);
+		CameraTiltPivot->SetRelativeRotation(FRotator(CameraTiltDegrees, 0.f, 0.f));
+		AppliedCameraTiltDegrees = CameraTiltDegrees;
 	}
+}
 
-	// Ground-ish behavior: don't "launch" from tiny penetrations
-	if (SurfaceNormal.Z > 0.6f)
+void ADroneFPCharacter::SmoothInputs(
+	float DeltaTime,
+	float& OutPitchCmd,
+	float& OutRollCmd,
+	float& OutYawCmd)
+{
+	// Stick smoothing runs in the aggregator's RC filter chain: at report rate when a
+	// calibrated radio is streaming, otherwise once per frame on the Enhanced Input values.
+	if (AxisAgg)
 	{
-		// Apply friction to lateral velocity only (so you can still lift)
-		FVector Lateral(Velocity.X, Velocity.Y, 0.f);
-		constexpr float GroundFriction = 3.f; // tune 0..8
-		Lateral = FMath::VInterpTo(Lateral, FVector::ZeroVector, DeltaTime, GroundFriction);
-		Velocity.X = Lateral.X;
-		Velocity.Y = Lateral.Y;
+		// Filter convention is "+ = stick up/right"; forward stick is nose down here
+		const float Sticks[RcChannel::Num] = { RollInput, -PitchInput, YawInput, ThrottleInput };
+		AxisAgg->PushLogicalSticks(Sticks, DeltaTime);
+
+		const FRcStickState& Filtered = AxisAgg->GetFilteredSticks();
+		RollInputSmoothed = Filtered.GetCommand(RcChannel::Roll);
+		PitchInputSmoothed = -Filtered.GetCommand(RcChannel::Pitch);
+		YawInputSmoothed = Filtered.GetCommand(RcChannel::Yaw);
+		Throttle01 = FMath::Clamp(Filtered.GetCommand(RcChannel::Throttle), 0.f, 1.f);
 	}
+	else
+	{
+		RollInputSmoothed = RollInput;
+		PitchInputSmoothed = PitchInput;
+		YawInputSmoothed = YawInput;
+		Throttle01 = ThrottleInput;
+	}
+
+	// Rates are applied per substep by the flight core (RateTable)
+	OutPitchCmd = FMath::Clamp(PitchInputSmoothed, -1.f, 1.f);
+	OutRollCmd = FMath::Clamp(RollInputSmoothed, -1.f, 1.f);
+	OutYawCmd = FMath::Clamp(YawInputSmoothed, -1.f, 1.f);
 
-	HandleImpactDamage(Hit);
+	RECORD_DRONE_TELEMETRY(TelemetryRawPitch, PitchInput);
+	RECORD_DRONE_TELEMETRY(TelemetryPitchSmoothed, PitchInputSmoothed);
+	RECORD_DRONE_TELEMETRY(TelemetryPitchCmd, OutPitchCmd);
+	RECORD_DRONE_TELEMETRY(TelemetryRollCmd, OutRollCmd);
+	RECORD_DRONE_TELEMETRY(TelemetryYawCmd, OutYawCmd);
 }
 
-void ADroneFPCharacter::HandleImpactDamage(const FHitResult& Hit)
+void ADroneFPCharacter::HandleImpactDamage(const FHitResult& Hit, float ImpactSpeedCm)
 {
 	if (!Hit.IsValidBlockingHit()) return;
 	if (Health <= 0.f) return;
-	if (Hit.GetActor() && Hit.GetActor()->GetName().Contains(TEXT("FoliageActor")))
-	{
-		bool HitFoliage = true;
-	}
 	const FVector Normal = Hit.Normal.GetSafeNormal();
 
-	// Velocity is in cm/s. We want component INTO the surface.
-	const float Vn = FVector::DotProduct(Velocity, Normal);
-	const float ImpactSpeedCm = FMath::Max(-Vn, 0.f); // only if moving into the surface
+	// ImpactSpeedCm is the speed into the surface before the contact response (Velocity is
+	// already the bounced/slid velocity here), so Vn is only kept for the logs
+	const float Vn = -ImpactSpeedCm;
 	// Convert to m/s for energy calculation
 	const float ImpactSpeedM = ImpactSpeedCm / 100.f;
 
@@ -550,10 +1051,10 @@ void ADroneFPCharacter::HandleImpactDamage(const FHitResult& Hit)
 	// Hardness multiplier based on what we hit (1.0 = neutral)
 	const float Hardness = GetSurfaceHardness(Hit);
 
-	if (ImpactSpeedCm <= KINDA_SMALL_NUMBER)
+	if (IsRestingImpact(ImpactSpeedCm))
 	{
-		// Always log (so we can see why Damage might be 0)
-		UE_LOG(LogTemp, Warning,
+		// Fires every substep while resting on something, so keep it out of the default log
+		UE_LOG(LogTemp, VeryVerbose,
 			TEXT("IMPACT DEBUG Grazing | Mass= %.3f | Normal=%s | Vel=%s | Vn=%.3f | ImpactSpeed=%.3f cm/s (%.8f m/s) | Energy=%.6f | Hardness=%.3f "),
 			Mass,
 			*Normal.ToString(),
@@ -565,7 +1066,7 @@ void ADroneFPCharacter::HandleImpactDamage(const FHitResult& Hit)
 			Hardness
 		);
 
-		UE_LOG(LogTemp, Warning,
+		UE_LOG(LogTemp, VeryVerbose,
 			TEXT("Grazing Impact"));
 		return; // grazing / sliding, no real impact
 	}
@@ -579,8 +1080,8 @@ void ADroneFPCharacter::HandleImpactDamage(const FHitResult& Hit)
 
 	const float Damage = Damage01 * MaxDamagePerImpact * Hardness;
 
-	// Always log (so we can see why Damage might be 0)
-	UE_LOG(LogTemp, Warning,
+	// Verbose: shows why Damage might be 0 without flooding the log on every bump
+	UE_LOG(LogTemp, Verbose,
 		TEXT("IMPACT DEBUG DirectHit | Mass= %.3f | Normal=%s | Vel=%s | Vn=%.3f | ImpactSpeed=%.3f cm/s (%.6f m/s) | Energy=%.8f | Hardness=%.3f | Damage01=%.3f | Damage=%.3f | Health=%.1f/%.1f"),
 		Mass,
 		*Normal.ToString(),
@@ -605,96 +1106,11 @@ void ADroneFPCharacter::HandleImpactDamage(const FHitResult& Hit)
 	}
 }
 
-void DebugHit(const FHitResult& Hit)
-{
-	UE_LOG(LogTemp, Warning,
-		TEXT("HIT DEBUG\n Actor=%s\n Comp=%s\n Class=%s\n Instance=%d\n ImpactPoint=%s\n ImpactNormal=%s"),
-		*GetNameSafe(Hit.GetActor()),
-		*GetNameSafe(Hit.GetComponent()),
-		Hit.GetActor() ? *Hit.GetActor()->GetClass()->GetName() : TEXT("None"),
-		Hit.Item,
-		*Hit.ImpactPoint.ToString(),
-		*Hit.ImpactNormal.ToString()
-	);
-}
-
-FVector ADroneFPCharacter::ComputeThrustAccel(float DeltaTime)
+bool ADroneFPCharacter::IsRestingImpact(float ImpactSpeedCm) const
 {
-	// 1) Smooth throttle (unchanged)
-	ThrottleSmoothed = FMath::FInterpTo(
-		ThrottleSmoothed,
-		Throttle01,
-		DeltaTime,
-		ThrustResponse
-	);
-
-	// 2) Map throttle around hover into t in [-1, +1]
-	float t = 0.f;
-
-	if (ThrottleSmoothed >= HoverThrottle)
-	{
-		// scale [HoverThrottle..1] -> [0..1]
-		t = (ThrottleSmoothed - HoverThrottle) /
-			FMath::Max(1e-3f, (1.f - HoverThrottle));
-	}
-	else
-	{
-		// scale [0..HoverThrottle] -> [-1..0]
-		t = (ThrottleSmoothed - HoverThrottle) /
-			FMath::Max(1e-3f, HoverThrottle);
-	}
-
-	// 3) Expo shaping around hover
-	const float Sign = (t >= 0.f) ? 1.f : -1.f;
-	const float Mag = FMath::Pow(FMath::Abs(t), ThrustExpo);
-	const float Shaped = Sign * Mag;   // in [-1 .. +1]
-
-	// 4) Convert shaped value into an UPWARD acceleration
-
-	// Gravity is negative in UE (e.g. -980 cm/s^2)
-	const float GravityZ = GetWorld()->GetGravityZ();
-	const float HoverAccel = -GravityZ;                 // +g  (about 980 cm/s^2)
-
-	const float MaxUpAccel = HoverAccel * MaxThrustG;   // e.g. 2g at full throttle
-	const float MinUpAccel = 0.f;                       // no thrust
-
-	float UpAccel = HoverAccel; // default at shaped=0 (hover)
-
-	if (Shaped >= 0.f)
-	{
-		// Shaped in [0..1] → lerp from HoverAccel to MaxUpAccel
-		UpAccel = FMath::Lerp(HoverAccel, MaxUpAccel, Shaped);
-	}
-	else
-	{
-		// Shaped in [-1..0] → lerp from MinUpAccel to HoverAccel
-		// remap [-1..0] -> [0..1]
-		const float Alpha = Shaped + 1.f;  // -1→0, 0→1
-		UpAccel = FMath::Lerp(MinUpAccel, HoverAccel, Alpha);
-	}
-	const float NetZ = UpAccel + GravityZ;          // thrust + gravity
-	// Read current vertical velocity (if you track it):
-	float VelocityZ = 0.f;
-	if (Velocity.IsNearlyZero() == false)
-	{
-		VelocityZ = Velocity.Z;
-	}
-	float Altitude = GetActorLocation().Z;
-
-	UE_LOG(LogTemp, Warning,
-		TEXT("THRUST DEBUG | Thr=%.3f Sm=%.3f Hover=%.3f Shaped=%.3f | Up=%.1f Grav=%.1f Net=%.1f | VelZ=%.1f AltZ=%.1f"),
-		Throttle01,
-		ThrottleSmoothed,
-		HoverThrottle,
-		Shaped,
-		UpAccel,
-		GravityZ,
-		NetZ,
-		VelocityZ,
-		Altitude
-	);
-	// 5) Return thrust acceleration along the drone's Up axis
-	return GetActorUpVector() * UpAccel;
+	// Sitting on a surface still closes the contact gap at a few cm/s every step; below the
+	// bounce threshold the flight core treats it as resting too
+	return ImpactSpeedCm < FMath::Max(BounceMinSpeed, KINDA_SMALL_NUMBER);
 }
 
 float ADroneFPCharacter::GetSurfaceHardness(const FHitResult& Hit) const
@@ -747,9 +1163,19 @@ void ADroneFPCharacter::OnDroneDestroyed()
 {
 	UE_LOG(LogTemp, Warning, TEXT("Drone destroyed!"));
 
+	if (bRecordingInputs)
+	{
+		// The crash response below happens outside StepFlightModel, which is all a replay runs,
+		// so the log ends with the last step before it (this step's checksum isn't added yet)
+		UE_LOG(LogTemp, Warning, TEXT("Input recording stopped: the drone crashed"));
+		StopInputRecording(TEXT("Interrupted"));
+	}
+
 	// Simple behavior: disarm and stop
 	bThrottleArmed = false;
 	Velocity = FVector::ZeroVector;
+	FlightState.Velocity = FFlightVec3();
+	FlightState.AngularVelocity = FFlightVec3();
 
 	// You could also:
 	// - Enable SimulatePhysics on mesh and let it ragdoll
@@ -776,115 +1202,64 @@ void ADroneFPCharacter::Throttle(const FInputActionValue& Value)
 
 		// This takes your input (which is now roughly 0.0 to 1.0 thanks to the Scalar)
 		// and forces it to stay strictly within 0.0 and 1.0
-		ThrottleInput = FMath::Clamp(RawInput, 0.0f, 1.0f);
-
-		if (GEngine)
+		const float NewThrottle = FMath::Clamp(RawInput, 0.0f, 1.0f);
+		if (NewThrottle != ThrottleInput)
 		{
-			GEngine->AddOnScreenDebugMessage(1, 0.1f, FColor::Yellow,
-				FString::Printf(TEXT("Throttle: %.3f"), ThrottleInput));
+			FDroneLatency::StampInputEvent();
 		}
+		ThrottleInput = NewThrottle;
+		RECORD_DRONE_TELEMETRY(TelemetryThrottleEvent, ThrottleInput);
 	}
 }
 
 void ADroneFPCharacter::Yaw(const FInputActionValue& Value)
 {
-	YawInput = Value.Get<float>();
-	UE_LOG(LogTemp, Warning, TEXT("YawInput = %.3f"), YawInput);
-	if (GEngine)
+	const float NewYaw = Value.Get<float>();
+	if (NewYaw != YawInput)
 	{
-		GEngine->AddOnScreenDebugMessage(
-			2,                 // A unique Key (use -1 to stack messages, or a fixed number to overwrite)
-			0.1f,              // Time to display (keep short for real-time values)
-			FColor::Green,      // Text Color
-			FString::Printf(TEXT("Yaw Input: %.3f"), YawInput) // The formatted float
-		);
+		FDroneLatency::StampInputEvent();
 	}
+	YawInput = NewYaw;
+	RECORD_DRONE_TELEMETRY(TelemetryYawEvent, YawInput);
 }
 
 void ADroneFPCharacter::Pitch(const FInputActionValue& Value)
 {
 	// Standard Sim: Forward stick = Nose Down. 
 	// If your IMC doesn't have a 'Negate' modifier, do it here:
-	PitchInput = -Value.Get<float>();
-	UE_LOG(LogTemp, Warning, TEXT("PitchInput = %.3f"), PitchInput);
-	if (GEngine)
-	{
-		GEngine->AddOnScreenDebugMessage(
-			3,                 // A unique Key (use -1 to stack messages, or a fixed number to overwrite)
-			0.1f,              // Time to display (keep short for real-time values)
-			FColor::Cyan,      // Text Color
-			FString::Printf(TEXT("Pitch Input: %.3f"), PitchInput) // The formatted float
-		);
-	}
-}
-
-void ADroneFPCharacter::Roll(const FInputActionValue& Value)
-{
-	RollInput = Value.Get<float>();
-	UE_LOG(LogTemp, Warning, TEXT("RollInput = %.3f"), RollInput);
-	if (GEngine)
+	const float NewPitch = -Value.Get<float>();
+	if (NewPitch != PitchInput)
 	{
-		GEngine->AddOnScreenDebugMessage(
-			4,                 // A unique Key (use -1 to stack messages, or a fixed number to overwrite)
-			0.1f,              // Time to display (keep short for real-time values)
-			FColor::Magenta,      // Text Color
-			FString::Printf(TEXT("Roll Input: %.3f"), RollInput) // The formatted float
-		);
+		FDroneLatency::StampInputEvent();
 	}
+	PitchInput = NewPitch;
+	RECORD_DRONE_TELEMETRY(TelemetryPitchEvent, PitchInput);
 }
 
-static float Deadzone1D(float v, float dz = 0.1f)
-{
-	return (FMath::Abs(v) < dz) ? 0.f : v;
-}
-
-void ADroneFPCharacter::Move(const FInputActionValue& Value)
+void ADroneFPCharacter::Roll(const FInputActionValue& Value)
 {
-	const FVector2D Input = Value.Get<FVector2D>();
-	const float X = Deadzone1D(Input.X);
-	const float Y = Deadzone1D(Input.Y);
-
-	if (Controller && (FMath::Abs(X) > 0.f || FMath::Abs(Y) > 0.f))
-	{
-		const FRotator YawRot(0.f, Controller->GetControlRotation().Yaw, 0.f);
-		const FVector Forward = FRotationMatrix(YawRot).GetUnitAxis(EAxis::X);
-		const FVector Right = FRotationMatrix(YawRot).GetUnitAxis(EAxis::Y);
-
-		AddMovementInput(Forward, Y);
-		AddMovementInput(Right, X);
-	}
-
-	if (GEngine)
+	const float NewRoll = Value.Get<float>();
+	if (NewRoll != RollInput)
 	{
-		GEngine->AddOnScreenDebugMessage(
-			-1, 0.f, FColor::Green,
-			FString::Printf(TEXT("Move: X=%.2f Y=%.2f"), X, Y));
+		FDroneLatency::StampInputEvent();
 	}
+	RollInput = NewRoll;
+	RECORD_DRONE_TELEMETRY(TelemetryRollEvent, RollInput);
 }
 
-void ADroneFPCharacter::Look(const FInputActionValue& Value)
+void ADroneFPCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	const FVector2D Input = Value.Get<FVector2D>();
-	const float X = Deadzone1D(Input.X);
-	const float Y = Deadzone1D(Input.Y);
-
-	AddControllerYawInput(X);
-	AddControllerPitchInput(Y);
-
-	if (GEngine)
+	if (UControllerCalibrationStore* Store = GetCalibrationStore())
 	{
-		GEngine->AddOnScreenDebugMessage(
-			-1, 0.f, FColor::Cyan,
-			FString::Printf(TEXT("Look: X=%.2f Y=%.2f"), X, Y));
+		Store->OnProfileLoaded.RemoveAll(this);
 	}
-}
 
-void ADroneFPCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
-{
 #if PLATFORM_WINDOWS
 	FDjiHidReader::Get().Stop();
 #endif
 
+	Blackbox.Stop();
+
 	Super::EndPlay(EndPlayReason);
 }
 void ADroneFPCharacter::PossessedBy(AController* NewController)
@@ -1,22 +1,56 @@
 #pragma once
 
 #include "CoreMinimal.h"
-#include "GameFramework/Character.h"
+#include "GameFramework/Pawn.h"
 #include "InputAction.h"
 #include "InputActionValue.h"
 #include "InputMappingContext.h"
-#include "Components/SkeletalMeshComponent.h"
 #include "ControllerAxisAggregatorComponent.h"
 #include "GenericHidInputComponent.h"
+#include "FlightCore/FlightModel.h"
+#include "DroneInputLog.h"
+#include "DroneBlackbox.h"
 #include "DroneFPCharacter.generated.h"
 
 class UCameraComponent;
+class UCapsuleComponent;
 class UInputAction;
 class USceneComponent;
-class USkeletalMeshComponent;
+class UStaticMeshComponent;
 class UDroneControllerCalibrationWidget;
+class FDroneCapsuleCollision;
+struct FDroneFlightProfile;
+
+/** Betaflight rate models; the RcRate / SuperRate fields change meaning with the model (see FFlightAxisRates). */
+UENUM(BlueprintType)
+enum class EDroneRatesType : uint8
+{
+    Betaflight,
+    Actual,
+    Quick
+};
+
+UENUM(BlueprintType)
+enum class EDroneFlightMode : uint8
+{
+    Acro,
+    Angle,
+    Horizon
+};
+
+UENUM(BlueprintType)
+enum class EDroneIntegrator : uint8
+{
+    ExplicitEuler,
+    SemiImplicitEuler,
+    Verlet,
+    RK4
+};
 /**
- * Physics-based first-person drone character, DJI Mode 2 controls.
+ * Physics-based first-person drone, DJI Mode 2 controls.
+ *
+ * A plain APawn: capsule root (swept by the flight model), camera pivot and a visual mesh.
+ * No movement component or skeleton; FlightCore moves the actor.
  *
  * Left Stick:
  *   Y: Throttle (up/down)
@@ -27,7 +61,7 @@ class UDroneControllerCalibrationWidget;
  *   X: Roll (bank left/right, rotation about longitudinal axis)
  */
 UCLASS()
-class DRONERACERFP_API ADroneFPCharacter : public ACharacter
+class DRONERACERFP_API ADroneFPCharacter : public APawn
 {
     GENERATED_BODY()
 
@@ -36,12 +70,22 @@ public:
 
     virtual void Tick(float DeltaTime) override;
 
+    UCapsuleComponent* GetCapsuleComponent() const { return CapsuleComponent; }
+
 protected:
     virtual void BeginPlay() override;
     virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
     virtual void CalcCamera(float DeltaTime, FMinimalViewInfo& OutResult) override;
 
+    /** Root and collision shape. Keeps ACharacter's subobject name so existing overrides still load. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+    UCapsuleComponent* CapsuleComponent;
+
+    /** What other pilots, ghosts and replays see; an engine cube by default. Hidden from this drone's own FPV camera. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
+    UStaticMeshComponent* DroneMesh;
+
     /** First person camera */
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Components")
     UCameraComponent* FirstPersonCamera;
@@ -69,12 +113,6 @@ protected:
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Input")
     UInputMappingContext* DefaultMappingContext;
 
-    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Input")
-    UInputAction* IA_Move;
-
-    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Input")
-    UInputAction* IA_Look;
-
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Input")
     UInputAction* IA_StartCalibration=nullptr;
 
@@ -84,6 +122,17 @@ protected:
     UPROPERTY(VisibleAnywhere, Category = "Camera")
     USceneComponent* CameraTiltPivot;
 
+    /**
+     * Right before the view is finalized, steps a copy of the flight state up to the current time with
+     * the latest commands and shows that orientation. Only the view turns; the actor stays put.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera|FPV")
+    bool bLateLatchCamera = false;
+
+    /** Predictions are capped here so a hitch doesn't swing the view. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Camera|FPV", meta = (ClampMin = "0", ClampMax = "50"))
+    float MaxLateLatchMs = 20.f;
+
     UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "UI", meta = (AllowPrivateAccess = "true"))
     TSubclassOf<UUserWidget> CalibrationWidgetClass;
 
@@ -114,16 +163,11 @@ protected:
     float RollInput = 0.f;
 
     // ===== Physical parameters =====
-    //SMOOTHING OF INPUTS
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Flight|Input")
-    float ThrottleSmoothSpeed = 5.f; // how quickly we follow stick
+    // Stick smoothing lives in AxisAgg's RC filter chain (RcSmoothing settings)
 
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Input")
     UGenericHidInputComponent* GenericHid;
 
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Flight|Input")
-    float RotSmoothSpeed = 8.f;
-
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Flight|Input")
     float PitchInputSmoothed = 0.f;
 
@@ -138,10 +182,6 @@ protected:
     float Mass = .7f;
 
 
-    // Thrust/hover tuning
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Flight|Thrust")
-    float MaxThrustAccel = 2500.f;   // cm/s^2 at full throttle (tune 1500-6000)
-
     // Full stick up gives this many "g's" upward.
 // 2.0f means full throttle = 2g up (nice DJI-ish feeling).
     UPROPERTY(EditAnywhere, Category = "Flight|Thrust")
@@ -156,14 +196,21 @@ protected:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Flight|Thrust")
     float ThrustResponse = 1.0f;     // smoothing rate (bigger = snappier)
 
+    // Rates, in the units the Betaflight configurator shows for the selected model:
+    //   Betaflight: RC Rate 1.00, Super Rate 0.70, Expo 0.00
+    //   Actual:     RcRate = center sensitivity (deg/s), SuperRate = max rate (deg/s)
+    //   Quick:      RC Rate 1.00, SuperRate = max rate (deg/s)
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Flight|Rates")
-    float PitchExpo = 0.7f;
+    EDroneRatesType RatesType = EDroneRatesType::Betaflight;
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Flight|Rates")
-    float RollExpo = 0.7f;
+    float PitchExpo = 0.0f;
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Flight|Rates")
-    float YawExpo = 0.7f;
+    float RollExpo = 0.0f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Flight|Rates")
+    float YawExpo = 0.0f;
 
     // Base sensitivity
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Flight|Rates")
@@ -177,37 +224,177 @@ protected:
 
     // End-of-stick acceleration
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Flight|Rates")
-    float PitchSuperRate = 1.0f;
+    float PitchSuperRate = 0.7f;
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Flight|Rates")
-    float RollSuperRate = 1.0f;
+    float RollSuperRate = 0.7f;
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Flight|Rates")
-    float YawSuperRate = 1.0f;
+    float YawSuperRate = 0.7f;
 
-    // Smoothed throttle used by physics
-    float ThrottleSmoothed = 0.f;
+    /** Setpoint clamp on every axis (deg/s), Betaflight's rate_limit */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Flight|Rates", meta = (ClampMin = "0.0", Units = "deg/s"))
+    float RateLimit = 1998.f;
 
+    /** Paste the output of the Betaflight CLI "dump" or "diff" here; the rates in it are applied at BeginPlay. */
+    UPROPERTY(EditAnywhere, Category = "Flight|Rates", meta = (MultiLine = "true"))
+    FString BetaflightRatesDump;
 
-    /** Linear drag coefficient */
+    /** Takes the rates from Betaflight CLI output (selected rate profile) into the properties above. */
+    UFUNCTION(BlueprintCallable, Category = "Flight|Rates")
+    bool ImportBetaflightRates(const FString& CliDump);
+
+    /** Linear drag coefficient, on airspeed (props and low-speed losses) */
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flight|Physics")
     float DragCoeff = 1.0f;
 
-    /** Pitch rate (deg/s) at full stick */
-    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flight|Physics")
-    float PitchRateDeg =360.0f;
+    /** Quadratic drag: Cd * area (cm^2) seen by airflow along body X (frontal), Y (side) and Z (top). 0 = linear drag only */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flight|Physics", meta = (ClampMin = "0.0"))
+    FVector DragArea = FVector(90.f, 110.f, 250.f);
 
-    /** Roll rate (deg/s) at full stick */
+    /** Baked wind to fly in; the first one in the level when left empty. */
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flight|Physics")
-    float RollRateDeg = 360.0f;
+    class ADroneWindField* WindField = nullptr;
+
+    /** Sweeps per substep: after a hit the drone slides/bounces on with what's left of the substep */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flight|Physics", meta = (ClampMin = "1", ClampMax = "16"))
+    int32 MaxSlideIterations = 4;
+
+    /** Impacts slower than this (cm/s, into the surface) don't bounce; restitution and friction come from the hit's physical material */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flight|Physics", meta = (ClampMin = "0.0", Units = "cm/s"))
+    float BounceMinSpeed = 150.f;
+
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
     UControllerAxisAggregatorComponent* AxisAgg;
 
-    /** Yaw rate (deg/s) at full stick */
-    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flight|Physics")
-    float YawRateDeg = 180.0f;
+    /** Diagonal of the body inertia tensor (kg*cm^2): roll, pitch, yaw axes. A 5" racer is roughly (25, 25, 45). */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flight|RigidBody")
+    FVector Inertia = FVector(25.f, 25.f, 45.f);
 
-    /** Current world-space velocity of the drone (cm/s) */
+    /** Motor offset from the center along each body axis (cm), X frame */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flight|RigidBody", meta = (ClampMin = "1.0", Units = "cm"))
+    float ArmLength = 8.f;
+
+    /** Prop drag torque per unit of thrust (cm); sets yaw authority */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flight|RigidBody", meta = (ClampMin = "0.1"))
+    float YawTorqueCoeff = 1.5f;
+
+    /** Motor lag: time constant from command to thrust when spinning up / down */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flight|RigidBody", meta = (ClampMin = "0.0", Units = "s"))
+    float MotorSpinUpTime = 0.02f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flight|RigidBody", meta = (ClampMin = "0.0", Units = "s"))
+    float MotorSpinDownTime = 0.035f;
+
+    // ===== Simulated flight controller =====
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Flight|PID")
+    EDroneFlightMode FlightMode = EDroneFlightMode::Acro;
+
+    /** Firmware loop rate. Each physics substep runs the PID, mixer, motors and rotation this often. */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flight|PID", meta = (ClampMin = "1000", ClampMax = "8000", Units = "Hz"))
+    float PidLoopRateHz = 4000.f;
+
+    // Rate PID per axis (X = roll, Y = pitch, Z = yaw); see FFlightPidParams for units
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flight|PID")
+    FVector RatePidP = FVector(100.f, 100.f, 60.f);
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flight|PID")
+    FVector RatePidI = FVector(200.f, 200.f, 120.f);
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flight|PID")
+    FVector RatePidD = FVector(0.8f, 0.8f, 0.f);
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flight|PID")
+    FVector RatePidFF = FVector(1.f, 1.f, 0.5f);
+
+    /** Cutoff of the two D-term low-pass stages */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flight|PID", meta = (ClampMin = "10.0", Units = "Hz"))
+    float DTermCutoffHz = 100.f;
+
+    /** Angle / horizon: attitude at full stick */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flight|PID", meta = (ClampMin = "5.0", ClampMax = "85.0", Units = "deg"))
+    float AngleLimitDeg = 55.f;
+
+    /** Angle / horizon: how fast attitude errors are corrected (1/s) */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flight|PID", meta = (ClampMin = "0.5"))
+    float AngleStrength = 6.f;
+
+    /** Horizon: stick deflection at which self-levelling has faded out completely */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Flight|PID", meta = (ClampMin = "0.05", ClampMax = "1.0"))
+    float HorizonTransition = 0.75f;
+
+    /** Flight simulation rate. The frame rate only decides how many fixed steps run per frame. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Flight|Simulation", meta = (ClampMin = "250", ClampMax = "2000", Units = "Hz"))
+    float PhysicsRateHz = 1000.f;
+
+    /** Substeps allowed per frame; after a longer hitch the excess time is dropped instead of simulated in one burst. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Flight|Simulation", meta = (ClampMin = "1"))
+    int32 MaxSubstepsPerFrame = 64;
+
+    /** Translation integrator. Drone.Flight.BenchmarkIntegrators shows cost and drift per physics rate. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Flight|Simulation")
+    EDroneIntegrator Integrator = EDroneIntegrator::SemiImplicitEuler;
+
+    /**
+     * Bit-exact flight for replays, ghosts and CI: sticks are stamped on the simulation clock and
+     * consumed per fixed step, RC smoothing runs at the physics rate instead of the frame rate, the
+     * FP environment is pinned, and every step's state goes into a running checksum.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Flight|Simulation")
+    bool bDeterministic = false;
+
+    /**
+     * Starts logging deterministic inputs and checksums (turns bDeterministic on). A crash or a
+     * teleport ends the recording early as "Interrupted", since a replay can't reproduce either.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Flight|Simulation")
+    void StartInputRecording();
+
+    /** Stops and writes Saved/FlightLogs/<Name>.dinput. */
+    UFUNCTION(BlueprintCallable, Category = "Flight|Simulation")
+    bool StopInputRecording(const FString& Name);
+
+    UFUNCTION(BlueprintPure, Category = "Flight|Simulation")
+    bool IsRecordingInputs() const { return bRecordingInputs; }
+
+    /**
+     * Re-runs a recorded log from its start state with the current tuning and this level's collision,
+     * without touching the drone, and compares the checksum after every step. True if all match.
+     */
+    UFUNCTION(BlueprintCallable, Category = "Flight|Simulation")
+    bool VerifyInputLog(const FString& Name);
+
+    /** Running checksum of the flight state, updated every step in deterministic mode. */
+    UFUNCTION(BlueprintPure, Category = "Flight|Simulation")
+    int64 GetStateChecksum() const { return StateChecksum; }
+
+    /**
+     * Flies a recorded log from its start state with full health, in deterministic mode, ignoring the
+     * live sticks until its last step. False if it was recorded at another physics rate.
+     */
+    bool StartInputPlayback(const FDroneInputLog& Log);
+    void StopInputPlayback() { bPlayingInputs = false; }
+    bool IsPlayingInputs() const { return bPlayingInputs; }
+
+    /** Step count, step time and sweeps are added to Profile while it is set (benchmarks). */
+    void SetFlightProfile(FDroneFlightProfile* Profile) { FlightProfile = Profile; }
+
+    /** Records every physics step (sticks, commands, motors, pose, health, impacts) to Saved/Blackbox from BeginPlay. */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Flight|Blackbox")
+    bool bRecordBlackbox = false;
+
+    /** Starts the flight recorder into Saved/Blackbox/<Name>.dbbx; an empty name uses a timestamp. */
+    UFUNCTION(BlueprintCallable, Category = "Flight|Blackbox")
+    bool StartBlackbox(const FString& Name);
+
+    UFUNCTION(BlueprintCallable, Category = "Flight|Blackbox")
+    void StopBlackbox();
+
+    UFUNCTION(BlueprintPure, Category = "Flight|Blackbox")
+    bool IsBlackboxRecording() const { return Blackbox.IsRecording(); }
+
+    /** Current world-space velocity of the drone (cm/s), mirrored from the flight state each substep */
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Flight|Physics")
     FVector Velocity = FVector::ZeroVector;
 
@@ -231,6 +418,15 @@ protected:
     UFUNCTION()
     void OnGenericHidAxesUpdated(const FGenericHidDeviceAxes& Axes);
 
+    void OnGenericHidDeviceConnected(const FGenericHidDeviceAxes& Device);
+    void OnGenericHidReport(const FString& DeviceId, TArrayView<const float> Axes);
+    void OnCalibrationProfileLoaded(const FString& DeviceId, bool bFound);
+
+    /** Applies the stored profile for AxisAgg's device (or the most recent one) before we fly. */
+    void ApplyStoredCalibration();
+    void SaveCurrentCalibration();
+    class UControllerCalibrationStore* GetCalibrationStore() const;
+
 
 
     // ===== Input handlers (Enhanced Input) =====
@@ -240,10 +436,8 @@ protected:
     void Pitch(const FInputActionValue& Value);
     void Roll(const FInputActionValue& Value);
 
-    void Move(const FInputActionValue& Value);
-    void Look(const FInputActionValue& Value);
-
-    void HandleImpactDamage(const FHitResult& Hit);
+    void HandleImpactDamage(const FHitResult& Hit, float ImpactSpeedCm);
+    bool IsRestingImpact(float ImpactSpeedCm) const;
     float GetSurfaceHardness(const FHitResult& Hit) const;
     void ApplyDamageToDrone(float DamageAmount);
     void OnDroneDestroyed();
@@ -260,15 +454,53 @@ private:
     void ApplyMappingContext();
     float Throttle01=0.f;
     bool bThrottleArmed = false;
-    FVector ComputeThrustAccel(float DeltaTime);
-    float PrevVelocity = 0.f;
     void UpdateCameraTilt();
+    float AppliedCameraTiltDegrees = TNumericLimits<float>::Max();   // last tilt pushed to the pivot
     void SmoothInputs(float DeltaTime, float& OutPitchCmd, float& OutRollCmd, float& OutYawCmd);
-    void UpdateOrientation(float DeltaTime, float PitchCmd, float RollCmd, float YawCmd);
-    FVector ComputeTotalAcceleration(float DeltaTime);
-    void IntegrateMovement(float DeltaTime, const FVector& Accel);
-    void DebugHit(const FHitResult& Hit);
-    void VelocityDebugPrint();
-    UPROPERTY(VisibleDefaultsOnly, Category = Mesh)
-    USkeletalMeshComponent* Mesh1P;
+
+    // Fixed-step flight. The model in FlightCore owns the pose; the actor only shows it.
+    FFlightParams MakeFlightParams() const;
+    void UpdateRateTable();
+    void StepFlight(float Step, const FFlightParams& Params, const FFlightInput& Input, FDroneCapsuleCollision& Collision);
+    void ResetPhysicsStateFromActor();
+    void ApplyInterpolatedTransform(float Alpha);
+    void ApplyLateLatch(FMinimalViewInfo& View);
+
+    FFlightInput LateLatchInput;        // commands of the last step
+    double LateLatchBaseSeconds = 0.0;  // wall clock when PhysicsAccumulator was last current
+
+    FFlightState FlightState;
+    FFlightState PrevFlightState;
+
+    /** Rate curves baked from the Flight|Rates properties; rebuilt when they change. */
+    FFlightRateTable RateTable;
+    bool bRateTableValid = false;
+    float PhysicsAccumulator = 0.f;
+
+    /** Baked clearance field of this world, if any; lets collision skip sweeps through open air. */
+    UPROPERTY(Transient)
+    class UDroneProximitySubsystem* ProximityCache = nullptr;
+
+    /** The level's ghost recorder / player, if it has one. */
+    UPROPERTY(Transient)
+    class ADroneGhostManager* GhostManager = nullptr;
+
+    // Deterministic mode
+    FDroneInputSample SampleSticks(double SimTime) const;
+    void ResetDeterministicInput(float Step);
+    FDroneDeterministicInput DeterministicInput;
+    float DeterministicStep = 0.f;   // step the input filter was configured for; 0 = needs a reset
+    int64 StepIndex = 0;
+    uint32 StateChecksum = 0;
+    bool bRecordingInputs = false;
+    FDroneInputLog InputLog;
+    bool bPlayingInputs = false;
+    int64 PlaybackEndStep = 0;
+    FDroneFlightProfile* FlightProfile = nullptr;
+
+    void RecordBlackboxStep(const FFlightInput& Input, const FFlightStepResult& Result, float HealthBefore);
+    FDroneBlackbox Blackbox;
+
+    /** Where we last put the actor; anything else means it was moved from outside. */
+    FVector RenderedLocation = FVector::ZeroVector;
 };
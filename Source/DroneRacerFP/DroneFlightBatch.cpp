@@ -0,0 +1,502 @@
+// DroneFlightBatch.cpp
+
+#include "DroneFlightBatch.h"
+#include "Async/ParallelFor.h"
+
+namespace
+{
+	using FBatchVec = VectorRegister4Float;
+
+	float BatchPt1Gain(float CutoffHz, float Dt)
+	{
+		const float Omega = 2.f * FlightPi * CutoffHz * Dt;
+		return Omega / (Omega + 1.f);
+	}
+
+	FORCEINLINE FBatchVec BatchClamp(const FBatchVec& V, const FBatchVec& Lo, const FBatchVec& Hi)
+	{
+		return VectorMin(VectorMax(V, Lo), Hi);
+	}
+
+	/** 0/1 float lanes <-> select masks. */
+	FORCEINLINE FBatchVec BatchToMask(const FBatchVec& Flags)
+	{
+		return VectorCompareGT(Flags, VectorSetFloat1(0.5f));
+	}
+
+	FORCEINLINE FBatchVec BatchFromMask(const FBatchVec& Mask)
+	{
+		return VectorSelect(Mask, VectorOneFloat(), VectorZeroFloat());
+	}
+}
+
+int32 FDroneFlightBatch::AddDrone(const FFlightState& Initial, float FloorZ)
+{
+	int32 Slot;
+	if (FreeSlots.Num() > 0)
+	{
+		Slot = FreeSlots.Pop(EAllowShrinking::No);
+		LiveSlots[Slot] = true;
+	}
+	else
+	{
+		if (NumSlots > SlotMask)
+		{
+			return INDEX_NONE;
+		}
+		Reserve(NumSlots + 1);
+		Slot = NumSlots++;
+		Generations.Add(0);
+		LiveSlots.Add(true);
+	}
+
+	const FFlightPidState& Pid = Initial.Pid;
+	const float Values[NumFields] =
+	{
+		Initial.Position.X, Initial.Position.Y, Initial.Position.Z,
+		Initial.Velocity.X, Initial.Velocity.Y, Initial.Velocity.Z,
+		Initial.Rotation.X, Initial.Rotation.Y, Initial.Rotation.Z, Initial.Rotation.W,
+		Initial.Position.X, Initial.Position.Y, Initial.Position.Z,
+		Initial.Rotation.X, Initial.Rotation.Y, Initial.Rotation.Z, Initial.Rotation.W,
+		Initial.AngularVelocity.X, Initial.AngularVelocity.Y, Initial.AngularVelocity.Z,
+		Initial.MotorThrust[0], Initial.MotorThrust[1], Initial.MotorThrust[2], Initial.MotorThrust[3],
+		Initial.ThrottleSmoothed,
+		Pid.ITerm.X, Pid.ITerm.Y, Pid.ITerm.Z,
+		Pid.PrevGyro.X, Pid.PrevGyro.Y, Pid.PrevGyro.Z,
+		Pid.DTermLpf1.X, Pid.DTermLpf1.Y, Pid.DTermLpf1.Z,
+		Pid.DTermLpf2.X, Pid.DTermLpf2.Y, Pid.DTermLpf2.Z,
+		Pid.PrevSetpoint.X, Pid.PrevSetpoint.Y, Pid.PrevSetpoint.Z,
+		Pid.Feedforward.X, Pid.Feedforward.Y, Pid.Feedforward.Z,
+		Pid.bSaturated ? 1.f : 0.f,
+		0.f, 0.f, 0.f,          // sticks
+		0.f,                    // throttle
+		0.f,                    // disarmed until the first SetInput
+		FloorZ,
+		0.f, 0.f, 0.f,          // setpoint
+		0.f
+	};
+
+	for (int32 F = 0; F < NumFields; ++F)
+	{
+		Field((EField)F)[Slot] = Values[F];
+	}
+	return ((int32)Generations[Slot] << SlotBits) | Slot;
+}
+
+int32 FDroneFlightBatch::ToSlot(int32 Handle) const
+{
+	if (Handle < 0)
+	{
+		return INDEX_NONE;
+	}
+	const int32 Slot = Handle & SlotMask;
+	return Slot < NumSlots && LiveSlots[Slot] && Generations[Slot] == (Handle >> SlotBits) ? Slot : INDEX_NONE;
+}
+
+bool FDroneFlightBatch::IsValidHandle(int32 Handle) const
+{
+	return ToSlot(Handle) != INDEX_NONE;
+}
+
+void FDroneFlightBatch::RemoveDrone(int32 Handle)
+{
+	const int32 Slot = ToSlot(Handle);
+	if (Slot == INDEX_NONE)
+	{
+		return;
+	}
+
+	// Parked: disarmed and resting where it is, so stepping the slot costs nothing but lane time
+	Field(Armed)[Slot] = 0.f;
+	Field(ThrottleIn)[Slot] = 0.f;
+	Field(Floor)[Slot] = Field(PosZ)[Slot];
+	for (EField F : { VelX, VelY, VelZ, AngX, AngY, AngZ })
+	{
+		Field(F)[Slot] = 0.f;
+	}
+	FreeSlots.Add(Slot);
+	LiveSlots[Slot] = false;
+	Generations[Slot] = (uint16)((Generations[Slot] + 1) & GenerationMask);
+}
+
+bool FDroneFlightBatch::SetInput(int32 Handle, const FFlightInput& Input)
+{
+	const int32 Slot = ToSlot(Handle);
+	if (Slot == INDEX_NONE)
+	{
+		return false;
+	}
+
+	Field(StickRoll)[Slot] = Input.Roll;
+	Field(StickPitch)[Slot] = Input.Pitch;
+	Field(StickYaw)[Slot] = Input.Yaw;
+	Field(ThrottleIn)[Slot] = Input.Throttle;
+	Field(Armed)[Slot] = Input.bArmed ? 1.f : 0.f;
+	return true;
+}
+
+bool FDroneFlightBatch::SetFloorZ(int32 Handle, float FloorZ)
+{
+	const int32 Slot = ToSlot(Handle);
+	if (Slot == INDEX_NONE)
+	{
+		return false;
+	}
+	Field(Floor)[Slot] = FloorZ;
+	return true;
+}
+
+FVector FDroneFlightBatch::GetLocation(int32 Handle, float Alpha) const
+{
+	const int32 Slot = ToSlot(Handle);
+	if (Slot == INDEX_NONE)
+	{
+		return FVector::ZeroVector;
+	}
+	const FVector Prev(Field(PrevPosX)[Slot], Field(PrevPosY)[Slot], Field(PrevPosZ)[Slot]);
+	const FVector Curr(Field(PosX)[Slot], Field(PosY)[Slot], Field(PosZ)[Slot]);
+	return FMath::Lerp(Prev, Curr, Alpha);
+}
+
+FQuat FDroneFlightBatch::GetRotation(int32 Handle, float Alpha) const
+{
+	const int32 Slot = ToSlot(Handle);
+	if (Slot == INDEX_NONE)
+	{
+		return FQuat::Identity;
+	}
+	const FQuat Prev(Field(PrevRotX)[Slot], Field(PrevRotY)[Slot], Field(PrevRotZ)[Slot], Field(PrevRotW)[Slot]);
+	const FQuat Curr(Field(RotX)[Slot], Field(RotY)[Slot], Field(RotZ)[Slot], Field(RotW)[Slot]);
+	return FQuat::Slerp(Prev, Curr, Alpha);
+}
+
+FVector FDroneFlightBatch::GetVelocity(int32 Handle) const
+{
+	const int32 Slot = ToSlot(Handle);
+	if (Slot == INDEX_NONE)
+	{
+		return FVector::ZeroVector;
+	}
+	return FVector(Field(VelX)[Slot], Field(VelY)[Slot], Field(VelZ)[Slot]);
+}
+
+void FDroneFlightBatch::Reserve(int32 MinSlots)
+{
+	if (MinSlots <= Capacity)
+	{
+		return;
+	}
+
+	const int32 NewCapacity = Align(FMath::Max(MinSlots, Capacity * 2), DronesPerTask);
+
+	TArray<float, TAlignedHeapAllocator<16>> NewData;
+	NewData.SetNumZeroed(NumFields * NewCapacity);
+
+	for (int32 F = 0; F < NumFields; ++F)
+	{
+		float* NewField = NewData.GetData() + (SIZE_T)F * NewCapacity;
+		if (Capacity > 0)
+		{
+			FMemory::Memcpy(NewField, Field((EField)F), Capacity * sizeof(float));
+		}
+
+		// Unused lanes still get stepped with their group: keep them a valid, resting body
+		if (F == RotW || F == PrevRotW)
+		{
+			for (int32 i = Capacity; i < NewCapacity; ++i)
+			{
+				NewField[i] = 1.f;
+			}
+		}
+	}
+
+	Data = MoveTemp(NewData);
+	Capacity = NewCapacity;
+}
+
+void FDroneFlightBatch::Step(float Dt, bool bParallel)
+{
+	QUICK_SCOPE_CYCLE_COUNTER(STAT_DroneFlightBatch_Step);
+
+	if (NumSlots == 0 || Dt <= 0.f)
+	{
+		return;
+	}
+
+	// Capacity is a multiple of DronesPerTask, so every chunk is whole SIMD groups
+	const int32 NumLanes = Align(NumSlots, LaneWidth);
+	const int32 NumTasks = FMath::DivideAndRoundUp(NumLanes, DronesPerTask);
+
+	ParallelFor(NumTasks, [this, NumLanes, Dt](int32 Task)
+	{
+		const int32 Begin = Task * DronesPerTask;
+		StepRange(Begin, FMath::Min(Begin + DronesPerTask, NumLanes), Dt);
+	}, bParallel ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+}
+
+void FDroneFlightBatch::StepRange(int32 Begin, int32 End, float Dt)
+{
+	const FFlightParams& P = Params;
+	const float SafeMass = FMath::Max(P.Mass, 1e-4f);
+
+	// Throttle curve per drone (branches and a pow, not worth vectorizing), and the pose
+	// before this step for interpolation
+	{
+		float* Throttle = Field(ThrottleSmoothed);
+		float* Coll = Field(Collective);
+		const float* In = Field(ThrottleIn);
+		const float* Arm = Field(Armed);
+		for (int32 i = Begin; i < End; ++i)
+		{
+			Throttle[i] = FMath::FInterpTo(Throttle[i], Arm[i] > 0.5f ? In[i] : 0.f, Dt, P.ThrustResponse);
+			Coll[i] = ComputeFlightUpAccel(Throttle[i], P) * SafeMass;
+		}
+
+		// Acro rate setpoints in the state's axis convention, as StepFlightModel computes them,
+		// from the current params so new rates apply to sticks that were set before
+		const float* Roll = Field(StickRoll);
+		const float* Pitch = Field(StickPitch);
+		const float* Yaw = Field(StickYaw);
+		float* SpX = Field(SetpointX);
+		float* SpY = Field(SetpointY);
+		float* SpZ = Field(SetpointZ);
+		for (int32 i = Begin; i < End; ++i)
+		{
+			const float RollRate = P.Rates ? P.Rates->Lookup(FlightAxis::Roll, Roll[i]) : Roll[i] * P.RollRateDeg;
+			const float PitchRate = P.Rates ? P.Rates->Lookup(FlightAxis::Pitch, Pitch[i]) : Pitch[i] * P.PitchRateDeg;
+			const float YawRate = P.Rates ? P.Rates->Lookup(FlightAxis::Yaw, Yaw[i]) : Yaw[i] * P.YawRateDeg;
+			SpX[i] = -RollRate * FlightDegToRad;
+			SpY[i] = -PitchRate * FlightDegToRad;
+			SpZ[i] = YawRate * FlightDegToRad;
+		}
+
+		static constexpr EField PoseFields[] = { PosX, PosY, PosZ, RotX, RotY, RotZ, RotW };
+		static constexpr EField PrevFields[] = { PrevPosX, PrevPosY, PrevPosZ, PrevRotX, PrevRotY, PrevRotZ, PrevRotW };
+		for (int32 F = 0; F < (int32)UE_ARRAY_COUNT(PoseFields); ++F)
+		{
+			FMemory::Memcpy(Field(PrevFields[F]) + Begin, Field(PoseFields[F]) + Begin, (End - Begin) * sizeof(float));
+		}
+	}
+
+	// Loop constants, the same for every lane
+	const int32 Iterations = FMath::Max(1, (int32)(Dt * P.Pid.LoopRateHz + 0.5f));
+	const float PidDt = Dt / (float)Iterations;
+
+	const FBatchVec Zero = VectorZeroFloat();
+	const FBatchVec One = VectorOneFloat();
+	const FBatchVec VPidDt = VectorSetFloat1(PidDt);
+	const FBatchVec VInvPidDt = VectorSetFloat1(1.f / PidDt);
+	const FBatchVec VHalfPidDt = VectorSetFloat1(0.5f * PidDt);
+	const FBatchVec VDt = VectorSetFloat1(Dt);
+
+	const FBatchVec DK = VectorSetFloat1(BatchPt1Gain(P.Pid.DTermCutoffHz, PidDt));
+	const FBatchVec FK = VectorSetFloat1(BatchPt1Gain(P.Pid.FeedforwardCutoffHz, PidDt));
+	const FBatchVec ILimit = VectorSetFloat1(P.Pid.ITermLimit);
+	const FBatchVec NegILimit = VectorSetFloat1(-P.Pid.ITermLimit);
+
+	const FFlightVec3 Inertia(FMath::Max(P.Inertia.X, 1e-3f), FMath::Max(P.Inertia.Y, 1e-3f), FMath::Max(P.Inertia.Z, 1e-3f));
+	const FBatchVec VInertia[3] = { VectorSetFloat1(Inertia.X), VectorSetFloat1(Inertia.Y), VectorSetFloat1(Inertia.Z) };
+	const FBatchVec VInvInertia[3] = { VectorSetFloat1(1.f / Inertia.X), VectorSetFloat1(1.f / Inertia.Y), VectorSetFloat1(1.f / Inertia.Z) };
+	const FBatchVec Kp[3] = { VectorSetFloat1(P.Pid.P.X), VectorSetFloat1(P.Pid.P.Y), VectorSetFloat1(P.Pid.P.Z) };
+	const FBatchVec KiDt[3] = { VectorSetFloat1(P.Pid.I.X * PidDt), VectorSetFloat1(P.Pid.I.Y * PidDt), VectorSetFloat1(P.Pid.I.Z * PidDt) };
+	const FBatchVec Kd[3] = { VectorSetFloat1(P.Pid.D.X), VectorSetFloat1(P.Pid.D.Y), VectorSetFloat1(P.Pid.D.Z) };
+	const FBatchVec Kff[3] = { VectorSetFloat1(P.Pid.FF.X), VectorSetFloat1(P.Pid.FF.Y), VectorSetFloat1(P.Pid.FF.Z) };
+
+	const float MaxMotorThrust = 0.25f * P.Mass * -P.GravityZ * P.MaxThrustG;
+	const FBatchVec MaxMotor = VectorSetFloat1(MaxMotorThrust);
+	const FBatchVec ArmScale = VectorSetFloat1(0.25f / FMath::Max(P.ArmLength, 1e-3f));
+	const FBatchVec YawScale = VectorSetFloat1(0.25f / FMath::Max(P.YawTorqueCoeff, 1e-3f));
+	const FBatchVec Arm = VectorSetFloat1(P.ArmLength);
+	const FBatchVec YawCoeff = VectorSetFloat1(P.YawTorqueCoeff);
+	const FBatchVec UpK = VectorSetFloat1(PidDt / (FMath::Max(P.MotorSpinUpTime, 0.f) + PidDt));
+	const FBatchVec DownK = VectorSetFloat1(PidDt / (FMath::Max(P.MotorSpinDownTime, 0.f) + PidDt));
+
+	const FBatchVec ThrustToAccel = VectorSetFloat1(1.f / ((float)Iterations * SafeMass));
+	const FBatchVec GravityDt = VectorSetFloat1(P.GravityZ * Dt);
+	const FBatchVec DragDt = VectorSetFloat1(-P.DragCoeff / SafeMass * Dt);
+	const FBatchVec GroundKeep = VectorSetFloat1(1.f - FMath::Clamp(Dt * P.GroundFriction, 0.f, 1.f));
+
+	for (int32 i = Begin; i < End; i += LaneWidth)
+	{
+		auto Load = [this, i](EField F) { return VectorLoadAligned(Field(F) + i); };
+		auto Store = [this, i](EField F, const FBatchVec& V) { VectorStoreAligned(V, Field(F) + i); };
+
+		FBatchVec W[3] = { Load(AngX), Load(AngY), Load(AngZ) };
+		FBatchVec QX = Load(RotX), QY = Load(RotY), QZ = Load(RotZ), QW = Load(RotW);
+		FBatchVec M[4] = { Load(Motor0), Load(Motor1), Load(Motor2), Load(Motor3) };
+
+		FBatchVec ITerm[3] = { Load(ITermX), Load(ITermY), Load(ITermZ) };
+		FBatchVec PrevGyro[3] = { Load(PrevGyroX), Load(PrevGyroY), Load(PrevGyroZ) };
+		FBatchVec Lpf1[3] = { Load(DLpf1X), Load(DLpf1Y), Load(DLpf1Z) };
+		FBatchVec Lpf2[3] = { Load(DLpf2X), Load(DLpf2Y), Load(DLpf2Z) };
+		FBatchVec PrevSp[3] = { Load(PrevSetX), Load(PrevSetY), Load(PrevSetZ) };
+		FBatchVec Ff[3] = { Load(FfX), Load(FfY), Load(FfZ) };
+		FBatchVec SatMask = BatchToMask(Load(Saturated));
+
+		const FBatchVec Sp[3] = { Load(SetpointX), Load(SetpointY), Load(SetpointZ) };
+		const FBatchVec ArmedMask = BatchToMask(Load(Armed));
+		const FBatchVec QuarterCollective = VectorMultiply(Load(Collective), VectorSetFloat1(0.25f));
+
+		FBatchVec ThrustSum = Zero;
+
+		for (int32 k = 0; k < Iterations; ++k)
+		{
+			// 1) PID (UpdateFlightPid), torque request = inertia * angular acceleration.
+			// Disarmed lanes compute it too and are reset below, like ResetFlightPid.
+			FBatchVec Request[3];
+			for (int32 a = 0; a < 3; ++a)
+			{
+				const FBatchVec Error = VectorSubtract(Sp[a], W[a]);
+
+				const FBatchVec NewITerm = BatchClamp(VectorMultiplyAdd(KiDt[a], Error, ITerm[a]), NegILimit, ILimit);
+				ITerm[a] = VectorSelect(SatMask, ITerm[a], NewITerm);
+
+				const FBatchVec GyroAccel = VectorMultiply(VectorSubtract(W[a], PrevGyro[a]), VInvPidDt);
+				PrevGyro[a] = W[a];
+				Lpf1[a] = VectorMultiplyAdd(VectorSubtract(GyroAccel, Lpf1[a]), DK, Lpf1[a]);
+				Lpf2[a] = VectorMultiplyAdd(VectorSubtract(Lpf1[a], Lpf2[a]), DK, Lpf2[a]);
+
+				const FBatchVec SetpointAccel = VectorMultiply(VectorSubtract(Sp[a], PrevSp[a]), VInvPidDt);
+				PrevSp[a] = Sp[a];
+				Ff[a] = VectorMultiplyAdd(VectorSubtract(SetpointAccel, Ff[a]), FK, Ff[a]);
+
+				FBatchVec Out = VectorMultiplyAdd(Kp[a], Error, ITerm[a]);
+				Out = VectorNegateMultiplyAdd(Kd[a], Lpf2[a], Out);
+				Out = VectorMultiplyAdd(Kff[a], Ff[a], Out);
+				Request[a] = VectorMultiply(Out, VInertia[a]);
+			}
+
+			// 2) Mixer (MixMotorCommands) with the X-frame signs written out per motor
+			const FBatchVec RollMinusPitch = VectorMultiply(VectorSubtract(Request[0], Request[1]), ArmScale);
+			const FBatchVec RollPlusPitch = VectorMultiply(VectorAdd(Request[0], Request[1]), ArmScale);
+			const FBatchVec Yaw = VectorMultiply(Request[2], YawScale);
+			const FBatchVec Part[4] =
+			{
+				VectorAdd(RollMinusPitch, Yaw),
+				VectorSubtract(RollPlusPitch, Yaw),
+				VectorSubtract(Yaw, RollMinusPitch),
+				VectorNegate(VectorAdd(RollPlusPitch, Yaw))
+			};
+
+			const FBatchVec MinPart = VectorMin(VectorMin(VectorMin(Part[0], Part[1]), VectorMin(Part[2], Part[3])), Zero);
+			const FBatchVec MaxPart = VectorMax(VectorMax(VectorMax(Part[0], Part[1]), VectorMax(Part[2], Part[3])), Zero);
+			const FBatchVec Range = VectorSubtract(MaxPart, MinPart);
+
+			const FBatchVec TooMuch = VectorCompareGT(Range, MaxMotor);
+			const FBatchVec TorqueScale = VectorSelect(TooMuch, VectorDivide(MaxMotor, VectorMax(Range, VectorSetFloat1(1e-6f))), One);
+
+			const FBatchVec Base = BatchClamp(QuarterCollective,
+				VectorNegate(VectorMultiply(MinPart, TorqueScale)),
+				VectorSubtract(MaxMotor, VectorMultiply(MaxPart, TorqueScale)));
+
+			SatMask = VectorBitwiseAnd(TooMuch, ArmedMask);
+
+			// Disarmed: no commands, PID state cleared (PrevGyro already follows the gyro)
+			for (int32 a = 0; a < 3; ++a)
+			{
+				ITerm[a] = VectorSelect(ArmedMask, ITerm[a], Zero);
+				Lpf1[a] = VectorSelect(ArmedMask, Lpf1[a], Zero);
+				Lpf2[a] = VectorSelect(ArmedMask, Lpf2[a], Zero);
+				PrevSp[a] = VectorSelect(ArmedMask, PrevSp[a], Zero);
+				Ff[a] = VectorSelect(ArmedMask, Ff[a], Zero);
+			}
+
+			// 3) Motor lag (UpdateMotors)
+			for (int32 m = 0; m < 4; ++m)
+			{
+				const FBatchVec Command = VectorSelect(ArmedMask, VectorMultiplyAdd(Part[m], TorqueScale, Base), Zero);
+				const FBatchVec K = VectorSelect(VectorCompareGT(Command, M[m]), UpK, DownK);
+				M[m] = VectorMultiplyAdd(K, VectorSubtract(Command, M[m]), M[m]);
+			}
+
+			const FBatchVec Front = VectorAdd(M[0], M[3]);
+			const FBatchVec Rear = VectorAdd(M[1], M[2]);
+			const FBatchVec Right = VectorAdd(M[0], M[1]);
+			const FBatchVec Left = VectorAdd(M[2], M[3]);
+			ThrustSum = VectorAdd(ThrustSum, VectorAdd(Front, Rear));
+
+			const FBatchVec Torque[3] =
+			{
+				VectorMultiply(Arm, VectorSubtract(Right, Left)),
+				VectorMultiply(Arm, VectorSubtract(Rear, Front)),
+				VectorMultiply(YawCoeff, VectorSubtract(VectorAdd(M[0], M[2]), VectorAdd(M[1], M[3])))
+			};
+
+			// 4) Euler's equation (IntegrateRotation): I * dw/dt = tau - w x (I w)
+			const FBatchVec IW[3] = { VectorMultiply(VInertia[0], W[0]), VectorMultiply(VInertia[1], W[1]), VectorMultiply(VInertia[2], W[2]) };
+			const FBatchVec Gyroscopic[3] =
+			{
+				VectorSubtract(VectorMultiply(W[1], IW[2]), VectorMultiply(W[2], IW[1])),
+				VectorSubtract(VectorMultiply(W[2], IW[0]), VectorMultiply(W[0], IW[2])),
+				VectorSubtract(VectorMultiply(W[0], IW[1]), VectorMultiply(W[1], IW[0]))
+			};
+			for (int32 a = 0; a < 3; ++a)
+			{
+				const FBatchVec AngularAccel = VectorMultiply(VectorSubtract(Torque[a], Gyroscopic[a]), VInvInertia[a]);
+				W[a] = VectorMultiplyAdd(AngularAccel, VPidDt, W[a]);
+			}
+
+			// Rotation * FromRotationVector(W * dt); half-angle sin/cos by series, the
+			// angle per PID iteration is a few hundredths of a radian at most
+			const FBatchVec HX = VectorMultiply(W[0], VHalfPidDt);
+			const FBatchVec HY = VectorMultiply(W[1], VHalfPidDt);
+			const FBatchVec HZ = VectorMultiply(W[2], VHalfPidDt);
+			const FBatchVec H2 = VectorMultiplyAdd(HX, HX, VectorMultiplyAdd(HY, HY, VectorMultiply(HZ, HZ)));
+			const FBatchVec SinScale = VectorNegateMultiplyAdd(H2, VectorSetFloat1(1.f / 6.f), One);
+			const FBatchVec DW = VectorMultiplyAdd(VectorMultiply(H2, H2), VectorSetFloat1(1.f / 24.f), VectorNegateMultiplyAdd(H2, VectorSetFloat1(0.5f), One));
+			const FBatchVec DX = VectorMultiply(HX, SinScale);
+			const FBatchVec DY = VectorMultiply(HY, SinScale);
+			const FBatchVec DZ = VectorMultiply(HZ, SinScale);
+
+			const FBatchVec NX = VectorAdd(VectorMultiplyAdd(QW, DX, VectorMultiply(QX, DW)), VectorSubtract(VectorMultiply(QY, DZ), VectorMultiply(QZ, DY)));
+			const FBatchVec NY = VectorAdd(VectorMultiplyAdd(QW, DY, VectorMultiply(QY, DW)), VectorSubtract(VectorMultiply(QZ, DX), VectorMultiply(QX, DZ)));
+			const FBatchVec NZ = VectorAdd(VectorMultiplyAdd(QW, DZ, VectorMultiply(QZ, DW)), VectorSubtract(VectorMultiply(QX, DY), VectorMultiply(QY, DX)));
+			const FBatchVec NW = VectorSubtract(VectorMultiply(QW, DW), VectorMultiplyAdd(QX, DX, VectorMultiplyAdd(QY, DY, VectorMultiply(QZ, DZ))));
+
+			const FBatchVec LengthSq = VectorMultiplyAdd(NX, NX, VectorMultiplyAdd(NY, NY, VectorMultiplyAdd(NZ, NZ, VectorMultiply(NW, NW))));
+			const FBatchVec InvLength = VectorReciprocalSqrt(LengthSq);
+			QX = VectorMultiply(NX, InvLength);
+			QY = VectorMultiply(NY, InvLength);
+			QZ = VectorMultiply(NZ, InvLength);
+			QW = VectorMultiply(NW, InvLength);
+		}
+
+		// 5) Thrust along body up + gravity + drag, semi-implicit Euler (ComputeAcceleration)
+		const FBatchVec UpAccelDt = VectorMultiply(VectorMultiply(ThrustSum, ThrustToAccel), VDt);
+		const FBatchVec Two = VectorSetFloat1(2.f);
+		const FBatchVec UpX = VectorMultiply(Two, VectorMultiplyAdd(QX, QZ, VectorMultiply(QW, QY)));
+		const FBatchVec UpY = VectorMultiply(Two, VectorSubtract(VectorMultiply(QY, QZ), VectorMultiply(QW, QX)));
+		const FBatchVec UpZ = VectorNegateMultiplyAdd(Two, VectorMultiplyAdd(QX, QX, VectorMultiply(QY, QY)), One);
+
+		FBatchVec VX = Load(VelX), VY = Load(VelY), VZ = Load(VelZ);
+		VX = VectorAdd(VX, VectorMultiplyAdd(VX, DragDt, VectorMultiply(UpX, UpAccelDt)));
+		VY = VectorAdd(VY, VectorMultiplyAdd(VY, DragDt, VectorMultiply(UpY, UpAccelDt)));
+		VZ = VectorAdd(VZ, VectorAdd(VectorMultiplyAdd(VZ, DragDt, VectorMultiply(UpZ, UpAccelDt)), GravityDt));
+
+		const FBatchVec PX = VectorMultiplyAdd(VX, VDt, Load(PosX));
+		const FBatchVec PY = VectorMultiplyAdd(VY, VDt, Load(PosY));
+		FBatchVec PZ = VectorMultiplyAdd(VZ, VDt, Load(PosZ));
+
+		// 6) Floor: no sinking, no velocity into it, ground friction on the lateral part
+		const FBatchVec FloorZ = Load(Floor);
+		const FBatchVec OnFloor = VectorCompareLT(PZ, FloorZ);
+		PZ = VectorMax(PZ, FloorZ);
+		VZ = VectorSelect(OnFloor, VectorMax(VZ, Zero), VZ);
+		const FBatchVec Keep = VectorSelect(OnFloor, GroundKeep, One);
+		VX = VectorMultiply(VX, Keep);
+		VY = VectorMultiply(VY, Keep);
+
+		Store(PosX, PX); Store(PosY, PY); Store(PosZ, PZ);
+		Store(VelX, VX); Store(VelY, VY); Store(VelZ, VZ);
+		Store(RotX, QX); Store(RotY, QY); Store(RotZ, QZ); Store(RotW, QW);
+		Store(AngX, W[0]); Store(AngY, W[1]); Store(AngZ, W[2]);
+		Store(Motor0, M[0]); Store(Motor1, M[1]); Store(Motor2, M[2]); Store(Motor3, M[3]);
+		Store(ITermX, ITerm[0]); Store(ITermY, ITerm[1]); Store(ITermZ, ITerm[2]);
+		Store(PrevGyroX, PrevGyro[0]); Store(PrevGyroY, PrevGyro[1]); Store(PrevGyroZ, PrevGyro[2]);
+		Store(DLpf1X, Lpf1[0]); Store(DLpf1Y, Lpf1[1]); Store(DLpf1Z, Lpf1[2]);
+		Store(DLpf2X, Lpf2[0]); Store(DLpf2Y, Lpf2[1]); Store(DLpf2Z, Lpf2[2]);
+		Store(PrevSetX, PrevSp[0]); Store(PrevSetY, PrevSp[1]); Store(PrevSetZ, PrevSp[2]);
+		Store(FfX, Ff[0]); Store(FfY, Ff[1]); Store(FfZ, Ff[2]);
+		Store(Saturated, BatchFromMask(SatMask));
+	}
+}
@@ -0,0 +1,106 @@
+// DroneFlightBatch.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FlightCore/FlightModel.h"
+
+/**
+ * Many drones stepped together, for AI and ghost drones that don't need a full pawn.
+ *
+ * Every state variable is its own array (structure of arrays), so one SIMD register holds
+ * the same variable for four drones and the step runs the flight controller, mixer, motors
+ * and rigid body four drones at a time with no per-drone branches or virtual calls. Work is
+ * split into fixed-size chunks over ParallelFor workers; cost is linear in the drone count.
+ *
+ * Same physics as StepFlightModel in acro mode with the semi-implicit Euler integrator
+ * (Params.Integrator is ignored), sharing one FFlightParams (airframe, PID, rates) across
+ * the batch. Drag is the linear DragCoeff term on ground velocity only: Params.DragArea and
+ * Params.Wind are ignored, so batch drones fly in still air. Angle/horizon modes and world
+ * collision are not simulated here; each drone has a floor height instead (ground contact
+ * with lateral friction).
+ *
+ * Drones are addressed by handles: a slot index plus the slot's generation, so a handle kept
+ * after RemoveDrone (or never issued) is rejected instead of touching whoever reuses the slot.
+ */
+class DRONERACERFP_API FDroneFlightBatch
+{
+public:
+	static constexpr int32 LaneWidth = 4;
+	static constexpr int32 DronesPerTask = 64;
+
+	/** Shared airframe and controller settings. Params.Rates must outlive the batch (or be null). */
+	void SetParams(const FFlightParams& InParams) { Params = InParams; }
+	const FFlightParams& GetParams() const { return Params; }
+
+	/** Returns the drone's handle, >= 0. */
+	int32 AddDrone(const FFlightState& Initial, float FloorZ = -UE_BIG_NUMBER);
+	void RemoveDrone(int32 Handle);
+	bool IsValidHandle(int32 Handle) const;
+
+	/** Raw sticks; the shared rates turn them into setpoints in every step. False for a stale handle. */
+	bool SetInput(int32 Handle, const FFlightInput& Input);
+	bool SetFloorZ(int32 Handle, float FloorZ);
+
+	/** Advances every drone by Dt (one flight substep). */
+	void Step(float Dt, bool bParallel = true);
+
+	/** Pose between the previous and the latest step, for rendering with a fixed-step accumulator. Identity for a stale handle. */
+	FVector GetLocation(int32 Handle, float Alpha = 1.f) const;
+	FQuat GetRotation(int32 Handle, float Alpha = 1.f) const;
+	FVector GetVelocity(int32 Handle) const;
+
+	int32 Num() const { return NumSlots - FreeSlots.Num(); }
+
+private:
+	enum EField : int32
+	{
+		PosX, PosY, PosZ,
+		VelX, VelY, VelZ,
+		RotX, RotY, RotZ, RotW,
+		PrevPosX, PrevPosY, PrevPosZ,
+		PrevRotX, PrevRotY, PrevRotZ, PrevRotW,
+		AngX, AngY, AngZ,
+		Motor0, Motor1, Motor2, Motor3,
+		ThrottleSmoothed,
+		ITermX, ITermY, ITermZ,
+		PrevGyroX, PrevGyroY, PrevGyroZ,
+		DLpf1X, DLpf1Y, DLpf1Z,
+		DLpf2X, DLpf2Y, DLpf2Z,
+		PrevSetX, PrevSetY, PrevSetZ,
+		FfX, FfY, FfZ,
+		Saturated,              // 1 = mixer saturated last iteration
+		// Inputs
+		StickRoll, StickPitch, StickYaw,
+		ThrottleIn,
+		Armed,                  // 1 / 0
+		Floor,
+		// Per-step scratch
+		SetpointX, SetpointY, SetpointZ,
+		Collective,
+		NumFields
+	};
+
+	float* Field(EField F) { return Data.GetData() + (SIZE_T)F * Capacity; }
+	const float* Field(EField F) const { return Data.GetData() + (SIZE_T)F * Capacity; }
+
+	static constexpr int32 SlotBits = 20;
+	static constexpr int32 SlotMask = (1 << SlotBits) - 1;
+	static constexpr int32 GenerationMask = (1 << (31 - SlotBits)) - 1;
+
+	/** Slot of a live drone, or INDEX_NONE. */
+	int32 ToSlot(int32 Handle) const;
+
+	void Reserve(int32 MinSlots);
+	void StepRange(int32 Begin, int32 End, float Dt);
+
+	FFlightParams Params;
+
+	/** NumFields arrays of Capacity floats each, back to back. */
+	TArray<float, TAlignedHeapAllocator<16>> Data;
+	int32 Capacity = 0;         // slots per field, multiple of DronesPerTask
+	int32 NumSlots = 0;         // high-water mark of used slots
+	TArray<int32> FreeSlots;
+	TArray<uint16> Generations;    // per slot; bumped on removal
+	TBitArray<> LiveSlots;
+};
@@ -0,0 +1,81 @@
+// DroneFlightBatchSubsystem.cpp
+
+#include "DroneFlightBatchSubsystem.h"
+#include "Engine/World.h"
+
+void UDroneFlightBatchSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (Batch.Num() == 0)
+	{
+		return;
+	}
+
+	const float Step = 1.f / FMath::Clamp(PhysicsRateHz, 100.f, 2000.f);
+	Accumulator += DeltaTime;
+
+	int32 Substeps = 0;
+	while (Accumulator >= Step && Substeps < MaxSubstepsPerFrame)
+	{
+		Batch.Step(Step, bParallel);
+		Accumulator -= Step;
+		++Substeps;
+	}
+
+	if (Accumulator >= Step)
+	{
+		Accumulator = FMath::Fmod(Accumulator, Step);
+	}
+
+	Alpha = Accumulator / Step;
+}
+
+TStatId UDroneFlightBatchSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UDroneFlightBatchSubsystem, STATGROUP_Tickables);
+}
+
+bool UDroneFlightBatchSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UDroneFlightBatchSubsystem::SetFlightParams(const FFlightParams& Params, const FFlightRateTable* Rates)
+{
+	FFlightParams Copy = Params;
+	if (Rates)
+	{
+		RateTable = *Rates;
+		Copy.Rates = &RateTable;
+	}
+	else
+	{
+		Copy.Rates = nullptr;
+	}
+
+	// Same gravity as the player's drone (ADroneFPCharacter::MakeFlightParams)
+	Copy.GravityZ = GetWorld() ? GetWorld()->GetGravityZ() : Copy.GravityZ;
+	Batch.SetParams(Copy);
+}
+
+int32 UDroneFlightBatchSubsystem::RegisterDrone(const FTransform& Transform, float FloorZ)
+{
+	const FVector Location = Transform.GetLocation();
+	const FQuat Rotation = Transform.GetRotation();
+
+	FFlightState State;
+	State.Position = FFlightVec3((float)Location.X, (float)Location.Y, (float)Location.Z);
+	State.Rotation = FFlightQuat((float)Rotation.X, (float)Rotation.Y, (float)Rotation.Z, (float)Rotation.W);
+	return Batch.AddDrone(State, FloorZ);
+}
+
+void UDroneFlightBatchSubsystem::UnregisterDrone(int32 Handle)
+{
+	Batch.RemoveDrone(Handle);
+}
+
+FTransform UDroneFlightBatchSubsystem::GetDroneTransform(int32 Handle) const
+{
+	return FTransform(Batch.GetRotation(Handle, Alpha), Batch.GetLocation(Handle, Alpha));
+}
@@ -0,0 +1,58 @@
+// DroneFlightBatchSubsystem.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "DroneFlightBatch.h"
+#include "DroneFlightBatchSubsystem.generated.h"
+
+/**
+ * Runs every AI / ghost drone of a world in one FDroneFlightBatch on a fixed step.
+ *
+ * Drones register once and get a handle. Whoever controls them (AI, ghost playback) pushes
+ * sticks with SetDroneInput; actors only read their interpolated transform back in their own
+ * Tick, they don't simulate anything themselves.
+ */
+UCLASS()
+class DRONERACERFP_API UDroneFlightBatchSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+	/** Airframe, controller and rates shared by all batch drones. The rate table is copied. */
+	void SetFlightParams(const FFlightParams& Params, const FFlightRateTable* Rates = nullptr);
+
+	int32 RegisterDrone(const FTransform& Transform, float FloorZ = -UE_BIG_NUMBER);
+	void UnregisterDrone(int32 Handle);
+
+	/** False (and ignored) for a handle that was unregistered or never issued. */
+	bool SetDroneInput(int32 Handle, const FFlightInput& Input) { return Batch.SetInput(Handle, Input); }
+	bool SetDroneFloorZ(int32 Handle, float FloorZ) { return Batch.SetFloorZ(Handle, FloorZ); }
+	bool IsValidDrone(int32 Handle) const { return Batch.IsValidHandle(Handle); }
+
+	/** Pose interpolated between the last two fixed steps. */
+	FTransform GetDroneTransform(int32 Handle) const;
+	FVector GetDroneVelocity(int32 Handle) const { return Batch.GetVelocity(Handle); }
+
+	int32 GetNumDrones() const { return Batch.Num(); }
+
+	/** Fixed step rate for the whole batch (Hz). */
+	float PhysicsRateHz = 500.f;
+
+	/** Hitch protection: steps beyond this per frame are dropped. */
+	int32 MaxSubstepsPerFrame = 8;
+
+	/** Spread the batch over worker threads (off = game thread only, for profiling). */
+	bool bParallel = true;
+
+private:
+	FDroneFlightBatch Batch;
+	FFlightRateTable RateTable;
+	float Accumulator = 0.f;
+	float Alpha = 1.f;
+};
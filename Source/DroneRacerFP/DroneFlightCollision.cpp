@@ -0,0 +1,97 @@
+// DroneFlightCollision.cpp
+
+#include "DroneFlightCollision.h"
+#include "DroneFlightStats.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+#include "FlightCore/FlightProximity.h"
+
+DECLARE_CYCLE_STAT(TEXT("Collision sweep"), STAT_DroneFlightSweep, STATGROUP_DroneFlight);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Collision sweeps per frame"), STAT_DroneFlightSweeps, STATGROUP_DroneFlight);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sweeps skipped (proximity)"), STAT_DroneFlightSweepsSkipped, STATGROUP_DroneFlight);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sweeps shortened (proximity)"), STAT_DroneFlightSweepsShortened, STATGROUP_DroneFlight);
+
+FDroneCapsuleCollision::FDroneCapsuleCollision(const UCapsuleComponent* InCapsule)
+	: World(InCapsule ? InCapsule->GetWorld() : nullptr)
+	, Capsule(InCapsule)
+	, QueryParams(SCENE_QUERY_STAT(DroneFlightSweep), /*bTraceComplex=*/false, InCapsule ? InCapsule->GetOwner() : nullptr)
+	, DefaultMaterial(GEngine ? GEngine->DefaultPhysMaterial : nullptr)
+{
+	QueryParams.bReturnPhysicalMaterial = true; // restitution, friction, GetSurfaceHardness
+	if (Capsule)
+	{
+		ResponseParams = FCollisionResponseParams(Capsule->GetCollisionResponseToChannels());
+
+		// The capsule fits in a sphere of its half height (which includes the hemispheres)
+		BoundingRadius = FMath::Max(Capsule->GetScaledCapsuleHalfHeight(), Capsule->GetScaledCapsuleRadius());
+	}
+}
+
+bool FDroneCapsuleCollision::Sweep(const FFlightVec3& Start, const FFlightVec3& Delta, const FFlightQuat& Rotation, FFlightContact& OutContact)
+{
+	if (!Capsule || !World)
+	{
+		return false;
+	}
+
+	++NumQueries;
+
+	// Whatever the field proves free doesn't need the physics scene
+	float FreeFraction = 0.f;
+	if (ProximityField)
+	{
+		FreeFraction = ComputeFreeSweepFraction(*ProximityField, Start, Delta, BoundingRadius);
+		if (FreeFraction >= 1.f)
+		{
+			++NumSkipped;
+			INC_DWORD_STAT(STAT_DroneFlightSweepsSkipped);
+			return false;
+		}
+		if (FreeFraction > 0.f)
+		{
+			++NumShortened;
+			INC_DWORD_STAT(STAT_DroneFlightSweepsShortened);
+		}
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_DroneFlightSweep);
+	INC_DWORD_STAT(STAT_DroneFlightSweeps);
+
+	const FVector From = ToVector(Start + Delta * FreeFraction);
+	const FVector To = ToVector(Start + Delta);
+	if (!World->SweepSingleByChannel(LastHit, From, To, ToQuat(Rotation),
+		Capsule->GetCollisionObjectType(), Capsule->GetCollisionShape(), QueryParams, ResponseParams))
+	{
+		return false;
+	}
+
+	// Prefer ImpactNormal for the surface normal
+	const FVector SurfaceNormal = LastHit.ImpactNormal.IsNearlyZero()
+		? LastHit.Normal.GetSafeNormal()
+		: LastHit.ImpactNormal.GetSafeNormal();
+
+	OutContact.Location = ToFlight(LastHit.Location);
+	OutContact.Normal = ToFlight(LastHit.Normal);
+	OutContact.SurfaceNormal = ToFlight(SurfaceNormal);
+	OutContact.PenetrationDepth = LastHit.PenetrationDepth;
+	OutContact.Time = FreeFraction + LastHit.Time * (1.f - FreeFraction);
+	OutContact.bStartPenetrating = LastHit.bStartPenetrating;
+
+	if (const UPhysicalMaterial* Material = LastHit.PhysMaterial.IsValid() ? LastHit.PhysMaterial.Get() : DefaultMaterial)
+	{
+		OutContact.Restitution = Material->Restitution;
+		OutContact.Friction = Material->Friction;
+	}
+	return true;
+}
+
+void FDroneCapsuleCollision::OnContactResolved(const FFlightContact& /*Contact*/, float InImpactSpeed)
+{
+	if (InImpactSpeed > ImpactSpeed)
+	{
+		ImpactSpeed = InImpactSpeed;
+		ImpactHit = LastHit;
+	}
+}
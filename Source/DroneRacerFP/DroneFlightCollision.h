@@ -0,0 +1,64 @@
+// DroneFlightCollision.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/HitResult.h"
+#include "CollisionQueryParams.h"
+#include "FlightCore/FlightModel.h"
+
+class UCapsuleComponent;
+class UPhysicalMaterial;
+class FFlightProximityField;
+
+// ===== FlightCore <-> engine types =====
+FORCEINLINE FVector ToVector(const FFlightVec3& V) { return FVector(V.X, V.Y, V.Z); }
+FORCEINLINE FQuat ToQuat(const FFlightQuat& Q) { return FQuat(Q.X, Q.Y, Q.Z, Q.W); }
+FORCEINLINE FFlightVec3 ToFlight(const FVector& V) { return FFlightVec3((float)V.X, (float)V.Y, (float)V.Z); }
+FORCEINLINE FFlightQuat ToFlight(const FQuat& Q) { return FFlightQuat((float)Q.X, (float)Q.Y, (float)Q.Z, (float)Q.W); }
+
+/**
+ * The flight model's view of the world: sweeps a drone's collision capsule. Built once per
+ * frame and shared by that frame's substeps. Keeps the hardest hit of the current
+ * substep for damage/hardness.
+ *
+ * With a proximity field, sweeps the field proves free are skipped, and sweeps that start
+ * in free space begin where the free space ends.
+ */
+class FDroneCapsuleCollision : public IFlightCollision
+{
+public:
+	explicit FDroneCapsuleCollision(const UCapsuleComponent* InCapsule);
+
+	void SetProximityField(const FFlightProximityField* InField) { ProximityField = InField; }
+
+	/** Forget the previous substep's impact. */
+	void BeginStep()
+	{
+		ImpactSpeed = -1.f;
+	}
+
+	virtual bool Sweep(const FFlightVec3& Start, const FFlightVec3& Delta, const FFlightQuat& Rotation, FFlightContact& OutContact) override;
+	virtual void OnContactResolved(const FFlightContact& Contact, float InImpactSpeed) override;
+
+	FHitResult LastHit;
+
+	/** Hardest hit of the current substep and its speed into the surface (cm/s). */
+	FHitResult ImpactHit;
+	float ImpactSpeed = -1.f;
+
+	// Since construction
+	int32 NumQueries = 0;       // Sweep() calls
+	int32 NumSkipped = 0;       // answered by the proximity field alone
+	int32 NumShortened = 0;     // physics sweep over only the part not proven free
+
+private:
+	UWorld* World;
+	const UCapsuleComponent* Capsule;
+	FCollisionQueryParams QueryParams;
+	FCollisionResponseParams ResponseParams;
+	const UPhysicalMaterial* DefaultMaterial;
+
+	const FFlightProximityField* ProximityField = nullptr;
+	float BoundingRadius = 0.f;
+};
@@ -0,0 +1,9 @@
+// DroneFlightStats.h
+//
+// "stat DroneFlight": shared by the pawn, its collision adapter and the flight caches.
+
+#pragma once
+
+#include "Stats/Stats.h"
+
+DECLARE_STATS_GROUP(TEXT("DroneFlight"), STATGROUP_DroneFlight, STATCAT_Advanced);
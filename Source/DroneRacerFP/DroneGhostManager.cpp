@@ -0,0 +1,298 @@
+// DroneGhostManager.cpp
+//
+// .dghost file: uint32 magic "DGST", uint16 version, float lap seconds, then the
+// FFlightGhostTrack blob as a byte array.
+
+#include "DroneGhostManager.h"
+#include "DroneFlightCollision.h"
+#include "RaceGateManager.h"
+#include "EngineUtils.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogDroneGhost, Log, All);
+
+namespace
+{
+	constexpr uint32 GhostFileMagic = 0x54534744; // "DGST"
+	constexpr uint16 GhostFileVersion = 1;
+	const TCHAR* const PersonalBestGhostName = TEXT("PersonalBest");
+}
+
+ADroneGhostManager::ADroneGhostManager()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	Instances = CreateDefaultSubobject<UInstancedStaticMeshComponent>(TEXT("Instances"));
+	Instances->SetMobility(EComponentMobility::Movable);
+	Instances->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Instances->SetGenerateOverlapEvents(false);
+	Instances->SetCanEverAffectNavigation(false);
+	Instances->SetCastShadow(false);
+	RootComponent = Instances;
+}
+
+FString ADroneGhostManager::GetGhostPath(const UWorld* World, const FString& Name)
+{
+	const FString Map = World ? UWorld::RemovePIEPrefix(World->GetMapName()) : FString(TEXT("Default"));
+	return FPaths::ProjectSavedDir() / TEXT("Ghosts") / FPaths::MakeValidFileName(Map, TEXT('_')) / FPaths::MakeValidFileName(Name, TEXT('_')) + TEXT(".dghost");
+}
+
+void ADroneGhostManager::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (GhostMesh)
+	{
+		Instances->SetStaticMesh(GhostMesh);
+	}
+	if (GhostMaterial)
+	{
+		Instances->SetMaterial(0, GhostMaterial);
+	}
+
+	for (TActorIterator<ARaceGateManager> It(GetWorld()); It; ++It)
+	{
+		GateManager = *It;
+		GatePassedHandle = It->OnGatePassed.AddUObject(this, &ADroneGhostManager::OnGatePassed);
+		break;
+	}
+	if (!GateManager.IsValid())
+	{
+		UE_LOG(LogDroneGhost, Warning, TEXT("%s: no race gate manager in the level, laps can't be recorded"), *GetName());
+	}
+
+	TArray<uint8> FileData;
+	if (FFileHelper::LoadFileToArray(FileData, *GetGhostPath(GetWorld(), PersonalBestGhostName), FILEREAD_Silent))
+	{
+		AddGhost(FileData, /*bPersonalBest=*/true);
+	}
+	for (const FString& Name : GhostsToLoad)
+	{
+		AddGhostFromFile(Name);
+	}
+}
+
+void ADroneGhostManager::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (ARaceGateManager* Manager = GateManager.Get())
+	{
+		Manager->OnGatePassed.Remove(GatePassedHandle);
+	}
+	Super::EndPlay(EndPlayReason);
+}
+
+bool ADroneGhostManager::AddGhostFromFile(const FString& Name)
+{
+	TArray<uint8> FileData;
+	if (!FFileHelper::LoadFileToArray(FileData, *GetGhostPath(GetWorld(), Name), FILEREAD_Silent))
+	{
+		UE_LOG(LogDroneGhost, Warning, TEXT("Can't read ghost %s"), *GetGhostPath(GetWorld(), Name));
+		return false;
+	}
+	return AddGhost(FileData, /*bPersonalBest=*/false);
+}
+
+bool ADroneGhostManager::AddGhostData(const TArray<uint8>& FileData)
+{
+	return AddGhost(FileData, /*bPersonalBest=*/false);
+}
+
+bool ADroneGhostManager::AddGhost(const TArray<uint8>& FileData, bool bPersonalBest)
+{
+	FMemoryReader Ar(FileData);
+	uint32 Magic = 0;
+	uint16 Version = 0;
+	float LapSeconds = 0.f;
+	TArray<uint8> TrackData;
+	Ar << Magic;
+	Ar << Version;
+	Ar << LapSeconds;
+	Ar << TrackData;
+
+	TUniquePtr<FGhost> Ghost = MakeUnique<FGhost>();
+	if (Ar.IsError() || Magic != GhostFileMagic || Version == 0 || Version > GhostFileVersion
+		|| !Ghost->Track.Init(TrackData.GetData(), TrackData.Num()))
+	{
+		UE_LOG(LogDroneGhost, Warning, TEXT("Not a ghost lap (%d bytes)"), FileData.Num());
+		return false;
+	}
+
+	if (bPersonalBest)
+	{
+		if (!bRaceAgainstPersonalBest)
+		{
+			PersonalBestSeconds = LapSeconds;
+			return true;
+		}
+		Ghosts.RemoveAll([](const TUniquePtr<FGhost>& Existing) { return Existing->bPersonalBest; });
+		PersonalBestSeconds = LapSeconds;
+	}
+	else if (Ghosts.Num() >= MaxGhosts)
+	{
+		UE_LOG(LogDroneGhost, Warning, TEXT("Ghost limit (%d) reached"), MaxGhosts);
+		return false;
+	}
+
+	Ghost->LapSeconds = LapSeconds;
+	Ghost->bPersonalBest = bPersonalBest;
+	Ghosts.Add(MoveTemp(Ghost));
+	RebuildPlayback();
+	return true;
+}
+
+void ADroneGhostManager::ClearGhosts()
+{
+	Ghosts.Reset();
+	RebuildPlayback();
+}
+
+void ADroneGhostManager::RebuildPlayback()
+{
+	std::vector<const FFlightGhostTrack*> Tracks;
+	Tracks.reserve(Ghosts.Num());
+	for (const TUniquePtr<FGhost>& Ghost : Ghosts)
+	{
+		Tracks.push_back(&Ghost->Track);
+	}
+	Playback.SetTracks(MoveTemp(Tracks));
+
+	Poses.SetNum(Ghosts.Num());
+	InstanceTransforms.SetNum(Ghosts.Num());
+	Instances->ClearInstances();
+	Instances->AddInstances(InstanceTransforms, /*bShouldReturnIndices=*/false, /*bWorldSpace=*/true);
+}
+
+void ADroneGhostManager::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (Ghosts.Num() == 0)
+	{
+		return;
+	}
+
+	// Ghosts wait on the start line until the player crosses it
+	const double RaceTime = RaceStartTime < 0.0 ? 0.0 : GetWorld()->GetTimeSeconds() - RaceStartTime;
+	Playback.Evaluate(RaceTime, Poses.GetData());
+
+	for (int32 i = 0; i < Poses.Num(); ++i)
+	{
+		InstanceTransforms[i].SetComponents(ToQuat(Poses[i].Rotation), ToVector(Poses[i].Position), FVector::OneVector);
+	}
+	Instances->BatchUpdateInstancesTransforms(0, InstanceTransforms, /*bWorldSpace=*/true, /*bMarkRenderStateDirty=*/true, /*bTeleport=*/true);
+}
+
+void ADroneGhostManager::OnGatePassed(int32 GateIndex, bool bRaceComplete)
+{
+	if (GateIndex == 0)
+	{
+		RaceStartTime = GetWorld()->GetTimeSeconds();
+
+		Recorder = FFlightGhostEncoder(SampleRateHz);
+		RecordSeconds = 0.0;
+		NextSampleSeconds = 0.0;
+		bHasPrev = false;
+		bRecording = true;
+	}
+
+	if (bRaceComplete && bRecording)
+	{
+		FinishLap();
+	}
+}
+
+void ADroneGhostManager::RecordStep(float StepSeconds, const FVector& Location, const FQuat& Rotation)
+{
+	if (!bHasPrev)
+	{
+		PrevLocation = Location;
+		PrevRotation = Rotation;
+		bHasPrev = true;
+	}
+
+	// Fixed-rate samples between the last two physics states
+	const double StepStart = RecordSeconds;
+	RecordSeconds += StepSeconds;
+	while (NextSampleSeconds <= RecordSeconds)
+	{
+		const float Alpha = StepSeconds > 0.f ? (float)((NextSampleSeconds - StepStart) / StepSeconds) : 1.f;
+		FFlightGhostSample Sample;
+		Sample.Position = ToFlight(FMath::Lerp(PrevLocation, Location, Alpha));
+		Sample.Rotation = ToFlight(FQuat::Slerp(PrevRotation, Rotation, Alpha));
+		Recorder.Add(Sample);
+		NextSampleSeconds += 1.0 / SampleRateHz;
+	}
+
+	PrevLocation = Location;
+	PrevRotation = Rotation;
+}
+
+void ADroneGhostManager::FinishLap()
+{
+	bRecording = false;
+	const float LapSeconds = (float)RecordSeconds;
+	const std::vector<uint8_t> Encoded = Recorder.Encode();
+
+	UE_LOG(LogDroneGhost, Display, TEXT("Lap %.3f s: %d poses in %d bytes"), LapSeconds, Recorder.GetNumSamples(), (int32)Encoded.size());
+
+	if (!bRecordPersonalBest || (PersonalBestSeconds > 0.f && LapSeconds >= PersonalBestSeconds))
+	{
+		return;
+	}
+
+	TArray<uint8> TrackData(Encoded.data(), (int32)Encoded.size());
+	TArray<uint8> FileData;
+	FMemoryWriter Ar(FileData);
+	uint32 Magic = GhostFileMagic;
+	uint16 Version = GhostFileVersion;
+	float Seconds = LapSeconds;
+	Ar << Magic;
+	Ar << Version;
+	Ar << Seconds;
+	Ar << TrackData;
+
+	const FString Path = GetGhostPath(GetWorld(), PersonalBestGhostName);
+	if (!FFileHelper::SaveArrayToFile(FileData, *Path))
+	{
+		UE_LOG(LogDroneGhost, Error, TEXT("Couldn't write %s"), *Path);
+	}
+	UE_LOG(LogDroneGhost, Display, TEXT("New personal best %.3f s (was %.3f s)"), LapSeconds, PersonalBestSeconds);
+
+	AddGhost(FileData, /*bPersonalBest=*/true);
+}
+
+static ADroneGhostManager* FindGhostManager(UWorld* World)
+{
+	TActorIterator<ADroneGhostManager> Manager(World);
+	return Manager ? *Manager : nullptr;
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GGhostLoadCommand(
+	TEXT("Drone.Ghost.Load"),
+	TEXT("Adds ghosts from Saved/Ghosts/<Map>/<Name>.dghost. Args: Name [Name...]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (ADroneGhostManager* Manager = World ? FindGhostManager(World) : nullptr)
+		{
+			for (const FString& Name : Args)
+			{
+				Manager->AddGhostFromFile(Name);
+			}
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs GGhostClearCommand(
+	TEXT("Drone.Ghost.Clear"),
+	TEXT("Removes every ghost from the race."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (ADroneGhostManager* Manager = World ? FindGhostManager(World) : nullptr)
+		{
+			Manager->ClearGhosts();
+		}
+	}));
@@ -0,0 +1,117 @@
+// DroneGhostManager.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "FlightCore/FlightGhost.h"
+#include "DroneGhostManager.generated.h"
+
+class UInstancedStaticMeshComponent;
+class UMaterialInterface;
+class UStaticMesh;
+
+/**
+ * Ghost laps for the race in this level. Records the player drone from the start gate to the
+ * finish, keeps the fastest lap as Saved/Ghosts/<Map>/PersonalBest.dghost, and plays any number
+ * of ghosts (personal best, leaderboard downloads) as instances of one mesh: no pawns, no
+ * collision, one spline evaluation per ghost per frame out of a shared decode cache.
+ */
+UCLASS()
+class DRONERACERFP_API ADroneGhostManager : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ADroneGhostManager();
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ghosts")
+	TObjectPtr<UStaticMesh> GhostMesh = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ghosts")
+	TObjectPtr<UMaterialInterface> GhostMaterial = nullptr;
+
+	/** Poses recorded per second; 30 is a few KB per minute of flight. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Ghosts", meta = (ClampMin = "5.0", ClampMax = "120.0", Units = "Hz"))
+	float SampleRateHz = 30.f;
+
+	/** Save the player's lap when it beats the stored personal best. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ghosts")
+	bool bRecordPersonalBest = true;
+
+	/** Fly the stored personal best as a ghost. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ghosts")
+	bool bRaceAgainstPersonalBest = true;
+
+	/** More ghosts from Saved/Ghosts/<Map>/, loaded at BeginPlay. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ghosts")
+	TArray<FString> GhostsToLoad;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Ghosts", meta = (ClampMin = "1"))
+	int32 MaxGhosts = 50;
+
+	UFUNCTION(BlueprintCallable, Category = "Ghosts")
+	bool AddGhostFromFile(const FString& Name);
+
+	/** The contents of a .dghost file, e.g. downloaded from a leaderboard. */
+	UFUNCTION(BlueprintCallable, Category = "Ghosts")
+	bool AddGhostData(const TArray<uint8>& FileData);
+
+	UFUNCTION(BlueprintCallable, Category = "Ghosts")
+	void ClearGhosts();
+
+	UFUNCTION(BlueprintPure, Category = "Ghosts")
+	int32 GetNumGhosts() const { return Ghosts.Num(); }
+
+	/** 0 until a lap has been stored for this level. */
+	UFUNCTION(BlueprintPure, Category = "Ghosts")
+	float GetPersonalBestSeconds() const { return PersonalBestSeconds; }
+
+	/** Fed by the drone every physics step while a lap is being recorded. */
+	bool IsRecording() const { return bRecording; }
+	void RecordStep(float StepSeconds, const FVector& Location, const FQuat& Rotation);
+
+	/** Saved/Ghosts/<Map>/<Name>.dghost */
+	static FString GetGhostPath(const UWorld* World, const FString& Name);
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void Tick(float DeltaSeconds) override;
+
+private:
+	struct FGhost
+	{
+		FFlightGhostTrack Track;
+		float LapSeconds = 0.f;
+		bool bPersonalBest = false;
+	};
+
+	bool AddGhost(const TArray<uint8>& FileData, bool bPersonalBest);
+	void RebuildPlayback();
+	void OnGatePassed(int32 GateIndex, bool bRaceComplete);
+	void FinishLap();
+
+	UPROPERTY(VisibleAnywhere, Category = "Ghosts")
+	TObjectPtr<UInstancedStaticMeshComponent> Instances;
+
+	// Pointers into these are held by Playback, hence the indirection
+	TArray<TUniquePtr<FGhost>> Ghosts;
+	FFlightGhostPlayback Playback;
+	TArray<FFlightGhostSample> Poses;
+	TArray<FTransform> InstanceTransforms;
+
+	double RaceStartTime = -1.0;    // world seconds at the start gate; < 0 before the race
+	float PersonalBestSeconds = 0.f;
+
+	bool bRecording = false;
+	FFlightGhostEncoder Recorder;
+	double RecordSeconds = 0.0;
+	double NextSampleSeconds = 0.0;
+	FVector PrevLocation = FVector::ZeroVector;
+	FQuat PrevRotation = FQuat::Identity;
+	bool bHasPrev = false;
+
+	FDelegateHandle GatePassedHandle;
+	TWeakObjectPtr<class ARaceGateManager> GateManager;
+};
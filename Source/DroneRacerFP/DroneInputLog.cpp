@@ -0,0 +1,172 @@
+// DroneInputLog.cpp
+
+#include "DroneInputLog.h"
+#include "DroneFPCharacter.h"
+#include "FlightCore/FlightInputLog.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+// The byte format lives in FlightCore (FlightInputLog) so headless tools and tests share it
+
+static_assert(RcChannel::Num == sizeof(FFlightInputLogSample::Sticks) / sizeof(float), "Input log stores one float per RC channel");
+
+void FDroneDeterministicInput::Reset(float InStepSeconds, const FRcAxisFilterSettings (&Settings)[RcChannel::Num])
+{
+	StepSeconds = InStepSeconds;
+	Filter.Configure(Settings, 1.f / InStepSeconds);
+	bPrimed = false;
+	Pending.Reset();
+	PendingHead = 0;
+	Current = FDroneInputSample();
+}
+
+void FDroneDeterministicInput::Push(const FDroneInputSample& Sample)
+{
+	Pending.Add(Sample);
+}
+
+FFlightInput FDroneDeterministicInput::Consume(int64 StepIndex)
+{
+	// Sample and hold: the newest sample that arrived before this step ends
+	const double StepEnd = (double)(StepIndex + 1) * StepSeconds;
+	while (PendingHead < Pending.Num() && Pending[PendingHead].Time < StepEnd)
+	{
+		Current = Pending[PendingHead++];
+	}
+	if (PendingHead == Pending.Num())
+	{
+		Pending.Reset();
+		PendingHead = 0;
+	}
+
+	float Setpoint[RcChannel::Num];
+	float Feedforward[RcChannel::Num] = {};
+	if (bPrimed)
+	{
+		Filter.Process(Current.Sticks, Setpoint, Feedforward);
+	}
+	else
+	{
+		Filter.Reset(Current.Sticks);
+		FMemory::Memcpy(Setpoint, Current.Sticks, sizeof(Setpoint));
+		bPrimed = true;
+	}
+
+	auto Command = [&Setpoint, &Feedforward](RcChannel::Type Channel) { return Setpoint[Channel] + Feedforward[Channel]; };
+
+	// Filter convention is "+ = stick up/right"; forward stick is nose down in the flight input
+	FFlightInput Input;
+	Input.Roll = FMath::Clamp(Command(RcChannel::Roll), -1.f, 1.f);
+	Input.Pitch = FMath::Clamp(-Command(RcChannel::Pitch), -1.f, 1.f);
+	Input.Yaw = FMath::Clamp(Command(RcChannel::Yaw), -1.f, 1.f);
+	Input.Throttle = FMath::Clamp(Command(RcChannel::Throttle), 0.f, 1.f);
+	Input.bArmed = Current.bArmed;
+	return Input;
+}
+
+void FDroneInputLog::Reset(float InStepSeconds, int64 InFirstStep, const FFlightState& InInitialState)
+{
+	StepSeconds = InStepSeconds;
+	FirstStep = InFirstStep;
+	InitialState = InInitialState;
+	Samples.Reset();
+	Checksums.Reset();
+}
+
+FString FDroneInputLog::GetLogPath(const FString& Name)
+{
+	return FPaths::ProjectSavedDir() / TEXT("FlightLogs") / FPaths::MakeValidFileName(Name, TEXT('_')) + TEXT(".dinput");
+}
+
+bool FDroneInputLog::SaveToFile(const FString& Name) const
+{
+	FFlightInputLogData Data;
+	Data.StepSeconds = StepSeconds;
+	Data.FirstStep = FirstStep;
+	Data.InitialState = InitialState;
+	Data.Samples.resize(Samples.Num());
+	for (int32 i = 0; i < Samples.Num(); ++i)
+	{
+		FFlightInputLogSample& Out = Data.Samples[i];
+		Out.Time = Samples[i].Time;
+		FMemory::Memcpy(Out.Sticks, Samples[i].Sticks, sizeof(Out.Sticks));
+		Out.bArmed = Samples[i].bArmed;
+	}
+	Data.Checksums.assign(Checksums.GetData(), Checksums.GetData() + Checksums.Num());
+
+	const std::vector<uint8_t> Bytes = EncodeFlightInputLog(Data);
+	return FFileHelper::SaveArrayToFile(TArrayView64<const uint8>(Bytes.data(), (int64)Bytes.size()), *GetLogPath(Name));
+}
+
+bool FDroneInputLog::LoadFromFile(const FString& Name)
+{
+	TArray<uint8> Bytes;
+	if (!FFileHelper::LoadFileToArray(Bytes, *GetLogPath(Name), FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	FFlightInputLogData Data;
+	if (!DecodeFlightInputLog(Bytes.GetData(), Bytes.Num(), Data))
+	{
+		return false;
+	}
+
+	StepSeconds = Data.StepSeconds;
+	FirstStep = Data.FirstStep;
+	InitialState = Data.InitialState;
+	Samples.SetNum((int32)Data.Samples.size());
+	for (int32 i = 0; i < Samples.Num(); ++i)
+	{
+		const FFlightInputLogSample& In = Data.Samples[i];
+		Samples[i].Time = In.Time;
+		FMemory::Memcpy(Samples[i].Sticks, In.Sticks, sizeof(In.Sticks));
+		Samples[i].bArmed = In.bArmed;
+	}
+	Checksums = TArray<uint32>(Data.Checksums.data(), (int32)Data.Checksums.size());
+	return true;
+}
+
+static ADroneFPCharacter* FindInputLogDrone(UWorld* World)
+{
+	TActorIterator<ADroneFPCharacter> Drone(World);
+	return Drone ? *Drone : nullptr;
+}
+
+static void RecordInputsCommand(const TArray<FString>& Args, UWorld* World)
+{
+	ADroneFPCharacter* Drone = World ? FindInputLogDrone(World) : nullptr;
+	if (!Drone)
+	{
+		return;
+	}
+
+	if (Drone->IsRecordingInputs())
+	{
+		Drone->StopInputRecording(Args.Num() > 0 ? Args[0] : TEXT("Last"));
+	}
+	else
+	{
+		Drone->StartInputRecording();
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GRecordInputsCommand(
+	TEXT("Drone.Flight.RecordInputs"),
+	TEXT("Starts a deterministic input recording of the player drone; run again to stop and save. Args: [Name=Last]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RecordInputsCommand));
+
+static void VerifyInputsCommand(const TArray<FString>& Args, UWorld* World)
+{
+	if (ADroneFPCharacter* Drone = World ? FindInputLogDrone(World) : nullptr)
+	{
+		Drone->VerifyInputLog(Args.Num() > 0 ? Args[0] : TEXT("Last"));
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GVerifyInputsCommand(
+	TEXT("Drone.Flight.VerifyInputs"),
+	TEXT("Replays a recorded input log against the drone's current tuning and compares every step's state checksum. Args: [Name=Last]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&VerifyInputsCommand));
@@ -0,0 +1,62 @@
+// DroneInputLog.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RcFilterChain.h"
+#include "FlightCore/FlightModel.h"
+
+/** Logical sticks as they arrived, before smoothing, stamped on the simulation clock. */
+struct FDroneInputSample
+{
+	double Time = 0.0;                  // s, step index * step length
+	float Sticks[RcChannel::Num] = {};  // FRcStickState convention: + = stick up/right, throttle 0..1
+	bool bArmed = false;
+};
+
+/**
+ * Turns timestamped stick samples into one FFlightInput per fixed step. Step N takes every
+ * sample stamped before its end (the latest wins) and runs the RC filter chain once at the
+ * step rate, so nothing depends on frame timing: live play and a replay of the same samples
+ * produce the same inputs.
+ */
+class DRONERACERFP_API FDroneDeterministicInput
+{
+public:
+	void Reset(float InStepSeconds, const FRcAxisFilterSettings (&Settings)[RcChannel::Num]);
+
+	/** Samples must arrive in time order. */
+	void Push(const FDroneInputSample& Sample);
+
+	FFlightInput Consume(int64 StepIndex);
+
+private:
+	float StepSeconds = 0.f;
+	FRcFilterBank Filter;
+	bool bPrimed = false;
+
+	TArray<FDroneInputSample> Pending;
+	int32 PendingHead = 0;
+	FDroneInputSample Current;
+};
+
+/**
+ * Everything needed to reproduce a deterministic run besides the drone's tuning and the level:
+ * start state, stick samples and the state checksum after every step.
+ */
+struct DRONERACERFP_API FDroneInputLog
+{
+	float StepSeconds = 0.f;
+	int64 FirstStep = 0;
+	FFlightState InitialState;
+	TArray<FDroneInputSample> Samples;
+	TArray<uint32> Checksums;
+
+	void Reset(float InStepSeconds, int64 InFirstStep, const FFlightState& InInitialState);
+
+	/** Saved/FlightLogs/<Name>.dinput */
+	static FString GetLogPath(const FString& Name);
+
+	bool SaveToFile(const FString& Name) const;
+	bool LoadFromFile(const FString& Name);
+};
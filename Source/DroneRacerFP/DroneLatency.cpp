@@ -0,0 +1,240 @@
+// DroneLatency.cpp
+
+#include "DroneLatency.h"
+#include "Framework/Application/SlateApplication.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+#include "Rendering/SlateRenderer.h"
+#include "RenderingThread.h"
+
+#include <atomic>
+
+DEFINE_LOG_CATEGORY_STATIC(LogDroneLatency, Log, All);
+
+DECLARE_STATS_GROUP(TEXT("DroneLatency"), STATGROUP_DroneLatency, STATCAT_Advanced);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Device read to input (ms)"), STAT_DroneLatencyInput, STATGROUP_DroneLatency);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Input to simulation (ms)"), STAT_DroneLatencySimulated, STATGROUP_DroneLatency);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Simulation to camera (ms)"), STAT_DroneLatencyCamera, STATGROUP_DroneLatency);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Camera to render thread (ms)"), STAT_DroneLatencyRenderThread, STATGROUP_DroneLatency);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Render thread to present (ms)"), STAT_DroneLatencyPresent, STATGROUP_DroneLatency);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Input to present (ms)"), STAT_DroneLatencyTotal, STATGROUP_DroneLatency);
+
+namespace
+{
+	struct FLatencyFrame
+	{
+		uint64 Cycles[DroneLatencyStage::Num] = {};
+	};
+
+	constexpr int32 LatencyHistorySize = 1024;
+	constexpr int32 LatencyCompletedSize = 8;
+
+	struct FLatencyState
+	{
+		std::atomic<uint64> PendingRead{ 0 };
+
+		// Game thread
+		uint64 PendingInput = 0;
+		FLatencyFrame Building;
+		uint64 LastCameraFrame = MAX_uint64;
+		bool bPresentHooked = false;
+		FLatencyFrame History[LatencyHistorySize];
+		int32 NumHistory = 0;
+		int32 HistoryHead = 0;
+
+		// Render thread
+		FLatencyFrame InFlight;
+		bool bInFlight = false;
+
+		// Render thread -> game thread, a frame or two at a time
+		FCriticalSection CompletedLock;
+		FLatencyFrame Completed[LatencyCompletedSize];
+		int32 NumCompleted = 0;
+	};
+
+	FLatencyState& GetLatencyState()
+	{
+		static FLatencyState State;
+		return State;
+	}
+
+	double LatencyStageMs(const FLatencyFrame& Frame, int32 From, int32 To)
+	{
+		return FPlatformTime::ToMilliseconds64(Frame.Cycles[To] - Frame.Cycles[From]);
+	}
+
+	void OnLatencyBackBufferReady(SWindow&, const FTextureRHIRef&)
+	{
+		FLatencyState& State = GetLatencyState();
+		if (!State.bInFlight)
+		{
+			return;
+		}
+		State.bInFlight = false;
+		State.InFlight.Cycles[DroneLatencyStage::Present] = FPlatformTime::Cycles64();
+
+		FScopeLock Lock(&State.CompletedLock);
+		if (State.NumCompleted < LatencyCompletedSize)
+		{
+			State.Completed[State.NumCompleted++] = State.InFlight;
+		}
+	}
+
+	void PublishLatencyFrame(FLatencyState& State, const FLatencyFrame& Frame)
+	{
+		using namespace DroneLatencyStage;
+		SET_FLOAT_STAT(STAT_DroneLatencyInput, LatencyStageMs(Frame, DeviceRead, InputEvent));
+		SET_FLOAT_STAT(STAT_DroneLatencySimulated, LatencyStageMs(Frame, InputEvent, Simulated));
+		SET_FLOAT_STAT(STAT_DroneLatencyCamera, LatencyStageMs(Frame, Simulated, Camera));
+		SET_FLOAT_STAT(STAT_DroneLatencyRenderThread, LatencyStageMs(Frame, Camera, RenderThread));
+		SET_FLOAT_STAT(STAT_DroneLatencyPresent, LatencyStageMs(Frame, RenderThread, Present));
+		SET_FLOAT_STAT(STAT_DroneLatencyTotal, LatencyStageMs(Frame, DeviceRead, Present));
+
+		State.History[State.HistoryHead] = Frame;
+		State.HistoryHead = (State.HistoryHead + 1) % LatencyHistorySize;
+		State.NumHistory = FMath::Min(State.NumHistory + 1, LatencyHistorySize);
+	}
+}
+
+void FDroneLatency::StampDeviceRead()
+{
+	uint64 Expected = 0;
+	GetLatencyState().PendingRead.compare_exchange_strong(Expected, FPlatformTime::Cycles64(), std::memory_order_relaxed);
+}
+
+void FDroneLatency::StampInputEvent(bool bDeviceReport)
+{
+	FLatencyState& State = GetLatencyState();
+	if (bDeviceReport && State.PendingRead.load(std::memory_order_relaxed) == 0)
+	{
+		return;
+	}
+	if (State.PendingInput == 0)
+	{
+		State.PendingInput = FPlatformTime::Cycles64();
+	}
+}
+
+void FDroneLatency::StampSimulated()
+{
+	FLatencyState& State = GetLatencyState();
+	if (State.PendingInput == 0 || State.Building.Cycles[DroneLatencyStage::Simulated] != 0)
+	{
+		return;
+	}
+
+	// Keyboard / gamepad input has no device stamp of its own: it starts at the input event
+	const uint64 Read = State.PendingRead.exchange(0, std::memory_order_relaxed);
+	State.Building.Cycles[DroneLatencyStage::DeviceRead] = (Read != 0 && Read <= State.PendingInput) ? Read : State.PendingInput;
+	State.Building.Cycles[DroneLatencyStage::InputEvent] = State.PendingInput;
+	State.Building.Cycles[DroneLatencyStage::Simulated] = FPlatformTime::Cycles64();
+	State.PendingInput = 0;
+}
+
+void FDroneLatency::StampCamera()
+{
+	FLatencyState& State = GetLatencyState();
+
+	if (!State.bPresentHooked && FSlateApplication::IsInitialized() && FSlateApplication::Get().GetRenderer())
+	{
+		FSlateApplication::Get().GetRenderer()->OnBackBufferReadyToPresent().AddStatic(&OnLatencyBackBufferReady);
+		State.bPresentHooked = true;
+	}
+
+	// Whatever the render thread finished since last frame
+	{
+		FLatencyFrame Done[LatencyCompletedSize];
+		int32 NumDone;
+		{
+			FScopeLock Lock(&State.CompletedLock);
+			NumDone = State.NumCompleted;
+			FMemory::Memcpy(Done, State.Completed, NumDone * sizeof(FLatencyFrame));
+			State.NumCompleted = 0;
+		}
+		for (int32 i = 0; i < NumDone; ++i)
+		{
+			PublishLatencyFrame(State, Done[i]);
+		}
+	}
+
+	// Once per frame, and only for frames that show a new input
+	if (State.LastCameraFrame == GFrameCounter || State.Building.Cycles[DroneLatencyStage::Simulated] == 0)
+	{
+		return;
+	}
+	State.LastCameraFrame = GFrameCounter;
+
+	FLatencyFrame Frame = State.Building;
+	Frame.Cycles[DroneLatencyStage::Camera] = FPlatformTime::Cycles64();
+	State.Building = FLatencyFrame();
+
+	// Runs ahead of this frame's scene and Slate draws, so the next back buffer is this frame's
+	ENQUEUE_RENDER_COMMAND(DroneLatencyRenderThread)([Frame](FRHICommandListImmediate&)
+	{
+		FLatencyState& RenderState = GetLatencyState();
+		RenderState.InFlight = Frame;
+		RenderState.InFlight.Cycles[DroneLatencyStage::RenderThread] = FPlatformTime::Cycles64();
+		RenderState.bInFlight = true;
+	});
+}
+
+void FDroneLatency::LogSummary()
+{
+	const FLatencyState& State = GetLatencyState();
+	if (State.NumHistory == 0)
+	{
+		UE_LOG(LogDroneLatency, Display, TEXT("No latency samples yet: move a stick"));
+		return;
+	}
+
+	static const TCHAR* StageNames[] = {
+		TEXT("Device read -> input"),
+		TEXT("Input -> simulation"),
+		TEXT("Simulation -> camera"),
+		TEXT("Camera -> render thread"),
+		TEXT("Render thread -> present"),
+		TEXT("Total (read -> present)")
+	};
+
+	UE_LOG(LogDroneLatency, Display, TEXT("Input-to-present latency over %d frames (ms):"), State.NumHistory);
+	TArray<double> Values;
+	Values.Reserve(State.NumHistory);
+	for (int32 Stage = 0; Stage < DroneLatencyStage::Num; ++Stage)
+	{
+		const int32 From = Stage < DroneLatencyStage::Num - 1 ? Stage : DroneLatencyStage::DeviceRead;
+		const int32 To = Stage < DroneLatencyStage::Num - 1 ? Stage + 1 : DroneLatencyStage::Present;
+
+		Values.Reset();
+		double Sum = 0.0;
+		for (int32 i = 0; i < State.NumHistory; ++i)
+		{
+			Values.Add(LatencyStageMs(State.History[i], From, To));
+			Sum += Values.Last();
+		}
+		Values.Sort();
+
+		UE_LOG(LogDroneLatency, Display, TEXT("  %-26s mean %6.2f  p50 %6.2f  p99 %6.2f  max %6.2f"),
+			StageNames[Stage], Sum / Values.Num(), Values[Values.Num() / 2],
+			Values[FMath::Min(Values.Num() * 99 / 100, Values.Num() - 1)], Values.Last());
+	}
+}
+
+void FDroneLatency::ResetHistory()
+{
+	FLatencyState& State = GetLatencyState();
+	State.NumHistory = 0;
+	State.HistoryHead = 0;
+}
+
+static FAutoConsoleCommand GDroneLatencyCommand(
+	TEXT("Drone.Latency"),
+	TEXT("Prints the input-to-present latency breakdown of the last 1024 frames that showed a new input. Args: [Reset]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic([](const TArray<FString>& Args)
+	{
+		if (Args.Num() > 0 && Args[0].Equals(TEXT("Reset"), ESearchCase::IgnoreCase))
+		{
+			FDroneLatency::ResetHistory();
+			return;
+		}
+		FDroneLatency::LogSummary();
+	}));
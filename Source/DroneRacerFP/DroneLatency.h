@@ -0,0 +1,55 @@
+// DroneLatency.h
+//
+// Input-to-photon latency, stage by stage. The oldest input nobody has simulated yet carries
+// its timestamp through the frame that first shows it:
+//
+//   DeviceRead   report read off the device (DJI reader thread, raw input handler)
+//   InputEvent   stick value reached the pawn (aggregator push or Enhanced Input handler)
+//   Simulated    first flight step that used it
+//   Camera       view computed for that frame
+//   RenderThread render thread started on that frame
+//   Present      back buffer handed to the swap chain
+//
+// Scan-out and the display itself come after Present and are out of software's reach.
+// "stat DroneLatency" shows the last frame; Drone.Latency prints percentiles.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace DroneLatencyStage
+{
+	enum Type : int32
+	{
+		DeviceRead,
+		InputEvent,
+		Simulated,
+		Camera,
+		RenderThread,
+		Present,
+		Num
+	};
+}
+
+class DRONERACERFP_API FDroneLatency
+{
+public:
+	/** Any thread, as soon as a report is read. Only the oldest unconsumed read is kept. */
+	static void StampDeviceRead();
+
+	/**
+	 * Game thread, when a stick value arrives at the pawn. Pass only changes, not repeats.
+	 * Device reports arrive unchanged too; with bDeviceReport they only count after a changed read.
+	 */
+	static void StampInputEvent(bool bDeviceReport = false);
+
+	/** Game thread, before the flight steps of a frame. */
+	static void StampSimulated();
+
+	/** Game thread, once the frame's view is known; sends the frame on to the render thread. */
+	static void StampCamera();
+
+	/** Logs mean / p50 / p99 / max of every stage over the recent frames. */
+	static void LogSummary();
+	static void ResetHistory();
+};
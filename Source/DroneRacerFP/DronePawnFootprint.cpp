@@ -0,0 +1,204 @@
+// DronePawnFootprint.cpp
+//
+// Per-drone cost of the pawn shell, against the ACharacter layout the drone used to be built on:
+// capsule, deactivated character movement, the inherited and the first-person skeletal meshes.
+// Spawns Count of each with the same camera and input components, then measures memory,
+// components, enabled component ticks, one tick of those components, and the teleport the
+// flight model does every frame. Best run in an empty level:
+//   Drone.Bench.PawnFootprint 64
+
+#include "CoreMinimal.h"
+#include "HAL/IConsoleManager.h"
+#include "Serialization/ArchiveCountMem.h"
+#include "Camera/CameraComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "Engine/World.h"
+#include "DroneFPCharacter.h"
+#include "GenericHidInputComponent.h"
+#include "ControllerAxisAggregatorComponent.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogDroneFootprint, Log, All);
+
+namespace
+{
+	struct FPawnFootprint
+	{
+		int32 Components = 0;
+		int32 TickingComponents = 0;
+		int64 Bytes = 0;
+		double TickMicroseconds = 0.0;
+		double MoveMicroseconds = 0.0;
+	};
+
+	constexpr int32 FootprintIterations = 200;
+
+	template <typename ComponentType>
+	ComponentType* AddFootprintComponent(AActor* Owner, FName Name, USceneComponent* Parent = nullptr)
+	{
+		ComponentType* Component = NewObject<ComponentType>(Owner, Name);
+		if constexpr (TIsDerivedFrom<ComponentType, USceneComponent>::Value)
+		{
+			Component->SetupAttachment(Parent ? Parent : Owner->GetRootComponent());
+		}
+		return Component;
+	}
+
+	/** What ADroneFPCharacter looked like on ACharacter, set up the way its constructor and BeginPlay did. */
+	AActor* SpawnCharacterLayout(UWorld* World, const FTransform& Transform)
+	{
+		ACharacter* Character = World->SpawnActorDeferred<ACharacter>(ACharacter::StaticClass(), Transform, nullptr, nullptr,
+			ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		Character->AutoPossessPlayer = EAutoReceiveInput::Disabled;
+		Character->GetCapsuleComponent()->InitCapsuleSize(12.f, 7.f);
+
+		UCharacterMovementComponent* MoveComp = Character->GetCharacterMovement();
+		MoveComp->SetMovementMode(MOVE_Flying);
+		MoveComp->GravityScale = 0.f;
+		MoveComp->bOrientRotationToMovement = false;
+		MoveComp->Deactivate();
+		Character->FinishSpawning(Transform);
+
+		USkeletalMeshComponent* Mesh1P = AddFootprintComponent<USkeletalMeshComponent>(Character, TEXT("CharacterMesh1P"));
+		Mesh1P->SetHiddenInGame(true);
+		Mesh1P->SetVisibility(false, true);
+		Mesh1P->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+		USceneComponent* Pivot = AddFootprintComponent<USceneComponent>(Character, TEXT("CameraTiltPivot"));
+		Pivot->SetRelativeLocation(FVector(0.f, 0.f, 64.f));
+		UCameraComponent* Camera = AddFootprintComponent<UCameraComponent>(Character, TEXT("FirstPersonCamera"), Pivot);
+
+		UGenericHidInputComponent* GenericHid = AddFootprintComponent<UGenericHidInputComponent>(Character, TEXT("GenericHid"));
+		GenericHid->bAutoStart = false;
+		UControllerAxisAggregatorComponent* AxisAgg = AddFootprintComponent<UControllerAxisAggregatorComponent>(Character, TEXT("AxisAgg"));
+
+		for (UActorComponent* Component : TArray<UActorComponent*>{ Mesh1P, Pivot, Camera, GenericHid, AxisAgg })
+		{
+			Character->AddInstanceComponent(Component);
+			Component->RegisterComponent();
+		}
+		return Character;
+	}
+
+	AActor* SpawnDronePawn(UWorld* World, const FTransform& Transform)
+	{
+		ADroneFPCharacter* Drone = World->SpawnActorDeferred<ADroneFPCharacter>(ADroneFPCharacter::StaticClass(), Transform, nullptr, nullptr,
+			ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		Drone->AutoPossessPlayer = EAutoReceiveInput::Disabled;
+		if (UGenericHidInputComponent* GenericHid = Drone->FindComponentByClass<UGenericHidInputComponent>())
+		{
+			GenericHid->bAutoStart = false;
+		}
+		Drone->FinishSpawning(Transform);
+		return Drone;
+	}
+
+	FPawnFootprint MeasureFootprint(UWorld* World, int32 Count, TFunctionRef<AActor*(UWorld*, const FTransform&)> Spawn)
+	{
+		FPawnFootprint Result;
+
+		// Far from the course so nothing overlaps
+		TArray<AActor*> Actors;
+		for (int32 i = 0; i < Count; ++i)
+		{
+			const FTransform Transform(FVector(i * 100.f, 0.f, 1000000.f));
+			if (AActor* Actor = Spawn(World, Transform))
+			{
+				Actors.Add(Actor);
+			}
+		}
+		if (Actors.Num() == 0)
+		{
+			return Result;
+		}
+
+		TArray<UActorComponent*> Ticking;
+		for (AActor* Actor : Actors)
+		{
+			TInlineComponentArray<UActorComponent*> Components(Actor);
+			Result.Components += Components.Num();
+
+			FArchiveCountMem ActorCount(Actor);
+			Result.Bytes += Actor->GetClass()->GetStructureSize() + ActorCount.GetMax();
+			for (UActorComponent* Component : Components)
+			{
+				FArchiveCountMem ComponentCount(Component);
+				Result.Bytes += Component->GetClass()->GetStructureSize() + ComponentCount.GetMax()
+					+ Component->GetResourceSizeBytes(EResourceSizeMode::Exclusive);
+
+				if (Component->IsRegistered() && Component->PrimaryComponentTick.IsTickFunctionEnabled())
+				{
+					Ticking.Add(Component);
+				}
+			}
+		}
+		Result.TickingComponents = Ticking.Num();
+
+		const float DeltaTime = 1.f / 60.f;
+		double Start = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < FootprintIterations; ++Iteration)
+		{
+			for (UActorComponent* Component : Ticking)
+			{
+				Component->TickComponent(DeltaTime, LEVELTICK_All, &Component->PrimaryComponentTick);
+			}
+		}
+		Result.TickMicroseconds = (FPlatformTime::Seconds() - Start) * 1e6 / FootprintIterations;
+
+		Start = FPlatformTime::Seconds();
+		for (int32 Iteration = 0; Iteration < FootprintIterations; ++Iteration)
+		{
+			const FQuat Rotation(FVector::UpVector, Iteration * 0.01f);
+			for (AActor* Actor : Actors)
+			{
+				Actor->SetActorLocationAndRotation(Actor->GetActorLocation() + FVector(0.f, 0.f, (Iteration & 1) ? 1.f : -1.f), Rotation,
+					false, nullptr, ETeleportType::TeleportPhysics);
+			}
+		}
+		Result.MoveMicroseconds = (FPlatformTime::Seconds() - Start) * 1e6 / FootprintIterations;
+
+		const int32 Num = Actors.Num();
+		for (AActor* Actor : Actors)
+		{
+			Actor->Destroy();
+		}
+
+		Result.Components /= Num;
+		Result.TickingComponents /= Num;
+		Result.Bytes /= Num;
+		Result.TickMicroseconds /= Num;
+		Result.MoveMicroseconds /= Num;
+		return Result;
+	}
+
+	void LogFootprint(const TCHAR* Name, const FPawnFootprint& Footprint)
+	{
+		UE_LOG(LogDroneFootprint, Display, TEXT("  %-22s %3d components, %2d ticking | %7.1f KB | tick %6.2f us | move %6.2f us"),
+			Name, Footprint.Components, Footprint.TickingComponents, Footprint.Bytes / 1024.0,
+			Footprint.TickMicroseconds, Footprint.MoveMicroseconds);
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GPawnFootprintCommand(
+	TEXT("Drone.Bench.PawnFootprint"),
+	TEXT("Per-drone memory and game thread cost of the APawn drone against the old ACharacter layout. Args: [Count=32]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (!World)
+		{
+			return;
+		}
+		const int32 Count = Args.Num() > 0 ? FMath::Clamp(FCString::Atoi(*Args[0]), 1, 1024) : 32;
+
+		const FPawnFootprint Character = MeasureFootprint(World, Count, &SpawnCharacterLayout);
+		const FPawnFootprint Pawn = MeasureFootprint(World, Count, &SpawnDronePawn);
+
+		UE_LOG(LogDroneFootprint, Display, TEXT("Per drone, %d of each, %d iterations:"), Count, FootprintIterations);
+		LogFootprint(TEXT("ACharacter layout"), Character);
+		LogFootprint(TEXT("ADroneFPCharacter"), Pawn);
+		UE_LOG(LogDroneFootprint, Display, TEXT("  saved %.1f KB and %.2f us per drone per frame"),
+			(Character.Bytes - Pawn.Bytes) / 1024.0,
+			(Character.TickMicroseconds + Character.MoveMicroseconds) - (Pawn.TickMicroseconds + Pawn.MoveMicroseconds));
+	}));
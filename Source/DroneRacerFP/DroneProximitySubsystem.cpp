@@ -0,0 +1,211 @@
+// DroneProximitySubsystem.cpp
+
+#include "DroneProximitySubsystem.h"
+#include "DroneCourseVoxelizer.h"
+#include "DroneFlightCollision.h"
+#include "DroneFPCharacter.h"
+#include "RaceGate.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogDroneProximity, Log, All);
+
+static TAutoConsoleVariable<int32> CVarProximityCache(
+	TEXT("Drone.Collision.ProximityCache"),
+	1,
+	TEXT("Skip collision sweeps the baked clearance field proves free. 0 = always sweep."),
+	ECVF_Default);
+
+bool UDroneProximitySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UDroneProximitySubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+	BuildField();
+}
+
+void UDroneProximitySubsystem::BuildField()
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	FBox Course(ForceInit);
+	for (TActorIterator<ARaceGate> It(World); It; ++It)
+	{
+		Course += It->GetComponentsBoundingBox(/*bNonColliding=*/true);
+	}
+	if (!Course.IsValid)
+	{
+		UE_LOG(LogDroneProximity, Log, TEXT("No race gates; proximity field not built"));
+		Field = FFlightProximityField();
+		return;
+	}
+	Course = Course.ExpandBy(CourseMargin);
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	float Cell = FMath::Max(CellSize, 10.f);
+	FIntVector Num;
+	for (;;)
+	{
+		const FVector Size = Course.GetSize();
+		Num = FIntVector(
+			FMath::CeilToInt32(Size.X / Cell),
+			FMath::CeilToInt32(Size.Y / Cell),
+			FMath::CeilToInt32(Size.Z / Cell));
+		if ((int64)Num.X * Num.Y * Num.Z <= MaxCells)
+		{
+			break;
+		}
+		Cell *= 1.25f;
+	}
+
+	Field.Init(ToFlight(Course.Min), Cell, Num.X, Num.Y, Num.Z);
+
+	const int64 NumQueries = VoxelizeDroneCourse(*World, Course.Min, Cell, Num,
+		[this](int32 X, int32 Y, int32 Z) { Field.SetBlocked(X, Y, Z); });
+
+	Field.Build();
+
+	UE_LOG(LogDroneProximity, Log, TEXT("Proximity field: %dx%dx%d cells of %.0f cm, %lld blocked, %lld overlap queries, %.1f ms"),
+		Num.X, Num.Y, Num.Z, Cell, Field.GetNumBlocked(), NumQueries, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+const FFlightProximityField* UDroneProximitySubsystem::GetField() const
+{
+	return CVarProximityCache.GetValueOnGameThread() != 0 && Field.IsBuilt() ? &Field : nullptr;
+}
+
+void UDroneProximitySubsystem::StartLapRecording()
+{
+	LapLocations.Reset();
+	LapRotations.Reset();
+	bRecordingLap = true;
+}
+
+void UDroneProximitySubsystem::StopLapRecording()
+{
+	bRecordingLap = false;
+}
+
+void UDroneProximitySubsystem::RecordLapSample(const FVector& Location, const FQuat& Rotation)
+{
+	LapLocations.Add(Location);
+	LapRotations.Add(Rotation);
+}
+
+void UDroneProximitySubsystem::RunLapBenchmark(const UCapsuleComponent& Capsule) const
+{
+	if (LapLocations.Num() < 2)
+	{
+		UE_LOG(LogDroneProximity, Warning, TEXT("No lap recorded (Drone.Collision.RecordLap, fly, Drone.Collision.RecordLap)"));
+		return;
+	}
+	if (!Field.IsBuilt())
+	{
+		UE_LOG(LogDroneProximity, Warning, TEXT("Proximity field not built"));
+		return;
+	}
+
+	// Every consecutive pair of samples is one flight step's sweep
+	auto Replay = [this, &Capsule](const FFlightProximityField* UseField, TArray<bool>& OutHits, FDroneCapsuleCollision& Collision)
+	{
+		Collision.SetProximityField(UseField);
+		OutHits.SetNumUninitialized(LapLocations.Num() - 1);
+
+		const double Start = FPlatformTime::Seconds();
+		for (int32 i = 1; i < LapLocations.Num(); ++i)
+		{
+			const FFlightVec3 From = ToFlight(LapLocations[i - 1]);
+			FFlightContact Contact;
+			OutHits[i - 1] = Collision.Sweep(From, ToFlight(LapLocations[i]) - From, ToFlight(LapRotations[i - 1]), Contact);
+		}
+		return FPlatformTime::Seconds() - Start;
+	};
+
+	TArray<bool> HitsFull;
+	TArray<bool> HitsCached;
+	FDroneCapsuleCollision Full(&Capsule);
+	FDroneCapsuleCollision Cached(&Capsule);
+	const double FullSeconds = Replay(nullptr, HitsFull, Full);
+	const double CachedSeconds = Replay(&Field, HitsCached, Cached);
+
+	int32 Mismatches = 0;
+	for (int32 i = 0; i < HitsFull.Num(); ++i)
+	{
+		Mismatches += HitsFull[i] != HitsCached[i] ? 1 : 0;
+	}
+
+	const int32 Queries = Cached.NumQueries;
+	UE_LOG(LogDroneProximity, Display, TEXT("Lap of %d sweeps | full: %.3f ms (%.2f us/sweep) | cached: %.3f ms (%.2f us/sweep), %d physics sweeps, %.1f%% skipped, %.1f%% shortened | %.2fx | %d hit mismatches"),
+		Queries,
+		FullSeconds * 1000.0, FullSeconds * 1e6 / Queries,
+		CachedSeconds * 1000.0, CachedSeconds * 1e6 / Queries,
+		Queries - Cached.NumSkipped,
+		100.0 * Cached.NumSkipped / Queries, 100.0 * Cached.NumShortened / Queries,
+		FullSeconds / FMath::Max(CachedSeconds, 1e-9),
+		Mismatches);
+}
+
+static void RecordProximityLapCommand(const TArray<FString>& /*Args*/, UWorld* World)
+{
+	UDroneProximitySubsystem* Proximity = World ? World->GetSubsystem<UDroneProximitySubsystem>() : nullptr;
+	if (!Proximity)
+	{
+		return;
+	}
+
+	if (Proximity->IsRecordingLap())
+	{
+		Proximity->StopLapRecording();
+		UE_LOG(LogDroneProximity, Display, TEXT("Lap recorded: %d flight steps"), Proximity->GetNumLapSamples());
+	}
+	else
+	{
+		Proximity->StartLapRecording();
+		UE_LOG(LogDroneProximity, Display, TEXT("Recording lap; run Drone.Collision.RecordLap again to stop"));
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GRecordProximityLapCommand(
+	TEXT("Drone.Collision.RecordLap"),
+	TEXT("Starts/stops recording the player drone's flight steps for Drone.Collision.BenchmarkProximity."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RecordProximityLapCommand));
+
+static void BenchmarkProximityCommand(const TArray<FString>& /*Args*/, UWorld* World)
+{
+	UDroneProximitySubsystem* Proximity = World ? World->GetSubsystem<UDroneProximitySubsystem>() : nullptr;
+	TActorIterator<ADroneFPCharacter> Drone(World);
+	if (!Proximity || !Drone)
+	{
+		UE_LOG(LogDroneProximity, Warning, TEXT("Needs a world with a drone"));
+		return;
+	}
+	Proximity->RunLapBenchmark(*Drone->GetCapsuleComponent());
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GBenchmarkProximityCommand(
+	TEXT("Drone.Collision.BenchmarkProximity"),
+	TEXT("Replays the recorded lap's sweeps with and without the proximity field and compares them."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&BenchmarkProximityCommand));
+
+static void RebuildProximityCommand(const TArray<FString>& /*Args*/, UWorld* World)
+{
+	if (UDroneProximitySubsystem* Proximity = World ? World->GetSubsystem<UDroneProximitySubsystem>() : nullptr)
+	{
+		Proximity->BuildField();
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GRebuildProximityCommand(
+	TEXT("Drone.Collision.RebuildProximity"),
+	TEXT("Re-bakes the proximity field from the current level geometry."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&RebuildProximityCommand));
@@ -0,0 +1,59 @@
+// DroneProximitySubsystem.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FlightCore/FlightProximity.h"
+#include "DroneProximitySubsystem.generated.h"
+
+class UCapsuleComponent;
+
+/**
+ * Clearance field over the race course, baked once when the world begins play, which lets the
+ * drones' collision skip sweeps through open air (see FDroneCapsuleCollision).
+ *
+ * Only geometry present at BeginPlay is baked: anything that moves or spawns later is not in
+ * the field, so levels with moving obstacles should turn it off (Drone.Collision.ProximityCache 0)
+ * or rebuild it (Drone.Collision.RebuildProximity).
+ *
+ * Also records a lap of drone poses to measure the saving on (Drone.Collision.BenchmarkProximity).
+ */
+UCLASS()
+class DRONERACERFP_API UDroneProximitySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	/** Bakes the field over the race gates' bounds plus a margin. */
+	void BuildField();
+
+	/** The baked field, or null when it is disabled or not built. */
+	const FFlightProximityField* GetField() const;
+
+	void StartLapRecording();
+	void StopLapRecording();
+	bool IsRecordingLap() const { return bRecordingLap; }
+	void RecordLapSample(const FVector& Location, const FQuat& Rotation);
+	int32 GetNumLapSamples() const { return LapLocations.Num(); }
+
+	/** Replays the recorded lap as sweeps of Capsule, with and without the field, and logs both. */
+	void RunLapBenchmark(const UCapsuleComponent& Capsule) const;
+
+	/** Cell size to start from (cm); grown until the grid fits MaxCells. */
+	float CellSize = 100.f;
+	int64 MaxCells = 2 * 1024 * 1024;
+
+	/** Free space kept around the gates' bounds (cm). */
+	float CourseMargin = 2000.f;
+
+private:
+	FFlightProximityField Field;
+
+	bool bRecordingLap = false;
+	TArray<FVector> LapLocations;
+	TArray<FQuat> LapRotations;
+};
@@ -27,6 +27,10 @@ public class DroneRacerFP : ModuleRules
         PrivateDependencyModuleNames.AddRange(
             new string[]
             {
+                "Json",
+                "JsonUtilities",
+                "RenderCore",
+                "RHI"
             }
         );
 
@@ -10,6 +10,9 @@
 #include "InputActionValue.h"
 
 #include "DroneControllerCalibrationWidget.h"
+#include "ControllerAxisAggregatorComponent.h"
+#include "ControllerCalibrationStore.h"
+#include "Engine/GameInstance.h"
 #include "Kismet/GameplayStatics.h"
 
 void ADroneRacerFPPlayerController::BeginPlay()
@@ -96,37 +99,56 @@ void ADroneRacerFPPlayerController::ShowControllerCalibration()
         return;
     }
 
-    // 1) Decide which controller/device you're calibrating
-    // For now: pick a stable string for the active device.
-    // If you don't have per-device IDs yet, start with "Player0" and upgrade later.
-    const FString DeviceId = TEXT("Player0");  // TODO: replace with real per-device ID
+    // 1) The device we're calibrating is whatever the pawn's aggregator is fed by
+    APawn* MyPawn = GetPawn();
+    UControllerAxisAggregatorComponent* AxisAgg =
+        MyPawn ? MyPawn->FindComponentByClass<UControllerAxisAggregatorComponent>() : nullptr;
+
+    if (!AxisAgg)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ShowControllerCalibration: pawn has no UControllerAxisAggregatorComponent"));
+        CalibrationWidget = nullptr;
+        return;
+    }
+
+    const FString DeviceId = AxisAgg->DeviceId.IsEmpty() ? TEXT("Player0") : AxisAgg->DeviceId;
     CalibrationWidget->DeviceId = DeviceId;
+    CalibrationWidget->InitWithAxisAggregator(AxisAgg);
 
     // 2) Bind: provide raw axis state each tick
-    CalibrationWidget->OnGetRawState.BindLambda([this, DeviceId](FControllerRawState& OutState) -> bool
+    TWeakObjectPtr<UControllerAxisAggregatorComponent> WeakAgg(AxisAgg);
+    CalibrationWidget->OnGetRawState.BindLambda([WeakAgg, DeviceId](FControllerRawState& OutState) -> bool
         {
+            UControllerAxisAggregatorComponent* Agg = WeakAgg.Get();
+            if (!Agg || !Agg->GetRawState(OutState))
+            {
+                return false;
+            }
             OutState.DeviceId = DeviceId;
-
-            // ---- YOU MUST FILL THIS ----
-            // Provide ALL raw axis values in a consistent order each frame.
-            // Example placeholder: reading 8 axes from your own input aggregator.
-            OutState.Axes.Reset();
-
-            // TODO: Replace these with your real raw axes readout:
-            // OutState.Axes.Add(GetRawAxis(0));
-            // ...
-            // For now, return false so calibration doesn't run until implemented.
-            return false;
+            return true;
         });
 
-    // 3) Bind: receive completed calibration
-    CalibrationWidget->OnCalibrationFinished.BindLambda([this](const FControllerCalibration& Result)
+    // 3) Bind: receive completed calibration, persist it and apply it right away
+    CalibrationWidget->OnCalibrationFinished.BindLambda([this, WeakAgg](const FControllerCalibration& Result)
         {
             UE_LOG(LogTemp, Log, TEXT("Calibration finished for %s. Mappings=%d"),
                 *Result.DeviceId, Result.Mappings.Num());
 
-            // TODO: save Result to disk (next section)
-            // SaveCalibration(Result);
+            FControllerCalibrationProfile Profile;
+            Profile.Calibration = Result;
+
+            if (UControllerAxisAggregatorComponent* Agg = WeakAgg.Get())
+            {
+                Profile.AxisCalibrations = Agg->GetAxisCalibrations();
+                Agg->ApplyCalibrationProfile(Profile);
+            }
+
+            // Runs when the widget finishes, possibly during shutdown: the game instance may be gone
+            const UGameInstance* GI = GetGameInstance();
+            if (UControllerCalibrationStore* Store = GI ? GI->GetSubsystem<UControllerCalibrationStore>() : nullptr)
+            {
+                Store->SaveProfile(Profile);
+            }
 
             if (CalibrationWidget)
             {
@@ -0,0 +1,487 @@
+// DroneTelemetry.cpp
+
+#include "DroneTelemetry.h"
+#include "CanvasItem.h"
+#include "Debug/DebugDrawService.h"
+#include "Engine/Canvas.h"
+#include "Engine/Engine.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogDroneTelemetry, Log, All);
+
+std::atomic<bool> FDroneTelemetry::bRecording{ false };
+
+namespace
+{
+	enum class ETelemetryType : uint8
+	{
+		Float,
+		Int,
+		Bool,
+		Vector
+	};
+
+	struct FTelemetrySample
+	{
+		uint64 Cycles;
+		uint16 Channel;
+		ETelemetryType Type;
+		float Values[3];
+	};
+
+	/**
+	 * Single producer (the thread that owns it), single consumer (the game thread at end of frame).
+	 * Full = the sample is dropped and counted, the producer never waits. Retired when its thread
+	 * exits; the next flush drains what's left and frees it.
+	 */
+	class FTelemetryRing
+	{
+	public:
+		static constexpr uint32 Capacity = 1 << 13;
+
+		void Push(const FTelemetrySample& Sample)
+		{
+			const uint32 H = Head.load(std::memory_order_relaxed);
+			if (H - Tail.load(std::memory_order_acquire) >= Capacity)
+			{
+				Dropped.fetch_add(1, std::memory_order_relaxed);
+				return;
+			}
+			Samples[H & (Capacity - 1)] = Sample;
+			Head.store(H + 1, std::memory_order_release);
+		}
+
+		template <typename FuncType>
+		void Drain(FuncType&& Func)
+		{
+			uint32 T = Tail.load(std::memory_order_relaxed);
+			const uint32 H = Head.load(std::memory_order_acquire);
+			for (; T != H; ++T)
+			{
+				Func(Samples[T & (Capacity - 1)]);
+			}
+			Tail.store(T, std::memory_order_release);
+		}
+
+		uint32 TakeDropped() { return Dropped.exchange(0, std::memory_order_relaxed); }
+
+		/** Called by the owning thread after its last Push. */
+		void Retire() { bRetired.store(true, std::memory_order_release); }
+		bool IsRetired() const { return bRetired.load(std::memory_order_acquire); }
+
+	private:
+		FTelemetrySample Samples[Capacity];
+		std::atomic<uint32> Head{ 0 };
+		std::atomic<uint32> Tail{ 0 };
+		std::atomic<uint32> Dropped{ 0 };
+		std::atomic<bool> bRetired{ false };
+	};
+
+	struct FTelemetryChannelInfo
+	{
+		const TCHAR* Name;
+		EDroneTelemetryLevel Level;
+		bool bGraphed = false;
+
+		// Graph history: the latest GraphLength values (first component), oldest at GraphHead
+		TArray<float> History;
+		int32 GraphHead = 0;
+		float Last = 0.f;
+	};
+
+	constexpr int32 TelemetryGraphLength = 256;
+
+	/** Everything behind the rings; touched on the game thread only, except for ring registration. */
+	struct FTelemetryState
+	{
+		FCriticalSection RingsLock;
+		TArray<TUniquePtr<FTelemetryRing>> Rings;
+
+		TArray<FTelemetryChannelInfo> Channels;
+
+		bool bGraph = false;
+		FDelegateHandle DrawHandle;
+
+		TUniquePtr<FArchive> File;
+		TArray<ANSICHAR> FileBuffer;
+
+		FDelegateHandle EndFrameHandle;
+		uint64 StartCycles = 0;
+	};
+
+	FTelemetryState& GetTelemetryState()
+	{
+		static FTelemetryState State;
+		return State;
+	}
+
+	/** Retires the thread's ring when the thread exits, so short-lived task threads don't leak one each. */
+	struct FTelemetryRingOwner
+	{
+		FTelemetryRing* Ring = nullptr;
+
+		~FTelemetryRingOwner()
+		{
+			if (Ring)
+			{
+				Ring->Retire();
+			}
+		}
+	};
+
+	FTelemetryRing& GetThreadTelemetryRing()
+	{
+		static thread_local FTelemetryRingOwner Owner;
+		if (!Owner.Ring)
+		{
+			FTelemetryState& State = GetTelemetryState();
+			FScopeLock Lock(&State.RingsLock);
+			Owner.Ring = State.Rings.Add_GetRef(MakeUnique<FTelemetryRing>()).Get();
+		}
+		return *Owner.Ring;
+	}
+
+	void PushTelemetrySample(uint16 Channel, ETelemetryType Type, float X, float Y = 0.f, float Z = 0.f)
+	{
+		if (Channel == MAX_uint16)
+		{
+			return;
+		}
+		GetThreadTelemetryRing().Push({ FPlatformTime::Cycles64(), Channel, Type, { X, Y, Z } });
+	}
+
+	void AppendTelemetryCsv(TArray<ANSICHAR>& Buffer, double Seconds, const FTelemetryChannelInfo& Channel, const FTelemetrySample& Sample)
+	{
+		ANSICHAR Line[256];
+		int32 Length;
+		switch (Sample.Type)
+		{
+		case ETelemetryType::Vector:
+			Length = FCStringAnsi::Snprintf(Line, UE_ARRAY_COUNT(Line), "%.6f,%s,%g,%g,%g\n",
+				Seconds, TCHAR_TO_ANSI(Channel.Name), Sample.Values[0], Sample.Values[1], Sample.Values[2]);
+			break;
+		case ETelemetryType::Int:
+		case ETelemetryType::Bool:
+			Length = FCStringAnsi::Snprintf(Line, UE_ARRAY_COUNT(Line), "%.6f,%s,%d,,\n",
+				Seconds, TCHAR_TO_ANSI(Channel.Name), (int32)Sample.Values[0]);
+			break;
+		default:
+			Length = FCStringAnsi::Snprintf(Line, UE_ARRAY_COUNT(Line), "%.6f,%s,%g,,\n",
+				Seconds, TCHAR_TO_ANSI(Channel.Name), Sample.Values[0]);
+			break;
+		}
+		Buffer.Append(Line, FMath::Clamp(Length, 0, (int32)UE_ARRAY_COUNT(Line) - 1));
+	}
+
+	void FlushTelemetry()
+	{
+		FTelemetryState& State = GetTelemetryState();
+
+		// Retired is read before draining: once it's set, the drain below sees the thread's last sample
+		TArray<FTelemetryRing*, TInlineAllocator<16>> Rings;
+		TArray<FTelemetryRing*, TInlineAllocator<4>> RetiredRings;
+		{
+			FScopeLock Lock(&State.RingsLock);
+			for (const TUniquePtr<FTelemetryRing>& Ring : State.Rings)
+			{
+				Rings.Add(Ring.Get());
+				if (Ring->IsRetired())
+				{
+					RetiredRings.Add(Ring.Get());
+				}
+			}
+		}
+
+		uint32 Dropped = 0;
+		for (FTelemetryRing* Ring : Rings)
+		{
+			Ring->Drain([&State](const FTelemetrySample& Sample)
+			{
+				if (!State.Channels.IsValidIndex(Sample.Channel))
+				{
+					return;
+				}
+				FTelemetryChannelInfo& Channel = State.Channels[Sample.Channel];
+				Channel.Last = Sample.Values[0];
+
+				if (Channel.bGraphed)
+				{
+					if (Channel.History.Num() < TelemetryGraphLength)
+					{
+						Channel.History.Add(Sample.Values[0]);
+					}
+					else
+					{
+						Channel.History[Channel.GraphHead] = Sample.Values[0];
+						Channel.GraphHead = (Channel.GraphHead + 1) % TelemetryGraphLength;
+					}
+				}
+
+				if (State.File)
+				{
+					const double Seconds = FPlatformTime::ToSeconds64(Sample.Cycles - State.StartCycles);
+					AppendTelemetryCsv(State.FileBuffer, Seconds, Channel, Sample);
+				}
+			});
+			Dropped += Ring->TakeDropped();
+		}
+
+		if (RetiredRings.Num() > 0)
+		{
+			FScopeLock Lock(&State.RingsLock);
+			State.Rings.RemoveAll([&RetiredRings](const TUniquePtr<FTelemetryRing>& Ring)
+			{
+				return RetiredRings.Contains(Ring.Get());
+			});
+		}
+
+		if (State.File && State.FileBuffer.Num() > 0)
+		{
+			State.File->Serialize(State.FileBuffer.GetData(), State.FileBuffer.Num());
+			State.FileBuffer.Reset();
+		}
+
+		if (Dropped > 0)
+		{
+			UE_LOG(LogDroneTelemetry, Verbose, TEXT("%u samples dropped (ring full)"), Dropped);
+		}
+	}
+
+	void DrawTelemetryGraphs(UCanvas* Canvas, APlayerController* /*PC*/)
+	{
+		FTelemetryState& State = GetTelemetryState();
+		if (!Canvas || !GEngine)
+		{
+			return;
+		}
+
+		constexpr float GraphWidth = 256.f;
+		constexpr float GraphHeight = 48.f;
+		constexpr float Margin = 8.f;
+		float Top = 120.f;
+		const float Left = Canvas->ClipX - GraphWidth - 2.f * Margin;
+
+		for (const FTelemetryChannelInfo& Channel : State.Channels)
+		{
+			if (!Channel.bGraphed || Channel.History.Num() < 2)
+			{
+				continue;
+			}
+
+			float Min = Channel.History[0];
+			float Max = Min;
+			for (const float Value : Channel.History)
+			{
+				Min = FMath::Min(Min, Value);
+				Max = FMath::Max(Max, Value);
+			}
+			const float Range = FMath::Max(Max - Min, KINDA_SMALL_NUMBER);
+
+			FCanvasTileItem Background(FVector2D(Left, Top), FVector2D(GraphWidth, GraphHeight), FLinearColor(0.f, 0.f, 0.f, 0.5f));
+			Background.BlendMode = SE_BLEND_Translucent;
+			Canvas->DrawItem(Background);
+
+			const int32 Num = Channel.History.Num();
+			const int32 Oldest = Num < TelemetryGraphLength ? 0 : Channel.GraphHead;
+			FVector2D Prev;
+			for (int32 i = 0; i < Num; ++i)
+			{
+				const float Value = Channel.History[(Oldest + i) % Num];
+				const FVector2D Point(Left + GraphWidth * i / (TelemetryGraphLength - 1), Top + GraphHeight * (1.f - (Value - Min) / Range));
+				if (i > 0)
+				{
+					FCanvasLineItem Line(Prev, Point);
+					Line.SetColor(FLinearColor::Green);
+					Canvas->DrawItem(Line);
+				}
+				Prev = Point;
+			}
+
+			Canvas->SetDrawColor(FColor::White);
+			Canvas->DrawText(GEngine->GetSmallFont(),
+				FString::Printf(TEXT("%s  %.3f  [%.3f, %.3f]"), Channel.Name, Channel.Last, Min, Max), Left + 2.f, Top + 1.f);
+
+			Top += GraphHeight + Margin;
+		}
+	}
+}
+
+FDroneTelemetryChannel::FDroneTelemetryChannel(const TCHAR* Name, EDroneTelemetryLevel Level, bool bCompiledIn)
+	: Id(bCompiledIn ? FDroneTelemetry::RegisterChannel(Name, Level) : MAX_uint16)
+{
+}
+
+uint16 FDroneTelemetry::RegisterChannel(const TCHAR* Name, EDroneTelemetryLevel Level)
+{
+	// Static initialization: single threaded
+	TArray<FTelemetryChannelInfo>& Channels = GetTelemetryState().Channels;
+	check(Channels.Num() < MAX_uint16);
+	FTelemetryChannelInfo& Channel = Channels.AddDefaulted_GetRef();
+	Channel.Name = Name;
+	Channel.Level = Level;
+	return (uint16)(Channels.Num() - 1);
+}
+
+void FDroneTelemetry::Record(uint16 Channel, float Value)
+{
+	PushTelemetrySample(Channel, ETelemetryType::Float, Value);
+}
+
+void FDroneTelemetry::Record(uint16 Channel, int32 Value)
+{
+	PushTelemetrySample(Channel, ETelemetryType::Int, (float)Value);
+}
+
+void FDroneTelemetry::Record(uint16 Channel, bool bValue)
+{
+	PushTelemetrySample(Channel, ETelemetryType::Bool, bValue ? 1.f : 0.f);
+}
+
+void FDroneTelemetry::Record(uint16 Channel, const FVector& Value)
+{
+	PushTelemetrySample(Channel, ETelemetryType::Vector, (float)Value.X, (float)Value.Y, (float)Value.Z);
+}
+
+void FDroneTelemetry::StartGraph(const FString& Pattern)
+{
+	FTelemetryState& State = GetTelemetryState();
+
+	int32 NumMatched = 0;
+	for (FTelemetryChannelInfo& Channel : State.Channels)
+	{
+		if (FString(Channel.Name).MatchesWildcard(Pattern))
+		{
+			Channel.bGraphed = true;
+			++NumMatched;
+		}
+	}
+	UE_LOG(LogDroneTelemetry, Display, TEXT("Graphing %d channels matching %s"), NumMatched, *Pattern);
+
+	if (!State.bGraph)
+	{
+		State.bGraph = true;
+		State.DrawHandle = UDebugDrawService::Register(TEXT("Game"), FDebugDrawDelegate::CreateStatic(&DrawTelemetryGraphs));
+	}
+	UpdateRecording();
+}
+
+void FDroneTelemetry::StopGraph()
+{
+	FTelemetryState& State = GetTelemetryState();
+	for (FTelemetryChannelInfo& Channel : State.Channels)
+	{
+		Channel.bGraphed = false;
+		Channel.History.Reset();
+		Channel.GraphHead = 0;
+	}
+
+	if (State.bGraph)
+	{
+		UDebugDrawService::Unregister(State.DrawHandle);
+		State.bGraph = false;
+	}
+	UpdateRecording();
+}
+
+void FDroneTelemetry::StartFile(const FString& Name)
+{
+	StopFile();
+
+	FTelemetryState& State = GetTelemetryState();
+	const FString Path = FPaths::ProjectSavedDir() / TEXT("Telemetry") / FPaths::MakeValidFileName(Name, TEXT('_')) + TEXT(".csv");
+	State.File.Reset(IFileManager::Get().CreateFileWriter(*Path));
+	if (!State.File)
+	{
+		UE_LOG(LogDroneTelemetry, Error, TEXT("Can't write %s"), *Path);
+		return;
+	}
+
+	static const ANSICHAR Header[] = "time_s,channel,x,y,z\n";
+	State.File->Serialize((void*)Header, sizeof(Header) - 1);
+	UE_LOG(LogDroneTelemetry, Display, TEXT("Writing telemetry to %s"), *Path);
+	UpdateRecording();
+}
+
+void FDroneTelemetry::StopFile()
+{
+	FTelemetryState& State = GetTelemetryState();
+	if (State.File)
+	{
+		FlushTelemetry();
+		State.File->Close();
+		State.File.Reset();
+	}
+	UpdateRecording();
+}
+
+void FDroneTelemetry::LogChannels()
+{
+	UE_LOG(LogDroneTelemetry, Display, TEXT("Telemetry channels (compiled level %d):"), DRONE_TELEMETRY_LEVEL);
+	for (const FTelemetryChannelInfo& Channel : GetTelemetryState().Channels)
+	{
+		UE_LOG(LogDroneTelemetry, Display, TEXT("  %s (%s)%s"), Channel.Name,
+			Channel.Level == EDroneTelemetryLevel::Basic ? TEXT("Basic") : TEXT("Verbose"),
+			Channel.bGraphed ? TEXT(" [graph]") : TEXT(""));
+	}
+}
+
+void FDroneTelemetry::UpdateRecording()
+{
+	FTelemetryState& State = GetTelemetryState();
+	const bool bWanted = State.bGraph || State.File.IsValid();
+
+	if (bWanted && !State.EndFrameHandle.IsValid())
+	{
+		State.StartCycles = FPlatformTime::Cycles64();
+		State.EndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&FlushTelemetry);
+	}
+	else if (!bWanted && State.EndFrameHandle.IsValid())
+	{
+		FCoreDelegates::OnEndFrame.Remove(State.EndFrameHandle);
+		State.EndFrameHandle.Reset();
+	}
+
+	bRecording.store(bWanted, std::memory_order_relaxed);
+}
+
+static void TelemetryGraphCommand(const TArray<FString>& Args)
+{
+	if (Args.Num() == 0 || Args[0] == TEXT("off"))
+	{
+		FDroneTelemetry::StopGraph();
+		return;
+	}
+	for (const FString& Pattern : Args)
+	{
+		FDroneTelemetry::StartGraph(Pattern);
+	}
+}
+
+static FAutoConsoleCommand GTelemetryGraphCommand(
+	TEXT("Drone.Telemetry.Graph"),
+	TEXT("On-screen graphs of telemetry channels. Args: <pattern>... (e.g. Input.* Flight.VelZ) | off"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&TelemetryGraphCommand));
+
+static void TelemetryFileCommand(const TArray<FString>& Args)
+{
+	if (Args.Num() > 0 && Args[0] == TEXT("off"))
+	{
+		FDroneTelemetry::StopFile();
+		return;
+	}
+	FDroneTelemetry::StartFile(Args.Num() > 0 ? Args[0] : TEXT("Telemetry"));
+}
+
+static FAutoConsoleCommand GTelemetryFileCommand(
+	TEXT("Drone.Telemetry.File"),
+	TEXT("Writes every telemetry channel to Saved/Telemetry/<Name>.csv. Args: [Name=Telemetry] | off"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&TelemetryFileCommand));
+
+static FAutoConsoleCommand GTelemetryListCommand(
+	TEXT("Drone.Telemetry.List"),
+	TEXT("Lists the telemetry channels compiled into this build."),
+	FConsoleCommandDelegate::CreateStatic(&FDroneTelemetry::LogChannels));
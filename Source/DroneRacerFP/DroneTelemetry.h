@@ -0,0 +1,87 @@
+// DroneTelemetry.h
+//
+// Typed per-tick values from hot paths (sticks, thrust, camera) without formatting strings.
+//
+//   DECLARE_DRONE_TELEMETRY_CHANNEL(TelemetryPitchCmd, TEXT("Input.PitchCmd"), Verbose);
+//   ...
+//   RECORD_DRONE_TELEMETRY(TelemetryPitchCmd, OutPitchCmd);
+//
+// Channels above DRONE_TELEMETRY_LEVEL compile to nothing, arguments included. Compiled-in
+// channels cost one relaxed atomic load until something listens (Drone.Telemetry.Graph /
+// Drone.Telemetry.File); then values go into a lock-free ring of the recording thread and are
+// drained on the game thread at the end of the frame.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <atomic>
+
+enum class EDroneTelemetryLevel : uint8
+{
+	Basic = 1,      // a few values per frame
+	Verbose = 2     // per substep / per input event
+};
+
+#ifndef DRONE_TELEMETRY_LEVEL
+	#if UE_BUILD_SHIPPING
+		#define DRONE_TELEMETRY_LEVEL 0
+	#elif UE_BUILD_TEST
+		#define DRONE_TELEMETRY_LEVEL 1
+	#else
+		#define DRONE_TELEMETRY_LEVEL 2
+	#endif
+#endif
+
+/** A named value stream. Declare with DECLARE_DRONE_TELEMETRY_CHANNEL at file scope. */
+struct DRONERACERFP_API FDroneTelemetryChannel
+{
+	FDroneTelemetryChannel(const TCHAR* Name, EDroneTelemetryLevel Level, bool bCompiledIn);
+
+	uint16 Id = MAX_uint16;
+};
+
+class DRONERACERFP_API FDroneTelemetry
+{
+public:
+	/** True while a graph or a file wants values. */
+	static bool IsRecording() { return bRecording.load(std::memory_order_relaxed); }
+
+	static void Record(uint16 Channel, float Value);
+	static void Record(uint16 Channel, int32 Value);
+	static void Record(uint16 Channel, bool bValue);
+	static void Record(uint16 Channel, const FVector& Value);
+
+	/** On-screen graphs of the channels matching Pattern (wildcards, e.g. "Input.*"). */
+	static void StartGraph(const FString& Pattern);
+	static void StopGraph();
+
+	/** Every channel to Saved/Telemetry/<Name>.csv. */
+	static void StartFile(const FString& Name);
+	static void StopFile();
+
+	static void LogChannels();
+
+	static uint16 RegisterChannel(const TCHAR* Name, EDroneTelemetryLevel Level);
+
+private:
+	static void UpdateRecording();
+
+	static std::atomic<bool> bRecording;
+};
+
+#define DECLARE_DRONE_TELEMETRY_CHANNEL(Var, Name, InLevel) \
+	static constexpr bool Var##_bCompiledIn = (int32)EDroneTelemetryLevel::InLevel <= DRONE_TELEMETRY_LEVEL; \
+	static const FDroneTelemetryChannel Var(Name, EDroneTelemetryLevel::InLevel, Var##_bCompiledIn)
+
+#define RECORD_DRONE_TELEMETRY(Var, Value) \
+	do \
+	{ \
+		if constexpr (Var##_bCompiledIn) \
+		{ \
+			if (FDroneTelemetry::IsRecording()) \
+			{ \
+				FDroneTelemetry::Record(Var.Id, Value); \
+			} \
+		} \
+	} while (0)
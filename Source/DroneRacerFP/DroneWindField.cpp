@@ -0,0 +1,131 @@
+// DroneWindField.cpp
+
+#include "DroneWindField.h"
+#include "DroneCourseVoxelizer.h"
+#include "DroneFlightCollision.h"
+#include "Components/BoxComponent.h"
+#include "Engine/World.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogDroneWind, Log, All);
+
+ADroneWindField::ADroneWindField()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	Bounds = CreateDefaultSubobject<UBoxComponent>(TEXT("Bounds"));
+	Bounds->SetBoxExtent(FVector(20000.f, 20000.f, 3000.f));
+	Bounds->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Bounds->SetCanEverAffectNavigation(false);
+	RootComponent = Bounds;
+}
+
+void ADroneWindField::BeginPlay()
+{
+	Super::BeginPlay();
+
+	InitField();
+
+	std::vector<FFlightVec3> Cells;
+	Cells.reserve(BakedCells.Num());
+	for (const FVector3f& Cell : BakedCells)
+	{
+		Cells.emplace_back(Cell.X, Cell.Y, Cell.Z);
+	}
+
+	if (BakedSettingsHash != ComputeSettingsHash() || !Field.SetCells(Cells))
+	{
+		UE_LOG(LogDroneWind, Warning, TEXT("%s: bake is missing or out of date, baking at load (press Bake on the actor to save it)"), *GetName());
+		Bake();
+	}
+}
+
+FFlightWindBakeParams ADroneWindField::MakeBakeParams() const
+{
+	const float YawRad = FMath::DegreesToRadians(WindYawDeg);
+
+	FFlightWindBakeParams Params;
+	Params.MeanWind = FFlightVec3(FMath::Cos(YawRad), FMath::Sin(YawRad), 0.f) * WindSpeed;
+	Params.TurbulenceIntensity = TurbulenceIntensity;
+	Params.TurbulenceScale = TurbulenceScale;
+	Params.TurbulenceOctaves = TurbulenceOctaves;
+	Params.VerticalTurbulence = VerticalTurbulence;
+	Params.Seed = (uint32)Seed;
+	Params.ShadowLength = ShadowLength;
+	Params.ShadowMinScale = ShadowMinScale;
+	Params.WakeTurbulence = WakeTurbulence;
+	return Params;
+}
+
+void ADroneWindField::InitField()
+{
+	const FBox Box = FBox::BuildAABB(Bounds->GetComponentLocation(), Bounds->GetScaledBoxExtent());
+	const FVector Size = Box.GetSize();
+
+	float Cell = FMath::Max(CellSize, 50.f);
+	FIntVector Num;
+	for (;;)
+	{
+		Num = FIntVector(
+			FMath::Max(FMath::CeilToInt32(Size.X / Cell), 1),
+			FMath::Max(FMath::CeilToInt32(Size.Y / Cell), 1),
+			FMath::Max(FMath::CeilToInt32(Size.Z / Cell), 1));
+		if ((int64)Num.X * Num.Y * Num.Z <= MaxCells)
+		{
+			break;
+		}
+		Cell *= 1.25f;
+	}
+
+	Field.Init(ToFlight(Box.Min), Cell, Num.X, Num.Y, Num.Z, MakeBakeParams().MeanWind);
+}
+
+uint32 ADroneWindField::ComputeSettingsHash() const
+{
+	uint32 Hash = GetTypeHash(Bounds->GetComponentLocation());
+	Hash = HashCombine(Hash, GetTypeHash(Bounds->GetScaledBoxExtent()));
+	for (const float Value : { WindYawDeg, WindSpeed, TurbulenceIntensity, TurbulenceScale, VerticalTurbulence,
+		ShadowLength, ShadowMinScale, WakeTurbulence, CellSize })
+	{
+		Hash = HashCombine(Hash, GetTypeHash(Value));
+	}
+	Hash = HashCombine(Hash, GetTypeHash(TurbulenceOctaves));
+	Hash = HashCombine(Hash, GetTypeHash(Seed));
+	return HashCombine(Hash, GetTypeHash(MaxCells));
+}
+
+void ADroneWindField::Bake()
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	InitField();
+	const FIntVector Num(Field.GetNum(0), Field.GetNum(1), Field.GetNum(2));
+	const FVector Min = Bounds->GetComponentLocation() - Bounds->GetScaledBoxExtent();
+	int64 NumBlocked = 0;
+	const int64 NumQueries = VoxelizeDroneCourse(*World, Min, Field.GetCellSize(), Num,
+		[this, &NumBlocked](int32 X, int32 Y, int32 Z) { Field.SetBlocked(X, Y, Z); ++NumBlocked; });
+
+	Field.Bake(MakeBakeParams());
+
+	// Stored with the level for the next load
+	Modify();
+	BakedCells.Reset(Field.GetCells().size());
+	for (const FFlightVec3& Cell : Field.GetCells())
+	{
+		BakedCells.Emplace(Cell.X, Cell.Y, Cell.Z);
+	}
+	BakedSettingsHash = ComputeSettingsHash();
+
+	UE_LOG(LogDroneWind, Log, TEXT("%s: %dx%dx%d cells of %.0f cm, %lld blocked, %lld overlap queries, %.1f ms"),
+		*GetName(), Num.X, Num.Y, Num.Z, Field.GetCellSize(), NumBlocked, NumQueries, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+FVector ADroneWindField::SampleWind(const FVector& Location) const
+{
+	return ToVector(Field.Sample(ToFlight(Location)));
+}
@@ -0,0 +1,105 @@
+// DroneWindField.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "FlightCore/FlightWind.h"
+#include "DroneWindField.generated.h"
+
+class UBoxComponent;
+
+/**
+ * Wind over the box of this actor (axis aligned; the actor's rotation is ignored), for outdoor
+ * maps. "Bake" in the details panel voxelizes the level, lays down mean wind, frozen
+ * turbulence and wakes behind obstacles, and stores the grid with the level, so play only
+ * loads it and drones pay one trilinear sample per flight step.
+ *
+ * If the settings or the box changed since the last bake, BeginPlay bakes again (and warns).
+ */
+UCLASS()
+class DRONERACERFP_API ADroneWindField : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ADroneWindField();
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Wind")
+	UBoxComponent* Bounds;
+
+	/** Direction the wind blows towards, degrees around Z (0 = +X). */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Wind")
+	float WindYawDeg = 0.f;
+
+	/** Mean wind in open air. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Wind", meta = (ClampMin = "0.0", Units = "cm/s"))
+	float WindSpeed = 500.f;
+
+	/** Gust amplitude as a fraction of WindSpeed. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Wind|Turbulence", meta = (ClampMin = "0.0", ClampMax = "2.0"))
+	float TurbulenceIntensity = 0.15f;
+
+	/** Size of the largest eddies. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Wind|Turbulence", meta = (ClampMin = "100.0", Units = "cm"))
+	float TurbulenceScale = 1000.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Wind|Turbulence", meta = (ClampMin = "1", ClampMax = "6"))
+	int32 TurbulenceOctaves = 3;
+
+	/** Vertical gusts relative to horizontal ones. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Wind|Turbulence", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float VerticalTurbulence = 0.4f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Wind|Turbulence")
+	int32 Seed = 1;
+
+	/** How far downwind of an obstacle the wind takes to recover. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Wind|Shadowing", meta = (ClampMin = "0.0", Units = "cm"))
+	float ShadowLength = 3000.f;
+
+	/** Mean wind fraction right behind an obstacle. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Wind|Shadowing", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float ShadowMinScale = 0.2f;
+
+	/** Extra turbulence right behind an obstacle, fading over ShadowLength. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Wind|Shadowing", meta = (ClampMin = "0.0"))
+	float WakeTurbulence = 1.5f;
+
+	/** Grid resolution; grown when the box would need more than MaxCells. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Wind|Bake", meta = (ClampMin = "50.0", Units = "cm"))
+	float CellSize = 400.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Wind|Bake", meta = (ClampMin = "1000"))
+	int32 MaxCells = 1000000;
+
+	/** Voxelizes the level and bakes the grid; saved with the level. */
+	UFUNCTION(CallInEditor, Category = "Wind|Bake")
+	void Bake();
+
+	/** Wind velocity at a world location (cm/s). */
+	UFUNCTION(BlueprintPure, Category = "Wind")
+	FVector SampleWind(const FVector& Location) const;
+
+	/** The baked field, or null before BeginPlay / without a bake. */
+	const FFlightWindField* GetField() const { return Field.IsBaked() ? &Field : nullptr; }
+
+protected:
+	virtual void BeginPlay() override;
+
+private:
+	FFlightWindBakeParams MakeBakeParams() const;
+
+	/** Lays out Field over Bounds. */
+	void InitField();
+
+	uint32 ComputeSettingsHash() const;
+
+	FFlightWindField Field;
+
+	UPROPERTY()
+	TArray<FVector3f> BakedCells;
+
+	UPROPERTY()
+	uint32 BakedSettingsHash = 0;
+};
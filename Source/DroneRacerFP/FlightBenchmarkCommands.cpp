@@ -0,0 +1,200 @@
+// FlightBenchmarkCommands.cpp
+//
+// Console entry point for the flight core benchmark. Also runs without a window:
+//   UnrealEditor-Cmd <project> -game -nullrhi -ExecCmds="Drone.Flight.Benchmark 10000000, Quit"
+
+#include "CoreMinimal.h"
+#include "HAL/IConsoleManager.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "FlightCore/FlightBenchmark.h"
+#include "DroneFlightBatch.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogDroneFlight, Log, All);
+
+static void RunFlightBenchmarkCommand(const TArray<FString>& Args)
+{
+	const int64 Steps = Args.Num() > 0 ? FMath::Max<int64>(FCString::Atoi64(*Args[0]), 1) : 5000000;
+	const float RateHz = Args.Num() > 1 ? FMath::Clamp(FCString::Atof(*Args[1]), 50.f, 20000.f) : 1000.f;
+
+	const FFlightBenchmarkResult Result = RunFlightBenchmark(Steps, 1.f / RateHz);
+
+	UE_LOG(LogDroneFlight, Display,
+		TEXT("Flight core: %lld steps @ %.0f Hz in %.3f s | %.2f M steps/s | %.1f ns/step | %lld contact steps | %.2f sweeps/step | final pos (%.1f, %.1f, %.1f)"),
+		Result.Steps, RateHz, Result.Seconds,
+		Result.StepsPerSecond / 1e6, Result.NanosecondsPerStep, Result.Contacts, (double)Result.Sweeps / FMath::Max<int64>(Result.Steps, 1),
+		Result.FinalState.Position.X, Result.FinalState.Position.Y, Result.FinalState.Position.Z);
+}
+
+static FAutoConsoleCommand GFlightBenchmarkCommand(
+	TEXT("Drone.Flight.Benchmark"),
+	TEXT("Steps the engine-independent flight model over a scripted input. Args: [Steps=5000000] [RateHz=1000]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunFlightBenchmarkCommand));
+
+static void RunPidBenchmarkCommand(const TArray<FString>& Args)
+{
+	const int32 NumDrones = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 64;
+	const float LoopRateHz = Args.Num() > 1 ? FMath::Clamp(FCString::Atof(*Args[1]), 1000.f, 32000.f) : 8000.f;
+	const double Seconds = Args.Num() > 2 ? FMath::Max(FCString::Atod(*Args[2]), 0.1) : 5.0;
+
+	const FFlightPidBenchmarkResult Result = RunPidBenchmark(NumDrones, LoopRateHz, Seconds);
+
+	UE_LOG(LogDroneFlight, Display,
+		TEXT("Flight controller: %d drones @ %.0f Hz, %.1f s simulated in %.3f s | %.2fx realtime (%s) | %.2f M PID updates/s"),
+		Result.NumDrones, Result.LoopRateHz, Result.SimulatedSeconds, Result.WallSeconds,
+		Result.RealtimeFactor, Result.RealtimeFactor >= 1.0 ? TEXT("sustained") : TEXT("NOT sustained"),
+		Result.PidUpdatesPerSecond / 1e6);
+}
+
+static FAutoConsoleCommand GPidBenchmarkCommand(
+	TEXT("Drone.Flight.BenchmarkPid"),
+	TEXT("Runs many drones' PID loop, mixer, motors and rigid body on one thread. Args: [Drones=64] [LoopRateHz=8000] [SimSeconds=5]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunPidBenchmarkCommand));
+
+static void RunIntegratorBenchmarkCommand(const TArray<FString>& Args)
+{
+	const double Seconds = Args.Num() > 0 ? FMath::Max(FCString::Atod(*Args[0]), 0.1) : 10.0;
+	const double MaxErrorCm = Args.Num() > 1 ? FMath::Max(FCString::Atod(*Args[1]), 0.0) : 5.0;
+	const double MaxEnergyError = Args.Num() > 2 ? FMath::Max(FCString::Atod(*Args[2]), 0.0) : 0.01;
+
+	static const float RatesHz[] = { 60.f, 120.f, 250.f, 500.f, 1000.f, 2000.f };
+	static const EFlightIntegrator Integrators[] =
+	{
+		EFlightIntegrator::ExplicitEuler, EFlightIntegrator::SemiImplicitEuler, EFlightIntegrator::Verlet, EFlightIntegrator::RK4
+	};
+	static const EFlightDriftScenario Scenarios[] =
+	{
+		EFlightDriftScenario::Hover, EFlightDriftScenario::Ballistic, EFlightDriftScenario::Orbit
+	};
+
+	UE_LOG(LogDroneFlight, Display, TEXT("Integrator drift: %.1f s per run, accurate = max error <= %.2f cm and energy error <= %.2f%%"),
+		Seconds, MaxErrorCm, MaxEnergyError * 100.0);
+
+	for (float RateHz : RatesHz)
+	{
+		const char* Recommended = nullptr;
+		double RecommendedCost = TNumericLimits<double>::Max();
+
+		for (EFlightIntegrator Integrator : Integrators)
+		{
+			bool bAccurate = true;
+			double IntegratorCost = 0.0;
+
+			for (EFlightDriftScenario Scenario : Scenarios)
+			{
+				const FFlightDriftResult R = RunIntegratorDriftBenchmark(Integrator, Scenario, RateHz, Seconds);
+				bAccurate &= R.MaxPositionError <= MaxErrorCm && R.MaxEnergyError <= MaxEnergyError;
+
+				// Hover and ballistic time the whole flight step (mostly the PID loop); orbit times the integrator alone
+				if (Scenario == EFlightDriftScenario::Orbit)
+				{
+					IntegratorCost = R.NanosecondsPerStep;
+				}
+
+				UE_LOG(LogDroneFlight, Display, TEXT("  %5.0f Hz  %-9s %-17s %9.1f ns/step | final %9.3f cm | max %9.3f cm | energy %8.4f%%"),
+					RateHz, ANSI_TO_TCHAR(GetFlightDriftScenarioName(Scenario)), ANSI_TO_TCHAR(GetFlightIntegratorName(Integrator)),
+					R.NanosecondsPerStep, R.FinalPositionError, R.MaxPositionError, R.MaxEnergyError * 100.0);
+			}
+
+			if (bAccurate && IntegratorCost < RecommendedCost)
+			{
+				RecommendedCost = IntegratorCost;
+				Recommended = GetFlightIntegratorName(Integrator);
+			}
+		}
+
+		UE_LOG(LogDroneFlight, Display, TEXT("  %5.0f Hz  -> cheapest accurate integrator: %s"), RateHz, Recommended ? ANSI_TO_TCHAR(Recommended) : TEXT("none"));
+	}
+}
+
+static FAutoConsoleCommand GIntegratorBenchmarkCommand(
+	TEXT("Drone.Flight.BenchmarkIntegrators"),
+	TEXT("Cost and drift of each translation integrator against closed-form hover, ballistic and orbit runs at 60..2000 Hz. Args: [SimSeconds=10] [MaxErrorCm=5] [MaxEnergyError=0.01]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunIntegratorBenchmarkCommand));
+
+/** Seconds to run NumSteps of Simulate, which steps every drone once. */
+template <typename SimulateFn>
+static double TimeFlightSteps(int32 NumSteps, SimulateFn&& Simulate)
+{
+	const double Begin = FPlatformTime::Seconds();
+	for (int32 i = 0; i < NumSteps; ++i)
+	{
+		Simulate(i);
+	}
+	return FPlatformTime::Seconds() - Begin;
+}
+
+static void RunBatchBenchmarkCommand(const TArray<FString>& Args)
+{
+	const int32 NumDrones = Args.Num() > 0 ? FMath::Clamp(FCString::Atoi(*Args[0]), 1, 100000) : 200;
+	const double Seconds = Args.Num() > 1 ? FMath::Max(FCString::Atod(*Args[1]), 0.1) : 5.0;
+	const float RateHz = Args.Num() > 2 ? FMath::Clamp(FCString::Atof(*Args[2]), 100.f, 2000.f) : 500.f;
+
+	const float StepSeconds = 1.f / RateHz;
+	const int32 NumSteps = FMath::CeilToInt32(Seconds * RateHz);
+	const FFlightParams Params;
+
+	auto MakeInput = [StepSeconds](int32 Step, int32 Drone)
+	{
+		return MakeScriptedFlightInput((double)Step * StepSeconds + Drone * 0.37);
+	};
+
+	// Reference: one StepFlightModel per drone, the way each pawn steps itself
+	TArray<FFlightState> Scalar;
+	Scalar.SetNum(NumDrones);
+	for (int32 d = 0; d < NumDrones; ++d)
+	{
+		Scalar[d].Position = FFlightVec3(300.f * d, 0.f, 100.f);
+	}
+	const double ScalarSeconds = TimeFlightSteps(NumSteps, [&](int32 Step)
+	{
+		for (int32 d = 0; d < NumDrones; ++d)
+		{
+			StepFlightModel(Scalar[d], Params, MakeInput(Step, d), StepSeconds, nullptr);
+		}
+	});
+
+	auto RunBatch = [&](bool bParallel)
+	{
+		FDroneFlightBatch Batch;
+		Batch.SetParams(Params);
+		TArray<int32> Handles;
+		for (int32 d = 0; d < NumDrones; ++d)
+		{
+			FFlightState State;
+			State.Position = FFlightVec3(300.f * d, 0.f, 100.f);
+			Handles.Add(Batch.AddDrone(State));
+		}
+		return TimeFlightSteps(NumSteps, [&](int32 Step)
+		{
+			for (int32 d = 0; d < NumDrones; ++d)
+			{
+				Batch.SetInput(Handles[d], MakeInput(Step, d));
+			}
+			Batch.Step(StepSeconds, bParallel);
+		});
+	};
+
+	const double BatchSerialSeconds = RunBatch(false);
+	const double BatchParallelSeconds = RunBatch(true);
+
+	const double DroneSteps = (double)NumDrones * NumSteps;
+	const double FrameBudgetMs = 1000.0 / 60.0;
+	auto Report = [&](const TCHAR* Name, double WallSeconds)
+	{
+		UE_LOG(LogDroneFlight, Display,
+			TEXT("  %-24s %8.1f ns/drone-step | %6.3f ms per 60 Hz frame (%.1f%% of budget) | %.2fx vs scalar"),
+			Name, WallSeconds * 1e9 / DroneSteps, WallSeconds * 1000.0 / (Seconds * 60.0),
+			WallSeconds * 1000.0 / (Seconds * 60.0) / FrameBudgetMs * 100.0, ScalarSeconds / FMath::Max(WallSeconds, 1e-9));
+	};
+
+	UE_LOG(LogDroneFlight, Display, TEXT("Flight batch: %d drones, %.1f s @ %.0f Hz, PID %.0f Hz, %d worker threads"),
+		NumDrones, Seconds, RateHz, Params.Pid.LoopRateHz, FTaskGraphInterface::Get().GetNumWorkerThreads());
+	Report(TEXT("scalar, one by one"), ScalarSeconds);
+	Report(TEXT("SoA SIMD, 1 thread"), BatchSerialSeconds);
+	Report(TEXT("SoA SIMD, ParallelFor"), BatchParallelSeconds);
+}
+
+static FAutoConsoleCommand GBatchBenchmarkCommand(
+	TEXT("Drone.Flight.BenchmarkBatch"),
+	TEXT("Compares stepping drones one by one against the SoA batch, single-threaded and over ParallelFor. Args: [Drones=200] [SimSeconds=5] [RateHz=500]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&RunBatchBenchmarkCommand));
@@ -0,0 +1,243 @@
+// FlightBenchmark.cpp
+
+#include "FlightBenchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+FFlightInput MakeScriptedFlightInput(double TimeSeconds)
+{
+	// Incommensurate periods so the drone doesn't settle into a short repeating cycle
+	const double T = TimeSeconds;
+
+	FFlightInput Input;
+	Input.bArmed = true;
+	Input.Throttle = (float)(0.55 + 0.35 * std::sin(T * 0.9) + 0.1 * std::sin(T * 7.3));
+	Input.Roll = (float)std::sin(T * 1.7);
+	Input.Pitch = (float)(0.6 * std::sin(T * 1.13 + 0.5));
+	Input.Yaw = (float)(0.4 * std::sin(T * 0.41));
+	return Input;
+}
+
+FFlightBenchmarkResult RunFlightBenchmark(int64_t NumSteps, float StepSeconds, const FFlightParams& Params)
+{
+	FFlightGroundPlane Ground(0.f, 7.f);
+
+	FFlightState State;
+	State.Position = FFlightVec3(0.f, 0.f, 100.f);
+
+	FFlightBenchmarkResult Result;
+	FFlightStepResult Step;
+
+	const auto Begin = std::chrono::steady_clock::now();
+
+	for (int64_t i = 0; i < NumSteps; ++i)
+	{
+		const FFlightInput Input = MakeScriptedFlightInput((double)i * StepSeconds);
+		StepFlightModel(State, Params, Input, StepSeconds, &Ground, &Step);
+		Result.Contacts += Step.bContact ? 1 : 0;
+		Result.Sweeps += Step.NumSweeps;
+	}
+
+	const auto End = std::chrono::steady_clock::now();
+
+	Result.Steps = NumSteps;
+	Result.Seconds = std::chrono::duration<double>(End - Begin).count();
+	Result.StepsPerSecond = Result.Seconds > 0.0 ? (double)NumSteps / Result.Seconds : 0.0;
+	Result.NanosecondsPerStep = NumSteps > 0 ? Result.Seconds * 1e9 / (double)NumSteps : 0.0;
+	Result.FinalState = State;
+	return Result;
+}
+
+FFlightPidBenchmarkResult RunPidBenchmark(int NumDrones, float LoopRateHz, double SimulatedSeconds, FFlightParams Params)
+{
+	constexpr float StepSeconds = 0.001f;
+	Params.Pid.LoopRateHz = LoopRateHz;
+
+	FFlightGroundPlane Ground(0.f, 7.f);
+	std::vector<FFlightState> Drones(NumDrones);
+	for (int d = 0; d < NumDrones; ++d)
+	{
+		Drones[d].Position = FFlightVec3(300.f * d, 0.f, 100.f);
+	}
+
+	const int64_t NumSteps = (int64_t)(SimulatedSeconds / StepSeconds);
+	const auto Begin = std::chrono::steady_clock::now();
+
+	for (int64_t i = 0; i < NumSteps; ++i)
+	{
+		for (int d = 0; d < NumDrones; ++d)
+		{
+			// Offset each drone's script so they don't all take the same branches
+			const FFlightInput Input = MakeScriptedFlightInput((double)i * StepSeconds + d * 0.37);
+			StepFlightModel(Drones[d], Params, Input, StepSeconds, &Ground);
+		}
+	}
+
+	const auto End = std::chrono::steady_clock::now();
+
+	FFlightPidBenchmarkResult Result;
+	Result.NumDrones = NumDrones;
+	Result.LoopRateHz = LoopRateHz;
+	Result.SimulatedSeconds = (double)NumSteps * StepSeconds;
+	Result.WallSeconds = std::chrono::duration<double>(End - Begin).count();
+	if (Result.WallSeconds > 0.0)
+	{
+		Result.RealtimeFactor = Result.SimulatedSeconds / Result.WallSeconds;
+		Result.PidUpdatesPerSecond = Result.SimulatedSeconds * LoopRateHz * NumDrones / Result.WallSeconds;
+	}
+	return Result;
+}
+
+const char* GetFlightDriftScenarioName(EFlightDriftScenario Scenario)
+{
+	switch (Scenario)
+	{
+	case EFlightDriftScenario::Hover: return "Hover";
+	case EFlightDriftScenario::Ballistic: return "Ballistic";
+	case EFlightDriftScenario::Orbit: return "Orbit";
+	}
+	return "?";
+}
+
+FFlightDriftResult RunIntegratorDriftBenchmark(EFlightIntegrator Integrator, EFlightDriftScenario Scenario, float RateHz,
+	double SimulatedSeconds, FFlightParams Params)
+{
+	Params.Integrator = Integrator;
+	const float Dt = 1.f / RateHz;
+	const int64_t NumSteps = (int64_t)(SimulatedSeconds * RateHz + 0.5);
+
+	// Orbit: 10 m radius, one revolution every 2 s
+	constexpr double OrbitRadius = 1000.0;
+	constexpr double OrbitOmega = FlightPi;
+	constexpr double OrbitMu = OrbitOmega * OrbitOmega * OrbitRadius * OrbitRadius * OrbitRadius;
+
+	const double Gravity = Params.GravityZ;
+	const double DragRate = Params.DragCoeff / std::max(Params.Mass, 1e-4f);
+
+	FFlightState Initial;
+	FFlightInput Input;
+	switch (Scenario)
+	{
+	case EFlightDriftScenario::Hover:
+		// Trimmed hover: throttle and motors already at hover thrust, level, PID at rest
+		Input.bArmed = true;
+		Input.Throttle = Params.HoverThrottle;
+		Initial.ThrottleSmoothed = Params.HoverThrottle;
+		for (float& Thrust : Initial.MotorThrust)
+		{
+			Thrust = 0.25f * Params.Mass * -Params.GravityZ;
+		}
+		Initial.Velocity = FFlightVec3(300.f, -200.f, 150.f);
+		break;
+	case EFlightDriftScenario::Ballistic:
+		Params.DragCoeff = 0.f;
+		Initial.Velocity = FFlightVec3(800.f, 0.f, 1200.f);
+		break;
+	case EFlightDriftScenario::Orbit:
+		Initial.Position = FFlightVec3((float)OrbitRadius, 0.f, 0.f);
+		Initial.Velocity = FFlightVec3(0.f, (float)(OrbitOmega * OrbitRadius), 0.f);
+		break;
+	}
+
+	const FFlightVec3 X0 = Initial.Position;
+	const FFlightVec3 V0 = Initial.Velocity;
+	const double V0Sq = (double)V0.SizeSquared();
+
+	auto CentralAccel = [](const FFlightVec3& Position, const FFlightVec3& /*Velocity*/)
+	{
+		const float R = Position.Size();
+		return Position * (float)(-OrbitMu / ((double)R * R * R));
+	};
+
+	auto StepOnce = [&](FFlightState& State)
+	{
+		if (Scenario == EFlightDriftScenario::Orbit)
+		{
+			IntegrateFlightTranslation(Integrator, State.Position, State.Velocity, Dt, CentralAccel);
+		}
+		else
+		{
+			StepFlightModel(State, Params, Input, Dt, nullptr);
+		}
+	};
+
+	// Specific mechanical energy (cm^2/s^2), and its closed-form value at time T
+	auto Energy = [&](const FFlightState& State)
+	{
+		const double KineticEnergy = 0.5 * State.Velocity.SizeSquared();
+		switch (Scenario)
+		{
+		case EFlightDriftScenario::Ballistic: return KineticEnergy - Gravity * State.Position.Z;
+		case EFlightDriftScenario::Orbit: return KineticEnergy - OrbitMu / State.Position.Size();
+		default: return KineticEnergy; // thrust cancels gravity: only drag does work
+		}
+	};
+
+	auto Reference = [&](double T, double& OutEnergy)
+	{
+		switch (Scenario)
+		{
+		case EFlightDriftScenario::Hover:
+		{
+			const double Decay = std::exp(-DragRate * T);
+			OutEnergy = 0.5 * V0Sq * Decay * Decay;
+			const double Travel = DragRate > 0.0 ? (1.0 - Decay) / DragRate : T;
+			return FFlightVec3((float)(X0.X + V0.X * Travel), (float)(X0.Y + V0.Y * Travel), (float)(X0.Z + V0.Z * Travel));
+		}
+		case EFlightDriftScenario::Ballistic:
+			OutEnergy = 0.5 * V0Sq - Gravity * X0.Z;
+			return FFlightVec3((float)(X0.X + V0.X * T), (float)(X0.Y + V0.Y * T), (float)(X0.Z + V0.Z * T + 0.5 * Gravity * T * T));
+		case EFlightDriftScenario::Orbit:
+		default:
+			OutEnergy = -OrbitMu / (2.0 * OrbitRadius);
+			return FFlightVec3((float)(OrbitRadius * std::cos(OrbitOmega * T)), (float)(OrbitRadius * std::sin(OrbitOmega * T)), 0.f);
+		}
+	};
+
+	FFlightDriftResult Result;
+	Result.Integrator = Integrator;
+	Result.Scenario = Scenario;
+	Result.RateHz = RateHz;
+	Result.Steps = NumSteps;
+
+	// Accuracy pass
+	{
+		double E0 = 0.0;
+		Reference(0.0, E0);
+		const double EnergyScale = std::max(std::fabs(E0), 1e-6);
+
+		FFlightState State = Initial;
+		for (int64_t i = 1; i <= NumSteps; ++i)
+		{
+			StepOnce(State);
+
+			double RefEnergy = 0.0;
+			const FFlightVec3 RefPosition = Reference((double)i * Dt, RefEnergy);
+			const double PositionError = (State.Position - RefPosition).Size();
+			Result.MaxPositionError = std::max(Result.MaxPositionError, PositionError);
+			Result.MaxEnergyError = std::max(Result.MaxEnergyError, std::fabs(Energy(State) - RefEnergy) / EnergyScale);
+			Result.FinalPositionError = PositionError;
+		}
+	}
+
+	// Cost pass
+	{
+		FFlightState State = Initial;
+		const auto Begin = std::chrono::steady_clock::now();
+		for (int64_t i = 0; i < NumSteps; ++i)
+		{
+			StepOnce(State);
+		}
+		const auto End = std::chrono::steady_clock::now();
+
+		// Keeps the loop from being optimized out
+		volatile float Sink = State.Position.X;
+		(void)Sink;
+
+		Result.NanosecondsPerStep = NumSteps > 0 ? std::chrono::duration<double>(End - Begin).count() * 1e9 / (double)NumSteps : 0.0;
+	}
+	return Result;
+}
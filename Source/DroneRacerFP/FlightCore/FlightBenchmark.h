@@ -0,0 +1,71 @@
+// FlightBenchmark.h
+//
+// Headless driver for the flight core: scripted stick inputs, fixed step, wall-clock timing.
+// Engine-free like the rest of FlightCore; Drone.Flight.Benchmark runs it in-game.
+
+#pragma once
+
+#include "FlightModel.h"
+
+#include <cstdint>
+
+struct FFlightBenchmarkResult
+{
+	int64_t Steps = 0;
+	double Seconds = 0.0;
+	double StepsPerSecond = 0.0;
+	double NanosecondsPerStep = 0.0;
+	int64_t Contacts = 0;
+	int64_t Sweeps = 0;
+	FFlightState FinalState;
+};
+
+/** Deterministic acro-ish stick script: throttle punches, rolls, pitch and yaw sweeps. */
+FFlightInput MakeScriptedFlightInput(double TimeSeconds);
+
+/** Steps a single drone NumSteps times over the script, 1 m above a ground plane. */
+FFlightBenchmarkResult RunFlightBenchmark(int64_t NumSteps, float StepSeconds = 0.001f, const FFlightParams& Params = FFlightParams());
+
+struct FFlightPidBenchmarkResult
+{
+	int NumDrones = 0;
+	float LoopRateHz = 0.f;
+	double SimulatedSeconds = 0.0;
+	double WallSeconds = 0.0;
+	double RealtimeFactor = 0.0;    // simulated / wall time; >= 1 means the rate is sustained
+	double PidUpdatesPerSecond = 0.0; // all drones, wall clock
+};
+
+/**
+ * Flight controller load test: NumDrones independent drones, each with the PID, mixer, motors
+ * and rigid body stepped at LoopRateHz inside 1 kHz flight steps, on the calling thread.
+ */
+FFlightPidBenchmarkResult RunPidBenchmark(int NumDrones, float LoopRateHz, double SimulatedSeconds, FFlightParams Params = FFlightParams());
+
+enum class EFlightDriftScenario : unsigned char
+{
+	Hover,      // full flight step at hover thrust with an initial kick: pure drag decay
+	Ballistic,  // full flight step, disarmed and drag-free: constant gravity
+	Orbit       // integrator only, circular orbit around an inverse-square attractor
+};
+
+const char* GetFlightDriftScenarioName(EFlightDriftScenario Scenario);
+
+struct FFlightDriftResult
+{
+	EFlightIntegrator Integrator = EFlightIntegrator::SemiImplicitEuler;
+	EFlightDriftScenario Scenario = EFlightDriftScenario::Hover;
+	float RateHz = 0.f;
+	int64_t Steps = 0;
+	double NanosecondsPerStep = 0.0;
+	double FinalPositionError = 0.0;  // cm from the analytic solution at the end
+	double MaxPositionError = 0.0;    // cm, worst over the run
+	double MaxEnergyError = 0.0;      // |E - E_analytic| / |E_0|, worst over the run
+};
+
+/**
+ * Integrator accuracy and cost for one scenario at one physics rate, against the closed-form
+ * solution. Timing comes from a second run without the error bookkeeping.
+ */
+FFlightDriftResult RunIntegratorDriftBenchmark(EFlightIntegrator Integrator, EFlightDriftScenario Scenario, float RateHz,
+	double SimulatedSeconds, FFlightParams Params = FFlightParams());
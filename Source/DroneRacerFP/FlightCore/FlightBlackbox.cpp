@@ -0,0 +1,302 @@
+// FlightBlackbox.cpp
+
+#include "FlightBlackbox.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	enum : uint8_t
+	{
+		BlackboxTagKeyframe = 'I',
+		BlackboxTagDelta = 'P',
+		BlackboxTagEvent = 'E'
+	};
+
+	// How each field is predicted in a delta frame
+	enum EBlackboxPredictor : uint8_t
+	{
+		PredictPrevious,    // sticks, commands, health, flags: step changes
+		PredictLinear       // motion: 2 * previous - the one before
+	};
+
+	struct FBlackboxField
+	{
+		float Scale;
+		EBlackboxPredictor Predictor;
+	};
+
+	// Order: sticks (4), commands (4), motors (4), rotation (4), velocity (3), position (3), health, flags
+	constexpr FBlackboxField BlackboxFields[FFlightBlackboxEncoder::NumFields] = {
+		{ 1e4f, PredictPrevious }, { 1e4f, PredictPrevious }, { 1e4f, PredictPrevious }, { 1e4f, PredictPrevious },
+		{ 1e4f, PredictPrevious }, { 1e4f, PredictPrevious }, { 1e4f, PredictPrevious }, { 1e4f, PredictPrevious },
+		{ 1e2f, PredictLinear }, { 1e2f, PredictLinear }, { 1e2f, PredictLinear }, { 1e2f, PredictLinear },
+		{ 1e6f, PredictLinear }, { 1e6f, PredictLinear }, { 1e6f, PredictLinear }, { 1e6f, PredictLinear },
+		{ 1e2f, PredictLinear }, { 1e2f, PredictLinear }, { 1e2f, PredictLinear },
+		{ 1e2f, PredictLinear }, { 1e2f, PredictLinear }, { 1e2f, PredictLinear },
+		{ 1e2f, PredictPrevious },
+		{ 1.f, PredictPrevious }
+	};
+
+	void GatherBlackboxFields(const FFlightBlackboxFrame& Frame, float (&Out)[FFlightBlackboxEncoder::NumFields])
+	{
+		int i = 0;
+		for (float V : Frame.Sticks) { Out[i++] = V; }
+		for (float V : Frame.Commands) { Out[i++] = V; }
+		for (float V : Frame.MotorThrust) { Out[i++] = V; }
+		Out[i++] = Frame.Rotation.X; Out[i++] = Frame.Rotation.Y; Out[i++] = Frame.Rotation.Z; Out[i++] = Frame.Rotation.W;
+		Out[i++] = Frame.Velocity.X; Out[i++] = Frame.Velocity.Y; Out[i++] = Frame.Velocity.Z;
+		Out[i++] = Frame.Position.X; Out[i++] = Frame.Position.Y; Out[i++] = Frame.Position.Z;
+		Out[i++] = Frame.Health;
+		Out[i++] = (float)Frame.Flags;
+	}
+
+	void ScatterBlackboxFields(const int64_t (&Quantized)[FFlightBlackboxEncoder::NumFields], FFlightBlackboxFrame& Frame)
+	{
+		float V[FFlightBlackboxEncoder::NumFields];
+		for (int i = 0; i < FFlightBlackboxEncoder::NumFields; ++i)
+		{
+			V[i] = (float)((double)Quantized[i] / BlackboxFields[i].Scale);
+		}
+		int i = 0;
+		for (float& F : Frame.Sticks) { F = V[i++]; }
+		for (float& F : Frame.Commands) { F = V[i++]; }
+		for (float& F : Frame.MotorThrust) { F = V[i++]; }
+		Frame.Rotation = FFlightQuat(V[12], V[13], V[14], V[15]);
+		Frame.Velocity = FFlightVec3(V[16], V[17], V[18]);
+		Frame.Position = FFlightVec3(V[19], V[20], V[21]);
+		Frame.Health = V[22];
+		Frame.Flags = (uint8_t)Quantized[23];
+	}
+
+	int64_t PredictBlackboxField(int Field, const int64_t (&History)[2][FFlightBlackboxEncoder::NumFields], int NumHistory)
+	{
+		if (BlackboxFields[Field].Predictor == PredictLinear && NumHistory >= 2)
+		{
+			return 2 * History[0][Field] - History[1][Field];
+		}
+		return History[0][Field];
+	}
+
+	void PushBlackboxHistory(int64_t (&History)[2][FFlightBlackboxEncoder::NumFields], int& NumHistory, const int64_t (&Values)[FFlightBlackboxEncoder::NumFields])
+	{
+		std::memcpy(History[1], History[0], sizeof(History[0]));
+		std::memcpy(History[0], Values, sizeof(History[0]));
+		NumHistory = NumHistory < 2 ? NumHistory + 1 : 2;
+	}
+
+	uint8_t* WriteBlackboxVarint(uint8_t* Out, uint64_t Value)
+	{
+		while (Value >= 0x80)
+		{
+			*Out++ = (uint8_t)(Value | 0x80);
+			Value >>= 7;
+		}
+		*Out++ = (uint8_t)Value;
+		return Out;
+	}
+
+	uint8_t* WriteBlackboxSigned(uint8_t* Out, int64_t Value)
+	{
+		return WriteBlackboxVarint(Out, ((uint64_t)Value << 1) ^ (uint64_t)(Value >> 63));
+	}
+
+	bool ReadBlackboxVarint(const uint8_t*& Cursor, const uint8_t* End, uint64_t& OutValue)
+	{
+		OutValue = 0;
+		for (int Shift = 0; Shift < 64 && Cursor < End; Shift += 7)
+		{
+			const uint8_t Byte = *Cursor++;
+			OutValue |= (uint64_t)(Byte & 0x7F) << Shift;
+			if (!(Byte & 0x80))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool ReadBlackboxSigned(const uint8_t*& Cursor, const uint8_t* End, int64_t& OutValue)
+	{
+		uint64_t Raw;
+		if (!ReadBlackboxVarint(Cursor, End, Raw))
+		{
+			return false;
+		}
+		OutValue = (int64_t)(Raw >> 1) ^ -(int64_t)(Raw & 1);
+		return true;
+	}
+
+	// Clamped to int32 so a residual (at most four times that) always fits a 5-byte varint
+	int64_t QuantizeBlackbox(float Value, float Scale)
+	{
+		if (!std::isfinite(Value))
+		{
+			return 0;
+		}
+		const double Scaled = std::min(std::max((double)Value * Scale, (double)INT32_MIN), (double)INT32_MAX);
+		return (int64_t)std::llround(Scaled);
+	}
+
+	// Tag, step, then every field at its 5-byte worst case
+	static_assert(1 + 5 + FFlightBlackboxEncoder::NumFields * 5 <= FlightBlackboxMaxRecordBytes, "blackbox keyframe can overrun a record");
+	static_assert(1 + 5 + 1 + 7 * 5 <= FlightBlackboxMaxRecordBytes, "blackbox event can overrun a record");
+}
+
+size_t FFlightBlackboxEncoder::EncodeFrame(const FFlightBlackboxFrame& Frame, uint8_t* Out)
+{
+	float Values[NumFields];
+	GatherBlackboxFields(Frame, Values);
+
+	int64_t Quantized[NumFields];
+	for (int i = 0; i < NumFields; ++i)
+	{
+		Quantized[i] = QuantizeBlackbox(Values[i], BlackboxFields[i].Scale);
+	}
+
+	uint8_t* Cursor = Out;
+	if (FramesSinceKeyframe >= KeyframeInterval || NumHistory == 0)
+	{
+		*Cursor++ = BlackboxTagKeyframe;
+		Cursor = WriteBlackboxVarint(Cursor, Frame.Step);
+		for (int i = 0; i < NumFields; ++i)
+		{
+			Cursor = WriteBlackboxSigned(Cursor, Quantized[i]);
+		}
+		FramesSinceKeyframe = 0;
+		NumHistory = 0;
+	}
+	else
+	{
+		*Cursor++ = BlackboxTagDelta;
+		Cursor = WriteBlackboxVarint(Cursor, Frame.Step - PrevStep);
+		for (int i = 0; i < NumFields; ++i)
+		{
+			Cursor = WriteBlackboxSigned(Cursor, Quantized[i] - PredictBlackboxField(i, History, NumHistory));
+		}
+	}
+
+	++FramesSinceKeyframe;
+	PrevStep = Frame.Step;
+	PushBlackboxHistory(History, NumHistory, Quantized);
+	return (size_t)(Cursor - Out);
+}
+
+size_t FFlightBlackboxEncoder::EncodeEvent(const FFlightBlackboxEvent& Event, uint8_t* Out)
+{
+	uint8_t* Cursor = Out;
+	*Cursor++ = BlackboxTagEvent;
+	Cursor = WriteBlackboxVarint(Cursor, Event.Step);
+	*Cursor++ = (uint8_t)Event.Type;
+	Cursor = WriteBlackboxSigned(Cursor, QuantizeBlackbox(Event.Location.X, 1e2f));
+	Cursor = WriteBlackboxSigned(Cursor, QuantizeBlackbox(Event.Location.Y, 1e2f));
+	Cursor = WriteBlackboxSigned(Cursor, QuantizeBlackbox(Event.Location.Z, 1e2f));
+	Cursor = WriteBlackboxSigned(Cursor, QuantizeBlackbox(Event.Normal.X, 1e4f));
+	Cursor = WriteBlackboxSigned(Cursor, QuantizeBlackbox(Event.Normal.Y, 1e4f));
+	Cursor = WriteBlackboxSigned(Cursor, QuantizeBlackbox(Event.Normal.Z, 1e4f));
+	Cursor = WriteBlackboxSigned(Cursor, QuantizeBlackbox(Event.Value, 1e2f));
+	return (size_t)(Cursor - Out);
+}
+
+EFlightBlackboxRecord FFlightBlackboxDecoder::Next(const uint8_t*& Cursor, const uint8_t* End, FFlightBlackboxFrame& OutFrame, FFlightBlackboxEvent& OutEvent)
+{
+	constexpr int NumFields = FFlightBlackboxEncoder::NumFields;
+
+	while (Cursor < End)
+	{
+		const uint8_t Tag = *Cursor++;
+		if (Tag == BlackboxTagEvent)
+		{
+			uint64_t Step;
+			if (!ReadBlackboxVarint(Cursor, End, Step) || Cursor >= End)
+			{
+				return EFlightBlackboxRecord::None;
+			}
+			OutEvent.Step = (uint32_t)Step;
+			OutEvent.Type = (FFlightBlackboxEvent::EType)*Cursor++;
+
+			int64_t Q[7];
+			for (int64_t& V : Q)
+			{
+				if (!ReadBlackboxSigned(Cursor, End, V))
+				{
+					return EFlightBlackboxRecord::None;
+				}
+			}
+			OutEvent.Location = FFlightVec3((float)(Q[0] / 1e2), (float)(Q[1] / 1e2), (float)(Q[2] / 1e2));
+			OutEvent.Normal = FFlightVec3((float)(Q[3] / 1e4), (float)(Q[4] / 1e4), (float)(Q[5] / 1e4));
+			OutEvent.Value = (float)(Q[6] / 1e2);
+			return EFlightBlackboxRecord::Event;
+		}
+
+		if (Tag != BlackboxTagKeyframe && Tag != BlackboxTagDelta)
+		{
+			return EFlightBlackboxRecord::None;
+		}
+
+		const bool bKeyframe = Tag == BlackboxTagKeyframe;
+		uint64_t Step;
+		int64_t Quantized[NumFields];
+		if (!ReadBlackboxVarint(Cursor, End, Step))
+		{
+			return EFlightBlackboxRecord::None;
+		}
+		for (int64_t& V : Quantized)
+		{
+			if (!ReadBlackboxSigned(Cursor, End, V))
+			{
+				return EFlightBlackboxRecord::None;
+			}
+		}
+
+		if (bKeyframe)
+		{
+			NumHistory = 0;
+		}
+		else if (NumHistory == 0)
+		{
+			continue; // no keyframe yet: nothing to predict from
+		}
+		else
+		{
+			Step += PrevStep;
+			for (int i = 0; i < NumFields; ++i)
+			{
+				Quantized[i] += PredictBlackboxField(i, History, NumHistory);
+			}
+		}
+
+		PrevStep = (uint32_t)Step;
+		PushBlackboxHistory(History, NumHistory, Quantized);
+
+		OutFrame.Step = (uint32_t)Step;
+		ScatterBlackboxFields(Quantized, OutFrame);
+		return EFlightBlackboxRecord::Frame;
+	}
+	return EFlightBlackboxRecord::None;
+}
+
+void WriteFlightBlackboxHeader(uint8_t* Out, float StepSeconds)
+{
+	std::memcpy(Out, &FlightBlackboxMagic, 4);
+	std::memcpy(Out + 4, &FlightBlackboxVersion, 2);
+	const uint16_t Reserved = 0;
+	std::memcpy(Out + 6, &Reserved, 2);
+	std::memcpy(Out + 8, &StepSeconds, 4);
+}
+
+bool ReadFlightBlackboxHeader(const uint8_t* Data, size_t Size, float& OutStepSeconds)
+{
+	if (Size < FlightBlackboxHeaderBytes)
+	{
+		return false;
+	}
+	uint32_t Magic;
+	uint16_t Version;
+	std::memcpy(&Magic, Data, 4);
+	std::memcpy(&Version, Data + 4, 2);
+	std::memcpy(&OutStepSeconds, Data + 8, 4);
+	return Magic == FlightBlackboxMagic && Version >= 1 && Version <= FlightBlackboxVersion;
+}
@@ -0,0 +1,106 @@
+// FlightBlackbox.h
+//
+// Compact per-step flight log, in the spirit of Betaflight's blackbox: every field is
+// quantized to an integer, predicted from the previous frames and stored as a zigzag varint
+// of the residual. Keyframes at a fixed interval (and after any gap) store raw values, so
+// a log can be decoded from any keyframe and survives dropped blocks. Engine-free so the
+// same decoder serves the exporter and external tools.
+
+#pragma once
+
+#include "FlightMath.h"
+
+#include <cstddef>
+#include <cstdint>
+
+struct FFlightBlackboxFrame
+{
+	uint32_t Step = 0;
+	float Sticks[4] = {};           // roll, pitch, yaw, throttle before smoothing (+ = up/right)
+	float Commands[4] = {};         // roll, pitch, yaw, throttle as the flight model got them
+	float MotorThrust[4] = {};      // FR, RR, RL, FL
+	FFlightQuat Rotation;
+	FFlightVec3 Velocity;
+	FFlightVec3 Position;
+	float Health = 0.f;
+	uint8_t Flags = 0;              // EFlightBlackboxFlags
+};
+
+enum EFlightBlackboxFlags : uint8_t
+{
+	FlightBlackboxFlag_Armed = 1 << 0,
+	FlightBlackboxFlag_Contact = 1 << 1,
+	FlightBlackboxFlag_OnGround = 1 << 2
+};
+
+struct FFlightBlackboxEvent
+{
+	enum EType : uint8_t
+	{
+		Impact,     // Location, Normal, Value = speed into the surface (cm/s)
+		Damage,     // Value = damage taken
+		Crash,      // health reached zero
+		Marker      // user marker, Value free
+	};
+
+	uint32_t Step = 0;
+	EType Type = Impact;
+	FFlightVec3 Location;
+	FFlightVec3 Normal;
+	float Value = 0.f;
+};
+
+enum class EFlightBlackboxRecord : uint8_t
+{
+	None,
+	Frame,
+	Event
+};
+
+/** Upper bound of one encoded record: fields are clamped to int32, so a keyframe is at most 126 bytes. */
+constexpr size_t FlightBlackboxMaxRecordBytes = 160;
+
+class FFlightBlackboxEncoder
+{
+public:
+	explicit FFlightBlackboxEncoder(uint32_t InKeyframeInterval = 1000) : KeyframeInterval(InKeyframeInterval) {}
+
+	/** Writes Frame to Out (at least FlightBlackboxMaxRecordBytes). Returns the bytes written. */
+	size_t EncodeFrame(const FFlightBlackboxFrame& Frame, uint8_t* Out);
+	size_t EncodeEvent(const FFlightBlackboxEvent& Event, uint8_t* Out);
+
+	/** The next frame is stored raw: call after bytes were lost. */
+	void ForceKeyframe() { FramesSinceKeyframe = KeyframeInterval; }
+
+	static constexpr int NumFields = 24;
+
+private:
+	uint32_t KeyframeInterval;
+	uint32_t FramesSinceKeyframe = 0xFFFFFFFFu;
+	uint32_t PrevStep = 0;
+	int64_t History[2][NumFields] = {};
+	int NumHistory = 0;
+};
+
+class FFlightBlackboxDecoder
+{
+public:
+	/**
+	 * Reads the next record from [Cursor, End). Returns None at the end or on corrupt data.
+	 * Frames before the first keyframe can't be predicted and are skipped.
+	 */
+	EFlightBlackboxRecord Next(const uint8_t*& Cursor, const uint8_t* End, FFlightBlackboxFrame& OutFrame, FFlightBlackboxEvent& OutEvent);
+
+private:
+	uint32_t PrevStep = 0;
+	int64_t History[2][FFlightBlackboxEncoder::NumFields] = {};
+	int NumHistory = 0;
+};
+
+/** File header: magic, version, then the step length. Records follow. */
+constexpr uint32_t FlightBlackboxMagic = 0x58424244; // "DBBX"
+constexpr uint16_t FlightBlackboxVersion = 1;
+constexpr size_t FlightBlackboxHeaderBytes = 12;
+
+void WriteFlightBlackboxHeader(uint8_t* Out, float StepSeconds);
+bool ReadFlightBlackboxHeader(const uint8_t* Data, size_t Size, float& OutStepSeconds);
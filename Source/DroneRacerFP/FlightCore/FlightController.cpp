@@ -0,0 +1,90 @@
+// FlightController.cpp
+
+#include "FlightController.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	float Pt1Gain(float CutoffHz, float Dt)
+	{
+		const float Omega = 2.f * FlightPi * CutoffHz * Dt;
+		return Omega / (Omega + 1.f);
+	}
+
+	FFlightVec3 ClampVec(const FFlightVec3& V, float Limit)
+	{
+		return { std::clamp(V.X, -Limit, Limit), std::clamp(V.Y, -Limit, Limit), std::clamp(V.Z, -Limit, Limit) };
+	}
+}
+
+void ResetFlightPid(FFlightPidState& State, const FFlightVec3& Gyro)
+{
+	State = FFlightPidState();
+	State.PrevGyro = Gyro;
+}
+
+FFlightVec3 UpdateFlightPid(FFlightPidState& State, const FFlightPidParams& Params, const FFlightVec3& Setpoint, const FFlightVec3& Gyro, float Dt)
+{
+	const float InvDt = 1.f / Dt;
+	const FFlightVec3 Error = Setpoint - Gyro;
+
+	// I: held while the mixer is saturated so it can't wind up against the motor limits
+	if (!State.bSaturated)
+	{
+		State.ITerm = ClampVec(State.ITerm + Params.I * Error * Dt, Params.ITermLimit);
+	}
+
+	// D on measurement (no setpoint kick), low-passed twice
+	const FFlightVec3 GyroAccel = (Gyro - State.PrevGyro) * InvDt;
+	State.PrevGyro = Gyro;
+
+	const float DK = Pt1Gain(Params.DTermCutoffHz, Dt);
+	State.DTermLpf1 += (GyroAccel - State.DTermLpf1) * DK;
+	State.DTermLpf2 += (State.DTermLpf1 - State.DTermLpf2) * DK;
+
+	// FF on the smoothed setpoint change, so stick moves don't wait for an error to build
+	const FFlightVec3 SetpointAccel = (Setpoint - State.PrevSetpoint) * InvDt;
+	State.PrevSetpoint = Setpoint;
+	State.Feedforward += (SetpointAccel - State.Feedforward) * Pt1Gain(Params.FeedforwardCutoffHz, Dt);
+
+	return Params.P * Error + State.ITerm - Params.D * State.DTermLpf2 + Params.FF * State.Feedforward;
+}
+
+FFlightVec3 ApplyLevelMode(const FFlightPidParams& Params, const FFlightQuat& Rotation, const FFlightVec3& AcroSetpoint, float RollStick, float PitchStick)
+{
+	if (Params.Mode == EFlightMode::Acro)
+	{
+		return AcroSetpoint;
+	}
+
+	// Current attitude, FRotator convention: + pitch = nose up, + roll = right wing down
+	const FFlightVec3 Forward = Rotation.GetForwardVector();
+	const FFlightVec3 Right = Rotation.GetRightVector();
+	const FFlightVec3 Up = Rotation.GetUpVector();
+	const float Pitch = std::asin(std::clamp(Forward.Z, -1.f, 1.f));
+	const float Roll = std::atan2(-Right.Z, Up.Z);
+
+	const float Limit = Params.AngleLimitDeg * FlightDegToRad;
+	const float RollError = std::clamp(RollStick, -1.f, 1.f) * Limit - Roll;
+	const float PitchError = std::clamp(PitchStick, -1.f, 1.f) * Limit - Pitch;
+
+	// Levelling rates, back in the state's axis convention (+X = roll left, +Y = pitch down)
+	const FFlightVec3 LevelSetpoint(-RollError * Params.AngleStrength, -PitchError * Params.AngleStrength, AcroSetpoint.Z);
+
+	if (Params.Mode == EFlightMode::Angle)
+	{
+		return LevelSetpoint;
+	}
+
+	// Horizon: levelling fades out as the sticks approach HorizonTransition
+	const float Deflection = std::max(std::fabs(RollStick), std::fabs(PitchStick));
+	const float Level = 1.f - std::clamp(Deflection / std::max(Params.HorizonTransition, 0.01f), 0.f, 1.f);
+
+	return {
+		AcroSetpoint.X + (LevelSetpoint.X - AcroSetpoint.X) * Level,
+		AcroSetpoint.Y + (LevelSetpoint.Y - AcroSetpoint.Y) * Level,
+		AcroSetpoint.Z
+	};
+}
@@ -0,0 +1,65 @@
+// FlightController.h
+//
+// Simulated flight controller: Betaflight-style PID rate loop with a filtered,
+// measurement-based D term and setpoint feedforward, plus the self-levelling
+// angle and horizon modes. Runs at its own loop rate inside the flight step.
+// All vectors use FFlightState::AngularVelocity's axis convention (X roll, Y pitch, Z yaw).
+
+#pragma once
+
+#include "FlightMath.h"
+
+enum class EFlightMode : unsigned char
+{
+	Acro,       // sticks command body rates
+	Angle,      // roll/pitch sticks command an attitude, limited to AngleLimitDeg
+	Horizon     // angle near center stick, acro towards full deflection
+};
+
+struct FFlightPidParams
+{
+	EFlightMode Mode = EFlightMode::Acro;
+
+	float LoopRateHz = 4000.f;      // PID loop rate; the flight step runs it several times per substep
+
+	// Gains produce angular acceleration (times the inertia = torque request). P acts on the rate
+	// error (1/s), I on its integral (1/s^2), D on gyro acceleration and FF on setpoint acceleration
+	// (both unitless). Defaults give ~35 ms to 90% and ~13% overshoot on a roll step with the default motors.
+	FFlightVec3 P = { 100.f, 100.f, 60.f };
+	FFlightVec3 I = { 200.f, 200.f, 120.f };
+	FFlightVec3 D = { 0.8f, 0.8f, 0.f };
+	FFlightVec3 FF = { 1.f, 1.f, 0.5f };
+
+	float ITermLimit = 400.f;       // rad/s^2, per axis
+	float DTermCutoffHz = 100.f;    // two PT1 stages on the D term, like dterm_lpf1 + dterm_lpf2
+	float FeedforwardCutoffHz = 30.f;
+
+	// Self-levelling (Angle / Horizon)
+	float AngleLimitDeg = 55.f;     // attitude at full stick
+	float AngleStrength = 6.f;      // 1/s, attitude error -> rate setpoint
+	float HorizonTransition = 0.75f; // stick deflection where horizon mode becomes pure acro
+};
+
+struct FFlightPidState
+{
+	FFlightVec3 ITerm;
+	FFlightVec3 PrevGyro;
+	FFlightVec3 DTermLpf1;
+	FFlightVec3 DTermLpf2;
+	FFlightVec3 PrevSetpoint;
+	FFlightVec3 Feedforward;
+	bool bSaturated = false;        // mixer ran out of authority last iteration: hold the I term
+};
+
+/** Clears integrators and filters, seeding them from the current gyro so the first D is zero. */
+void ResetFlightPid(FFlightPidState& State, const FFlightVec3& Gyro);
+
+/** One PID iteration. Returns the requested angular acceleration (rad/s^2). */
+FFlightVec3 UpdateFlightPid(FFlightPidState& State, const FFlightPidParams& Params, const FFlightVec3& Setpoint, const FFlightVec3& Gyro, float Dt);
+
+/**
+ * Angle / horizon: replaces the roll and pitch of an acro rate setpoint with a levelling
+ * term towards the attitude the sticks ask for. Sticks are -1..1 (+ roll = right wing down,
+ * + pitch = nose up). Acro mode returns AcroSetpoint untouched.
+ */
+FFlightVec3 ApplyLevelMode(const FFlightPidParams& Params, const FFlightQuat& Rotation, const FFlightVec3& AcroSetpoint, float RollStick, float PitchStick);
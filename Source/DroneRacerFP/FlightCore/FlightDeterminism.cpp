@@ -0,0 +1,79 @@
+// FlightDeterminism.cpp
+
+#include "FlightDeterminism.h"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <xmmintrin.h>
+#define FLIGHT_HAS_MXCSR 1
+#else
+#define FLIGHT_HAS_MXCSR 0
+#endif
+
+namespace
+{
+	constexpr uint32_t FlightFnvPrime = 16777619u;
+
+	uint32_t HashFlightFloat(uint32_t Hash, float Value)
+	{
+		uint32_t Bits;
+		std::memcpy(&Bits, &Value, sizeof(Bits));
+		for (int Byte = 0; Byte < 4; ++Byte)
+		{
+			Hash = (Hash ^ ((Bits >> (Byte * 8)) & 0xFFu)) * FlightFnvPrime;
+		}
+		return Hash;
+	}
+
+	uint32_t HashFlightVec(uint32_t Hash, const FFlightVec3& V)
+	{
+		return HashFlightFloat(HashFlightFloat(HashFlightFloat(Hash, V.X), V.Y), V.Z);
+	}
+}
+
+uint32_t HashFlightState(const FFlightState& State, uint32_t Checksum)
+{
+	// Field by field: no padding bytes in the hash
+	uint32_t Hash = Checksum;
+	Hash = HashFlightVec(Hash, State.Position);
+	Hash = HashFlightVec(Hash, State.Velocity);
+	Hash = HashFlightFloat(Hash, State.Rotation.X);
+	Hash = HashFlightFloat(Hash, State.Rotation.Y);
+	Hash = HashFlightFloat(Hash, State.Rotation.Z);
+	Hash = HashFlightFloat(Hash, State.Rotation.W);
+	Hash = HashFlightFloat(Hash, State.ThrottleSmoothed);
+	Hash = HashFlightVec(Hash, State.AngularVelocity);
+	for (const float Thrust : State.MotorThrust)
+	{
+		Hash = HashFlightFloat(Hash, Thrust);
+	}
+
+	const FFlightPidState& Pid = State.Pid;
+	Hash = HashFlightVec(Hash, Pid.ITerm);
+	Hash = HashFlightVec(Hash, Pid.PrevGyro);
+	Hash = HashFlightVec(Hash, Pid.DTermLpf1);
+	Hash = HashFlightVec(Hash, Pid.DTermLpf2);
+	Hash = HashFlightVec(Hash, Pid.PrevSetpoint);
+	Hash = HashFlightVec(Hash, Pid.Feedforward);
+	return (Hash ^ (Pid.bSaturated ? 1u : 0u)) * FlightFnvPrime;
+}
+
+FFlightFloatEnvironment::FFlightFloatEnvironment()
+{
+#if FLIGHT_HAS_MXCSR
+	constexpr unsigned int RoundingMask = 0x6000u;   // 00 = round to nearest
+	constexpr unsigned int FlushToZero = 0x8000u;
+	constexpr unsigned int DenormalsAreZero = 0x0040u;
+
+	SavedControl = _mm_getcsr();
+	_mm_setcsr((SavedControl & ~RoundingMask) | FlushToZero | DenormalsAreZero);
+#endif
+}
+
+FFlightFloatEnvironment::~FFlightFloatEnvironment()
+{
+#if FLIGHT_HAS_MXCSR
+	_mm_setcsr(SavedControl);
+#endif
+}
@@ -0,0 +1,35 @@
+// FlightDeterminism.h
+//
+// Helpers for bit-exact runs of the flight model: a per-step state checksum and a scope
+// that pins the floating-point environment. Same binary + same CPU family + same inputs
+// gives the same bits; across compilers or architectures (FMA contraction, libm) it doesn't.
+
+#pragma once
+
+#include "FlightModel.h"
+
+#include <cstdint>
+
+/** Starting value for a chain of HashFlightState calls. */
+constexpr uint32_t FlightChecksumSeed = 2166136261u;
+
+/** FNV-1a over the bit patterns of everything in State, chained onto Checksum. */
+uint32_t HashFlightState(const FFlightState& State, uint32_t Checksum = FlightChecksumSeed);
+
+/**
+ * Pins the SSE control register for its lifetime: round to nearest, denormals flushed to zero
+ * on input and output, so the result doesn't depend on what the thread was left in.
+ * No-op where there is no MXCSR.
+ */
+class FFlightFloatEnvironment
+{
+public:
+	FFlightFloatEnvironment();
+	~FFlightFloatEnvironment();
+
+	FFlightFloatEnvironment(const FFlightFloatEnvironment&) = delete;
+	FFlightFloatEnvironment& operator=(const FFlightFloatEnvironment&) = delete;
+
+private:
+	unsigned int SavedControl = 0;
+};
@@ -0,0 +1,461 @@
+// FlightGhost.cpp
+//
+// Blob layout (little endian):
+//   uint32 magic "DGHO", uint16 version, uint16 chunk size, float sample rate, uint32 samples,
+//   uint32 chunk count, uint32 byte offset of every chunk from the start of the blob, chunks.
+// A chunk starts with its first sample raw (positions 32 bits, quaternion components 16 bits);
+// the rest are Rice-coded zigzag residuals, interleaved by sample.
+
+#include "FlightGhost.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+	constexpr uint32_t GhostMagic = 0x4F484744; // "DGHO"
+	constexpr uint16_t GhostVersion = 1;
+	constexpr size_t GhostHeaderBytes = 20;
+
+	constexpr float GhostPositionScale = 1.f;       // 1 cm
+	constexpr float GhostRotationScale = 2048.f;
+
+	// Residuals this far out are stored raw after an escape
+	constexpr uint32_t GhostRiceEscape = 24;
+
+	constexpr int GhostFieldBits[FFlightGhostEncoder::NumFields] = { 32, 32, 32, 16, 16, 16, 16 };
+
+	class FGhostBitWriter
+	{
+	public:
+		explicit FGhostBitWriter(std::vector<uint8_t>& InBytes) : Bytes(InBytes) {}
+
+		void Write(uint32_t Value, int NumBits)
+		{
+			for (int i = NumBits - 1; i >= 0; --i)
+			{
+				WriteBit((Value >> i) & 1);
+			}
+		}
+
+		void WriteBit(uint32_t Bit)
+		{
+			if (NumPending == 0)
+			{
+				Bytes.push_back(0);
+			}
+			Bytes.back() |= (uint8_t)(Bit << (7 - NumPending));
+			NumPending = (NumPending + 1) & 7;
+		}
+
+		/** Chunks start on a byte. */
+		void Align() { NumPending = 0; }
+
+	private:
+		std::vector<uint8_t>& Bytes;
+		int NumPending = 0;
+	};
+
+	class FGhostBitReader
+	{
+	public:
+		FGhostBitReader(const uint8_t* InData, size_t InSize, size_t ByteOffset) : Data(InData), NumBits(InSize * 8), Cursor(ByteOffset * 8) {}
+
+		uint32_t Read(int Count)
+		{
+			uint32_t Value = 0;
+			for (int i = 0; i < Count; ++i)
+			{
+				Value = (Value << 1) | ReadBit();
+			}
+			return Value;
+		}
+
+		uint32_t ReadBit()
+		{
+			if (Cursor >= NumBits)
+			{
+				bOverrun = true;
+				return 0;
+			}
+			const uint32_t Bit = (Data[Cursor >> 3] >> (7 - (Cursor & 7))) & 1;
+			++Cursor;
+			return Bit;
+		}
+
+		bool IsOverrun() const { return bOverrun; }
+
+	private:
+		const uint8_t* Data;
+		size_t NumBits;
+		size_t Cursor;
+		bool bOverrun = false;
+	};
+
+	/** Rice parameter from the running mean of the magnitudes, as in LOCO-I. */
+	struct FGhostRiceState
+	{
+		uint32_t Sum = 4;
+		uint32_t Count = 1;
+
+		int GetK() const
+		{
+			int K = 0;
+			while ((Count << K) < Sum && K < 30)
+			{
+				++K;
+			}
+			return K;
+		}
+
+		void Update(uint32_t Value)
+		{
+			Sum += Value;
+			if (++Count >= 64)
+			{
+				Sum >>= 1;
+				Count >>= 1;
+			}
+		}
+	};
+
+	uint32_t GhostZigzag(int32_t Value) { return ((uint32_t)Value << 1) ^ (uint32_t)(Value >> 31); }
+	int32_t GhostUnzigzag(uint32_t Value) { return (int32_t)(Value >> 1) ^ -(int32_t)(Value & 1); }
+
+	void WriteGhostRice(FGhostBitWriter& Writer, FGhostRiceState& State, uint32_t Value)
+	{
+		const int K = State.GetK();
+		const uint32_t Quotient = Value >> K;
+		if (Quotient >= GhostRiceEscape)
+		{
+			for (uint32_t i = 0; i < GhostRiceEscape; ++i)
+			{
+				Writer.WriteBit(1);
+			}
+			Writer.Write(Value, 32);
+		}
+		else
+		{
+			for (uint32_t i = 0; i < Quotient; ++i)
+			{
+				Writer.WriteBit(1);
+			}
+			Writer.WriteBit(0);
+			Writer.Write(Value & ((1u << K) - 1), K);
+		}
+		State.Update(Value);
+	}
+
+	uint32_t ReadGhostRice(FGhostBitReader& Reader, FGhostRiceState& State)
+	{
+		const int K = State.GetK();
+		uint32_t Quotient = 0;
+		while (Quotient < GhostRiceEscape && Reader.ReadBit() && !Reader.IsOverrun())
+		{
+			++Quotient;
+		}
+		const uint32_t Value = Quotient >= GhostRiceEscape ? Reader.Read(32) : (Quotient << K) | Reader.Read(K);
+		State.Update(Value);
+		return Value;
+	}
+
+	int32_t PredictGhostField(const int32_t* Prev1, const int32_t* Prev2, int Field)
+	{
+		if (!Prev1)
+		{
+			return 0;
+		}
+		return Prev2 ? 2 * Prev1[Field] - Prev2[Field] : Prev1[Field];
+	}
+
+	template <typename T>
+	void WriteGhostPod(std::vector<uint8_t>& Out, T Value)
+	{
+		const size_t At = Out.size();
+		Out.resize(At + sizeof(T));
+		std::memcpy(&Out[At], &Value, sizeof(T));
+	}
+
+	template <typename T>
+	T ReadGhostPod(const uint8_t* Data)
+	{
+		T Value;
+		std::memcpy(&Value, Data, sizeof(T));
+		return Value;
+	}
+
+	template <typename T>
+	T GhostCatmullRom(const T& P0, const T& P1, const T& P2, const T& P3, float Alpha)
+	{
+		const float A2 = Alpha * Alpha;
+		const float A3 = A2 * Alpha;
+		return (P1 * 2.f + (P2 - P0) * Alpha + (P0 * 2.f - P1 * 5.f + P2 * 4.f - P3) * A2 + (P1 * 3.f - P0 - P2 * 3.f + P3) * A3) * 0.5f;
+	}
+}
+
+void FFlightGhostEncoder::Add(const FFlightGhostSample& Sample)
+{
+	FFlightQuat Q = Sample.Rotation;
+
+	// Stay on the previous sample's hemisphere so the components move smoothly
+	if (!Quantized.empty())
+	{
+		const int32_t* Prev = &Quantized[Quantized.size() - NumFields];
+		const float Dot = Q.X * Prev[3] + Q.Y * Prev[4] + Q.Z * Prev[5] + Q.W * Prev[6];
+		if (Dot < 0.f)
+		{
+			Q = FFlightQuat(-Q.X, -Q.Y, -Q.Z, -Q.W);
+		}
+	}
+
+	Quantized.push_back((int32_t)std::lround(Sample.Position.X / GhostPositionScale));
+	Quantized.push_back((int32_t)std::lround(Sample.Position.Y / GhostPositionScale));
+	Quantized.push_back((int32_t)std::lround(Sample.Position.Z / GhostPositionScale));
+	Quantized.push_back((int32_t)std::lround(Q.X * GhostRotationScale));
+	Quantized.push_back((int32_t)std::lround(Q.Y * GhostRotationScale));
+	Quantized.push_back((int32_t)std::lround(Q.Z * GhostRotationScale));
+	Quantized.push_back((int32_t)std::lround(Q.W * GhostRotationScale));
+}
+
+std::vector<uint8_t> FFlightGhostEncoder::Encode() const
+{
+	const int NumSamples = GetNumSamples();
+	const int NumChunks = (NumSamples + ChunkSize - 1) / ChunkSize;
+
+	std::vector<uint8_t> Out;
+	WriteGhostPod(Out, GhostMagic);
+	WriteGhostPod(Out, GhostVersion);
+	WriteGhostPod(Out, (uint16_t)ChunkSize);
+	WriteGhostPod(Out, SampleRateHz);
+	WriteGhostPod(Out, (uint32_t)NumSamples);
+	WriteGhostPod(Out, (uint32_t)NumChunks);
+
+	const size_t OffsetTable = Out.size();
+	Out.resize(OffsetTable + NumChunks * sizeof(uint32_t));
+
+	for (int Chunk = 0; Chunk < NumChunks; ++Chunk)
+	{
+		const uint32_t Offset = (uint32_t)Out.size();
+		std::memcpy(&Out[OffsetTable + Chunk * sizeof(uint32_t)], &Offset, sizeof(Offset));
+
+		FGhostBitWriter Writer(Out);
+		FGhostRiceState Rice[NumFields];
+
+		const int First = Chunk * ChunkSize;
+		const int Last = std::min(First + ChunkSize, NumSamples);
+		for (int i = First; i < Last; ++i)
+		{
+			const int32_t* Sample = &Quantized[(size_t)i * NumFields];
+			const int32_t* Prev1 = i > First ? Sample - NumFields : nullptr;
+			const int32_t* Prev2 = i > First + 1 ? Sample - 2 * NumFields : nullptr;
+
+			for (int Field = 0; Field < NumFields; ++Field)
+			{
+				if (!Prev1)
+				{
+					Writer.Write((uint32_t)Sample[Field], GhostFieldBits[Field]);
+				}
+				else
+				{
+					WriteGhostRice(Writer, Rice[Field], GhostZigzag(Sample[Field] - PredictGhostField(Prev1, Prev2, Field)));
+				}
+			}
+		}
+		Writer.Align();
+	}
+	return Out;
+}
+
+bool FFlightGhostTrack::Init(const uint8_t* InData, size_t Size)
+{
+	if (!InData || Size < GhostHeaderBytes
+		|| ReadGhostPod<uint32_t>(InData) != GhostMagic
+		|| ReadGhostPod<uint16_t>(InData + 4) == 0 || ReadGhostPod<uint16_t>(InData + 4) > GhostVersion
+		|| ReadGhostPod<uint16_t>(InData + 6) != FFlightGhostEncoder::ChunkSize)
+	{
+		return false;
+	}
+
+	const float Rate = ReadGhostPod<float>(InData + 8);
+	const uint32_t Samples = ReadGhostPod<uint32_t>(InData + 12);
+	const uint32_t Chunks = ReadGhostPod<uint32_t>(InData + 16);
+	if (!(Rate > 0.f) || Chunks != (Samples + FFlightGhostEncoder::ChunkSize - 1) / FFlightGhostEncoder::ChunkSize
+		|| GhostHeaderBytes + (size_t)Chunks * sizeof(uint32_t) > Size)
+	{
+		return false;
+	}
+
+	ChunkOffsets.resize(Chunks);
+	for (uint32_t i = 0; i < Chunks; ++i)
+	{
+		ChunkOffsets[i] = ReadGhostPod<uint32_t>(InData + GhostHeaderBytes + i * sizeof(uint32_t));
+		if (ChunkOffsets[i] >= Size)
+		{
+			ChunkOffsets.clear();
+			return false;
+		}
+	}
+
+	Data.assign(InData, InData + Size);
+	NumSamples = (int)Samples;
+	SampleRateHz = Rate;
+	return true;
+}
+
+int FFlightGhostTrack::DecodeChunk(int Index, FFlightGhostSample* Out) const
+{
+	constexpr int NumFields = FFlightGhostEncoder::NumFields;
+	if (Index < 0 || Index >= GetNumChunks())
+	{
+		return 0;
+	}
+
+	FGhostBitReader Reader(Data.data(), Data.size(), ChunkOffsets[Index]);
+	FGhostRiceState Rice[NumFields];
+	int32_t History[3][NumFields];
+
+	const int First = Index * FFlightGhostEncoder::ChunkSize;
+	const int Count = std::min(FFlightGhostEncoder::ChunkSize, NumSamples - First);
+	for (int i = 0; i < Count; ++i)
+	{
+		int32_t* Sample = History[i % 3];
+		const int32_t* Prev1 = i > 0 ? History[(i + 2) % 3] : nullptr;
+		const int32_t* Prev2 = i > 1 ? History[(i + 1) % 3] : nullptr;
+
+		for (int Field = 0; Field < NumFields; ++Field)
+		{
+			if (!Prev1)
+			{
+				const uint32_t Raw = Reader.Read(GhostFieldBits[Field]);
+				Sample[Field] = GhostFieldBits[Field] == 16 ? (int32_t)(int16_t)Raw : (int32_t)Raw;
+			}
+			else
+			{
+				Sample[Field] = PredictGhostField(Prev1, Prev2, Field) + GhostUnzigzag(ReadGhostRice(Reader, Rice[Field]));
+			}
+		}
+
+		FFlightGhostSample& Decoded = Out[i];
+		Decoded.Position = FFlightVec3(Sample[0] * GhostPositionScale, Sample[1] * GhostPositionScale, Sample[2] * GhostPositionScale);
+		Decoded.Rotation = FFlightQuat(Sample[3] / GhostRotationScale, Sample[4] / GhostRotationScale,
+			Sample[5] / GhostRotationScale, Sample[6] / GhostRotationScale).GetNormalized();
+	}
+	return Reader.IsOverrun() ? 0 : Count;
+}
+
+void FFlightGhostPlayback::SetTracks(std::vector<const FFlightGhostTrack*> InTracks)
+{
+	Tracks = std::move(InTracks);
+
+	// Two chunks per ghost covers the spline window; one spare for the hand-over
+	Slots.assign(Tracks.size() * 2 + 1, FSlot());
+	Samples.resize(Slots.size() * FFlightGhostEncoder::ChunkSize);
+	RecentSlots.assign(Tracks.size(), { -1, -1 });
+	UseCounter = 0;
+}
+
+const FFlightGhostSample& FFlightGhostPlayback::GetSample(int Track, int Index)
+{
+	const int Chunk = Index / FFlightGhostEncoder::ChunkSize;
+	const int Offset = Index % FFlightGhostEncoder::ChunkSize;
+	++UseCounter;
+
+	// Almost always one of the two chunks this track used last
+	for (int Hint : RecentSlots[Track])
+	{
+		if (Hint >= 0 && Slots[Hint].Track == Track && Slots[Hint].Chunk == Chunk)
+		{
+			Slots[Hint].LastUse = UseCounter;
+			return Samples[(size_t)Hint * FFlightGhostEncoder::ChunkSize + Offset];
+		}
+	}
+
+	int Victim = 0;
+	for (int i = 0; i < (int)Slots.size(); ++i)
+	{
+		if (Slots[i].Track == Track && Slots[i].Chunk == Chunk)
+		{
+			Slots[i].LastUse = UseCounter;
+			RememberSlot(Track, i);
+			return Samples[(size_t)i * FFlightGhostEncoder::ChunkSize + Offset];
+		}
+		if (Slots[i].LastUse < Slots[Victim].LastUse)
+		{
+			Victim = i;
+		}
+	}
+
+	// Least recently used slot takes the chunk
+	FSlot& Slot = Slots[Victim];
+	FFlightGhostSample* Out = &Samples[(size_t)Victim * FFlightGhostEncoder::ChunkSize];
+	if (Tracks[Track]->DecodeChunk(Chunk, Out) == 0)
+	{
+		std::fill(Out, Out + FFlightGhostEncoder::ChunkSize, FFlightGhostSample());
+	}
+	++NumChunkDecodes;
+
+	Slot.Track = Track;
+	Slot.Chunk = Chunk;
+	Slot.LastUse = UseCounter;
+	RememberSlot(Track, Victim);
+	return Out[Offset];
+}
+
+void FFlightGhostPlayback::RememberSlot(int Track, int Slot)
+{
+	std::array<int, 2>& Recent = RecentSlots[Track];
+	if (Recent[0] != Slot)
+	{
+		Recent[1] = Recent[0];
+		Recent[0] = Slot;
+	}
+}
+
+void FFlightGhostPlayback::Evaluate(double Time, FFlightGhostSample* Out)
+{
+	for (int Track = 0; Track < (int)Tracks.size(); ++Track)
+	{
+		const FFlightGhostTrack& Ghost = *Tracks[Track];
+		const int Last = Ghost.GetNumSamples() - 1;
+		if (Last < 0)
+		{
+			Out[Track] = FFlightGhostSample();
+			continue;
+		}
+
+		const double Position = std::clamp(Time * Ghost.GetSampleRate(), 0.0, (double)Last);
+		const int I1 = std::min((int)Position, Last);
+		const int I0 = std::max(I1 - 1, 0);
+		const int I2 = std::min(I1 + 1, Last);
+		const int I3 = std::min(I1 + 2, Last);
+		const float T = (float)(Position - I1);
+
+		// Copies: fetching one sample may evict the chunk of another
+		const FFlightGhostSample S0 = GetSample(Track, I0);
+		const FFlightGhostSample S1 = GetSample(Track, I1);
+		const FFlightGhostSample S2 = GetSample(Track, I2);
+		const FFlightGhostSample S3 = GetSample(Track, I3);
+
+		Out[Track].Position = GhostCatmullRom(S0.Position, S1.Position, S2.Position, S3.Position, T);
+
+		// Components on S1's hemisphere, splined and renormalized: close to squad at these sample spacings
+		const FFlightQuat* Keys[4] = { &S0.Rotation, &S1.Rotation, &S2.Rotation, &S3.Rotation };
+		float Components[4][4];
+		for (int k = 0; k < 4; ++k)
+		{
+			const FFlightQuat& Q = *Keys[k];
+			const float Sign = (Q.X * S1.Rotation.X + Q.Y * S1.Rotation.Y + Q.Z * S1.Rotation.Z + Q.W * S1.Rotation.W) < 0.f ? -1.f : 1.f;
+			Components[0][k] = Q.X * Sign;
+			Components[1][k] = Q.Y * Sign;
+			Components[2][k] = Q.Z * Sign;
+			Components[3][k] = Q.W * Sign;
+		}
+		float Splined[4];
+		for (int c = 0; c < 4; ++c)
+		{
+			Splined[c] = GhostCatmullRom(Components[c][0], Components[c][1], Components[c][2], Components[c][3], T);
+		}
+		Out[Track].Rotation = FFlightQuat(Splined[0], Splined[1], Splined[2], Splined[3]).GetNormalized();
+	}
+}
@@ -0,0 +1,104 @@
+// FlightGhost.h
+//
+// Ghost laps: a drone's pose at a fixed rate, compressed to a few KB per lap, and cheap playback
+// of many of them at once. Positions (1 cm) and quaternion components (1/2048) are quantized,
+// predicted linearly from the two previous samples and the residuals Rice-coded with a per-field
+// adaptive parameter. Samples are grouped in chunks that decode on their own, so playback only
+// ever holds the few chunks around each ghost's current time. Engine-free like the rest of FlightCore.
+
+#pragma once
+
+#include "FlightMath.h"
+
+#include <cstddef>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+struct FFlightGhostSample
+{
+	FFlightVec3 Position;
+	FFlightQuat Rotation;
+};
+
+class FFlightGhostEncoder
+{
+public:
+	explicit FFlightGhostEncoder(float InSampleRateHz = 30.f) : SampleRateHz(InSampleRateHz) {}
+
+	void Add(const FFlightGhostSample& Sample);
+	int GetNumSamples() const { return (int)(Quantized.size() / NumFields); }
+	float GetSampleRate() const { return SampleRateHz; }
+
+	/** The whole track as a self-contained blob (see FFlightGhostTrack). */
+	std::vector<uint8_t> Encode() const;
+
+	static constexpr int ChunkSize = 64;
+	static constexpr int NumFields = 7;
+
+private:
+	float SampleRateHz;
+	std::vector<int32_t> Quantized;     // NumFields per sample
+};
+
+/** An encoded track; chunks are decoded on request. */
+class FFlightGhostTrack
+{
+public:
+	/** Copies the blob. False if it isn't a ghost track. */
+	bool Init(const uint8_t* Data, size_t Size);
+
+	int GetNumSamples() const { return NumSamples; }
+	int GetNumChunks() const { return (int)ChunkOffsets.size(); }
+	float GetSampleRate() const { return SampleRateHz; }
+	double GetDuration() const { return NumSamples > 1 ? (NumSamples - 1) / (double)SampleRateHz : 0.0; }
+	size_t GetEncodedSize() const { return Data.size(); }
+
+	/** Decodes chunk Index into Out (room for ChunkSize). Returns the number of samples. */
+	int DecodeChunk(int Index, FFlightGhostSample* Out) const;
+
+private:
+	std::vector<uint8_t> Data;
+	std::vector<uint32_t> ChunkOffsets;
+	int NumSamples = 0;
+	float SampleRateHz = 30.f;
+};
+
+/**
+ * Plays any number of tracks against one shared cache of decoded chunks. Each ghost needs at most
+ * two chunks at a time (four samples for the spline), so the cache is sized to that and a chunk is
+ * decoded once per pass, not per frame.
+ */
+class FFlightGhostPlayback
+{
+public:
+	/** Tracks must outlive the playback, or be re-set. */
+	void SetTracks(std::vector<const FFlightGhostTrack*> InTracks);
+	int GetNumTracks() const { return (int)Tracks.size(); }
+
+	/**
+	 * Pose of every track at Time seconds from its start, Catmull-Rom between samples; holds the
+	 * first / last pose outside the track. Out needs GetNumTracks() entries.
+	 */
+	void Evaluate(double Time, FFlightGhostSample* Out);
+
+	int64_t GetNumChunkDecodes() const { return NumChunkDecodes; }
+
+private:
+	const FFlightGhostSample& GetSample(int Track, int Index);
+	void RememberSlot(int Track, int Slot);
+
+	struct FSlot
+	{
+		int Track = -1;
+		int Chunk = -1;
+		uint32_t LastUse = 0;
+	};
+
+	std::vector<const FFlightGhostTrack*> Tracks;
+	std::vector<FSlot> Slots;
+	std::vector<FFlightGhostSample> Samples;    // Slots.size() * ChunkSize
+	std::vector<std::array<int, 2>> RecentSlots;
+	uint32_t UseCounter = 0;
+	int64_t NumChunkDecodes = 0;
+};
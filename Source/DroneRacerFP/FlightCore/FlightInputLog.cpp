@@ -0,0 +1,183 @@
+// FlightInputLog.cpp
+//
+// uint32  Magic ('DINP')
+// uint16  Version
+// float   StepSeconds
+// int64   FirstStep
+// <state> InitialState: every float of FFlightState in declaration order, bSaturated as uint8
+// int32   NumSamples, then per sample: double Time, float Sticks[4], uint8 bArmed
+// int32   NumChecksums, then uint32 per step
+
+#include "FlightInputLog.h"
+
+#include <cstring>
+#include <utility>
+
+namespace
+{
+	constexpr size_t InputLogSampleBytes = 8 + 4 * 4 + 1;
+
+	class FInputLogWriter
+	{
+	public:
+		explicit FInputLogWriter(std::vector<uint8_t>& InOut) : Out(InOut) {}
+
+		template <typename T>
+		void Write(T Value)
+		{
+			uint8_t Bytes[sizeof(T)];
+			std::memcpy(Bytes, &Value, sizeof(T));
+			Out.insert(Out.end(), Bytes, Bytes + sizeof(T));
+		}
+
+	private:
+		std::vector<uint8_t>& Out;
+	};
+
+	class FInputLogReader
+	{
+	public:
+		FInputLogReader(const uint8_t* InData, size_t InSize) : Data(InData), Size(InSize) {}
+
+		template <typename T>
+		void Read(T& Value)
+		{
+			if (Size - Offset < sizeof(T))
+			{
+				bError = true;
+				Value = T();
+				return;
+			}
+			std::memcpy(&Value, Data + Offset, sizeof(T));
+			Offset += sizeof(T);
+		}
+
+		size_t Remaining() const { return Size - Offset; }
+
+		bool bError = false;
+
+	private:
+		const uint8_t* Data;
+		size_t Size;
+		size_t Offset = 0;
+	};
+
+	// Writer and reader visit the same fields in the same order
+	template <typename ArchiveFn>
+	void VisitInputLogState(FFlightState& State, ArchiveFn&& Visit)
+	{
+		auto Vec = [&Visit](FFlightVec3& V) { Visit(V.X); Visit(V.Y); Visit(V.Z); };
+
+		Vec(State.Position);
+		Vec(State.Velocity);
+		Visit(State.Rotation.X); Visit(State.Rotation.Y); Visit(State.Rotation.Z); Visit(State.Rotation.W);
+		Visit(State.ThrottleSmoothed);
+		Vec(State.AngularVelocity);
+		for (float& Thrust : State.MotorThrust)
+		{
+			Visit(Thrust);
+		}
+
+		FFlightPidState& Pid = State.Pid;
+		Vec(Pid.ITerm);
+		Vec(Pid.PrevGyro);
+		Vec(Pid.DTermLpf1);
+		Vec(Pid.DTermLpf2);
+		Vec(Pid.PrevSetpoint);
+		Vec(Pid.Feedforward);
+	}
+}
+
+std::vector<uint8_t> EncodeFlightInputLog(const FFlightInputLogData& Log)
+{
+	std::vector<uint8_t> Bytes;
+	Bytes.reserve(128 + Log.Samples.size() * InputLogSampleBytes + Log.Checksums.size() * 4);
+	FInputLogWriter Ar(Bytes);
+
+	Ar.Write(FlightInputLogMagic);
+	Ar.Write(FlightInputLogVersion);
+	Ar.Write(Log.StepSeconds);
+	Ar.Write(Log.FirstStep);
+
+	FFlightState State = Log.InitialState;
+	VisitInputLogState(State, [&Ar](float& V) { Ar.Write(V); });
+	Ar.Write((uint8_t)(State.Pid.bSaturated ? 1 : 0));
+
+	Ar.Write((int32_t)Log.Samples.size());
+	for (const FFlightInputLogSample& Sample : Log.Samples)
+	{
+		Ar.Write(Sample.Time);
+		for (float Stick : Sample.Sticks)
+		{
+			Ar.Write(Stick);
+		}
+		Ar.Write((uint8_t)(Sample.bArmed ? 1 : 0));
+	}
+
+	Ar.Write((int32_t)Log.Checksums.size());
+	for (uint32_t Checksum : Log.Checksums)
+	{
+		Ar.Write(Checksum);
+	}
+	return Bytes;
+}
+
+bool DecodeFlightInputLog(const uint8_t* Data, size_t Size, FFlightInputLogData& OutLog)
+{
+	FInputLogReader Ar(Data, Size);
+
+	uint32_t Magic = 0;
+	uint16_t Version = 0;
+	Ar.Read(Magic);
+	Ar.Read(Version);
+	if (Ar.bError || Magic != FlightInputLogMagic || Version == 0 || Version > FlightInputLogVersion)
+	{
+		return false;
+	}
+
+	FFlightInputLogData Log;
+	Ar.Read(Log.StepSeconds);
+	Ar.Read(Log.FirstStep);
+	VisitInputLogState(Log.InitialState, [&Ar](float& V) { Ar.Read(V); });
+	uint8_t bSaturated = 0;
+	Ar.Read(bSaturated);
+	Log.InitialState.Pid.bSaturated = bSaturated != 0;
+
+	int32_t NumSamples = 0;
+	Ar.Read(NumSamples);
+	if (Ar.bError || NumSamples < 0 || (size_t)NumSamples * InputLogSampleBytes > Ar.Remaining())
+	{
+		return false;
+	}
+	Log.Samples.resize((size_t)NumSamples);
+	for (FFlightInputLogSample& Sample : Log.Samples)
+	{
+		Ar.Read(Sample.Time);
+		for (float& Stick : Sample.Sticks)
+		{
+			Ar.Read(Stick);
+		}
+		uint8_t bArmed = 0;
+		Ar.Read(bArmed);
+		Sample.bArmed = bArmed != 0;
+	}
+
+	int32_t NumChecksums = 0;
+	Ar.Read(NumChecksums);
+	if (Ar.bError || NumChecksums < 0 || (size_t)NumChecksums * 4 > Ar.Remaining())
+	{
+		return false;
+	}
+	Log.Checksums.resize((size_t)NumChecksums);
+	for (uint32_t& Checksum : Log.Checksums)
+	{
+		Ar.Read(Checksum);
+	}
+
+	if (Ar.bError || !(Log.StepSeconds > 0.f))
+	{
+		return false;
+	}
+	OutLog = std::move(Log);
+	return true;
+}
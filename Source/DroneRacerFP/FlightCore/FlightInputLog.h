@@ -0,0 +1,38 @@
+// FlightInputLog.h
+//
+// Byte format of a deterministic input recording (.dinput): start state, stick samples stamped
+// on the simulation clock, and the state checksum after every step. Engine-free so headless
+// tools and tests can read and write the same files as the game.
+
+#pragma once
+
+#include "FlightModel.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct FFlightInputLogSample
+{
+	double Time = 0.0;              // s, step index * step length
+	float Sticks[4] = {};           // roll, pitch, yaw, throttle: + = stick up/right, throttle 0..1
+	bool bArmed = false;
+};
+
+struct FFlightInputLogData
+{
+	float StepSeconds = 0.f;
+	int64_t FirstStep = 0;
+	FFlightState InitialState;
+	std::vector<FFlightInputLogSample> Samples;
+	std::vector<uint32_t> Checksums;
+};
+
+constexpr uint32_t FlightInputLogMagic = 0x504E4944; // "DINP"
+constexpr uint16_t FlightInputLogVersion = 1;
+
+/** The whole file, header included. Little-endian. */
+std::vector<uint8_t> EncodeFlightInputLog(const FFlightInputLogData& Log);
+
+/** False on a wrong magic or version, truncated data or a non-positive step. */
+bool DecodeFlightInputLog(const uint8_t* Data, size_t Size, FFlightInputLogData& OutLog);
@@ -0,0 +1,82 @@
+// FlightIntegrator.h
+//
+// Translational integrators for the flight step, selectable at runtime. Header-only so the
+// acceleration callback inlines; the step and the drift benchmark share the exact same code.
+
+#pragma once
+
+#include "FlightMath.h"
+
+enum class EFlightIntegrator : unsigned char
+{
+	ExplicitEuler,      // position from the old velocity; gains energy, kept as the baseline
+	SemiImplicitEuler,  // velocity first, then position with the new velocity (symplectic, 1 eval)
+	Verlet,             // velocity Verlet, second order (2 evals)
+	RK4                 // classic Runge-Kutta, fourth order (4 evals)
+};
+
+inline const char* GetFlightIntegratorName(EFlightIntegrator Integrator)
+{
+	switch (Integrator)
+	{
+	case EFlightIntegrator::ExplicitEuler: return "ExplicitEuler";
+	case EFlightIntegrator::SemiImplicitEuler: return "SemiImplicitEuler";
+	case EFlightIntegrator::Verlet: return "Verlet";
+	case EFlightIntegrator::RK4: return "RK4";
+	}
+	return "?";
+}
+
+/**
+ * Advances Position and Velocity by Dt under Accel(Position, Velocity) -> cm/s^2.
+ * Velocity-dependent accelerations (drag) are handled by predicting the velocity
+ * for the later evaluations.
+ */
+template <typename AccelFn>
+void IntegrateFlightTranslation(EFlightIntegrator Integrator, FFlightVec3& Position, FFlightVec3& Velocity, float Dt, AccelFn&& Accel)
+{
+	const FFlightVec3 X0 = Position;
+	const FFlightVec3 V0 = Velocity;
+
+	switch (Integrator)
+	{
+	case EFlightIntegrator::ExplicitEuler:
+	{
+		const FFlightVec3 A0 = Accel(X0, V0);
+		Position = X0 + V0 * Dt;
+		Velocity = V0 + A0 * Dt;
+		break;
+	}
+	case EFlightIntegrator::Verlet:
+	{
+		const FFlightVec3 A0 = Accel(X0, V0);
+		Position = X0 + V0 * Dt + A0 * (0.5f * Dt * Dt);
+		const FFlightVec3 A1 = Accel(Position, V0 + A0 * Dt);
+		Velocity = V0 + (A0 + A1) * (0.5f * Dt);
+		break;
+	}
+	case EFlightIntegrator::RK4:
+	{
+		const float HalfDt = 0.5f * Dt;
+		const FFlightVec3 A1 = Accel(X0, V0);
+		const FFlightVec3 V1 = V0 + A1 * HalfDt;
+		const FFlightVec3 A2 = Accel(X0 + V0 * HalfDt, V1);
+		const FFlightVec3 V2 = V0 + A2 * HalfDt;
+		const FFlightVec3 A3 = Accel(X0 + V1 * HalfDt, V2);
+		const FFlightVec3 V3 = V0 + A3 * Dt;
+		const FFlightVec3 A4 = Accel(X0 + V2 * Dt, V3);
+
+		const float SixthDt = Dt / 6.f;
+		Position = X0 + (V0 + (V1 + V2) * 2.f + V3) * SixthDt;
+		Velocity = V0 + (A1 + (A2 + A3) * 2.f + A4) * SixthDt;
+		break;
+	}
+	case EFlightIntegrator::SemiImplicitEuler:
+	default:
+	{
+		Velocity = V0 + Accel(X0, V0) * Dt;
+		Position = X0 + Velocity * Dt;
+		break;
+	}
+	}
+}
@@ -0,0 +1,134 @@
+// FlightMath.h
+//
+// Minimal vector / quaternion types for the flight core. No engine headers, so the
+// flight model builds and runs outside Unreal. Same conventions as FVector / FQuat
+// (X forward, Y right, Z up, left-handed, quaternion as X,Y,Z,W), so converting at
+// the actor boundary is a plain member copy.
+
+#pragma once
+
+#include <cmath>
+
+constexpr float FlightPi = 3.14159265358979f;
+constexpr float FlightDegToRad = FlightPi / 180.f;
+
+struct FFlightVec3
+{
+	float X = 0.f;
+	float Y = 0.f;
+	float Z = 0.f;
+
+	FFlightVec3() = default;
+	constexpr FFlightVec3(float InX, float InY, float InZ) : X(InX), Y(InY), Z(InZ) {}
+
+	FFlightVec3 operator+(const FFlightVec3& V) const { return { X + V.X, Y + V.Y, Z + V.Z }; }
+	FFlightVec3 operator-(const FFlightVec3& V) const { return { X - V.X, Y - V.Y, Z - V.Z }; }
+	FFlightVec3 operator-() const { return { -X, -Y, -Z }; }
+	FFlightVec3 operator*(float S) const { return { X * S, Y * S, Z * S }; }
+	FFlightVec3 operator/(float S) const { const float Inv = 1.f / S; return { X * Inv, Y * Inv, Z * Inv }; }
+
+	// Component-wise, like FVector
+	FFlightVec3 operator*(const FFlightVec3& V) const { return { X * V.X, Y * V.Y, Z * V.Z }; }
+	FFlightVec3 operator/(const FFlightVec3& V) const { return { X / V.X, Y / V.Y, Z / V.Z }; }
+
+	FFlightVec3& operator+=(const FFlightVec3& V) { X += V.X; Y += V.Y; Z += V.Z; return *this; }
+	FFlightVec3& operator-=(const FFlightVec3& V) { X -= V.X; Y -= V.Y; Z -= V.Z; return *this; }
+	FFlightVec3& operator*=(float S) { X *= S; Y *= S; Z *= S; return *this; }
+
+	float SizeSquared() const { return X * X + Y * Y + Z * Z; }
+	float Size() const { return std::sqrt(SizeSquared()); }
+
+	static float Dot(const FFlightVec3& A, const FFlightVec3& B) { return A.X * B.X + A.Y * B.Y + A.Z * B.Z; }
+
+	static FFlightVec3 Cross(const FFlightVec3& A, const FFlightVec3& B)
+	{
+		return { A.Y * B.Z - A.Z * B.Y, A.Z * B.X - A.X * B.Z, A.X * B.Y - A.Y * B.X };
+	}
+};
+
+inline FFlightVec3 operator*(float S, const FFlightVec3& V) { return V * S; }
+
+struct FFlightQuat
+{
+	float X = 0.f;
+	float Y = 0.f;
+	float Z = 0.f;
+	float W = 1.f;
+
+	FFlightQuat() = default;
+	constexpr FFlightQuat(float InX, float InY, float InZ, float InW) : X(InX), Y(InY), Z(InZ), W(InW) {}
+
+	/** Hamilton product: applies B first, then this (like FQuat). */
+	FFlightQuat operator*(const FFlightQuat& B) const
+	{
+		return {
+			W * B.X + X * B.W + Y * B.Z - Z * B.Y,
+			W * B.Y - X * B.Z + Y * B.W + Z * B.X,
+			W * B.Z + X * B.Y - Y * B.X + Z * B.W,
+			W * B.W - X * B.X - Y * B.Y - Z * B.Z
+		};
+	}
+
+	FFlightQuat Inverse() const { return { -X, -Y, -Z, W }; } // unit quaternions only
+
+	FFlightQuat GetNormalized() const
+	{
+		const float SizeSq = X * X + Y * Y + Z * Z + W * W;
+		if (SizeSq <= 1e-12f)
+		{
+			return FFlightQuat();
+		}
+		const float Inv = 1.f / std::sqrt(SizeSq);
+		return { X * Inv, Y * Inv, Z * Inv, W * Inv };
+	}
+
+	/** Rotates a vector from local to world. */
+	FFlightVec3 RotateVector(const FFlightVec3& V) const
+	{
+		// v' = v + 2w(q x v) + 2(q x (q x v))
+		const FFlightVec3 Q(X, Y, Z);
+		const FFlightVec3 T = FFlightVec3::Cross(Q, V) * 2.f;
+		return V + T * W + FFlightVec3::Cross(Q, T);
+	}
+
+	/** Rotates a vector from world to local. */
+	FFlightVec3 UnrotateVector(const FFlightVec3& V) const { return Inverse().RotateVector(V); }
+
+	FFlightVec3 GetForwardVector() const { return RotateVector({ 1.f, 0.f, 0.f }); }
+	FFlightVec3 GetRightVector() const { return RotateVector({ 0.f, 1.f, 0.f }); }
+	FFlightVec3 GetUpVector() const { return RotateVector({ 0.f, 0.f, 1.f }); }
+
+	static FFlightQuat FromAxisAngle(const FFlightVec3& UnitAxis, float AngleRad)
+	{
+		const float S = std::sin(0.5f * AngleRad);
+		return { UnitAxis.X * S, UnitAxis.Y * S, UnitAxis.Z * S, std::cos(0.5f * AngleRad) };
+	}
+
+	/** Rotation by |V| radians about V (exponential map); exact for small angles too. */
+	static FFlightQuat FromRotationVector(const FFlightVec3& V)
+	{
+		const float AngleSq = V.SizeSquared();
+		if (AngleSq < 1e-12f)
+		{
+			return FFlightQuat(0.5f * V.X, 0.5f * V.Y, 0.5f * V.Z, 1.f).GetNormalized();
+		}
+		const float Angle = std::sqrt(AngleSq);
+		return FromAxisAngle(V / Angle, Angle);
+	}
+
+	/** Same result as FQuat(FRotator(Pitch, Yaw, Roll)): + pitch = nose up, + yaw = nose right, + roll = right wing down. */
+	static FFlightQuat FromRotatorDegrees(float PitchDeg, float YawDeg, float RollDeg)
+	{
+		constexpr float HalfDegToRad = 0.5f * FlightDegToRad;
+		const float SP = std::sin(PitchDeg * HalfDegToRad), CP = std::cos(PitchDeg * HalfDegToRad);
+		const float SY = std::sin(YawDeg * HalfDegToRad), CY = std::cos(YawDeg * HalfDegToRad);
+		const float SR = std::sin(RollDeg * HalfDegToRad), CR = std::cos(RollDeg * HalfDegToRad);
+
+		return {
+			CR * SP * SY - SR * CP * CY,
+			-CR * SP * CY - SR * CP * SY,
+			CR * CP * SY - SR * SP * CY,
+			CR * CP * CY + SR * SP * SY
+		};
+	}
+};
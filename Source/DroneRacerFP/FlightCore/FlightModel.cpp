@@ -0,0 +1,370 @@
+// FlightModel.cpp
+
+#include "FlightModel.h"
+
+#include <algorithm>
+
+namespace
+{
+	// FMath::FInterpTo without the engine: exponential-ish approach, never overshoots
+	float InterpTo(float Current, float Target, float Dt, float Speed)
+	{
+		if (Speed <= 0.f)
+		{
+			return Target;
+		}
+		const float Dist = Target - Current;
+		if (Dist * Dist < 1e-8f)
+		{
+			return Target;
+		}
+		return Current + Dist * std::clamp(Dt * Speed, 0.f, 1.f);
+	}
+
+	// X-frame motor layout: body X/Y position signs and prop spin direction (reaction torque sign)
+	constexpr float MotorX[4] = { 1.f, -1.f, -1.f, 1.f };
+	constexpr float MotorY[4] = { 1.f, 1.f, -1.f, -1.f };
+	constexpr float MotorSpin[4] = { 1.f, -1.f, 1.f, -1.f };
+
+	FFlightVec3 SafeInertia(const FFlightParams& Params)
+	{
+		return { std::max(Params.Inertia.X, 1e-3f), std::max(Params.Inertia.Y, 1e-3f), std::max(Params.Inertia.Z, 1e-3f) };
+	}
+
+	/** Acro rate setpoint (rad/s) in the state's axis convention (see FFlightState::AngularVelocity). */
+	FFlightVec3 ComputeAcroSetpoint(const FFlightParams& Params, const FFlightInput& Input)
+	{
+		float RollRate, PitchRate, YawRate;
+		if (Params.Rates)
+		{
+			RollRate = Params.Rates->Lookup(FlightAxis::Roll, Input.Roll);
+			PitchRate = Params.Rates->Lookup(FlightAxis::Pitch, Input.Pitch);
+			YawRate = Params.Rates->Lookup(FlightAxis::Yaw, Input.Yaw);
+		}
+		else
+		{
+			RollRate = Input.Roll * Params.RollRateDeg;
+			PitchRate = Input.Pitch * Params.PitchRateDeg;
+			YawRate = Input.Yaw * Params.YawRateDeg;
+		}
+		return { -RollRate * FlightDegToRad, -PitchRate * FlightDegToRad, YawRate * FlightDegToRad };
+	}
+
+	/**
+	 * Mixer: body torque request + collective thrust -> per-motor thrust commands.
+	 * Collective is shifted (airmode) so the requested torque survives low or full throttle.
+	 * Returns true if the torque had to be scaled down to fit the motors.
+	 */
+	bool MixMotorCommands(const FFlightParams& Params, const FFlightVec3& Torque, float CollectiveThrust, float (&OutCommand)[4])
+	{
+		// Inverse of the motor torque model below, for a symmetric X frame
+		const float ArmScale = 0.25f / std::max(Params.ArmLength, 1e-3f);
+		const float YawScale = 0.25f / std::max(Params.YawTorqueCoeff, 1e-3f);
+
+		float TorquePart[4];
+		float MinPart = 0.f, MaxPart = 0.f;
+		for (int i = 0; i < 4; ++i)
+		{
+			TorquePart[i] = (Torque.X * MotorY[i] - Torque.Y * MotorX[i]) * ArmScale + Torque.Z * MotorSpin[i] * YawScale;
+			MinPart = std::min(MinPart, TorquePart[i]);
+			MaxPart = std::max(MaxPart, TorquePart[i]);
+		}
+
+		const float MaxMotorThrust = 0.25f * Params.Mass * -Params.GravityZ * Params.MaxThrustG;
+
+		// More torque asked than the motors can give: keep the ratios, drop the magnitude
+		const float Range = MaxPart - MinPart;
+		float TorqueScale = 1.f;
+		if (Range > MaxMotorThrust)
+		{
+			TorqueScale = MaxMotorThrust / Range;
+			MinPart *= TorqueScale;
+			MaxPart *= TorqueScale;
+		}
+
+		const float Base = std::clamp(0.25f * CollectiveThrust, -MinPart, MaxMotorThrust - MaxPart);
+		for (int i = 0; i < 4; ++i)
+		{
+			OutCommand[i] = Base + TorquePart[i] * TorqueScale;
+		}
+		return TorqueScale < 1.f;
+	}
+
+	/** Motor lag, then the body torque and the total thrust the motors actually produce. */
+	float UpdateMotors(FFlightState& State, const FFlightParams& Params, const float (&Command)[4], float Dt, FFlightVec3& OutTorque)
+	{
+		const float UpK = Dt / (std::max(Params.MotorSpinUpTime, 0.f) + Dt);
+		const float DownK = Dt / (std::max(Params.MotorSpinDownTime, 0.f) + Dt);
+
+		float Total = 0.f;
+		OutTorque = FFlightVec3();
+		for (int i = 0; i < 4; ++i)
+		{
+			float& Thrust = State.MotorThrust[i];
+			Thrust += (Command[i] > Thrust ? UpK : DownK) * (Command[i] - Thrust);
+
+			// r x F with F along body +Z, plus prop drag about Z
+			OutTorque.X += MotorY[i] * Params.ArmLength * Thrust;
+			OutTorque.Y -= MotorX[i] * Params.ArmLength * Thrust;
+			OutTorque.Z += MotorSpin[i] * Params.YawTorqueCoeff * Thrust;
+			Total += Thrust;
+		}
+		return Total;
+	}
+
+	/** Euler's rigid-body equation in body frame, then the orientation update from the new rate. */
+	void IntegrateRotation(FFlightState& State, const FFlightParams& Params, const FFlightVec3& Torque, float Dt)
+	{
+		const FFlightVec3 Inertia = SafeInertia(Params);
+		const FFlightVec3& W = State.AngularVelocity;
+
+		// I * dw/dt = tau - w x (I w)
+		const FFlightVec3 AngularAccel = (Torque - FFlightVec3::Cross(W, Inertia * W)) / Inertia;
+		State.AngularVelocity += AngularAccel * Dt;
+
+		State.Rotation = (State.Rotation * FFlightQuat::FromRotationVector(State.AngularVelocity * Dt)).GetNormalized();
+	}
+
+	/**
+	 * Flight controller, motors and rigid-body rotation, stepped at the PID loop rate
+	 * (several iterations per flight step). Returns the mean total thrust over the step.
+	 */
+	float StepRotation(FFlightState& State, const FFlightParams& Params, const FFlightInput& Input, float Dt, FFlightVec3& OutTorque)
+	{
+		const float SafeMass = std::max(Params.Mass, 1e-4f);
+
+		// Collective from the throttle curve; disarmed, the applied throttle relaxes and the motors spin down
+		State.ThrottleSmoothed = InterpTo(State.ThrottleSmoothed, Input.bArmed ? Input.Throttle : 0.f, Dt, Params.ThrustResponse);
+		const float Collective = ComputeFlightUpAccel(State.ThrottleSmoothed, Params) * SafeMass;
+
+		const FFlightVec3 AcroSetpoint = ComputeAcroSetpoint(Params, Input);
+		const FFlightVec3 Inertia = SafeInertia(Params);
+
+		const int Iterations = std::max(1, (int)(Dt * Params.Pid.LoopRateHz + 0.5f));
+		const float PidDt = Dt / (float)Iterations;
+
+		float ThrustSum = 0.f;
+		FFlightVec3 TorqueSum;
+		for (int k = 0; k < Iterations; ++k)
+		{
+			float Command[4] = { 0.f, 0.f, 0.f, 0.f };
+			if (Input.bArmed)
+			{
+				const FFlightVec3 Setpoint = ApplyLevelMode(Params.Pid, State.Rotation, AcroSetpoint, Input.Roll, Input.Pitch);
+				const FFlightVec3 AngularAccel = UpdateFlightPid(State.Pid, Params.Pid, Setpoint, State.AngularVelocity, PidDt);
+				State.Pid.bSaturated = MixMotorCommands(Params, Inertia * AngularAccel, Collective, Command);
+			}
+			else
+			{
+				ResetFlightPid(State.Pid, State.AngularVelocity);
+			}
+
+			FFlightVec3 Torque;
+			ThrustSum += UpdateMotors(State, Params, Command, PidDt, Torque);
+			TorqueSum += Torque;
+			IntegrateRotation(State, Params, Torque, PidDt);
+		}
+
+		OutTorque = TorqueSum / (float)Iterations;
+		return ThrustSum / (float)Iterations;
+	}
+
+	/** Thrust + gravity, held constant over the step; drag is added per evaluation by the integrator. */
+	FFlightVec3 ComputeForceAcceleration(FFlightState& State, const FFlightParams& Params, const FFlightInput& Input, float Dt, FFlightStepResult& OutResult)
+	{
+		const float SafeMass = std::max(Params.Mass, 1e-4f);
+
+		OutResult.UpAccel = StepRotation(State, Params, Input, Dt, OutResult.Torque) / SafeMass;
+
+		const FFlightVec3 ThrustAccel = State.Rotation.GetUpVector() * OutResult.UpAccel;
+		const FFlightVec3 GravityAccel(0.f, 0.f, Params.GravityZ);
+
+		return ThrustAccel + GravityAccel;
+	}
+
+	/**
+	 * Bounce (above BounceMinSpeed) and Coulomb friction against the hit surface.
+	 * Returns the into-surface speed before the response, 0 if moving away.
+	 */
+	float ApplyContactResponse(FFlightVec3& Velocity, const FFlightParams& Params, const FFlightContact& Contact)
+	{
+		const FFlightVec3& Normal = Contact.SurfaceNormal;
+		const float Vn = FFlightVec3::Dot(Velocity, Normal);
+		if (Vn >= 0.f)
+		{
+			return 0.f;
+		}
+
+		const float ImpactSpeed = -Vn;
+		const float Restitution = ImpactSpeed > Params.BounceMinSpeed ? std::clamp(Contact.Restitution, 0.f, 1.f) : 0.f;
+
+		// Friction takes away tangential speed in proportion to the normal impulse
+		const FFlightVec3 Tangent = Velocity - Normal * Vn;
+		const float TangentSpeed = Tangent.Size();
+		const float FrictionLoss = std::max(Contact.Friction, 0.f) * (1.f + Restitution) * ImpactSpeed;
+		const float Keep = TangentSpeed > FrictionLoss ? (TangentSpeed - FrictionLoss) / TangentSpeed : 0.f;
+
+		Velocity = Tangent * Keep + Normal * (ImpactSpeed * Restitution);
+		return ImpactSpeed;
+	}
+
+	/**
+	 * Sweep and slide: moves the body by Delta, and on each hit resolves the velocity and
+	 * continues with what's left of this step's time along the new velocity, up to
+	 * MaxSlideIterations sweeps. Every query covers at most the rest of this one substep.
+	 */
+	bool MoveWithCollision(FFlightState& State, const FFlightParams& Params, const FFlightVec3& Delta, float Dt, IFlightCollision* Collision, FFlightStepResult& OutResult)
+	{
+		if (!Collision)
+		{
+			State.Position += Delta;
+			return false;
+		}
+
+		FFlightVec3 Remaining = Delta;
+		float RemainingTime = Dt;
+		bool bContact = false;
+
+		const int MaxIterations = std::max(Params.MaxSlideIterations, 1);
+		for (int Iteration = 0; Iteration < MaxIterations; ++Iteration)
+		{
+			FFlightContact Contact;
+			++OutResult.NumSweeps;
+			if (!Collision->Sweep(State.Position, Remaining, State.Rotation, Contact))
+			{
+				State.Position += Remaining;
+				break;
+			}
+
+			float TimeUsed = Contact.Time;
+			if (Contact.bStartPenetrating)
+			{
+				// Started inside something: push out along the depenetration normal, no time spent
+				State.Position += Contact.Normal * (Contact.PenetrationDepth + Params.ContactOffset);
+				TimeUsed = 0.f;
+			}
+			else
+			{
+				// Stop just short of the surface so the next sweep doesn't start penetrating
+				State.Position = Contact.Location + Contact.Normal * Params.ContactOffset;
+			}
+
+			const float ImpactSpeed = ApplyContactResponse(State.Velocity, Params, Contact);
+			Collision->OnContactResolved(Contact, ImpactSpeed);
+
+			if (!bContact || ImpactSpeed > OutResult.ImpactSpeed)
+			{
+				OutResult.Contact = Contact;
+				OutResult.ImpactSpeed = ImpactSpeed;
+			}
+			OutResult.bOnGround |= Contact.SurfaceNormal.Z > Params.WalkableNormalZ;
+			bContact = true;
+
+			RemainingTime *= 1.f - std::clamp(TimeUsed, 0.f, 1.f);
+			Remaining = State.Velocity * RemainingTime;
+			if (Remaining.SizeSquared() < 1e-6f)
+			{
+				break;
+			}
+		}
+		return bContact;
+	}
+}
+
+float ComputeFlightUpAccel(float ThrottleSmoothed, const FFlightParams& Params)
+{
+	// Map throttle around hover into t in [-1, +1]
+	const float t = (ThrottleSmoothed >= Params.HoverThrottle)
+		? (ThrottleSmoothed - Params.HoverThrottle) / std::max(1e-3f, 1.f - Params.HoverThrottle)
+		: (ThrottleSmoothed - Params.HoverThrottle) / std::max(1e-3f, Params.HoverThrottle);
+
+	// Expo shaping around hover
+	const float Shaped = (t >= 0.f ? 1.f : -1.f) * std::pow(std::fabs(t), Params.ThrustExpo);
+
+	// Hover at shaped == 0, MaxThrustG at +1, no thrust at -1
+	const float HoverAccel = -Params.GravityZ;
+	if (Shaped >= 0.f)
+	{
+		return HoverAccel + (HoverAccel * Params.MaxThrustG - HoverAccel) * Shaped;
+	}
+	return HoverAccel * (Shaped + 1.f);
+}
+
+void StepFlightModel(FFlightState& State, const FFlightParams& Params, const FFlightInput& Input, float Dt,
+	IFlightCollision* Collision, FFlightStepResult* OutResult)
+{
+	// 1-3) Controller, motors and rigid-body rotation at the PID rate, then thrust + gravity
+	FFlightStepResult Result;
+	const FFlightVec3 ForceAccel = ComputeForceAcceleration(State, Params, Input, Dt, Result);
+	const float InvMass = 1.f / std::max(Params.Mass, 1e-4f);
+	const float DragRate = Params.DragCoeff * InvMass;
+	const FFlightVec3 QuadraticDrag = Params.DragArea * (0.5f * Params.AirDensity * InvMass);
+	const bool bQuadraticDrag = QuadraticDrag.SizeSquared() > 0.f;
+
+	// Wind and attitude don't change noticeably within a step: sampled once, shared by all evaluations
+	const FFlightVec3 Wind = Params.Wind ? Params.Wind->Sample(State.Position) : FFlightVec3();
+	const FFlightQuat Rotation = State.Rotation;
+
+	// 4) Integrate with drag (Params.Integrator), then sweep and slide the move
+	FFlightVec3 Target = State.Position;
+	IntegrateFlightTranslation(Params.Integrator, Target, State.Velocity, Dt,
+		[&](const FFlightVec3& /*Position*/, const FFlightVec3& Velocity)
+		{
+			const FFlightVec3 Airspeed = Velocity - Wind;
+			FFlightVec3 Accel = ForceAccel - Airspeed * DragRate;
+			if (bQuadraticDrag)
+			{
+				// Each body axis with its own area: fast forward flight is cheap, falling flat is not
+				const FFlightVec3 Body = Rotation.UnrotateVector(Airspeed);
+				Accel -= Rotation.RotateVector(QuadraticDrag * Body * FFlightVec3(std::fabs(Body.X), std::fabs(Body.Y), std::fabs(Body.Z)));
+			}
+			return Accel;
+		});
+
+	Result.bContact = MoveWithCollision(State, Params, Target - State.Position, Dt, Collision, Result);
+
+	// Ground-ish: damp lateral velocity only, so you can still lift off
+	if (Result.bOnGround)
+	{
+		const float Keep = 1.f - std::clamp(Dt * Params.GroundFriction, 0.f, 1.f);
+		State.Velocity.X *= Keep;
+		State.Velocity.Y *= Keep;
+	}
+
+	if (OutResult)
+	{
+		*OutResult = Result;
+	}
+}
+
+bool FFlightGroundPlane::Sweep(const FFlightVec3& Start, const FFlightVec3& Delta, const FFlightQuat& /*Rotation*/, FFlightContact& OutContact)
+{
+	const float StartClearance = Start.Z - Radius - GroundZ;
+	if (StartClearance < 0.f)
+	{
+		OutContact.Location = Start;
+		OutContact.Normal = OutContact.SurfaceNormal = FFlightVec3(0.f, 0.f, 1.f);
+		OutContact.PenetrationDepth = -StartClearance;
+		OutContact.Time = 0.f;
+		OutContact.bStartPenetrating = true;
+		OutContact.Restitution = Restitution;
+		OutContact.Friction = Friction;
+		return true;
+	}
+
+	const float EndClearance = StartClearance + Delta.Z;
+	if (EndClearance >= 0.f)
+	{
+		return false;
+	}
+
+	const float Time = StartClearance / (StartClearance - EndClearance);
+	OutContact.Location = Start + Delta * Time;
+	OutContact.Normal = OutContact.SurfaceNormal = FFlightVec3(0.f, 0.f, 1.f);
+	OutContact.PenetrationDepth = 0.f;
+	OutContact.Time = Time;
+	OutContact.bStartPenetrating = false;
+	OutContact.Restitution = Restitution;
+	OutContact.Friction = Friction;
+	return true;
+}
@@ -0,0 +1,152 @@
+// FlightModel.h
+//
+// Engine-independent flight model: a plain state struct and a step function.
+// Units match Unreal (cm, s, kg, degrees for rates). ADroneFPCharacter wraps this;
+// anything here must build without Unreal headers so it can be driven headless.
+
+#pragma once
+
+#include "FlightController.h"
+#include "FlightIntegrator.h"
+#include "FlightMath.h"
+#include "FlightRates.h"
+#include "FlightWind.h"
+
+// Tunables. The actor copies its UPROPERTYs in here every frame.
+struct FFlightParams
+{
+	float Mass = 0.7f;              // kg
+	float GravityZ = -980.f;        // cm/s^2
+
+	// Thrust around hover: throttle -> [-1..1] around HoverThrottle -> expo -> 0..MaxThrustG
+	float MaxThrustG = 2.f;
+	float HoverThrottle = 0.5f;
+	float ThrustExpo = 0.7f;
+	float ThrustResponse = 1.f;     // 1/s, how fast applied throttle follows the stick
+
+	float DragCoeff = 1.f;          // linear, force per (cm/s) of airspeed
+
+	// Quadratic drag, 0.5 * rho * CdA * v^2 per body axis on the airspeed in body space
+	FFlightVec3 DragArea;           // Cd*A, cm^2: frontal (body X), side (body Y), top (body Z)
+	float AirDensity = 1.225e-6f;   // kg/cm^3 (sea level)
+
+	// Baked wind; airspeed is velocity minus the wind here. Null = still air.
+	const FFlightWindField* Wind = nullptr;
+
+	// Translation integrator; rotation always runs semi-implicit at the PID rate
+	EFlightIntegrator Integrator = EFlightIntegrator::SemiImplicitEuler;
+
+	// Stick -> body rate setpoint. Without a table the sticks map linearly to these full-stick rates.
+	const FFlightRateTable* Rates = nullptr;
+	float PitchRateDeg = 360.f;
+	float RollRateDeg = 360.f;
+	float YawRateDeg = 180.f;
+
+	// Rigid body: X-frame quad, motors at (+-ArmLength, +-ArmLength) in body space
+	FFlightVec3 Inertia = { 25.f, 25.f, 45.f }; // kg*cm^2, diagonal of the body inertia tensor (roll, pitch, yaw axes)
+	float ArmLength = 8.f;          // cm, motor offset along body X and along body Y
+	float YawTorqueCoeff = 1.5f;    // cm, prop drag torque per unit of motor thrust
+	float MotorSpinUpTime = 0.02f;  // s, first-order lag from motor command to thrust
+	float MotorSpinDownTime = 0.035f;
+
+	// Flight controller; rotation, motors and the PID run at Pid.LoopRateHz inside each step
+	FFlightPidParams Pid;
+
+	// Contact
+	float WalkableNormalZ = 0.6f;   // surfaces steeper than this don't get ground friction
+	float GroundFriction = 3.f;     // 1/s, lateral damping while touching walkable ground
+	float ContactOffset = 0.1f;     // cm kept between the body and what it hit
+	int MaxSlideIterations = 4;     // sweeps per step; motion left after the last one is dropped
+	float BounceMinSpeed = 150.f;   // cm/s into the surface; slower impacts don't bounce, so resting contact stays still
+};
+
+// Pilot commands for one step.
+struct FFlightInput
+{
+	// Filtered sticks, -1..1; Params.Rates turns them into rates. + pitch = nose up, + yaw = nose right, + roll = right wing down.
+	float Pitch = 0.f;
+	float Roll = 0.f;
+	float Yaw = 0.f;
+
+	float Throttle = 0.f;           // 0..1
+	bool bArmed = false;
+};
+
+// Everything that evolves over time.
+struct FFlightState
+{
+	FFlightVec3 Position;           // cm, world
+	FFlightVec3 Velocity;           // cm/s, world
+	FFlightQuat Rotation;           // body -> world
+	float ThrottleSmoothed = 0.f;   // applied throttle 0..1
+
+	// Body-frame angular velocity, rad/s, in FQuat's axis convention:
+	// +X = rolling left, +Y = pitching down, +Z = yawing right
+	FFlightVec3 AngularVelocity;
+
+	// Per-motor thrust after spin-up lag, kg*cm/s^2. Order: front-right, rear-right, rear-left, front-left.
+	float MotorThrust[4] = { 0.f, 0.f, 0.f, 0.f };
+
+	FFlightPidState Pid;
+};
+
+// A blocking hit reported by the collision callback.
+struct FFlightContact
+{
+	FFlightVec3 Location;           // where the body stopped along the sweep
+	FFlightVec3 Normal;             // depenetration / back-off direction
+	FFlightVec3 SurfaceNormal;      // normal of the surface that was hit
+	float PenetrationDepth = 0.f;
+	float Time = 0.f;               // fraction of the sweep travelled before the hit
+	bool bStartPenetrating = false;
+
+	// Surface material: restitution 0..1 and Coulomb friction against the impact impulse
+	float Restitution = 0.f;
+	float Friction = 0.f;
+};
+
+// World queries, provided by whoever runs the model (the actor, a test, a benchmark).
+class IFlightCollision
+{
+public:
+	virtual ~IFlightCollision() = default;
+
+	/** Sweeps the body from Start by Delta. Returns true and fills OutContact on a blocking hit. */
+	virtual bool Sweep(const FFlightVec3& Start, const FFlightVec3& Delta, const FFlightQuat& Rotation, FFlightContact& OutContact) = 0;
+
+	/** Called after the hit from the latest Sweep was resolved, with the into-surface speed it had (cm/s). */
+	virtual void OnContactResolved(const FFlightContact& /*Contact*/, float /*ImpactSpeed*/) {}
+};
+
+// Infinite horizontal ground at GroundZ, body treated as a sphere. For headless runs.
+class FFlightGroundPlane : public IFlightCollision
+{
+public:
+	explicit FFlightGroundPlane(float InGroundZ = 0.f, float InRadius = 7.f) : GroundZ(InGroundZ), Radius(InRadius) {}
+
+	virtual bool Sweep(const FFlightVec3& Start, const FFlightVec3& Delta, const FFlightQuat& Rotation, FFlightContact& OutContact) override;
+
+	float GroundZ;
+	float Radius;
+	float Restitution = 0.f;
+	float Friction = 0.f;
+};
+
+// Per-step outputs the caller may want (damage, debug display).
+struct FFlightStepResult
+{
+	bool bContact = false;
+	bool bOnGround = false;         // touched a walkable surface
+	FFlightContact Contact;         // the hardest hit this step
+	float ImpactSpeed = 0.f;        // cm/s into the surface at that hit, before the response
+	int NumSweeps = 0;              // collision queries this step
+	float UpAccel = 0.f;            // cm/s^2 of thrust along body up
+	FFlightVec3 Torque;             // kg*cm^2/s^2, body frame, from the motors this step
+};
+
+/** Advances State by Dt seconds. Collision may be null for free flight. */
+void StepFlightModel(FFlightState& State, const FFlightParams& Params, const FFlightInput& Input, float Dt,
+	IFlightCollision* Collision, FFlightStepResult* OutResult = nullptr);
+
+/** Collective thrust along body up for the applied throttle (cm/s^2), hover at HoverThrottle. */
+float ComputeFlightUpAccel(float ThrottleSmoothed, const FFlightParams& Params);
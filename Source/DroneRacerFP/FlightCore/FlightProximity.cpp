@@ -0,0 +1,186 @@
+// FlightProximity.cpp
+
+#include "FlightProximity.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	constexpr float ProximityInfinity = 1e20f;
+
+	// Keeps the field from being trusted down to the last millimetre
+	constexpr float ProximitySafetyMargin = 2.f;
+
+	/**
+	 * 1D squared distance transform (Felzenszwalb & Huttenlocher) over F, in place.
+	 * V, Z and D are scratch buffers of at least N, N + 1 and N entries.
+	 */
+	void DistanceTransform1D(float* F, int N, int Stride, int* V, float* Z, float* D)
+	{
+		auto Intersect = [F, Stride](int Q, int P)
+		{
+			return ((F[(int64_t)Q * Stride] + (float)Q * Q) - (F[(int64_t)P * Stride] + (float)P * P)) / (2.f * (Q - P));
+		};
+
+		int K = 0;
+		V[0] = 0;
+		Z[0] = -ProximityInfinity;
+		Z[1] = ProximityInfinity;
+
+		// Lower envelope of the parabolas rooted at each sample
+		for (int Q = 1; Q < N; ++Q)
+		{
+			float S = Intersect(Q, V[K]);
+			while (S <= Z[K])
+			{
+				--K;
+				S = Intersect(Q, V[K]);
+			}
+			++K;
+			V[K] = Q;
+			Z[K] = S;
+			Z[K + 1] = ProximityInfinity;
+		}
+
+		K = 0;
+		for (int Q = 0; Q < N; ++Q)
+		{
+			while (Z[K + 1] < (float)Q)
+			{
+				++K;
+			}
+			const int P = V[K];
+			D[Q] = (float)((Q - P) * (Q - P)) + F[(int64_t)P * Stride];
+		}
+		for (int Q = 0; Q < N; ++Q)
+		{
+			F[(int64_t)Q * Stride] = D[Q];
+		}
+	}
+}
+
+void FFlightProximityField::Init(const FFlightVec3& InMin, float InCellSize, int NumX, int NumY, int NumZ)
+{
+	Min = InMin;
+	CellSize = std::max(InCellSize, 1.f);
+	Num[0] = std::max(NumX, 1);
+	Num[1] = std::max(NumY, 1);
+	Num[2] = std::max(NumZ, 1);
+	NumBlocked = 0;
+	bBuilt = false;
+
+	Blocked.assign((size_t)GetNumCells(), 0);
+	Clearance.clear();
+}
+
+void FFlightProximityField::SetBlocked(int X, int Y, int Z)
+{
+	if (X < 0 || Y < 0 || Z < 0 || X >= Num[0] || Y >= Num[1] || Z >= Num[2])
+	{
+		return;
+	}
+	uint8_t& Cell = Blocked[(size_t)Index(X, Y, Z)];
+	NumBlocked += Cell ? 0 : 1;
+	Cell = 1;
+}
+
+void FFlightProximityField::Build()
+{
+	const int64_t NumCells = GetNumCells();
+
+	// Squared distance, in cells, to the nearest blocked cell center
+	std::vector<float> DistSq((size_t)NumCells);
+	for (int64_t i = 0; i < NumCells; ++i)
+	{
+		DistSq[(size_t)i] = Blocked[(size_t)i] ? 0.f : ProximityInfinity;
+	}
+
+	const int MaxN = std::max(Num[0], std::max(Num[1], Num[2]));
+	std::vector<int> V(MaxN);
+	std::vector<float> Z(MaxN + 1);
+	std::vector<float> D(MaxN);
+
+	// Separable: X rows, then Y columns, then Z columns
+	for (int Zi = 0; Zi < Num[2]; ++Zi)
+	{
+		for (int Yi = 0; Yi < Num[1]; ++Yi)
+		{
+			DistanceTransform1D(&DistSq[(size_t)Index(0, Yi, Zi)], Num[0], 1, V.data(), Z.data(), D.data());
+		}
+	}
+	for (int Zi = 0; Zi < Num[2]; ++Zi)
+	{
+		for (int Xi = 0; Xi < Num[0]; ++Xi)
+		{
+			DistanceTransform1D(&DistSq[(size_t)Index(Xi, 0, Zi)], Num[1], Num[0], V.data(), Z.data(), D.data());
+		}
+	}
+	for (int Yi = 0; Yi < Num[1]; ++Yi)
+	{
+		for (int Xi = 0; Xi < Num[0]; ++Xi)
+		{
+			DistanceTransform1D(&DistSq[(size_t)Index(Xi, Yi, 0)], Num[2], Num[0] * Num[1], V.data(), Z.data(), D.data());
+		}
+	}
+
+	// Geometry can be anywhere in a blocked cell: up to half a cell diagonal from its center
+	const float HalfDiagonal = 0.5f * std::sqrt(3.f) * CellSize;
+
+	Clearance.resize((size_t)NumCells);
+	for (int64_t i = 0; i < NumCells; ++i)
+	{
+		const float Dist = DistSq[(size_t)i] >= 0.5f * ProximityInfinity ? ProximityInfinity : std::sqrt(DistSq[(size_t)i]) * CellSize;
+		Clearance[(size_t)i] = Blocked[(size_t)i] ? 0.f : std::max(Dist - HalfDiagonal, 0.f);
+	}
+
+	// Only the clearances are needed from here on
+	std::vector<uint8_t>().swap(Blocked);
+	bBuilt = true;
+}
+
+float FFlightProximityField::GetClearance(const FFlightVec3& Position) const
+{
+	if (!bBuilt)
+	{
+		return 0.f;
+	}
+
+	const FFlightVec3 Local = (Position - Min) / CellSize;
+	const float LocalAxes[3] = { Local.X, Local.Y, Local.Z };
+
+	int Cell[3];
+	float EdgeDistance = ProximityInfinity;
+	for (int Axis = 0; Axis < 3; ++Axis)
+	{
+		if (LocalAxes[Axis] < 0.f || LocalAxes[Axis] >= (float)Num[Axis])
+		{
+			return 0.f;
+		}
+		Cell[Axis] = std::min((int)LocalAxes[Axis], Num[Axis] - 1);
+		EdgeDistance = std::min(EdgeDistance, std::min(LocalAxes[Axis], (float)Num[Axis] - LocalAxes[Axis]) * CellSize);
+	}
+
+	// The stored value is for the cell center; the position can be up to that far from it
+	const float FromCenter = (Position - GetCellCenter(Cell[0], Cell[1], Cell[2])).Size();
+	const float CellClearance = Clearance[(size_t)Index(Cell[0], Cell[1], Cell[2])] - FromCenter;
+
+	return std::max(std::min(CellClearance, EdgeDistance), 0.f);
+}
+
+FFlightVec3 FFlightProximityField::GetCellCenter(int X, int Y, int Z) const
+{
+	return Min + FFlightVec3(X + 0.5f, Y + 0.5f, Z + 0.5f) * CellSize;
+}
+
+float ComputeFreeSweepFraction(const FFlightProximityField& Field, const FFlightVec3& Start, const FFlightVec3& Delta, float BodyRadius)
+{
+	const float Free = Field.GetClearance(Start) - BodyRadius - ProximitySafetyMargin;
+	if (Free <= 0.f)
+	{
+		return 0.f;
+	}
+
+	const float Length = Delta.Size();
+	return Length <= Free ? 1.f : Free / Length;
+}
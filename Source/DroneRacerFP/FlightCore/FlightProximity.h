@@ -0,0 +1,58 @@
+// FlightProximity.h
+//
+// Coarse clearance field over the course: for any point, a distance that is guaranteed to be
+// free of collision geometry. Built once at load time from blocked/free cells; lets the flight
+// step skip or shorten sweeps that can't hit anything. Engine-free like the rest of FlightCore.
+
+#pragma once
+
+#include "FlightMath.h"
+
+#include <cstdint>
+#include <vector>
+
+class FFlightProximityField
+{
+public:
+	/** Grid of NumX*NumY*NumZ cubes of CellSize cm from Min. All cells start free; Build() must follow. */
+	void Init(const FFlightVec3& InMin, float InCellSize, int NumX, int NumY, int NumZ);
+
+	/** Marks a cell as (possibly) containing geometry. */
+	void SetBlocked(int X, int Y, int Z);
+
+	/** Euclidean distance transform of the blocked cells into a clearance per cell center. */
+	void Build();
+
+	bool IsBuilt() const { return bBuilt; }
+
+	/**
+	 * Lower bound on the distance from Position to any geometry (cm). Also bounded by the
+	 * distance to the edge of the grid, since nothing outside it was sampled; 0 outside.
+	 */
+	float GetClearance(const FFlightVec3& Position) const;
+
+	FFlightVec3 GetCellCenter(int X, int Y, int Z) const;
+	float GetCellSize() const { return CellSize; }
+	int GetNum(int Axis) const { return Num[Axis]; }
+	int64_t GetNumCells() const { return (int64_t)Num[0] * Num[1] * Num[2]; }
+	int64_t GetNumBlocked() const { return NumBlocked; }
+
+private:
+	int64_t Index(int X, int Y, int Z) const { return ((int64_t)Z * Num[1] + Y) * Num[0] + X; }
+
+	FFlightVec3 Min;
+	float CellSize = 100.f;
+	int Num[3] = { 0, 0, 0 };
+	int64_t NumBlocked = 0;
+	bool bBuilt = false;
+
+	std::vector<uint8_t> Blocked;
+	std::vector<float> Clearance;   // cm from the cell center, >= 0
+};
+
+/**
+ * Part of a sweep from Start by Delta that the field proves collision-free for a body that
+ * fits in a sphere of BodyRadius: 1 = the whole sweep can be skipped, 0 = sweep all of it.
+ * A sweep started at Start + Delta * Fraction gives the same first hit as the full sweep.
+ */
+float ComputeFreeSweepFraction(const FFlightProximityField& Field, const FFlightVec3& Start, const FFlightVec3& Delta, float BodyRadius);
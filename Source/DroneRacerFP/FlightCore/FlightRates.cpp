@@ -0,0 +1,253 @@
+// FlightRates.cpp
+
+#include "FlightRates.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <sstream>
+
+namespace
+{
+	// Betaflight's RC_RATE_INCREMENTAL: rc rates above 2.0 grow faster
+	constexpr float RcRateIncremental = 14.54f;
+
+	float ApplyBetaflightRates(const FFlightAxisRates& R, float X, float AbsX)
+	{
+		if (R.Expo > 0.f)
+		{
+			X = X * AbsX * AbsX * AbsX * R.Expo + X * (1.f - R.Expo);
+		}
+
+		float RcRate = R.RcRate;
+		if (RcRate > 2.f)
+		{
+			RcRate += RcRateIncremental * (RcRate - 2.f);
+		}
+
+		float Rate = 200.f * RcRate * X;
+		if (R.SuperRate > 0.f)
+		{
+			Rate *= 1.f / std::clamp(1.f - AbsX * R.SuperRate, 0.01f, 1.f);
+		}
+		return Rate;
+	}
+
+	float ApplyActualRates(const FFlightAxisRates& R, float X, float AbsX)
+	{
+		const float X5 = X * X * X * X * X;
+		const float Expof = AbsX * (X5 * R.Expo + X * (1.f - R.Expo));
+
+		const float Center = R.RcRate;
+		const float StickMovement = std::max(0.f, R.SuperRate - Center);
+		return X * Center + StickMovement * Expof;
+	}
+
+	float ApplyQuickRates(const FFlightAxisRates& R, float X, float AbsX)
+	{
+		const float RcRate = std::max(R.RcRate * 200.f, 1.f);
+		const float MaxRate = std::max(R.SuperRate, RcRate);
+		const float SuperFactorConfig = (MaxRate / RcRate - 1.f) / (MaxRate / RcRate);
+
+		// quickrates_rc_expo = OFF: expo shapes the super factor, not the stick
+		const float Curve = AbsX * AbsX * AbsX * R.Expo + AbsX * (1.f - R.Expo);
+		const float SuperFactor = 1.f / std::clamp(1.f - Curve * SuperFactorConfig, 0.01f, 1.f);
+		return X * RcRate * SuperFactor;
+	}
+
+	// ---- CLI parsing ----
+
+	// Raw CLI integers for one rate profile; -1 = not present
+	struct FRawRateProfile
+	{
+		int Type = -1;
+		int RcRate[FlightAxis::Num] = { -1, -1, -1 };
+		int SuperRate[FlightAxis::Num] = { -1, -1, -1 };
+		int Expo[FlightAxis::Num] = { -1, -1, -1 };
+		int RateLimit[FlightAxis::Num] = { -1, -1, -1 };
+		bool bAny = false;
+	};
+
+	std::string ToLower(std::string S)
+	{
+		std::transform(S.begin(), S.end(), S.begin(), [](unsigned char C) { return (char)std::tolower(C); });
+		return S;
+	}
+
+	std::string Trim(const std::string& S)
+	{
+		const size_t Begin = S.find_first_not_of(" \t\r");
+		if (Begin == std::string::npos)
+		{
+			return std::string();
+		}
+		const size_t End = S.find_last_not_of(" \t\r");
+		return S.substr(Begin, End - Begin + 1);
+	}
+
+	/** Applies one "name = value" setting; false if it isn't a rate setting. */
+	bool ApplyRawSetting(FRawRateProfile& P, const std::string& Name, const std::string& Value)
+	{
+		static const char* AxisPrefix[FlightAxis::Num] = { "roll_", "pitch_", "yaw_" };
+
+		if (Name == "rates_type")
+		{
+			const std::string V = ToLower(Value);
+			P.Type = V == "betaflight" ? 0 : V == "actual" ? 1 : V == "quick" ? 2 : 99;
+			return true;
+		}
+
+		const int IntValue = std::atoi(Value.c_str());
+
+		for (int Axis = 0; Axis < FlightAxis::Num; ++Axis)
+		{
+			const std::string Prefix = AxisPrefix[Axis];
+			if (Name == Prefix + "rc_rate") { P.RcRate[Axis] = IntValue; return true; }
+			if (Name == Prefix + "srate") { P.SuperRate[Axis] = IntValue; return true; }
+			if (Name == Prefix + "expo") { P.Expo[Axis] = IntValue; return true; }
+			if (Name == Prefix + "rate_limit") { P.RateLimit[Axis] = IntValue; return true; }
+		}
+
+		// Pre-4.0 names
+		if (Name == "rc_rate") { P.RcRate[FlightAxis::Roll] = P.RcRate[FlightAxis::Pitch] = IntValue; return true; }
+		if (Name == "rc_rate_yaw") { P.RcRate[FlightAxis::Yaw] = IntValue; return true; }
+		if (Name == "rc_expo") { P.Expo[FlightAxis::Roll] = P.Expo[FlightAxis::Pitch] = IntValue; return true; }
+		if (Name == "rc_expo_yaw" || Name == "rc_yaw_expo") { P.Expo[FlightAxis::Yaw] = IntValue; return true; }
+
+		return false;
+	}
+
+	void Merge(FRawRateProfile& Into, const FRawRateProfile& From)
+	{
+		if (From.Type >= 0) Into.Type = From.Type;
+		for (int Axis = 0; Axis < FlightAxis::Num; ++Axis)
+		{
+			if (From.RcRate[Axis] >= 0) Into.RcRate[Axis] = From.RcRate[Axis];
+			if (From.SuperRate[Axis] >= 0) Into.SuperRate[Axis] = From.SuperRate[Axis];
+			if (From.Expo[Axis] >= 0) Into.Expo[Axis] = From.Expo[Axis];
+			if (From.RateLimit[Axis] >= 0) Into.RateLimit[Axis] = From.RateLimit[Axis];
+		}
+		Into.bAny |= From.bAny;
+	}
+}
+
+float EvaluateFlightRate(const FFlightAxisRates& Rates, float Stick)
+{
+	const float X = std::clamp(Stick, -1.f, 1.f);
+	const float AbsX = std::fabs(X);
+
+	float Rate = 0.f;
+	switch (Rates.Type)
+	{
+	case EFlightRatesType::Actual:
+		Rate = ApplyActualRates(Rates, X, AbsX);
+		break;
+	case EFlightRatesType::Quick:
+		Rate = ApplyQuickRates(Rates, X, AbsX);
+		break;
+	case EFlightRatesType::Betaflight:
+	default:
+		Rate = ApplyBetaflightRates(Rates, X, AbsX);
+		break;
+	}
+
+	const float Limit = std::max(Rates.RateLimit, 0.f);
+	return std::clamp(Rate, -Limit, Limit);
+}
+
+void FFlightRateTable::Build(const FFlightAxisRates (&Axes)[FlightAxis::Num])
+{
+	for (int Axis = 0; Axis < FlightAxis::Num; ++Axis)
+	{
+		Source[Axis] = Axes[Axis];
+		for (int i = 0; i <= NumSegments; ++i)
+		{
+			Table[Axis][i] = EvaluateFlightRate(Axes[Axis], (float)i / NumSegments);
+		}
+	}
+}
+
+bool ParseBetaflightRates(const std::string& CliText, FFlightAxisRates (&InOutAxes)[FlightAxis::Num], std::string& OutError)
+{
+	// -1 collects settings that appear before any "rateprofile" line
+	std::map<int, FRawRateProfile> Profiles;
+	int CurrentProfile = -1;
+	int SelectedProfile = -1;
+
+	std::istringstream Stream(CliText);
+	std::string Line;
+	while (std::getline(Stream, Line))
+	{
+		Line = Trim(Line);
+		if (Line.empty() || Line[0] == '#')
+		{
+			continue;
+		}
+
+		const std::string Lower = ToLower(Line);
+
+		if (Lower.compare(0, 12, "rateprofile ") == 0)
+		{
+			CurrentProfile = SelectedProfile = std::atoi(Lower.c_str() + 12);
+			continue;
+		}
+
+		if (Lower.compare(0, 4, "set ") != 0)
+		{
+			continue;
+		}
+
+		const size_t Equals = Lower.find('=');
+		if (Equals == std::string::npos)
+		{
+			continue;
+		}
+
+		const std::string Name = Trim(Lower.substr(4, Equals - 4));
+		const std::string Value = Trim(Line.substr(Equals + 1));
+
+		FRawRateProfile& Profile = Profiles[CurrentProfile];
+		Profile.bAny |= ApplyRawSetting(Profile, Name, Value);
+	}
+
+	FRawRateProfile Raw;
+	if (Profiles.count(-1))
+	{
+		Merge(Raw, Profiles[-1]);
+	}
+	if (SelectedProfile >= 0 && Profiles.count(SelectedProfile))
+	{
+		Merge(Raw, Profiles[SelectedProfile]);
+	}
+
+	if (!Raw.bAny)
+	{
+		OutError = "no rate settings found";
+		return false;
+	}
+	if (Raw.Type > 2)
+	{
+		OutError = "unsupported rates_type (only BETAFLIGHT, ACTUAL and QUICK)";
+		return false;
+	}
+
+	// No rates_type line: firmware older than 4.2 only had Betaflight rates
+	const EFlightRatesType Type = Raw.Type >= 0 ? (EFlightRatesType)Raw.Type : EFlightRatesType::Betaflight;
+
+	// CLI stores integers: /100 for Betaflight-style factors, x10 deg/s for Actual/Quick rates
+	const float RcRateScale = Type == EFlightRatesType::Actual ? 10.f : 0.01f;
+	const float SuperRateScale = Type == EFlightRatesType::Betaflight ? 0.01f : 10.f;
+
+	for (int Axis = 0; Axis < FlightAxis::Num; ++Axis)
+	{
+		FFlightAxisRates& Out = InOutAxes[Axis];
+		Out.Type = Type;
+		if (Raw.RcRate[Axis] >= 0) Out.RcRate = Raw.RcRate[Axis] * RcRateScale;
+		if (Raw.SuperRate[Axis] >= 0) Out.SuperRate = Raw.SuperRate[Axis] * SuperRateScale;
+		if (Raw.Expo[Axis] >= 0) Out.Expo = Raw.Expo[Axis] * 0.01f;
+		if (Raw.RateLimit[Axis] >= 0) Out.RateLimit = (float)Raw.RateLimit[Axis];
+	}
+	return true;
+}
@@ -0,0 +1,91 @@
+// FlightRates.h
+//
+// Stick -> body rate setpoint curves using Betaflight's three rate models, baked into
+// lookup tables. Engine-free like the rest of FlightCore.
+
+#pragma once
+
+#include <string>
+
+/** Axis order shared by the rate tables and the flight input (same as RcChannel). */
+namespace FlightAxis
+{
+	enum Type : int
+	{
+		Roll,
+		Pitch,
+		Yaw,
+		Num
+	};
+}
+
+enum class EFlightRatesType : unsigned char
+{
+	Betaflight,
+	Actual,
+	Quick
+};
+
+/**
+ * One axis of a rate profile, in the units the Betaflight configurator shows:
+ *   Betaflight: RcRate 1.00, SuperRate 0.70, Expo 0.00
+ *   Actual:     RcRate = center sensitivity (deg/s), SuperRate = max rate (deg/s), Expo 0..1
+ *   Quick:      RcRate 1.00 (x200 deg/s at center), SuperRate = max rate (deg/s), Expo 0..1
+ */
+struct FFlightAxisRates
+{
+	EFlightRatesType Type = EFlightRatesType::Betaflight;
+	float RcRate = 1.f;
+	float SuperRate = 0.7f;
+	float Expo = 0.f;
+	float RateLimit = 1998.f;       // deg/s, Betaflight's rate_limit
+
+	bool operator==(const FFlightAxisRates& O) const
+	{
+		return Type == O.Type && RcRate == O.RcRate && SuperRate == O.SuperRate && Expo == O.Expo && RateLimit == O.RateLimit;
+	}
+	bool operator!=(const FFlightAxisRates& O) const { return !(*this == O); }
+};
+
+/** Exact rate curve (deg/s) for a stick position in -1..1. Used to bake tables; too slow for the step. */
+float EvaluateFlightRate(const FFlightAxisRates& Rates, float Stick);
+
+/**
+ * All three axes baked into tables over |stick| (every model is odd-symmetric).
+ * Build on parameter changes only; Lookup is a clamp, one multiply and a lerp.
+ */
+class FFlightRateTable
+{
+public:
+	static constexpr int NumSegments = 256;
+
+	void Build(const FFlightAxisRates (&Axes)[FlightAxis::Num]);
+
+	/** Rate setpoint in deg/s for Stick in -1..1. */
+	float Lookup(int Axis, float Stick) const
+	{
+		const float Abs = Stick < 0.f ? -Stick : Stick;
+		const float Pos = (Abs < 1.f ? Abs : 1.f) * NumSegments;
+		int Index = (int)Pos;
+		Index = Index < NumSegments - 1 ? Index : NumSegments - 1;
+
+		const float* Row = Table[Axis];
+		const float Rate = Row[Index] + (Row[Index + 1] - Row[Index]) * (Pos - (float)Index);
+		return Stick < 0.f ? -Rate : Rate;
+	}
+
+	const FFlightAxisRates& GetAxisRates(int Axis) const { return Source[Axis]; }
+
+private:
+	FFlightAxisRates Source[FlightAxis::Num];
+	float Table[FlightAxis::Num][NumSegments + 1] = {};
+};
+
+/**
+ * Reads rate settings from Betaflight CLI output ("dump", "dump all", "diff" or a few
+ * pasted "set" lines). With several rate profiles in the text, the one selected by the
+ * last "rateprofile N" line wins. Axes without a value in the text keep their value in
+ * InOutAxes. Returns false, with a reason, if no rate setting was found or the rates
+ * type isn't supported.
+ */
+bool ParseBetaflightRates(const std::string& CliText, FFlightAxisRates (&InOutAxes)[FlightAxis::Num], std::string& OutError);
@@ -0,0 +1,187 @@
+// FlightWind.cpp
+
+#include "FlightWind.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// Lattice value in [-1, 1]
+	float WindLatticeValue(int X, int Y, int Z, uint32_t Seed)
+	{
+		uint32_t H = Seed * 0x9E3779B9u;
+		H ^= (uint32_t)X * 0x85EBCA6Bu;
+		H = (H ^ (H >> 13)) * 0xC2B2AE35u;
+		H ^= (uint32_t)Y * 0x27D4EB2Fu;
+		H = (H ^ (H >> 15)) * 0x85EBCA6Bu;
+		H ^= (uint32_t)Z * 0x165667B1u;
+		H = (H ^ (H >> 16)) * 0x7FEB352Du;
+		H ^= H >> 15;
+		return (float)(H & 0xFFFFFF) / (float)0x7FFFFF - 1.f;
+	}
+
+	// Smoothly interpolated value noise, roughly [-1, 1]
+	float WindValueNoise(const FFlightVec3& P, uint32_t Seed)
+	{
+		const float FX = std::floor(P.X), FY = std::floor(P.Y), FZ = std::floor(P.Z);
+		const int X = (int)FX, Y = (int)FY, Z = (int)FZ;
+
+		auto Smooth = [](float T) { return T * T * (3.f - 2.f * T); };
+		const float TX = Smooth(P.X - FX), TY = Smooth(P.Y - FY), TZ = Smooth(P.Z - FZ);
+
+		auto Lerp = [](float A, float B, float T) { return A + (B - A) * T; };
+		auto Row = [&](int DY, int DZ)
+		{
+			return Lerp(WindLatticeValue(X, Y + DY, Z + DZ, Seed), WindLatticeValue(X + 1, Y + DY, Z + DZ, Seed), TX);
+		};
+		return Lerp(Lerp(Row(0, 0), Row(1, 0), TY), Lerp(Row(0, 1), Row(1, 1), TY), TZ);
+	}
+
+	FFlightVec3 WindTurbulence(const FFlightVec3& Position, const FFlightWindBakeParams& Params)
+	{
+		FFlightVec3 Sum;
+		float Frequency = 1.f / std::max(Params.TurbulenceScale, 1.f);
+		float Amplitude = 1.f;
+		float AmplitudeSum = 0.f;
+		for (int Octave = 0; Octave < std::max(Params.TurbulenceOctaves, 1); ++Octave)
+		{
+			const FFlightVec3 P = Position * Frequency;
+			const uint32_t Seed = Params.Seed * 3u + (uint32_t)Octave * 101u;
+			Sum += FFlightVec3(WindValueNoise(P, Seed), WindValueNoise(P, Seed + 1u), WindValueNoise(P, Seed + 2u)) * Amplitude;
+
+			AmplitudeSum += Amplitude;
+			Amplitude *= 0.5f;
+			Frequency *= 2.f;
+		}
+		return Sum / AmplitudeSum;
+	}
+}
+
+void FFlightWindField::Init(const FFlightVec3& InMin, float InCellSize, int NumX, int NumY, int NumZ, const FFlightVec3& InOutsideWind)
+{
+	Min = InMin;
+	OutsideWind = InOutsideWind;
+	CellSize = std::max(InCellSize, 1.f);
+	Num[0] = std::max(NumX, 1);
+	Num[1] = std::max(NumY, 1);
+	Num[2] = std::max(NumZ, 1);
+	bBaked = false;
+
+	Blocked.assign((size_t)GetNumCells(), 0);
+	Cells.clear();
+}
+
+void FFlightWindField::SetBlocked(int X, int Y, int Z)
+{
+	if (X < 0 || Y < 0 || Z < 0 || X >= Num[0] || Y >= Num[1] || Z >= Num[2] || Blocked.empty())
+	{
+		return;
+	}
+	Blocked[(size_t)Index(X, Y, Z)] = 1;
+}
+
+void FFlightWindField::Bake(const FFlightWindBakeParams& Params)
+{
+	const float MeanSpeed = Params.MeanWind.Size();
+	const FFlightVec3 Downwind = MeanSpeed > 1e-3f ? Params.MeanWind / MeanSpeed : FFlightVec3();
+	const FFlightVec3 GustScale = FFlightVec3(1.f, 1.f, Params.VerticalTurbulence) * (Params.TurbulenceIntensity * MeanSpeed);
+
+	// Wake: walk upwind one cell at a time looking for the nearest obstacle
+	const int ShadowSteps = MeanSpeed > 1e-3f ? (int)std::ceil(Params.ShadowLength / CellSize) : 0;
+	const bool bAnyBlocked = std::find(Blocked.begin(), Blocked.end(), (uint8_t)1) != Blocked.end();
+
+	Cells.resize((size_t)GetNumCells());
+	for (int Z = 0; Z < Num[2]; ++Z)
+	{
+		for (int Y = 0; Y < Num[1]; ++Y)
+		{
+			for (int X = 0; X < Num[0]; ++X)
+			{
+				const int64_t CellIndex = Index(X, Y, Z);
+				if (Blocked[(size_t)CellIndex])
+				{
+					Cells[(size_t)CellIndex] = FFlightVec3();
+					continue;
+				}
+
+				const FFlightVec3 Center = Min + FFlightVec3(X + 0.5f, Y + 0.5f, Z + 0.5f) * CellSize;
+
+				float Recovery = 1.f; // 0 right behind an obstacle, 1 in open air
+				if (bAnyBlocked)
+				{
+					for (int Step = 1; Step <= ShadowSteps; ++Step)
+					{
+						const FFlightVec3 Upwind = Center - Downwind * (Step * CellSize);
+						const FFlightVec3 Local = (Upwind - Min) / CellSize;
+						const int UX = (int)std::floor(Local.X), UY = (int)std::floor(Local.Y), UZ = (int)std::floor(Local.Z);
+						if (UX < 0 || UY < 0 || UZ < 0 || UX >= Num[0] || UY >= Num[1] || UZ >= Num[2])
+						{
+							break;
+						}
+						if (Blocked[(size_t)Index(UX, UY, UZ)])
+						{
+							Recovery = (float)(Step - 1) / (float)ShadowSteps;
+							break;
+						}
+					}
+				}
+
+				const float MeanScale = Params.ShadowMinScale + (1.f - Params.ShadowMinScale) * Recovery;
+				const float GustBoost = 1.f + Params.WakeTurbulence * (1.f - Recovery);
+				Cells[(size_t)CellIndex] = Params.MeanWind * MeanScale + WindTurbulence(Center, Params) * GustScale * GustBoost;
+			}
+		}
+	}
+
+	std::vector<uint8_t>().swap(Blocked);
+	bBaked = true;
+}
+
+bool FFlightWindField::SetCells(const std::vector<FFlightVec3>& InCells)
+{
+	if ((int64_t)InCells.size() != GetNumCells())
+	{
+		return false;
+	}
+	Cells = InCells;
+	std::vector<uint8_t>().swap(Blocked);
+	bBaked = true;
+	return true;
+}
+
+FFlightVec3 FFlightWindField::Sample(const FFlightVec3& Position) const
+{
+	if (!bBaked)
+	{
+		return OutsideWind;
+	}
+
+	// Cell-center coordinates; clamp to the outer centers so the edge cells extend to the bounds
+	const FFlightVec3 Local = (Position - Min) / CellSize - FFlightVec3(0.5f, 0.5f, 0.5f);
+	const float LocalAxes[3] = { Local.X, Local.Y, Local.Z };
+
+	int I0[3];
+	int I1[3];
+	float T[3];
+	for (int Axis = 0; Axis < 3; ++Axis)
+	{
+		if (LocalAxes[Axis] < -0.5f || LocalAxes[Axis] > (float)Num[Axis] - 0.5f)
+		{
+			return OutsideWind;
+		}
+		const float Clamped = std::clamp(LocalAxes[Axis], 0.f, (float)(Num[Axis] - 1));
+		I0[Axis] = std::min((int)Clamped, Num[Axis] - 1);
+		I1[Axis] = std::min(I0[Axis] + 1, Num[Axis] - 1);
+		T[Axis] = Clamped - (float)I0[Axis];
+	}
+
+	auto Cell = [this](int X, int Y, int Z) -> const FFlightVec3& { return Cells[(size_t)Index(X, Y, Z)]; };
+	auto Lerp = [](const FFlightVec3& A, const FFlightVec3& B, float Alpha) { return A + (B - A) * Alpha; };
+
+	const FFlightVec3 C00 = Lerp(Cell(I0[0], I0[1], I0[2]), Cell(I1[0], I0[1], I0[2]), T[0]);
+	const FFlightVec3 C10 = Lerp(Cell(I0[0], I1[1], I0[2]), Cell(I1[0], I1[1], I0[2]), T[0]);
+	const FFlightVec3 C01 = Lerp(Cell(I0[0], I0[1], I1[2]), Cell(I1[0], I0[1], I1[2]), T[0]);
+	const FFlightVec3 C11 = Lerp(Cell(I0[0], I1[1], I1[2]), Cell(I1[0], I1[1], I1[2]), T[0]);
+	return Lerp(Lerp(C00, C10, T[1]), Lerp(C01, C11, T[1]), T[2]);
+}
@@ -0,0 +1,69 @@
+// FlightWind.h
+//
+// Wind over a map, baked once into a grid of world-space velocities (mean wind, frozen
+// turbulence, wakes behind obstacles) and read back per flight step with one trilinear
+// sample. The bake can be expensive; sampling must stay a handful of loads.
+
+#pragma once
+
+#include "FlightMath.h"
+
+#include <cstdint>
+#include <vector>
+
+struct FFlightWindBakeParams
+{
+	FFlightVec3 MeanWind;               // cm/s, world, in open air
+
+	// Frozen turbulence: smooth 3D noise, re-scaled per cell
+	float TurbulenceIntensity = 0.15f;  // gust amplitude as a fraction of the mean wind speed
+	float TurbulenceScale = 1000.f;     // cm, size of the largest eddies
+	int TurbulenceOctaves = 3;          // each one half the size and half the strength of the last
+	float VerticalTurbulence = 0.4f;    // vertical gusts relative to horizontal ones
+	uint32_t Seed = 1;
+
+	// Wake of blocked cells: slowed and more turbulent air downwind
+	float ShadowLength = 3000.f;        // cm downwind before the wind has fully recovered
+	float ShadowMinScale = 0.2f;        // mean wind fraction right behind an obstacle
+	float WakeTurbulence = 1.5f;        // extra turbulence right behind an obstacle, fades with the wake
+};
+
+class FFlightWindField
+{
+public:
+	/**
+	 * Grid of NumX*NumY*NumZ cubes of CellSize cm from Min, values at the cell centers.
+	 * Outside the grid the wind is OutsideWind. All cells start free; Bake() or SetCells() must follow.
+	 */
+	void Init(const FFlightVec3& InMin, float InCellSize, int NumX, int NumY, int NumZ, const FFlightVec3& InOutsideWind);
+
+	/** Marks a cell as solid: no wind in it, and a wake downwind of it. */
+	void SetBlocked(int X, int Y, int Z);
+
+	void Bake(const FFlightWindBakeParams& Params);
+
+	/** Takes previously baked cells (GetCells() of a field with the same grid). False on a size mismatch. */
+	bool SetCells(const std::vector<FFlightVec3>& InCells);
+	const std::vector<FFlightVec3>& GetCells() const { return Cells; }
+
+	bool IsBaked() const { return bBaked; }
+
+	/** Wind velocity at Position (cm/s, world), trilinear between cell centers. */
+	FFlightVec3 Sample(const FFlightVec3& Position) const;
+
+	float GetCellSize() const { return CellSize; }
+	int GetNum(int Axis) const { return Num[Axis]; }
+	int64_t GetNumCells() const { return (int64_t)Num[0] * Num[1] * Num[2]; }
+
+private:
+	int64_t Index(int X, int Y, int Z) const { return ((int64_t)Z * Num[1] + Y) * Num[0] + X; }
+
+	FFlightVec3 Min;
+	FFlightVec3 OutsideWind;
+	float CellSize = 200.f;
+	int Num[3] = { 0, 0, 0 };
+	bool bBaked = false;
+
+	std::vector<uint8_t> Blocked;
+	std::vector<FFlightVec3> Cells;
+};
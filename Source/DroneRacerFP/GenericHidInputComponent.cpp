@@ -1,5 +1,6 @@
 // GenericHidInputComponent.cpp
 #include "GenericHidInputComponent.h"
+#include "DroneLatency.h"
 
 #include "HAL/PlatformProcess.h"
 #include "HAL/PlatformTime.h"
@@ -50,9 +51,10 @@ static bool GetPreparsedData(HANDLE DeviceHandle, TArray<uint8>& OutPreparsed)
 
 static FString MakeDeviceId(const RID_DEVICE_INFO_HID& HidInfo, HANDLE DeviceHandle)
 {
-    // NOTE: includes handle => not stable across runs; good enough for now.
-    return FString::Printf(TEXT("HID_%p_VID_%04X_PID_%04X"),
-        DeviceHandle, (uint32)HidInfo.dwVendorId, (uint32)HidInfo.dwProductId);
+    // Stable across runs so calibration profiles can be keyed on it.
+    // Two identical radios share an id (and therefore a profile).
+    return FString::Printf(TEXT("HID_VID_%04X_PID_%04X"),
+        (uint32)HidInfo.dwVendorId, (uint32)HidInfo.dwProductId);
 }
 
 static void NormalizeHidValueToFloat(LONG Value, LONG LogicalMin, LONG LogicalMax, float& OutFloat)
@@ -374,6 +376,13 @@ void UGenericHidInputComponent::HandleRawInput(void* RawInputHandle)
             UE_LOG(LogTemp, Log, TEXT("GenericHID: New device %s (VID=%04X PID=%04X)"),
                 *Device->DeviceId, Device->VendorId, Device->ProductId);
         }
+
+        FGenericHidDeviceAxes Connected;
+        Connected.DeviceId = Device->DeviceId;
+        Connected.VendorId = Device->VendorId;
+        Connected.ProductId = Device->ProductId;
+        Connected.Axes = Device->Axes;
+        OnDeviceConnected.Broadcast(Connected);
     }
 
     if (!Device->bInitialized)
@@ -473,15 +482,16 @@ void UGenericHidInputComponent::HandleRawInput(void* RawInputHandle)
 
     if (bAnyAxisChanged)
     {
-        if (bLogDevices)
-        {
-            UE_LOG(LogTemp, Warning, TEXT("HID %s Axes: X=%.3f Y=%.3f Z=%.3f Rx=%.3f Ry=%.3f Rz=%.3f Sl=%.3f"),
-                *Device->DeviceId,
-                Device->Axes[0], Device->Axes[1], Device->Axes[2],
-                Device->Axes[3], Device->Axes[4], Device->Axes[5],
-                Device->Axes[6]);
-        }
+        FDroneLatency::StampDeviceRead();
+    }
+
+    // Every report, changed or not: jitter statistics need the repeats too
+    OnReport.Broadcast(Device->DeviceId, Device->Axes);
 
+    if (bAnyAxisChanged)
+    {
+        // No per-report log: at 250-1000 Hz it swamps the output. Listeners record the values
+        // (the drone pawn puts them on its Input.HidXYZ / Input.HidRxRyRz telemetry channels).
         FGenericHidDeviceAxes Out;
         Out.DeviceId = Device->DeviceId;
         Out.VendorId = Device->VendorId;
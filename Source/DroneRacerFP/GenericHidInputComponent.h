@@ -16,6 +16,8 @@ struct FGenericHidDeviceAxes
 };
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnGenericHidAxesUpdated, const FGenericHidDeviceAxes&, Axes);
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnGenericHidDeviceConnected, const FGenericHidDeviceAxes& /*Device*/);
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnGenericHidReport, const FString& /*DeviceId*/, TArrayView<const float> /*Axes*/);
 
 UCLASS(ClassGroup = (Input), meta = (BlueprintSpawnableComponent))
 class DRONERACERFP_API UGenericHidInputComponent : public UActorComponent
@@ -28,12 +30,19 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GenericHID")
     bool bAutoStart = true;
 
+    /** Log each device once when it first reports; axis values are never logged per report */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "GenericHID")
     bool bLogDevices = true;
 
     UPROPERTY(BlueprintAssignable, Category = "GenericHID")
     FOnGenericHidAxesUpdated OnAxesUpdated;
 
+    /** Fired the first time a device sends a report (DeviceId is stable across runs). */
+    FOnGenericHidDeviceConnected OnDeviceConnected;
+
+    /** Fired for every HID report, changed or not, without copying the axes. */
+    FOnGenericHidReport OnReport;
+
     UFUNCTION(BlueprintCallable, Category = "GenericHID")
     void Start();
 
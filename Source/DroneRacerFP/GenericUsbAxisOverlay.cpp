@@ -0,0 +1,124 @@
+// GenericUsbAxisOverlay.cpp
+
+#include "GenericUsbAxisOverlay.h"
+#include "Debug/DebugDrawService.h"
+#include "Engine/Canvas.h"
+#include "Engine/Engine.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerInput.h"
+#include "HAL/IConsoleManager.h"
+
+namespace
+{
+	// Values closer to rest than this are hidden, as before
+	constexpr float UsbAxisDisplayThreshold = 0.01f;
+
+	struct FUsbAxisOverlayState
+	{
+		FDelegateHandle DrawHandle;
+		float Shown[FGenericUsbAxisOverlay::NumAxes] = {};
+		FString Lines[FGenericUsbAxisOverlay::NumAxes];
+	};
+
+	FUsbAxisOverlayState& GetUsbAxisOverlayState()
+	{
+		static FUsbAxisOverlayState State;
+		return State;
+	}
+
+	void DrawUsbAxisOverlay(UCanvas* Canvas, APlayerController* PC)
+	{
+		if (!Canvas || !PC)
+		{
+			return;
+		}
+
+		FUsbAxisOverlayState& State = GetUsbAxisOverlayState();
+		float Values[FGenericUsbAxisOverlay::NumAxes];
+		FGenericUsbAxisOverlay::ReadAxes(*PC, Values);
+
+		float Top = 120.f;
+		Canvas->SetDrawColor(FColor::Orange);
+		for (int32 i = 0; i < FGenericUsbAxisOverlay::NumAxes; ++i)
+		{
+			if (FMath::Abs(Values[i]) <= UsbAxisDisplayThreshold)
+			{
+				continue;
+			}
+
+			// The panel is retained: text only changes when the shown value does
+			const float Rounded = FMath::RoundToFloat(Values[i] * 1000.f) / 1000.f;
+			if (State.Lines[i].IsEmpty() || Rounded != State.Shown[i])
+			{
+				State.Shown[i] = Rounded;
+				State.Lines[i] = FString::Printf(TEXT("DETECTED - Axis %d: %.3f"), i + 1, Rounded);
+			}
+
+			Canvas->DrawText(GEngine->GetSmallFont(), State.Lines[i], 10.f, Top);
+			Top += 14.f;
+		}
+	}
+}
+
+const FKey (&FGenericUsbAxisOverlay::GetAxisKeys())[NumAxes]
+{
+	static const FKey Keys[NumAxes] = {
+		FKey(TEXT("GenericUSBController_Axis1")),
+		FKey(TEXT("GenericUSBController_Axis2")),
+		FKey(TEXT("GenericUSBController_Axis3")),
+		FKey(TEXT("GenericUSBController_Axis4")),
+		FKey(TEXT("GenericUSBController_Axis5")),
+		FKey(TEXT("GenericUSBController_Axis6")),
+		FKey(TEXT("GenericUSBController_Axis7")),
+		FKey(TEXT("GenericUSBController_Axis8"))
+	};
+	return Keys;
+}
+
+void FGenericUsbAxisOverlay::ReadAxes(APlayerController& PC, float (&OutValues)[NumAxes])
+{
+	const FKey (&Keys)[NumAxes] = GetAxisKeys();
+	const TMap<FKey, FKeyState>* KeyStates = PC.PlayerInput ? &PC.PlayerInput->GetKeyStateMap() : nullptr;
+
+	for (int32 i = 0; i < NumAxes; ++i)
+	{
+		const FKeyState* KeyState = KeyStates ? KeyStates->Find(Keys[i]) : nullptr;
+		OutValues[i] = KeyState ? KeyState->Value.X : 0.f;
+	}
+}
+
+void FGenericUsbAxisOverlay::SetVisible(bool bVisible)
+{
+	FUsbAxisOverlayState& State = GetUsbAxisOverlayState();
+	if (bVisible == State.DrawHandle.IsValid())
+	{
+		return;
+	}
+
+	if (bVisible)
+	{
+		State.DrawHandle = UDebugDrawService::Register(TEXT("Game"), FDebugDrawDelegate::CreateStatic(&DrawUsbAxisOverlay));
+	}
+	else
+	{
+		UDebugDrawService::Unregister(State.DrawHandle);
+		State.DrawHandle.Reset();
+		for (FString& Line : State.Lines)
+		{
+			Line.Empty();
+		}
+	}
+}
+
+bool FGenericUsbAxisOverlay::IsVisible()
+{
+	return GetUsbAxisOverlayState().DrawHandle.IsValid();
+}
+
+static FAutoConsoleCommand GUsbAxisOverlayCommand(
+	TEXT("Drone.Debug.UsbAxes"),
+	TEXT("Toggles the on-screen list of deflected GenericUSBController axes. Args: [0|1]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic([](const TArray<FString>& Args)
+	{
+		FGenericUsbAxisOverlay::SetVisible(Args.Num() > 0 ? FCString::Atoi(*Args[0]) != 0 : !FGenericUsbAxisOverlay::IsVisible());
+	}));
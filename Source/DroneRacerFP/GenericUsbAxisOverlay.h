@@ -0,0 +1,27 @@
+// GenericUsbAxisOverlay.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InputCoreTypes.h"
+
+class APlayerController;
+
+/**
+ * Debug panel listing the deflected GenericUSBController axes (Raw Input plugin keys
+ * GenericUSBController_Axis1..8). Hidden by default and costs nothing then; Drone.Debug.UsbAxes
+ * toggles it. The key table is built once and the text only rebuilt when a value changes.
+ */
+class DRONERACERFP_API FGenericUsbAxisOverlay
+{
+public:
+	static constexpr int32 NumAxes = 8;
+
+	static const FKey (&GetAxisKeys())[NumAxes];
+
+	/** All axes in one pass over the controller's key states; 0 for keys it hasn't seen. */
+	static void ReadAxes(APlayerController& PC, float (&OutValues)[NumAxes]);
+
+	static void SetVisible(bool bVisible);
+	static bool IsVisible();
+};
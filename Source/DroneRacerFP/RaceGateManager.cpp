@@ -41,7 +41,8 @@ void ARaceGateManager::GatePassed(ARaceGate* PassedGate)
     // Move to next gate
     CurrentIndex++;
 
-    if (Gates.IsValidIndex(CurrentIndex))
+    const bool bRaceComplete = !Gates.IsValidIndex(CurrentIndex);
+    if (!bRaceComplete)
     {
         Gates[CurrentIndex]->ActivateGate();
     }
@@ -49,4 +50,6 @@ void ARaceGateManager::GatePassed(ARaceGate* PassedGate)
     {
         UE_LOG(LogTemp, Warning, TEXT("RACE COMPLETE!"));
     }
+
+    OnGatePassed.Broadcast(PassedIndex, bRaceComplete);
 }
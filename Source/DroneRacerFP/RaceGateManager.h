@@ -30,4 +30,8 @@ public:
 
     // Called by a gate when passed
     void GatePassed(ARaceGate* PassedGate);
+
+    // After each correct gate; bRaceComplete on the last one
+    DECLARE_MULTICAST_DELEGATE_TwoParams(FOnGatePassed, int32 /*GateIndex*/, bool /*bRaceComplete*/);
+    FOnGatePassed OnGatePassed;
 };
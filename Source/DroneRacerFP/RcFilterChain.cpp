@@ -0,0 +1,153 @@
+// RcFilterChain.cpp
+
+#include "RcFilterChain.h"
+
+namespace
+{
+	// Cutoff multipliers that keep the -3 dB point of N cascaded PT1s at the requested
+	// frequency: 1 / sqrt(2^(1/N) - 1) (same correction as Betaflight's pt2/pt3FilterGain).
+	constexpr float Pt2CutoffCorrection = 1.553774f;
+	constexpr float Pt3CutoffCorrection = 1.961459f;
+
+	FORCEINLINE float Median3(float A, float B, float C)
+	{
+		return FMath::Max(FMath::Min(A, B), FMath::Min(FMath::Max(A, B), C));
+	}
+}
+
+float FRcFilterBank::Pt1Gain(float CutoffHz, float DeltaTime)
+{
+	const float Omega = 2.f * PI * CutoffHz * DeltaTime;
+	return Omega / (Omega + 1.f);
+}
+
+void FRcFilterBank::Configure(const FRcAxisFilterSettings (&Settings)[NumChannels], float InSampleRateHz)
+{
+	SampleRateHz = FMath::Max(InSampleRateHz, 1.f);
+	const float Dt = 1.f / SampleRateHz;
+	const float MaxCutoff = 0.45f * SampleRateHz;
+
+	for (int32 Ch = 0; Ch < NumChannels; ++Ch)
+	{
+		const FRcAxisFilterSettings& S = Settings[Ch];
+		const float Cutoff = FMath::Clamp(S.CutoffHz, 1.f, MaxCutoff);
+
+		MedianMix[Ch] = S.bMedian ? 1.f : 0.f;
+
+		for (int32 Stage = 0; Stage < NumPt1Stages; ++Stage)
+		{
+			Pt1K[Stage][Ch] = 1.f;
+		}
+
+		// Identity biquad unless selected
+		BqB0[Ch] = 1.f;
+		BqB1[Ch] = 0.f;
+		BqB2[Ch] = 0.f;
+		BqA1[Ch] = 0.f;
+		BqA2[Ch] = 0.f;
+
+		switch (S.Lowpass)
+		{
+		case ERcLowpassType::PT1:
+			Pt1K[0][Ch] = Pt1Gain(Cutoff, Dt);
+			break;
+
+		case ERcLowpassType::PT2:
+			Pt1K[0][Ch] = Pt1K[1][Ch] = Pt1Gain(FMath::Min(Cutoff * Pt2CutoffCorrection, MaxCutoff), Dt);
+			break;
+
+		case ERcLowpassType::PT3:
+			Pt1K[0][Ch] = Pt1K[1][Ch] = Pt1K[2][Ch] = Pt1Gain(FMath::Min(Cutoff * Pt3CutoffCorrection, MaxCutoff), Dt);
+			break;
+
+		case ERcLowpassType::Biquad:
+		{
+			// RBJ cookbook low-pass, normalized by a0
+			const float Omega = 2.f * PI * Cutoff * Dt;
+			const float Sn = FMath::Sin(Omega);
+			const float Cs = FMath::Cos(Omega);
+			const float Alpha = Sn / (2.f * FMath::Max(S.BiquadQ, 0.1f));
+			const float InvA0 = 1.f / (1.f + Alpha);
+
+			BqB0[Ch] = (1.f - Cs) * 0.5f * InvA0;
+			BqB1[Ch] = (1.f - Cs) * InvA0;
+			BqB2[Ch] = BqB0[Ch];
+			BqA1[Ch] = -2.f * Cs * InvA0;
+			BqA2[Ch] = (1.f - Alpha) * InvA0;
+			break;
+		}
+
+		case ERcLowpassType::None:
+		default:
+			break;
+		}
+
+		FfK[Ch] = Pt1Gain(FMath::Clamp(S.FeedforwardCutoffHz, 1.f, MaxCutoff), Dt);
+		FfScale[Ch] = FMath::Max(S.FeedforwardLead, 0.f) * SampleRateHz;
+	}
+}
+
+void FRcFilterBank::Reset(const float (&Values)[NumChannels])
+{
+	for (int32 Ch = 0; Ch < NumChannels; ++Ch)
+	{
+		const float V = Values[Ch];
+
+		MedianHistory[0][Ch] = V;
+		MedianHistory[1][Ch] = V;
+
+		for (int32 Stage = 0; Stage < NumPt1Stages; ++Stage)
+		{
+			Pt1State[Stage][Ch] = V;
+		}
+
+		// Transposed direct form II at rest with unity DC gain: y == x
+		BqS1[Ch] = V * (1.f - BqB0[Ch]);
+		BqS2[Ch] = V * (BqB2[Ch] - BqA2[Ch]);
+
+		FfPrev[Ch] = V;
+		FfRate[Ch] = 0.f;
+	}
+}
+
+void FRcFilterBank::Process(const float (&In)[NumChannels], float (&OutSetpoint)[NumChannels], float (&OutFeedforward)[NumChannels])
+{
+	float X[NumChannels];
+
+	// Median of the last three reports (blended out when disabled)
+	for (int32 Ch = 0; Ch < NumChannels; ++Ch)
+	{
+		const float Med = Median3(MedianHistory[0][Ch], MedianHistory[1][Ch], In[Ch]);
+		MedianHistory[0][Ch] = MedianHistory[1][Ch];
+		MedianHistory[1][Ch] = In[Ch];
+		X[Ch] = In[Ch] + MedianMix[Ch] * (Med - In[Ch]);
+	}
+
+	// PT1 cascade; K == 1 passes through
+	for (int32 Stage = 0; Stage < NumPt1Stages; ++Stage)
+	{
+		for (int32 Ch = 0; Ch < NumChannels; ++Ch)
+		{
+			Pt1State[Stage][Ch] += Pt1K[Stage][Ch] * (X[Ch] - Pt1State[Stage][Ch]);
+			X[Ch] = Pt1State[Stage][Ch];
+		}
+	}
+
+	// Biquad, transposed direct form II
+	for (int32 Ch = 0; Ch < NumChannels; ++Ch)
+	{
+		const float Y = BqB0[Ch] * X[Ch] + BqS1[Ch];
+		BqS1[Ch] = BqB1[Ch] * X[Ch] - BqA1[Ch] * Y + BqS2[Ch];
+		BqS2[Ch] = BqB2[Ch] * X[Ch] - BqA2[Ch] * Y;
+		OutSetpoint[Ch] = Y;
+	}
+
+	// Feedforward from the smoothed rate of the filtered stick
+	for (int32 Ch = 0; Ch < NumChannels; ++Ch)
+	{
+		const float Delta = OutSetpoint[Ch] - FfPrev[Ch];
+		FfPrev[Ch] = OutSetpoint[Ch];
+		FfRate[Ch] += FfK[Ch] * (Delta - FfRate[Ch]);
+		OutFeedforward[Ch] = FfScale[Ch] * FfRate[Ch];
+	}
+}
@@ -0,0 +1,118 @@
+// RcFilterChain.h
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RcFilterChain.generated.h"
+
+/** Logical RC channels, in the order the filter bank and the flight code index them. */
+namespace RcChannel
+{
+	enum Type : int32
+	{
+		Roll,
+		Pitch,
+		Yaw,
+		Throttle,
+		Num
+	};
+}
+
+UENUM(BlueprintType)
+enum class ERcLowpassType : uint8
+{
+	None,
+	PT1,
+	PT2,
+	PT3,
+	Biquad
+};
+
+// Stick smoothing for one RC channel. Stages run in order:
+// median -> low-pass (PT1/PT2/PT3 or biquad) -> feedforward.
+USTRUCT(BlueprintType)
+struct FRcAxisFilterSettings
+{
+	GENERATED_BODY()
+
+	/** 3-report median in front of the low-pass; removes single-report spikes from noisy links. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RcSmoothing")
+	bool bMedian = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RcSmoothing")
+	ERcLowpassType Lowpass = ERcLowpassType::PT3;
+
+	/**
+	 * -3 dB point of the whole low-pass, like Betaflight's rc_smoothing cutoffs
+	 * (PT2/PT3 stages are corrected so the cascade still cuts here). Clamped below Nyquist.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RcSmoothing", meta = (ClampMin = "1.0", Units = "Hz"))
+	float CutoffHz = 40.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RcSmoothing", meta = (ClampMin = "0.1", EditCondition = "Lowpass == ERcLowpassType::Biquad"))
+	float BiquadQ = 0.7071f;
+
+	/**
+	 * Feedforward: adds this many seconds of predicted stick travel (filtered stick rate * lead).
+	 * Buys back the low-pass delay on fast moves; 0 disables it.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RcSmoothing", meta = (ClampMin = "0.0", Units = "s"))
+	float FeedforwardLead = 0.f;
+
+	/** PT1 on the stick rate so feedforward doesn't amplify report jitter. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "RcSmoothing", meta = (ClampMin = "1.0", Units = "Hz"))
+	float FeedforwardCutoffHz = 15.f;
+};
+
+/**
+ * Per-channel RC filter pipeline, all channels stepped together once per input report.
+ *
+ * Coefficients are computed in Configure, never per sample. Every channel runs the same
+ * fixed stage sequence (three PT1 stages, then a biquad); stages a channel doesn't use get
+ * pass-through coefficients, so Process has no per-channel branches. Coefficients and state
+ * are stored per stage across channels (SoA) and each stage is one short loop.
+ */
+class DRONERACERFP_API FRcFilterBank
+{
+public:
+	static constexpr int32 NumChannels = RcChannel::Num;
+
+	/** Precomputes every coefficient. Call again when the settings or the input rate change; state is kept. */
+	void Configure(const FRcAxisFilterSettings (&Settings)[NumChannels], float InSampleRateHz);
+
+	/** Puts every stage in steady state at Values, so the first samples produce no transient. */
+	void Reset(const float (&Values)[NumChannels]);
+
+	/** Filters one sample of every channel. */
+	void Process(const float (&In)[NumChannels], float (&OutSetpoint)[NumChannels], float (&OutFeedforward)[NumChannels]);
+
+	float GetSampleRate() const { return SampleRateHz; }
+	bool IsConfigured() const { return SampleRateHz > 0.f; }
+
+	/** Betaflight's PT1 gain for a cutoff at the given sample interval. */
+	static float Pt1Gain(float CutoffHz, float DeltaTime);
+
+private:
+	static constexpr int32 NumPt1Stages = 3;
+
+	float SampleRateHz = 0.f;
+
+	// ---- Coefficients ----
+	float MedianMix[NumChannels];              // 1 = median, 0 = bypass
+	float Pt1K[NumPt1Stages][NumChannels];     // 1 = bypass
+	float BqB0[NumChannels];
+	float BqB1[NumChannels];
+	float BqB2[NumChannels];
+	float BqA1[NumChannels];
+	float BqA2[NumChannels];
+	float FfK[NumChannels];
+	float FfScale[NumChannels];                // lead * sample rate
+
+	// ---- State ----
+	float MedianHistory[2][NumChannels];
+	float Pt1State[NumPt1Stages][NumChannels];
+	float BqS1[NumChannels];
+	float BqS2[NumChannels];
+	float FfPrev[NumChannels];
+	float FfRate[NumChannels];
+};
@@ -0,0 +1,168 @@
+// FlightBlackboxTests.cpp
+//
+// Blackbox codec: header, keyframe/delta round trip within the quantization, events, a reader
+// joining at a keyframe, and the record size bound for out-of-range values.
+
+#include "FlightTest.h"
+#include "FlightBenchmark.h"
+#include "FlightBlackbox.h"
+
+#include <algorithm>
+#include <vector>
+
+FLIGHT_TEST(Blackbox)
+{
+	uint8_t Header[FlightBlackboxHeaderBytes];
+	WriteFlightBlackboxHeader(Header, FlightTestStep);
+	float StepSeconds = 0.f;
+	FLIGHT_CHECK(ReadFlightBlackboxHeader(Header, sizeof(Header), StepSeconds));
+	FLIGHT_CHECK(StepSeconds == FlightTestStep);
+	FLIGHT_CHECK(!ReadFlightBlackboxHeader(Header, sizeof(Header) - 1, StepSeconds));
+
+	// 20 s of scripted flight with a keyframe forced halfway (as after lost bytes)
+	const FFlightParams Params;
+	FFlightGroundPlane Ground(0.f);
+	FFlightState State = MakeFlightTestStartState();
+
+	FFlightBlackboxEncoder Encoder;
+	std::vector<uint8_t> Bytes;
+	std::vector<FFlightBlackboxFrame> Frames;
+	std::vector<FFlightBlackboxEvent> Events;
+	uint8_t Record[FlightBlackboxMaxRecordBytes];
+	const uint32_t ForcedKeyframe = 10000;
+	size_t ForcedKeyframeOffset = 0;
+
+	for (uint32_t i = 0; i < 20000; ++i)
+	{
+		const FFlightInput Input = MakeScriptedFlightInput(i * (double)FlightTestStep);
+		FFlightStepResult Result;
+		StepFlightModel(State, Params, Input, FlightTestStep, &Ground, &Result);
+
+		FFlightBlackboxFrame Frame;
+		Frame.Step = i;
+		const float Sticks[4] = { Input.Roll, Input.Pitch, Input.Yaw, Input.Throttle };
+		for (int k = 0; k < 4; ++k)
+		{
+			Frame.Sticks[k] = Sticks[k];
+			Frame.Commands[k] = Sticks[k] * 0.5f;
+			Frame.MotorThrust[k] = State.MotorThrust[k];
+		}
+		Frame.Rotation = State.Rotation;
+		Frame.Velocity = State.Velocity;
+		Frame.Position = State.Position;
+		Frame.Health = 100.f - i * 0.001f;
+		Frame.Flags = (Input.bArmed ? FlightBlackboxFlag_Armed : 0) | (Result.bContact ? FlightBlackboxFlag_Contact : 0);
+
+		if (i == ForcedKeyframe)
+		{
+			Encoder.ForceKeyframe();
+			ForcedKeyframeOffset = Bytes.size();
+		}
+		const size_t Size = Encoder.EncodeFrame(Frame, Record);
+		FLIGHT_CHECK(Size > 0 && Size <= FlightBlackboxMaxRecordBytes);
+		Bytes.insert(Bytes.end(), Record, Record + Size);
+		Frames.push_back(Frame);
+
+		if (i % 1000 == 500)
+		{
+			FFlightBlackboxEvent Event;
+			Event.Step = i;
+			Event.Type = (i / 1000) % 2 ? FFlightBlackboxEvent::Impact : FFlightBlackboxEvent::Damage;
+			Event.Location = State.Position;
+			Event.Normal = FFlightVec3(0.f, 0.f, 1.f);
+			Event.Value = 123.5f + i;
+			const size_t EventSize = Encoder.EncodeEvent(Event, Record);
+			Bytes.insert(Bytes.end(), Record, Record + EventSize);
+			Events.push_back(Event);
+		}
+	}
+
+	// Prediction keeps steady flight well under the raw 90+ bytes per frame
+	FLIGHT_CHECK(Bytes.size() < Frames.size() * 40);
+
+	auto Decode = [&](size_t Offset, size_t FirstFrame)
+	{
+		FFlightBlackboxDecoder Decoder;
+		const uint8_t* Cursor = Bytes.data() + Offset;
+		const uint8_t* End = Bytes.data() + Bytes.size();
+		FFlightBlackboxFrame Frame;
+		FFlightBlackboxEvent Event;
+		size_t NumFrames = 0, NumEvents = 0;
+		float MaxPositionError = 0.f, MaxRotationError = 0.f, MaxStickError = 0.f;
+		for (;;)
+		{
+			const EFlightBlackboxRecord Type = Decoder.Next(Cursor, End, Frame, Event);
+			if (Type == EFlightBlackboxRecord::None)
+			{
+				break;
+			}
+			if (Type == EFlightBlackboxRecord::Event)
+			{
+				const FFlightBlackboxEvent* Expected = nullptr;
+				for (const FFlightBlackboxEvent& Candidate : Events)
+				{
+					Expected = Candidate.Step == Event.Step ? &Candidate : Expected;
+				}
+				FLIGHT_CHECK(Expected && Expected->Type == Event.Type);
+				if (Expected)
+				{
+					FLIGHT_CHECK_NEAR(Event.Value, Expected->Value, 0.01);
+					FLIGHT_CHECK((Event.Location - Expected->Location).Size() < 0.01f);
+				}
+				++NumEvents;
+				continue;
+			}
+
+			const FFlightBlackboxFrame& Expected = Frames[FirstFrame + NumFrames++];
+			FLIGHT_CHECK(Frame.Step == Expected.Step);
+			FLIGHT_CHECK(Frame.Flags == Expected.Flags);
+			FLIGHT_CHECK_NEAR(Frame.Health, Expected.Health, 0.006);
+			MaxPositionError = std::max(MaxPositionError, (Frame.Position - Expected.Position).Size());
+			MaxRotationError = std::max(MaxRotationError, std::fabs(Frame.Rotation.W - Expected.Rotation.W));
+			for (int k = 0; k < 4; ++k)
+			{
+				MaxStickError = std::max(MaxStickError, std::fabs(Frame.Sticks[k] - Expected.Sticks[k]));
+				MaxStickError = std::max(MaxStickError, std::fabs(Frame.Commands[k] - Expected.Commands[k]));
+			}
+		}
+		FLIGHT_CHECK(Cursor == End);
+		FLIGHT_CHECK(NumFrames == Frames.size() - FirstFrame);
+		FLIGHT_CHECK(MaxPositionError < 0.01f);   // 1/100 cm
+		FLIGHT_CHECK(MaxRotationError < 2e-6f);   // 1e-6 per component
+		FLIGHT_CHECK(MaxStickError < 1e-4f);
+		return NumEvents;
+	};
+
+	FLIGHT_CHECK(Decode(0, 0) == Events.size());
+
+	// A reader joining at the forced keyframe picks up from there
+	FLIGHT_CHECK(Decode(ForcedKeyframeOffset, ForcedKeyframe) == Events.size() / 2);
+
+	// Values far outside the quantized range saturate instead of outgrowing a record
+	FFlightBlackboxEncoder Wild;
+	FFlightBlackboxFrame Huge;
+	for (int k = 0; k < 4; ++k)
+	{
+		Huge.Sticks[k] = Huge.Commands[k] = Huge.MotorThrust[k] = k % 2 ? 1e30f : -1e30f;
+	}
+	Huge.Rotation = FFlightQuat(-1e20f, 1e20f, -1e20f, 1e20f);
+	Huge.Velocity = FFlightVec3(1e30f, -1e30f, 1e30f);
+	Huge.Position = FFlightVec3(-1e30f, 1e30f, -1e30f);
+	Huge.Health = 1e30f;
+	Huge.Step = 0xFFFFFFF0u;
+	FFlightBlackboxFrame Opposite = Huge;
+	Opposite.Position = Huge.Position * -1.f;
+	Opposite.Velocity = Huge.Velocity * -1.f;
+	Opposite.Step = Huge.Step + 1;
+	for (const FFlightBlackboxFrame* Frame : { &Huge, &Opposite, &Huge })
+	{
+		FLIGHT_CHECK(Wild.EncodeFrame(*Frame, Record) <= FlightBlackboxMaxRecordBytes);
+	}
+	FFlightBlackboxEvent HugeEvent;
+	HugeEvent.Step = 0xFFFFFFFFu;
+	HugeEvent.Location = Huge.Position;
+	HugeEvent.Normal = Huge.Velocity;
+	HugeEvent.Value = -1e30f;
+	FLIGHT_CHECK(Wild.EncodeEvent(HugeEvent, Record) <= FlightBlackboxMaxRecordBytes);
+}
+
@@ -0,0 +1,52 @@
+// FlightCollisionTests.cpp
+//
+// Sweep and slide: bounce with the surface's restitution above BounceMinSpeed, a still rest
+// below it, and the sweep budget.
+
+#include "FlightTest.h"
+
+#include <algorithm>
+
+FLIGHT_TEST(Collision)
+{
+	FFlightParams Params;
+	Params.DragCoeff = 0.f;
+	FFlightGroundPlane Ground(0.f);
+	Ground.Restitution = 0.5f;
+
+	// Dropped from 5 m: the first hit bounces back up with half the impact speed
+	FFlightState State;
+	State.Position = FFlightVec3(0.f, 0.f, 500.f);
+	float FirstImpactSpeed = 0.f;
+	float ReboundSpeed = 0.f;
+	float MaxImpactSpeedAtRest = 0.f;
+	int MaxSweeps = 0;
+	for (int i = 0; i < 5000; ++i)
+	{
+		FFlightStepResult Result;
+		StepFlightModel(State, Params, FFlightInput(), FlightTestStep, &Ground, &Result);
+		MaxSweeps = std::max(MaxSweeps, Result.NumSweeps);
+		FLIGHT_CHECK(State.Position.Z >= Ground.Radius - 1e-3f);
+
+		if (Result.bContact && FirstImpactSpeed == 0.f)
+		{
+			FirstImpactSpeed = Result.ImpactSpeed;
+			ReboundSpeed = State.Velocity.Z;
+			FLIGHT_CHECK(Result.bOnGround);
+		}
+		if (i >= 4000 && Result.bContact)
+		{
+			MaxImpactSpeedAtRest = std::max(MaxImpactSpeedAtRest, Result.ImpactSpeed);
+		}
+	}
+
+	const float ExpectedImpact = std::sqrt(2.f * -Params.GravityZ * (500.f - Ground.Radius));
+	FLIGHT_CHECK_NEAR(FirstImpactSpeed, ExpectedImpact, ExpectedImpact * 0.01f);
+	FLIGHT_CHECK_NEAR(ReboundSpeed, FirstImpactSpeed * Ground.Restitution, FirstImpactSpeed * 0.02f);
+	FLIGHT_CHECK(MaxSweeps >= 1 && MaxSweeps <= Params.MaxSlideIterations);
+
+	// Settled: what's left are resting touches, too slow to bounce
+	FLIGHT_CHECK(MaxImpactSpeedAtRest > 0.f && MaxImpactSpeedAtRest < Params.BounceMinSpeed);
+	FLIGHT_CHECK_NEAR(State.Position.Z, Ground.Radius + Params.ContactOffset, 0.5);
+	FLIGHT_CHECK(State.Velocity.Z <= 0.f);
+}
@@ -0,0 +1,142 @@
+// FlightCoreBenchmark.cpp
+//
+// Headless counterpart of the Drone.Flight.Benchmark* console commands, plus the codecs:
+//   FlightCoreBenchmark [Steps=5000000] [Drones=64]
+
+#include "FlightBenchmark.h"
+#include "FlightBlackbox.h"
+#include "FlightGhost.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+	double SecondsSince(std::chrono::steady_clock::time_point Start)
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+	}
+
+	void RunCodecBenchmarks()
+	{
+		// One minute of scripted flight at 1 kHz, logged and ghosted the way the game does it
+		const FFlightParams Params;
+		FFlightGroundPlane Ground(0.f);
+		FFlightState State;
+		State.Position = FFlightVec3(0.f, 0.f, 100.f);
+
+		std::vector<FFlightBlackboxFrame> Frames;
+		FFlightGhostEncoder Ghost(30.f);
+		for (uint32_t i = 0; i < 60000; ++i)
+		{
+			const FFlightInput Input = MakeScriptedFlightInput(i * 0.001);
+			StepFlightModel(State, Params, Input, 0.001f, &Ground);
+
+			FFlightBlackboxFrame Frame;
+			Frame.Step = i;
+			Frame.Sticks[0] = Frame.Commands[0] = Input.Roll;
+			Frame.Sticks[1] = Frame.Commands[1] = Input.Pitch;
+			Frame.Sticks[2] = Frame.Commands[2] = Input.Yaw;
+			Frame.Sticks[3] = Frame.Commands[3] = Input.Throttle;
+			for (int k = 0; k < 4; ++k)
+			{
+				Frame.MotorThrust[k] = State.MotorThrust[k];
+			}
+			Frame.Rotation = State.Rotation;
+			Frame.Velocity = State.Velocity;
+			Frame.Position = State.Position;
+			Frame.Health = 100.f;
+			Frame.Flags = Input.bArmed ? FlightBlackboxFlag_Armed : 0;
+			Frames.push_back(Frame);
+
+			if (i % 33 == 0)
+			{
+				Ghost.Add({ State.Position, State.Rotation });
+			}
+		}
+
+		std::vector<uint8_t> Bytes(Frames.size() * FlightBlackboxMaxRecordBytes);
+		FFlightBlackboxEncoder Encoder;
+		auto Start = std::chrono::steady_clock::now();
+		size_t Size = 0;
+		for (const FFlightBlackboxFrame& Frame : Frames)
+		{
+			Size += Encoder.EncodeFrame(Frame, Bytes.data() + Size);
+		}
+		const double EncodeSeconds = SecondsSince(Start);
+
+		FFlightBlackboxDecoder Decoder;
+		const uint8_t* Cursor = Bytes.data();
+		FFlightBlackboxFrame Frame;
+		FFlightBlackboxEvent Event;
+		Start = std::chrono::steady_clock::now();
+		while (Decoder.Next(Cursor, Bytes.data() + Size, Frame, Event) != EFlightBlackboxRecord::None)
+		{
+		}
+		const double DecodeSeconds = SecondsSince(Start);
+
+		std::printf("Blackbox: %zu frames in %zu bytes (%.1f B/frame) | encode %.1f ns/frame | decode %.1f ns/frame\n",
+			Frames.size(), Size, (double)Size / Frames.size(), EncodeSeconds * 1e9 / Frames.size(), DecodeSeconds * 1e9 / Frames.size());
+
+		const std::vector<uint8_t> Blob = Ghost.Encode();
+		FFlightGhostTrack Track;
+		Track.Init(Blob.data(), Blob.size());
+
+		const int NumGhosts = 50;
+		std::vector<FFlightGhostTrack> Tracks(NumGhosts, Track);
+		std::vector<const FFlightGhostTrack*> TrackPointers;
+		for (const FFlightGhostTrack& Each : Tracks)
+		{
+			TrackPointers.push_back(&Each);
+		}
+		FFlightGhostPlayback Playback;
+		Playback.SetTracks(TrackPointers);
+		std::vector<FFlightGhostSample> Poses(NumGhosts);
+
+		int NumFrames = 0;
+		Start = std::chrono::steady_clock::now();
+		for (double Time = 0.0; Time < Track.GetDuration(); Time += 1.0 / 144.0, ++NumFrames)
+		{
+			Playback.Evaluate(Time, Poses.data());
+		}
+		std::printf("Ghost: %d samples in %zu bytes | %d ghosts %.2f us/frame, %lld chunk decodes over %d frames\n",
+			Track.GetNumSamples(), Blob.size(), NumGhosts, SecondsSince(Start) * 1e6 / NumFrames,
+			(long long)Playback.GetNumChunkDecodes(), NumFrames);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const int64_t Steps = argc > 1 ? std::max<int64_t>(std::atoll(argv[1]), 1) : 5000000;
+	const int NumDrones = argc > 2 ? std::max(std::atoi(argv[2]), 1) : 64;
+
+	const FFlightBenchmarkResult Flight = RunFlightBenchmark(Steps, 0.001f);
+	std::printf("Flight core: %lld steps @ 1000 Hz in %.3f s | %.2f M steps/s | %.1f ns/step | %lld contact steps | %.2f sweeps/step\n",
+		(long long)Flight.Steps, Flight.Seconds, Flight.StepsPerSecond / 1e6, Flight.NanosecondsPerStep,
+		(long long)Flight.Contacts, (double)Flight.Sweeps / std::max<int64_t>(Flight.Steps, 1));
+
+	const FFlightPidBenchmarkResult Pid = RunPidBenchmark(NumDrones, 8000.f, 5.0);
+	std::printf("Flight controller: %d drones @ %.0f Hz, %.1f s simulated in %.3f s | %.2fx realtime | %.2f M PID updates/s\n",
+		Pid.NumDrones, Pid.LoopRateHz, Pid.SimulatedSeconds, Pid.WallSeconds, Pid.RealtimeFactor, Pid.PidUpdatesPerSecond / 1e6);
+
+	std::printf("Integrator drift, 10 s per run:\n");
+	for (float RateHz : { 250.f, 1000.f })
+	{
+		for (int Scenario = 0; Scenario < 3; ++Scenario)
+		{
+			for (int Integrator = 0; Integrator < 4; ++Integrator)
+			{
+				const FFlightDriftResult Drift = RunIntegratorDriftBenchmark((EFlightIntegrator)Integrator, (EFlightDriftScenario)Scenario, RateHz, 10.0);
+				std::printf("  %5.0f Hz %-10s %-18s %7.1f ns/step | max error %9.4f cm | energy %.2e\n",
+					RateHz, GetFlightDriftScenarioName(Drift.Scenario), GetFlightIntegratorName(Drift.Integrator),
+					Drift.NanosecondsPerStep, Drift.MaxPositionError, Drift.MaxEnergyError);
+			}
+		}
+	}
+
+	RunCodecBenchmarks();
+	return 0;
+}
@@ -0,0 +1,63 @@
+// FlightCoreTests.cpp
+//
+// Runner for the FLIGHT_TEST cases in this directory:
+//   FlightCoreTests           every test
+//   FlightCoreTests <Name>    one test (CTest runs each this way)
+
+#include "FlightTest.h"
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	struct FFlightTest
+	{
+		const char* Name;
+		void (*Run)();
+	};
+
+	// Function-local so registration from other files' static initializers is safe
+	std::vector<FFlightTest>& GetFlightTests()
+	{
+		static std::vector<FFlightTest> Tests;
+		return Tests;
+	}
+
+	int GFailures = 0;
+}
+
+FFlightTestRegistrar::FFlightTestRegistrar(const char* Name, void (*Run)())
+{
+	GetFlightTests().push_back({ Name, Run });
+}
+
+void ReportFlightTestFailure(const char* File, int Line, const std::string& What)
+{
+	std::fprintf(stderr, "%s:%d: %s\n", File, Line, What.c_str());
+	++GFailures;
+}
+
+int main(int argc, char** argv)
+{
+	int NumRun = 0;
+	for (const FFlightTest& Test : GetFlightTests())
+	{
+		if (argc > 1 && std::strcmp(argv[1], Test.Name) != 0)
+		{
+			continue;
+		}
+
+		const int FailuresBefore = GFailures;
+		Test.Run();
+		std::printf("%-12s %s\n", Test.Name, GFailures == FailuresBefore ? "passed" : "FAILED");
+		++NumRun;
+	}
+
+	if (NumRun == 0)
+	{
+		std::fprintf(stderr, "No test named %s\n", argc > 1 ? argv[1] : "");
+		return 2;
+	}
+	return GFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+// FlightGhostTests.cpp
+//
+// Ghost laps: the compressed track stays within its quantization, playback passes through the
+// samples and decodes each shared chunk about once, and garbage is refused.
+
+#include "FlightTest.h"
+#include "FlightBenchmark.h"
+#include "FlightGhost.h"
+
+#include <algorithm>
+#include <vector>
+
+static float RotationErrorDegrees(const FFlightQuat& A, const FFlightQuat& B)
+{
+	const float Dot = std::fabs(A.X * B.X + A.Y * B.Y + A.Z * B.Z + A.W * B.W);
+	return 2.f * std::acos(std::min(Dot, 1.f)) / FlightDegToRad;
+}
+
+FLIGHT_TEST(Ghost)
+{
+	// 60 s of scripted flight sampled at 30 Hz
+	const FFlightParams Params;
+	FFlightGroundPlane Ground(0.f);
+	FFlightState State = MakeFlightTestStartState();
+
+	FFlightGhostEncoder Encoder(30.f);
+	std::vector<FFlightGhostSample> Samples;
+	for (int i = 0; i < 60000; ++i)
+	{
+		StepFlightModel(State, Params, MakeScriptedFlightInput(i * (double)FlightTestStep), FlightTestStep, &Ground);
+		if (i % 33 == 0)
+		{
+			const FFlightGhostSample Sample = { State.Position, State.Rotation };
+			Encoder.Add(Sample);
+			Samples.push_back(Sample);
+		}
+	}
+	FLIGHT_CHECK(Encoder.GetNumSamples() == (int)Samples.size());
+
+	const std::vector<uint8_t> Blob = Encoder.Encode();
+	FLIGHT_CHECK(Blob.size() < Samples.size() * 8);   // vs 28 bytes raw
+
+	FFlightGhostTrack Track;
+	FLIGHT_CHECK(Track.Init(Blob.data(), Blob.size()));
+	FLIGHT_CHECK(Track.GetNumSamples() == (int)Samples.size());
+	FLIGHT_CHECK(Track.GetSampleRate() == 30.f);
+	FLIGHT_CHECK(Track.GetNumChunks() == ((int)Samples.size() + FFlightGhostEncoder::ChunkSize - 1) / FFlightGhostEncoder::ChunkSize);
+
+	// Every sample back within the quantization step
+	std::vector<FFlightGhostSample> Decoded;
+	FFlightGhostSample Chunk[FFlightGhostEncoder::ChunkSize];
+	for (int i = 0; i < Track.GetNumChunks(); ++i)
+	{
+		const int Num = Track.DecodeChunk(i, Chunk);
+		Decoded.insert(Decoded.end(), Chunk, Chunk + Num);
+	}
+	FLIGHT_CHECK(Decoded.size() == Samples.size());
+	float MaxPositionError = 0.f, MaxRotationError = 0.f;
+	for (size_t i = 0; i < std::min(Decoded.size(), Samples.size()); ++i)
+	{
+		MaxPositionError = std::max(MaxPositionError, (Decoded[i].Position - Samples[i].Position).Size());
+		MaxRotationError = std::max(MaxRotationError, RotationErrorDegrees(Decoded[i].Rotation, Samples[i].Rotation));
+	}
+	FLIGHT_CHECK(MaxPositionError < 0.9f);    // half a cm per axis
+	FLIGHT_CHECK(MaxRotationError < 0.1f);
+
+	// Playback passes through the samples and holds the ends
+	std::vector<FFlightGhostTrack> Tracks(3, Track);
+	FFlightGhostPlayback Playback;
+	Playback.SetTracks({ &Tracks[0], &Tracks[1], &Tracks[2] });
+	FFlightGhostSample Out[3];
+	for (int i : { 0, 1, 63, 64, 65, 500, (int)Decoded.size() - 1 })
+	{
+		Playback.Evaluate(i / 30.0, Out);
+		for (const FFlightGhostSample& Pose : Out)
+		{
+			FLIGHT_CHECK((Pose.Position - Decoded[i].Position).Size() < 0.01f);
+			FLIGHT_CHECK(RotationErrorDegrees(Pose.Rotation, Decoded[i].Rotation) < 0.05f);
+		}
+	}
+	Playback.Evaluate(-5.0, Out);
+	FLIGHT_CHECK((Out[0].Position - Decoded.front().Position).Size() < 0.01f);
+	Playback.Evaluate(Track.GetDuration() + 5.0, Out);
+	FLIGHT_CHECK((Out[2].Position - Decoded.back().Position).Size() < 0.01f);
+
+	// Between samples the spline stays near the flown path
+	Playback.Evaluate(10.5 / 30.0, Out);
+	const FFlightVec3 Mid = (Decoded[10].Position + Decoded[11].Position) * 0.5f;
+	FLIGHT_CHECK((Out[0].Position - Mid).Size() < (Decoded[11].Position - Decoded[10].Position).Size());
+
+	// A forward pass decodes each chunk about once, however many ghosts share it
+	FFlightGhostPlayback Fresh;
+	Fresh.SetTracks({ &Tracks[0], &Tracks[1], &Tracks[2] });
+	for (double Time = 0.0; Time < Track.GetDuration(); Time += 1.0 / 144.0)
+	{
+		Fresh.Evaluate(Time, Out);
+	}
+	FLIGHT_CHECK(Fresh.GetNumChunkDecodes() <= 3 * (Track.GetNumChunks() + 1));
+
+	// Garbage is refused
+	FFlightGhostTrack Bad;
+	std::vector<uint8_t> Corrupt = Blob;
+	Corrupt[0] ^= 0xFF;
+	FLIGHT_CHECK(!Bad.Init(Corrupt.data(), Corrupt.size()));
+	FLIGHT_CHECK(!Bad.Init(Blob.data(), 8));
+}
+
@@ -0,0 +1,157 @@
+// FlightInputLogTests.cpp
+//
+// Deterministic replay: per-step checksums of a logged flight, and the input-log codec round
+// trip that the engine-side FDroneInputLog saves through.
+
+#include "FlightTest.h"
+#include "FlightBenchmark.h"
+#include "FlightDeterminism.h"
+#include "FlightInputLog.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+static FFlightInputLogSample MakeTestSample(int64_t Step)
+{
+	const FFlightInput Input = MakeScriptedFlightInput(Step * (double)FlightTestStep);
+	FFlightInputLogSample Sample;
+	Sample.Time = Step * (double)FlightTestStep;
+	Sample.Sticks[FlightAxis::Roll] = Input.Roll;
+	Sample.Sticks[FlightAxis::Pitch] = Input.Pitch;
+	Sample.Sticks[FlightAxis::Yaw] = Input.Yaw;
+	Sample.Sticks[3] = Input.Throttle;
+	Sample.bArmed = Input.bArmed;
+	return Sample;
+}
+
+static FFlightInput ToFlightInput(const FFlightInputLogSample& Sample)
+{
+	FFlightInput Input;
+	Input.Roll = Sample.Sticks[FlightAxis::Roll];
+	Input.Pitch = Sample.Sticks[FlightAxis::Pitch];
+	Input.Yaw = Sample.Sticks[FlightAxis::Yaw];
+	Input.Throttle = Sample.Sticks[3];
+	Input.bArmed = Sample.bArmed;
+	return Input;
+}
+
+/** Runs the samples from the log's start state over a ground plane, one checksum per step. */
+static std::vector<uint32_t> RunLoggedFlight(const FFlightInputLogData& Log, FFlightState* OutFinal = nullptr)
+{
+	FFlightFloatEnvironment FloatEnvironment;
+	const FFlightParams Params;
+	FFlightGroundPlane Ground(0.f);
+
+	FFlightState State = Log.InitialState;
+	uint32_t Checksum = FlightChecksumSeed;
+	std::vector<uint32_t> Checksums;
+	Checksums.reserve(Log.Samples.size());
+	for (const FFlightInputLogSample& Sample : Log.Samples)
+	{
+		StepFlightModel(State, Params, ToFlightInput(Sample), Log.StepSeconds, &Ground);
+		Checksum = HashFlightState(State, Checksum);
+		Checksums.push_back(Checksum);
+	}
+	if (OutFinal)
+	{
+		*OutFinal = State;
+	}
+	return Checksums;
+}
+
+static FFlightInputLogData MakeTestInputLog(int NumSteps)
+{
+	FFlightInputLogData Log;
+	Log.StepSeconds = FlightTestStep;
+	Log.FirstStep = 42;
+	Log.InitialState = MakeFlightTestStartState();
+	for (int i = 0; i < NumSteps; ++i)
+	{
+		Log.Samples.push_back(MakeTestSample(i));
+	}
+	Log.Checksums = RunLoggedFlight(Log);
+	return Log;
+}
+
+FLIGHT_TEST(Determinism)
+{
+	const FFlightInputLogData Log = MakeTestInputLog(20000);
+
+	// Same inputs, same bits, step by step
+	FFlightState FinalA, FinalB;
+	const std::vector<uint32_t> RunA = RunLoggedFlight(Log, &FinalA);
+	const std::vector<uint32_t> RunB = RunLoggedFlight(Log, &FinalB);
+	FLIGHT_CHECK(RunA == RunB);
+	FLIGHT_CHECK(HashFlightState(FinalA) == HashFlightState(FinalB));
+	FLIGHT_CHECK(std::memcmp(&FinalA.Position, &FinalB.Position, sizeof(FFlightVec3)) == 0);
+
+	// The drone actually went somewhere, touching the ground on the way
+	FLIGHT_CHECK((FinalA.Position - Log.InitialState.Position).Size() > 100.f);
+
+	// One changed sample changes every checksum from that step on, and none before it
+	FFlightInputLogData Changed = Log;
+	const size_t ChangedStep = 12345;
+	Changed.Samples[ChangedStep].Sticks[FlightAxis::Roll] += 0.01f;
+	const std::vector<uint32_t> RunC = RunLoggedFlight(Changed);
+	FLIGHT_CHECK(std::equal(RunA.begin(), RunA.begin() + ChangedStep, RunC.begin()));
+	FLIGHT_CHECK(RunA[ChangedStep] != RunC[ChangedStep]);
+	FLIGHT_CHECK(RunA.back() != RunC.back());
+
+	// The hash covers every field, including the controller state
+	FFlightState State = FinalA;
+	const uint32_t Base = HashFlightState(State);
+	State.Pid.ITerm.Z = std::nextafter(State.Pid.ITerm.Z, 1e9f);
+	FLIGHT_CHECK(HashFlightState(State) != Base);
+	State = FinalA;
+	State.Pid.bSaturated = !State.Pid.bSaturated;
+	FLIGHT_CHECK(HashFlightState(State) != Base);
+}
+
+
+FLIGHT_TEST(InputLog)
+{
+	const FFlightInputLogData Log = MakeTestInputLog(2000);
+	const std::vector<uint8_t> Bytes = EncodeFlightInputLog(Log);
+
+	// Header, 36 state floats + bSaturated, 25 bytes per sample, 4 per checksum
+	FLIGHT_CHECK(Bytes.size() == 4 + 2 + 4 + 8 + 36 * 4 + 1 + 4 + Log.Samples.size() * 25 + 4 + Log.Checksums.size() * 4);
+
+	FFlightInputLogData Loaded;
+	FLIGHT_CHECK(DecodeFlightInputLog(Bytes.data(), Bytes.size(), Loaded));
+	FLIGHT_CHECK(Loaded.StepSeconds == Log.StepSeconds);
+	FLIGHT_CHECK(Loaded.FirstStep == Log.FirstStep);
+	FLIGHT_CHECK(HashFlightState(Loaded.InitialState) == HashFlightState(Log.InitialState));
+	FLIGHT_CHECK(Loaded.Checksums == Log.Checksums);
+	FLIGHT_CHECK(Loaded.Samples.size() == Log.Samples.size());
+	for (size_t i = 0; i < std::min(Loaded.Samples.size(), Log.Samples.size()); ++i)
+	{
+		const FFlightInputLogSample& A = Log.Samples[i];
+		const FFlightInputLogSample& B = Loaded.Samples[i];
+		if (A.Time != B.Time || std::memcmp(A.Sticks, B.Sticks, sizeof(A.Sticks)) != 0 || A.bArmed != B.bArmed)
+		{
+			FLIGHT_CHECK(!"sample differs after the round trip");
+			break;
+		}
+	}
+
+	// A replay of the loaded log reproduces the recorded checksums
+	FLIGHT_CHECK(RunLoggedFlight(Loaded) == Log.Checksums);
+
+	// Encoding is stable
+	FLIGHT_CHECK(EncodeFlightInputLog(Loaded) == Bytes);
+
+	// Damaged files are refused, not half-read
+	FFlightInputLogData Untouched;
+	Untouched.StepSeconds = 123.f;
+	FLIGHT_CHECK(!DecodeFlightInputLog(Bytes.data(), Bytes.size() - 1, Untouched));
+	FLIGHT_CHECK(!DecodeFlightInputLog(Bytes.data(), 10, Untouched));
+	std::vector<uint8_t> BadMagic = Bytes;
+	BadMagic[0] ^= 0xFF;
+	FLIGHT_CHECK(!DecodeFlightInputLog(BadMagic.data(), BadMagic.size(), Untouched));
+	std::vector<uint8_t> NewerVersion = Bytes;
+	NewerVersion[4] = (uint8_t)(FlightInputLogVersion + 1);
+	FLIGHT_CHECK(!DecodeFlightInputLog(NewerVersion.data(), NewerVersion.size(), Untouched));
+	FLIGHT_CHECK(Untouched.StepSeconds == 123.f);
+}
+
@@ -0,0 +1,62 @@
+// FlightIntegratorTests.cpp
+//
+// Translation integrators: accuracy under constant acceleration, energy on a spring and the
+// orbit drift benchmark.
+
+#include "FlightTest.h"
+#include "FlightBenchmark.h"
+#include "FlightIntegrator.h"
+
+FLIGHT_TEST(Integrators)
+{
+	const EFlightIntegrator All[] =
+	{
+		EFlightIntegrator::ExplicitEuler, EFlightIntegrator::SemiImplicitEuler, EFlightIntegrator::Verlet, EFlightIntegrator::RK4
+	};
+
+	// Constant acceleration for 1 s at 1 kHz: the first-order methods are off by a * t * dt / 2
+	const float Dt = 0.001f;
+	const FFlightVec3 Gravity(0.f, 0.f, -980.f);
+	for (EFlightIntegrator Integrator : All)
+	{
+		FFlightVec3 Position, Velocity(100.f, 0.f, 0.f);
+		for (int i = 0; i < 1000; ++i)
+		{
+			IntegrateFlightTranslation(Integrator, Position, Velocity, Dt, [&Gravity](const FFlightVec3&, const FFlightVec3&) { return Gravity; });
+		}
+		FLIGHT_CHECK_NEAR(Velocity.Z, -980.f, 0.01);
+		FLIGHT_CHECK_NEAR(Position.X, 100.f, 0.01);
+
+		const bool bSecondOrder = Integrator == EFlightIntegrator::Verlet || Integrator == EFlightIntegrator::RK4;
+		const float Expected = Integrator == EFlightIntegrator::ExplicitEuler ? -490.f + 0.49f
+			: Integrator == EFlightIntegrator::SemiImplicitEuler ? -490.f - 0.49f
+			: -490.f;
+		FLIGHT_CHECK_NEAR(Position.Z, Expected, bSecondOrder ? 0.02 : 0.03);
+	}
+
+	// Spring: explicit Euler gains energy, the symplectic and higher-order methods hold it
+	auto SpringEnergy = [](EFlightIntegrator Integrator)
+	{
+		const float K = 400.f; // (2 pi / ~0.31 s)^2
+		FFlightVec3 Position(10.f, 0.f, 0.f), Velocity;
+		for (int i = 0; i < 10000; ++i)
+		{
+			IntegrateFlightTranslation(Integrator, Position, Velocity, 0.001f, [K](const FFlightVec3& X, const FFlightVec3&) { return X * -K; });
+		}
+		return 0.5f * Velocity.SizeSquared() + 0.5f * K * Position.SizeSquared();
+	};
+	const float Energy0 = 0.5f * 400.f * 100.f;
+	FLIGHT_CHECK(SpringEnergy(EFlightIntegrator::ExplicitEuler) > Energy0 * 1.5f);
+	FLIGHT_CHECK_NEAR(SpringEnergy(EFlightIntegrator::SemiImplicitEuler) / Energy0, 1.0, 0.01);
+	FLIGHT_CHECK_NEAR(SpringEnergy(EFlightIntegrator::Verlet) / Energy0, 1.0, 0.001);
+	FLIGHT_CHECK_NEAR(SpringEnergy(EFlightIntegrator::RK4) / Energy0, 1.0, 0.001);
+
+	// The drift benchmark agrees: explicit Euler doesn't keep an orbit, RK4 does
+	const FFlightDriftResult Explicit = RunIntegratorDriftBenchmark(EFlightIntegrator::ExplicitEuler, EFlightDriftScenario::Orbit, 250.f, 10.0);
+	const FFlightDriftResult SemiImplicit = RunIntegratorDriftBenchmark(EFlightIntegrator::SemiImplicitEuler, EFlightDriftScenario::Orbit, 250.f, 10.0);
+	const FFlightDriftResult Rk4 = RunIntegratorDriftBenchmark(EFlightIntegrator::RK4, EFlightDriftScenario::Orbit, 250.f, 10.0);
+	FLIGHT_CHECK(Explicit.MaxEnergyError > 0.1);
+	FLIGHT_CHECK(SemiImplicit.MaxEnergyError < 1e-3);
+	FLIGHT_CHECK(Rk4.MaxEnergyError < 1e-4);
+	FLIGHT_CHECK(Rk4.FinalPositionError < SemiImplicit.FinalPositionError);
+}
@@ -0,0 +1,75 @@
+// FlightModelTests.cpp
+//
+// StepFlightModel: gravity and thrust, landing on the ground plane, and repeatability.
+
+#include "FlightTest.h"
+#include "FlightBenchmark.h"
+
+#include <algorithm>
+#include <cstring>
+
+FLIGHT_TEST(Model)
+{
+	// Disarmed without drag: one second of free fall
+	{
+		FFlightParams Params;
+		Params.DragCoeff = 0.f;
+		FFlightState State = MakeFlightTestStartState();
+		const float StartZ = State.Position.Z;
+		for (int i = 0; i < 1000; ++i)
+		{
+			StepFlightModel(State, Params, FFlightInput(), FlightTestStep, nullptr);
+		}
+		FLIGHT_CHECK_NEAR(State.Velocity.Z, Params.GravityZ, 0.01);
+		FLIGHT_CHECK_NEAR(State.Position.Z - StartZ, 0.5f * Params.GravityZ, 1.0);
+		FLIGHT_CHECK_NEAR(State.Position.X, 1000.f, 1e-3);
+	}
+
+	// Thrust curve: nothing at zero throttle, 1 g at hover, MaxThrustG at full
+	{
+		const FFlightParams Params;
+		FLIGHT_CHECK_NEAR(ComputeFlightUpAccel(0.f, Params), 0.f, 1e-3);
+		FLIGHT_CHECK_NEAR(ComputeFlightUpAccel(Params.HoverThrottle, Params), -Params.GravityZ, 1e-3);
+		FLIGHT_CHECK_NEAR(ComputeFlightUpAccel(1.f, Params), -Params.GravityZ * Params.MaxThrustG, 1e-2);
+		float Prev = -1.f;
+		for (int i = 0; i <= 100; ++i)
+		{
+			const float Accel = ComputeFlightUpAccel(i / 100.f, Params);
+			FLIGHT_CHECK(Accel >= Prev);
+			Prev = Accel;
+		}
+	}
+
+	// Dropped onto the ground plane: comes to rest on it, never below it
+	{
+		const FFlightParams Params;
+		FFlightGroundPlane Ground(0.f);
+		FFlightState State = MakeFlightTestStartState();
+		float LowestZ = State.Position.Z;
+		bool bTouched = false;
+		for (int i = 0; i < 3000; ++i)
+		{
+			FFlightStepResult Result;
+			StepFlightModel(State, Params, FFlightInput(), FlightTestStep, &Ground, &Result);
+			LowestZ = std::min(LowestZ, State.Position.Z);
+			bTouched |= Result.bContact;
+		}
+		FLIGHT_CHECK(bTouched);
+		FLIGHT_CHECK(LowestZ >= Ground.Radius - 1e-3f);
+		FLIGHT_CHECK_NEAR(State.Position.Z, Ground.Radius + Params.ContactOffset, 0.5);
+		// Resting is a slow fall through the ContactOffset gap and a stop, so only a small speed is left
+		FLIGHT_CHECK(std::fabs(State.Velocity.X) + std::fabs(State.Velocity.Y) < 0.1f);
+		FLIGHT_CHECK(State.Velocity.Z <= 0.f && State.Velocity.Z > -20.f);
+	}
+
+	// Same script, same bits
+	{
+		const FFlightBenchmarkResult A = RunFlightBenchmark(20000);
+		const FFlightBenchmarkResult B = RunFlightBenchmark(20000);
+		FLIGHT_CHECK(A.Steps == 20000);
+		FLIGHT_CHECK(std::memcmp(&A.FinalState.Position, &B.FinalState.Position, sizeof(FFlightVec3)) == 0);
+		FLIGHT_CHECK(std::memcmp(&A.FinalState.Velocity, &B.FinalState.Velocity, sizeof(FFlightVec3)) == 0);
+		FLIGHT_CHECK(std::memcmp(&A.FinalState.Rotation, &B.FinalState.Rotation, sizeof(FFlightQuat)) == 0);
+		FLIGHT_CHECK(A.FinalState.Position.Z > 0.f);
+	}
+}
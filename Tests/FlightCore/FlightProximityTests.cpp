@@ -0,0 +1,74 @@
+// FlightProximityTests.cpp
+//
+// Clearance field: never more than the true distance to geometry, and sweeps skipped only
+// where they can't hit anything.
+
+#include "FlightTest.h"
+#include "FlightProximity.h"
+
+#include <algorithm>
+
+namespace
+{
+	/** Distance from P to an axis-aligned box. */
+	float DistanceToBox(const FFlightVec3& P, const FFlightVec3& BoxMin, const FFlightVec3& BoxMax)
+	{
+		const FFlightVec3 Outside(
+			std::max(std::max(BoxMin.X - P.X, P.X - BoxMax.X), 0.f),
+			std::max(std::max(BoxMin.Y - P.Y, P.Y - BoxMax.Y), 0.f),
+			std::max(std::max(BoxMin.Z - P.Z, P.Z - BoxMax.Z), 0.f));
+		return Outside.Size();
+	}
+}
+
+FLIGHT_TEST(Proximity)
+{
+	// 20 m cube of 1 m cells, one blocked cell in the middle
+	const float CellSize = 100.f;
+	FFlightProximityField Field;
+	Field.Init(FFlightVec3(), CellSize, 20, 20, 20);
+	FLIGHT_CHECK(Field.GetClearance(FFlightVec3(500.f, 500.f, 500.f)) == 0.f);   // not built yet
+	Field.SetBlocked(10, 10, 10);
+	Field.SetBlocked(10, 10, 10);
+	Field.SetBlocked(-1, 0, 0);
+	FLIGHT_CHECK(Field.GetNumBlocked() == 1);
+	Field.Build();
+	FLIGHT_CHECK(Field.IsBuilt());
+
+	const FFlightVec3 BoxMin(1000.f, 1000.f, 1000.f), BoxMax(1100.f, 1100.f, 1100.f);
+
+	// Conservative everywhere, and still useful a few cells away
+	int Checked = 0;
+	for (float X = 17.f; X < 2000.f; X += 61.f)
+	{
+		for (float Y = 23.f; Y < 2000.f; Y += 67.f)
+		{
+			for (float Z = 29.f; Z < 2000.f; Z += 71.f)
+			{
+				const FFlightVec3 P(X, Y, Z);
+				const float Edge = std::min({ X, Y, Z, 2000.f - X, 2000.f - Y, 2000.f - Z });
+				const float Clearance = Field.GetClearance(P);
+				FLIGHT_CHECK(Clearance <= DistanceToBox(P, BoxMin, BoxMax) + 1e-3f);
+				FLIGHT_CHECK(Clearance <= Edge + 1e-3f);
+				++Checked;
+			}
+		}
+	}
+	FLIGHT_CHECK(Checked > 1000);
+	FLIGHT_CHECK(Field.GetClearance(FFlightVec3(500.f, 1050.f, 1050.f)) > 200.f);
+	FLIGHT_CHECK(Field.GetClearance(FFlightVec3(1050.f, 1050.f, 1050.f)) == 0.f);
+	FLIGHT_CHECK(Field.GetClearance(FFlightVec3(-10.f, 500.f, 500.f)) == 0.f);
+
+	// Sweeps: a short hop in open air is skipped, one into the box is cut short before it
+	const float BodyRadius = 10.f;
+	const FFlightVec3 Start(500.f, 1050.f, 1050.f);
+	FLIGHT_CHECK(ComputeFreeSweepFraction(Field, Start, FFlightVec3(5.f, 0.f, 0.f), BodyRadius) == 1.f);
+
+	const FFlightVec3 Delta(600.f, 0.f, 0.f);
+	const float Fraction = ComputeFreeSweepFraction(Field, Start, Delta, BodyRadius);
+	FLIGHT_CHECK(Fraction > 0.f && Fraction < 1.f);
+	FLIGHT_CHECK(DistanceToBox(Start + Delta * Fraction, BoxMin, BoxMax) >= BodyRadius);
+
+	// Next to the box nothing can be skipped
+	FLIGHT_CHECK(ComputeFreeSweepFraction(Field, FFlightVec3(985.f, 1050.f, 1050.f), Delta, BodyRadius) == 0.f);
+}
@@ -0,0 +1,100 @@
+// FlightRatesTests.cpp
+//
+// Rate curves: the three models, the baked lookup table and Betaflight CLI import.
+
+#include "FlightTest.h"
+#include "FlightRates.h"
+
+#include <algorithm>
+#include <string>
+
+FLIGHT_TEST(Rates)
+{
+	// Betaflight defaults: 1.00 / 0.70 / 0 -> 200 / (1 - 0.7) at full stick
+	FFlightAxisRates Betaflight;
+	FLIGHT_CHECK_NEAR(EvaluateFlightRate(Betaflight, 1.f), 200.f / 0.3f, 0.01);
+	FLIGHT_CHECK_NEAR(EvaluateFlightRate(Betaflight, 0.f), 0.f, 1e-6);
+	FLIGHT_CHECK_NEAR(EvaluateFlightRate(Betaflight, 0.5f), 100.f / 0.65f, 0.01);
+
+	// Actual: center sensitivity, max rate at full stick
+	FFlightAxisRates Actual;
+	Actual.Type = EFlightRatesType::Actual;
+	Actual.RcRate = 70.f;
+	Actual.SuperRate = 670.f;
+	Actual.Expo = 0.54f;
+	FLIGHT_CHECK_NEAR(EvaluateFlightRate(Actual, 1.f), 670.f, 0.01);
+	FLIGHT_CHECK_NEAR(EvaluateFlightRate(Actual, 1e-4f) / 1e-4f, 70.f, 0.1);
+
+	// Quick: RcRate x 200 at center, max rate at full stick
+	FFlightAxisRates Quick;
+	Quick.Type = EFlightRatesType::Quick;
+	Quick.RcRate = 1.f;
+	Quick.SuperRate = 670.f;
+	FLIGHT_CHECK_NEAR(EvaluateFlightRate(Quick, 1.f), 670.f, 0.01);
+	FLIGHT_CHECK_NEAR(EvaluateFlightRate(Quick, 0.001f) / 0.001f, 200.f, 0.5);
+
+	// Every model is odd and monotonic; the rate limit caps all of them
+	FFlightAxisRates Wild;
+	Wild.RcRate = 2.5f;
+	Wild.SuperRate = 0.9f;
+	FLIGHT_CHECK_NEAR(EvaluateFlightRate(Wild, 1.f), Wild.RateLimit, 0.01);
+	for (const FFlightAxisRates* Rates : { &Betaflight, &Actual, &Quick, &Wild })
+	{
+		float Prev = -1.f;
+		for (int i = 0; i <= 100; ++i)
+		{
+			const float Stick = i / 100.f;
+			const float Rate = EvaluateFlightRate(*Rates, Stick);
+			FLIGHT_CHECK(Rate >= Prev);
+			FLIGHT_CHECK(EvaluateFlightRate(*Rates, -Stick) == -Rate);
+			Prev = Rate;
+		}
+	}
+
+	// The baked table follows the exact curve
+	const FFlightAxisRates Axes[FlightAxis::Num] = { Betaflight, Actual, Quick };
+	FFlightRateTable Table;
+	Table.Build(Axes);
+	for (int Axis = 0; Axis < FlightAxis::Num; ++Axis)
+	{
+		float MaxError = 0.f;
+		for (int i = -1000; i <= 1000; ++i)
+		{
+			const float Stick = i / 1000.f;
+			MaxError = std::max(MaxError, std::fabs(Table.Lookup(Axis, Stick) - EvaluateFlightRate(Axes[Axis], Stick)));
+		}
+		FLIGHT_CHECK(MaxError < 0.1f);
+		FLIGHT_CHECK(Table.GetAxisRates(Axis) == Axes[Axis]);
+	}
+	FLIGHT_CHECK(Table.Lookup(0, 2.f) == Table.Lookup(0, 1.f));
+
+	// CLI import: the last "rateprofile N" selects the profile, missing axes keep their value
+	const std::string Dump =
+		"# dump\n"
+		"rateprofile 0\n"
+		"set rates_type = ACTUAL\n"
+		"set roll_rc_rate = 7\n"
+		"set pitch_rc_rate = 7\n"
+		"set roll_expo = 54\n"
+		"set roll_srate = 67\n"
+		"set pitch_srate = 67\n"
+		"set yaw_srate = 50\n"
+		"rateprofile 1\n"
+		"set rates_type = BETAFLIGHT\n"
+		"set roll_rc_rate = 100\n"
+		"rateprofile 0\n";
+	FFlightAxisRates Parsed[FlightAxis::Num];
+	Parsed[FlightAxis::Yaw].RcRate = 33.f;
+	std::string Error;
+	FLIGHT_CHECK(ParseBetaflightRates(Dump, Parsed, Error));
+	FLIGHT_CHECK(Parsed[FlightAxis::Roll].Type == EFlightRatesType::Actual);
+	FLIGHT_CHECK_NEAR(Parsed[FlightAxis::Roll].RcRate, 70.f, 1e-3);
+	FLIGHT_CHECK_NEAR(Parsed[FlightAxis::Roll].SuperRate, 670.f, 1e-3);
+	FLIGHT_CHECK_NEAR(Parsed[FlightAxis::Roll].Expo, 0.54f, 1e-5);
+	FLIGHT_CHECK_NEAR(Parsed[FlightAxis::Yaw].SuperRate, 500.f, 1e-3);
+	FLIGHT_CHECK_NEAR(Parsed[FlightAxis::Yaw].RcRate, 33.f, 1e-5);
+
+	FFlightAxisRates Unchanged[FlightAxis::Num];
+	FLIGHT_CHECK(!ParseBetaflightRates("# nothing here\nset gyro_lpf1_static_hz = 250\n", Unchanged, Error));
+	FLIGHT_CHECK(!Error.empty());
+}
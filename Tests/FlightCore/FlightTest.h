@@ -0,0 +1,50 @@
+// FlightTest.h
+//
+// Minimal test harness for the engine-free flight core. No framework: a test is a function
+// registered with FLIGHT_TEST that reports failed checks; FlightCoreTests runs all of them,
+// or one by name (that's how CTest calls them).
+
+#pragma once
+
+#include "FlightModel.h"
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+void ReportFlightTestFailure(const char* File, int Line, const std::string& What);
+
+struct FFlightTestRegistrar
+{
+	FFlightTestRegistrar(const char* Name, void (*Run)());
+};
+
+#define FLIGHT_TEST(Name) \
+	static void FlightTest_##Name(); \
+	static const FFlightTestRegistrar FlightTestRegistrar_##Name(#Name, &FlightTest_##Name); \
+	static void FlightTest_##Name()
+
+#define FLIGHT_CHECK(Cond) \
+	do { if (!(Cond)) { ReportFlightTestFailure(__FILE__, __LINE__, "CHECK(" #Cond ")"); } } while (0)
+
+#define FLIGHT_CHECK_NEAR(A, B, Tolerance) \
+	do \
+	{ \
+		const double CheckA = (double)(A), CheckB = (double)(B); \
+		if (!(std::fabs(CheckA - CheckB) <= (double)(Tolerance))) \
+		{ \
+			char CheckText[256]; \
+			std::snprintf(CheckText, sizeof(CheckText), "CHECK_NEAR(" #A ", " #B ") %.9g vs %.9g, tolerance %.3g", CheckA, CheckB, (double)(Tolerance)); \
+			ReportFlightTestFailure(__FILE__, __LINE__, CheckText); \
+		} \
+	} while (0)
+
+// Shared setup
+constexpr float FlightTestStep = 0.001f;
+
+inline FFlightState MakeFlightTestStartState()
+{
+	FFlightState State;
+	State.Position = FFlightVec3(1000.f, -500.f, 100.f);
+	return State;
+}
@@ -0,0 +1,88 @@
+// FlightWindTests.cpp
+//
+// Airspeed-based drag and the baked wind field: quadratic terminal velocity, sampling, wakes,
+// and a drifting drone picking up the wind.
+
+#include "FlightTest.h"
+#include "FlightWind.h"
+
+FLIGHT_TEST(Drag)
+{
+	// Level free fall with quadratic drag only: terminal speed sqrt(2 m g / (rho CdA_top))
+	FFlightParams Params;
+	Params.DragCoeff = 0.f;
+	Params.DragArea = FFlightVec3(90.f, 110.f, 250.f);
+	FFlightState State = MakeFlightTestStartState();
+	State.Position.Z = 1e6f;
+	for (int i = 0; i < 20000; ++i)
+	{
+		StepFlightModel(State, Params, FFlightInput(), FlightTestStep, nullptr);
+	}
+	const float Terminal = std::sqrt(2.f * Params.Mass * -Params.GravityZ / (Params.AirDensity * Params.DragArea.Z));
+	FLIGHT_CHECK_NEAR(-State.Velocity.Z, Terminal, Terminal * 0.01f);
+	FLIGHT_CHECK_NEAR(State.Velocity.X, 0.f, 1e-3);
+
+	// Without any drag it keeps accelerating
+	Params.DragArea = FFlightVec3();
+	FFlightState NoDrag = MakeFlightTestStartState();
+	for (int i = 0; i < 3000; ++i)
+	{
+		StepFlightModel(NoDrag, Params, FFlightInput(), FlightTestStep, nullptr);
+	}
+	FLIGHT_CHECK(-NoDrag.Velocity.Z > Terminal);
+}
+
+FLIGHT_TEST(Wind)
+{
+	// 40 x 10 x 10 cells of 2 m, steady 5 m/s along +X, a pillar of blocked cells at X = 10
+	const FFlightVec3 MeanWind(500.f, 0.f, 0.f);
+	const FFlightVec3 Outside(100.f, 0.f, 0.f);
+	FFlightWindField Field;
+	Field.Init(FFlightVec3(), 200.f, 40, 10, 10, Outside);
+	FLIGHT_CHECK(Field.Sample(FFlightVec3(100.f, 100.f, 100.f)).X == Outside.X);   // not baked yet
+	for (int Z = 0; Z < 10; ++Z)
+	{
+		Field.SetBlocked(10, 5, Z);
+	}
+
+	FFlightWindBakeParams Bake;
+	Bake.MeanWind = MeanWind;
+	Bake.TurbulenceIntensity = 0.f;
+	Field.Bake(Bake);
+	FLIGHT_CHECK(Field.IsBaked());
+
+	// Open air upwind carries the mean wind, the obstacle none, its wake less
+	FLIGHT_CHECK_NEAR(Field.Sample(FFlightVec3(1000.f, 300.f, 1000.f)).X, MeanWind.X, 1e-2);
+	FLIGHT_CHECK_NEAR(Field.Sample(FFlightVec3(2100.f, 1100.f, 1100.f)).Size(), 0.f, 1e-3);
+	const float Wake = Field.Sample(FFlightVec3(2500.f, 1100.f, 1100.f)).X;
+	FLIGHT_CHECK(Wake < MeanWind.X * 0.5f && Wake > 0.f);
+	FLIGHT_CHECK(Field.Sample(FFlightVec3(3900.f, 1100.f, 1100.f)).X > Wake);
+	FLIGHT_CHECK(Field.Sample(FFlightVec3(-50.f, 100.f, 100.f)).X == Outside.X);
+
+	// Baked cells round trip
+	FFlightWindField Copy;
+	Copy.Init(FFlightVec3(), 200.f, 40, 10, 10, Outside);
+	FLIGHT_CHECK(Copy.SetCells(Field.GetCells()));
+	FLIGHT_CHECK(Copy.Sample(FFlightVec3(2500.f, 1100.f, 1100.f)).X == Wake);
+	FFlightWindField WrongSize;
+	WrongSize.Init(FFlightVec3(), 200.f, 4, 4, 4, Outside);
+	FLIGHT_CHECK(!WrongSize.SetCells(Field.GetCells()));
+
+	// A disarmed drone in open air is carried along at the wind speed (drag acts on airspeed)
+	FFlightWindField Uniform;
+	Uniform.Init(FFlightVec3(-1e5f, -1e5f, -1e6f), 1e5f, 2, 2, 20, MeanWind);
+	FFlightWindBakeParams UniformBake;
+	UniformBake.MeanWind = MeanWind;
+	UniformBake.TurbulenceIntensity = 0.f;
+	Uniform.Bake(UniformBake);
+
+	FFlightParams Params;
+	Params.Wind = &Uniform;
+	FFlightState State = MakeFlightTestStartState();
+	for (int i = 0; i < 10000; ++i)
+	{
+		StepFlightModel(State, Params, FFlightInput(), FlightTestStep, nullptr);
+	}
+	FLIGHT_CHECK_NEAR(State.Velocity.X, MeanWind.X, 1.0);
+	FLIGHT_CHECK_NEAR(State.Velocity.Y, 0.f, 1e-2);
+}